@@ -14,6 +14,7 @@
 #include <thread>
 
 #include <folly/GLog.h>
+#include <folly/String.h>
 #include <folly/executors/GlobalExecutor.h>
 #include <folly/executors/IOExecutor.h>
 #include <folly/json.h>
@@ -32,6 +33,15 @@ using IPVersion = channels::ping::IPVersion;
 
 Application::Application()
     : deviceFactory(*this),
+      pollScheduler(
+          eventBase,
+          *this,
+          static_cast<unsigned int>(FLAGS_poll_max_concurrency)),
+      configApplier(
+          eventBase,
+          *this,
+          static_cast<unsigned int>(FLAGS_config_apply_max_concurrency),
+          std::chrono::seconds(FLAGS_poll_interval)),
       cartographer(
           [this](const cartography::DeviceConfig& deviceConfig) {
             add(deviceConfig);
@@ -51,6 +61,8 @@ void Application::init(
             addEngine<channels::ping::Engine>(eventBase, IPVersion::v4);
         pingEngineIpv6 =
             addEngine<channels::ping::Engine>(eventBase, IPVersion::v6);
+        httpEngine = addEngine<channels::http::Engine>(eventBase);
+        cnMaestroEngine = addEngine<channels::cnmaestro::Engine>(*httpEngine);
       },
       [this]() { this->statusCode = EXIT_FAILURE; });
 }
@@ -84,6 +96,16 @@ channels::cli::Engine& Application::getCliEngine() {
   return *cliEngine;
 }
 
+channels::http::Engine& Application::getHttpEngine() {
+  assert(httpEngine != nullptr);
+  return *httpEngine;
+}
+
+channels::cnmaestro::Engine& Application::getCnMaestroEngine() {
+  assert(cnMaestroEngine != nullptr);
+  return *cnMaestroEngine;
+}
+
 std::string Application::getName() const {
   return name;
 }
@@ -92,53 +114,91 @@ std::string Application::getVersion() const {
   return version;
 }
 
-// TODO move to device
-void Application::pollDevices() {
-  for (auto& device : devices) {
-    device.second->updateSharedView(unifiedView);
+folly::Future<folly::Unit> Application::pollDevice(const devices::Id& id) {
+  auto device = devices.find(id);
+  if (device == devices.end()) {
+    return folly::makeFuture();
   }
+  return device->second->updateSharedView(unifiedView);
 }
 
-void Application::tryToApplyRunningDatastoreToDevices() {
-  for (auto& device : devices) {
-    LOG(INFO) << "About to apply running datastore to device " << device.first;
-    device.second->tryToApplyRunningDatastore();
+// The poll interval of a device is its own if configured, else the shortest
+// interval configured for any of its channel types, else the global one.
+static std::chrono::milliseconds getPollInterval(
+    const cartography::DeviceConfig& deviceConfig) {
+  if (deviceConfig.pollInterval != 0) {
+    return std::chrono::seconds(deviceConfig.pollInterval);
   }
+
+  std::chrono::seconds interval(FLAGS_poll_interval);
+  std::vector<std::string> overrides;
+  folly::split(',', FLAGS_poll_channel_intervals, overrides, true);
+  for (auto& override_ : overrides) {
+    std::string channel;
+    uint64_t seconds{0};
+    if (not folly::split(':', override_, channel, seconds)) {
+      LOG(ERROR) << "Bad poll channel interval '" << override_ << "'";
+      continue;
+    }
+    if (deviceConfig.channelConfigs.count(channel) != 0 and seconds != 0) {
+      interval = std::min(interval, std::chrono::seconds(seconds));
+    }
+  }
+  return interval;
 }
 
 void Application::doDebug() {
   LOG(INFO) << "Debug Information";
 
+  static const auto& engineIterations =
+      MetricFamily::get("channel.engine.iterations", "channel");
+  static const auto& engineRequests =
+      MetricFamily::get("channel.engine.requests", "channel");
+  static const auto& deviceCount = MetricFamily::get("device.count");
+  static const auto& livingStateObjects =
+      MetricFamily::get("device.living_state_objects");
+
+  auto sample = std::make_shared<MetricSample>();
+
   LOG(INFO) << "\tChannel Engines (" << channelEngines.size() << "):";
   for (auto& engine : channelEngines) {
     LOG(INFO) << "\t\t" << engine->getName()
               << ": iterations = " << engine->getNumIterations()
               << ", requests = " << engine->getNumRequests();
-    MetricSink::setGauge(
-        folly::sformat("channel.{}.engine.iterations", engine->getName()),
-        engine->getNumIterations());
-    MetricSink::setGauge(
-        folly::sformat("channel.{}.engine.requests", engine->getName()),
-        engine->getNumRequests());
+    sample->set(
+        engineIterations,
+        engine->getName(),
+        static_cast<double>(engine->getNumIterations()));
+    sample->set(
+        engineRequests,
+        engine->getName(),
+        static_cast<double>(engine->getNumRequests()));
   }
 
   LOG(INFO) << "\tDevices (" << devices.size() << "):";
   for (auto& device : devices) {
     LOG(INFO) << "\t\t" << device.second->getId();
   }
-  MetricSink::setGauge("device.count", devices.size());
+  sample->set(deviceCount, static_cast<double>(devices.size()));
 
   LOG(INFO) << "\tLiving Datastore Objects: "
             << utils::LifetimeTracker<devices::Datastore>::getLivingCount();
-  MetricSink::setGauge(
-      "device.living_state_objects",
-      utils::LifetimeTracker<devices::Datastore>::getLivingCount());
+  sample->set(
+      livingStateObjects,
+      static_cast<double>(
+          utils::LifetimeTracker<devices::Datastore>::getLivingCount()));
+
+  setGauges(sample);
 }
 
 UnifiedView Application::getUnifiedView() {
-  UnifiedView cpy;
-  unifiedView.withULock([&cpy](auto& map) { cpy = map; });
-  return cpy;
+  // Only the per device snapshot pointers are copied here, the bundles are
+  // shared with the view.
+  return *unifiedView.rlock();
+}
+
+SharedUnifiedView& Application::getSharedUnifiedView() {
+  return unifiedView;
 }
 
 void Application::scheduleEvery(
@@ -180,12 +240,7 @@ void Application::run() {
       service->start();
     }
 
-    // TODO move this to devices
-    scheduleEvery(
-        [this]() { pollDevices(); }, std::chrono::seconds(FLAGS_poll_interval));
-    scheduleEvery(
-        [this]() { tryToApplyRunningDatastoreToDevices(); },
-        std::chrono::seconds(FLAGS_poll_interval));
+    pollScheduler.start();
 
     if (FLAGS_debug_print_interval != 0) {
       scheduleEvery(
@@ -218,15 +273,48 @@ int Application::status() const {
 void Application::add(const cartography::DeviceConfig& deviceConfig) {
   ErrorHandler::executeWithCatch([this, &deviceConfig]() {
     addDevice(deviceFactory.createDevice(deviceConfig));
-    devices[deviceConfig.id]->setRunningDatastore(deviceConfig.yangConfig);
+    auto& device = devices[deviceConfig.id];
+    device->setRunningDatastore(deviceConfig.yangConfig);
+
+    auto id = deviceConfig.id;
+    // Config changes come through here as a delete and an add so only the
+    // devices which changed are applied.
+    std::weak_ptr<devices::Device> weak(device);
+    auto generation = configApplier.markDirty(id, [this, weak, id]() {
+      auto shared = weak.lock();
+      if (shared == nullptr) {
+        return folly::makeFuture();
+      }
+      LOG(INFO) << "About to apply running datastore to device " << id;
+      auto applied = folly::makeFutureWith(
+          [&shared]() { return shared->tryToApplyRunningDatastore(); });
+      // The device may have been deleted meanwhile, leaving this the last
+      // reference, so it is released on the event base like any other.
+      return std::move(applied).thenTry(
+          [this, shared = std::move(shared)](
+              folly::Try<folly::Unit>&& result) mutable {
+            eventBase.runInEventBaseThread([shared = std::move(shared)]() {});
+            return folly::makeFuture<folly::Unit>(std::move(result));
+          });
+    });
+    LOG(INFO) << "Config generation " << generation << " of " << id
+              << " is pending";
+
+    pollScheduler.add(id, getPollInterval(deviceConfig), [this, id]() {
+      return pollDevice(id);
+    });
   });
 }
 
 void Application::del(const cartography::DeviceConfig& deviceConfig) {
   LOG(INFO) << "deleting " << deviceConfig.id;
+  pollScheduler.del(deviceConfig.id);
+  configApplier.del(deviceConfig.id);
   if (devices.erase(deviceConfig.id) != 1) {
     LOG(ERROR) << "Failed to delete device " << deviceConfig.id;
   }
+  unifiedView.wlock()->erase(deviceConfig.id);
+  removeGauges("deviceID", deviceConfig.id);
 }
 
 void Application::addDevice(std::shared_ptr<devices::Device>&& device) {
@@ -282,4 +370,29 @@ void Application::setGauge(
   }
 }
 
+void Application::setGauges(std::shared_ptr<const MetricSample> sample) {
+  for (auto& service : services) {
+    service->setGauges(sample);
+  }
+}
+
+void Application::removeGauges(
+    const std::string& labelName,
+    const std::string& labelValue) {
+  for (auto& service : services) {
+    service->removeGauges(labelName, labelValue);
+  }
+}
+
+void Application::observeHistogram(
+    const std::string& key,
+    double value,
+    const std::vector<double>& boundaries,
+    const std::string& labelName,
+    const std::string& labelValue) {
+  for (auto& service : services) {
+    service->observeHistogram(key, value, boundaries, labelName, labelValue);
+  }
+}
+
 } // namespace devmand
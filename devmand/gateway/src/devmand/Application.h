@@ -17,11 +17,15 @@
 #include <folly/dynamic.h>
 #include <folly/io/async/EventBase.h>
 
+#include <devmand/ConfigApplier.h>
+#include <devmand/PollScheduler.h>
 #include <devmand/Service.h>
 #include <devmand/UnifiedView.h>
 #include <devmand/cartography/Cartographer.h>
 #include <devmand/channels/Engine.h>
 #include <devmand/channels/cli/engine/Engine.h>
+#include <devmand/channels/cnmaestro/Engine.h>
+#include <devmand/channels/http/Engine.h>
 #include <devmand/channels/packet/Engine.h>
 #include <devmand/channels/ping/Engine.h>
 #include <devmand/channels/snmp/Engine.h>
@@ -69,6 +73,7 @@ class Application : public MetricSink {
   std::string getVersion() const;
 
   UnifiedView getUnifiedView();
+  SharedUnifiedView& getSharedUnifiedView();
 
   folly::EventBase& getEventBase();
 
@@ -83,6 +88,8 @@ class Application : public MetricSink {
   channels::ping::Engine& getPingEngine(IPVersion ipv = IPVersion::v4);
   channels::ping::Engine& getPingEngine(folly::IPAddress ip);
   channels::cli::Engine& getCliEngine();
+  channels::http::Engine& getHttpEngine();
+  channels::cnmaestro::Engine& getCnMaestroEngine();
 
   syslog::Manager& getSyslogManager();
 
@@ -92,9 +99,21 @@ class Application : public MetricSink {
       const std::string& labelName,
       const std::string& labelValue);
 
+  virtual void setGauges(std::shared_ptr<const MetricSample> sample);
+
+  virtual void removeGauges(
+      const std::string& labelName,
+      const std::string& labelValue);
+
+  virtual void observeHistogram(
+      const std::string& key,
+      double value,
+      const std::vector<double>& boundaries,
+      const std::string& labelName,
+      const std::string& labelValue);
+
  private:
-  void pollDevices();
-  void tryToApplyRunningDatastoreToDevices();
+  folly::Future<folly::Unit> pollDevice(const devices::Id& id);
   void doDebug();
 
   template <class EngineType, class... Args>
@@ -141,6 +160,8 @@ class Application : public MetricSink {
   channels::ping::Engine* pingEngine;
   channels::ping::Engine* pingEngineIpv6;
   channels::cli::Engine* cliEngine = nullptr;
+  channels::http::Engine* httpEngine = nullptr;
+  channels::cnmaestro::Engine* cnMaestroEngine = nullptr;
 
   /*
    * Devices communicate with the off host devices through any number of
@@ -150,6 +171,16 @@ class Application : public MetricSink {
   Devices devices;
   devices::Factory deviceFactory;
 
+  /*
+   * Spreads device polls across the poll interval.
+   */
+  PollScheduler pollScheduler;
+
+  /*
+   * Applies the config of devices whose config changed.
+   */
+  ConfigApplier configApplier;
+
   /*
    * The cartographer is a class which implements a number of methods by which
    * to discover devices on the network.
@@ -15,6 +15,20 @@ DEFINE_string(
     "/etc/devmand/devices.yml",
     "Accepts .yml or .mconfig files. Inotify watches the file, and applies necessary changes.");
 DEFINE_uint64(poll_interval, 55, "The polling interval in seconds.");
+DEFINE_string(
+    poll_channel_intervals,
+    "",
+    "Comma separated channel:seconds pairs overriding the polling interval "
+    "for devices using that channel type, e.g. 'ping:10,snmp:30'.");
+DEFINE_uint64(
+    poll_max_concurrency,
+    0,
+    "The maximum number of device polls outstanding at once. A value of 0 "
+    "disables the limit.");
+DEFINE_uint64(
+    config_apply_max_concurrency,
+    4,
+    "The maximum number of devices having their config applied at once.");
 DEFINE_uint64(
     debug_print_interval,
     0,
@@ -23,5 +37,20 @@ DEFINE_bool(
     devices_readonly,
     false,
     "whether or not devices can be configured");
+DEFINE_uint64(
+    state_report_refresh_interval,
+    300,
+    "The interval in seconds after which the state of a device is reported "
+    "again even if it has not changed. A value of 0 reports every device on "
+    "every state report.");
+DEFINE_string(
+    fscache_path,
+    "/var/cache/devmand/state.log",
+    "Where the device states are persisted so they can be served straight "
+    "away after a restart.");
+DEFINE_uint64(
+    fscache_sync_interval,
+    10,
+    "The interval in seconds at which changed device states are persisted.");
 
 } // namespace devmand
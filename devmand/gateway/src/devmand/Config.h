@@ -14,7 +14,13 @@ namespace devmand {
 DECLARE_string(listen_interface);
 DECLARE_string(device_configuration_file);
 DECLARE_uint64(poll_interval);
+DECLARE_string(poll_channel_intervals);
+DECLARE_uint64(poll_max_concurrency);
+DECLARE_uint64(config_apply_max_concurrency);
 DECLARE_uint64(debug_print_interval);
 DECLARE_bool(devices_readonly);
+DECLARE_uint64(state_report_refresh_interval);
+DECLARE_string(fscache_path);
+DECLARE_uint64(fscache_sync_interval);
 
 } // namespace devmand
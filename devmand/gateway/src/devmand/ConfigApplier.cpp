@@ -0,0 +1,225 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <devmand/ConfigApplier.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include <folly/GLog.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
+
+#include <devmand/error/ErrorHandler.h>
+
+namespace devmand {
+
+// Buckets in seconds for both the apply duration and latency histograms.
+static const std::vector<double> applyBuckets{
+    0.01, 0.1, 0.5, 1.0, 5.0, 10.0, 30.0, 60.0, 300.0};
+
+static double toSeconds(const utils::Clock::duration& duration) {
+  return std::chrono::duration_cast<std::chrono::duration<double>>(duration)
+      .count();
+}
+
+ConfigApplier::ConfigApplier(
+    folly::EventBase& eventBase_,
+    MetricSink& sink_,
+    unsigned int maxConcurrentApplies_,
+    const std::chrono::milliseconds& retryInterval_,
+    const std::chrono::milliseconds& applyTimeout_)
+    : eventBase(eventBase_),
+      sink(sink_),
+      maxConcurrentApplies(std::max(maxConcurrentApplies_, 1u)),
+      retryInterval(retryInterval_),
+      applyTimeout(applyTimeout_),
+      workers(
+          maxConcurrentApplies,
+          std::make_shared<folly::NamedThreadFactory>("configApply")) {}
+
+ConfigApplier::~ConfigApplier() {
+  // Before the workers are joined as their applies still post completions.
+  alive.reset();
+}
+
+ConfigApplier::Generation ConfigApplier::markDirty(
+    const devices::Id& id,
+    Apply apply) {
+  auto it = entries.find(id);
+  if (it == entries.end()) {
+    it = entries.emplace(id, Entry{std::move(apply), nextToken++}).first;
+  } else {
+    it->second.apply = std::move(apply);
+  }
+
+  auto& entry = it->second;
+  if (entry.applied == entry.generation) {
+    entry.dirtySince = utils::Time::now();
+  }
+  entry.generation = nextGeneration++;
+
+  // One being applied is requeued when it finishes.
+  if (not entry.inFlight) {
+    enqueue(id, entry);
+  }
+  launchReady();
+  reportGauges();
+  return entry.generation;
+}
+
+void ConfigApplier::del(const devices::Id& id) {
+  auto it = entries.find(id);
+  if (it == entries.end()) {
+    return;
+  }
+  if (it->second.queued) {
+    ready.erase(std::find(ready.begin(), ready.end(), id));
+  }
+  // An outstanding apply still holds its worker until it completes.
+  entries.erase(it);
+  reportGauges();
+}
+
+ConfigApplier::Generation ConfigApplier::getAppliedGeneration(
+    const devices::Id& id) const {
+  auto it = entries.find(id);
+  return it != entries.end() ? it->second.applied : 0;
+}
+
+unsigned int ConfigApplier::getNumInFlight() const {
+  return inFlight;
+}
+
+void ConfigApplier::enqueue(const devices::Id& id, Entry& entry) {
+  if (not entry.queued) {
+    entry.queued = true;
+    ready.push_back(id);
+  }
+}
+
+void ConfigApplier::launchReady() {
+  while (not ready.empty() and inFlight < maxConcurrentApplies) {
+    auto id = ready.front();
+    ready.pop_front();
+    auto& entry = entries.at(id);
+    entry.queued = false;
+    launch(id, entry);
+  }
+}
+
+void ConfigApplier::launch(const devices::Id& id, Entry& entry) {
+  entry.inFlight = true;
+  ++inFlight;
+
+  auto token = entry.token;
+  auto generation = entry.generation;
+  auto start = utils::Time::now();
+  std::weak_ptr<bool> weak(alive);
+
+  // The timeout fails the apply but doesn't free its slot: the device stays
+  // in flight until the apply completes so a retry never overlaps it.
+  auto timedOut = std::make_shared<std::atomic<bool>>(false);
+  eventBase.scheduleAt(
+      [weak, id, generation, timedOut]() {
+        if (weak.lock() and not timedOut->exchange(true)) {
+          LOG(ERROR) << "Applying config generation " << generation << " to "
+                     << id << " timed out, waiting for it to complete";
+        }
+      },
+      eventBase.now() + applyTimeout);
+
+  // An apply may complete on any thread, e.g. a channel's event base.
+  folly::via(&workers, entry.apply)
+      .thenTry([this, weak, id, token, generation, start, timedOut](
+                   folly::Try<folly::Unit>&& result) {
+        if (result.hasException()) {
+          LOG(ERROR) << "Failed to apply config generation " << generation
+                     << " to " << id << ": " << result.exception().what();
+        }
+        auto ok = not timedOut->exchange(true) and result.hasValue();
+        eventBase.runInEventBaseThread(
+            [this, weak, id, token, generation, start, ok]() {
+              if (weak.lock()) {
+                finished(id, token, generation, start, ok);
+              }
+            });
+      });
+}
+
+void ConfigApplier::finished(
+    const devices::Id& id,
+    uint64_t token,
+    Generation generation,
+    utils::TimePoint applyStart,
+    bool succeeded) {
+  --inFlight;
+  auto now = utils::Time::now();
+  sink.observeHistogram(
+      "device.config.apply_seconds", toSeconds(now - applyStart), applyBuckets);
+
+  auto it = entries.find(id);
+  if (it != entries.end() and it->second.token == token) {
+    auto& entry = it->second;
+    entry.inFlight = false;
+    if (succeeded) {
+      sink.observeHistogram(
+          "device.config.apply_latency_seconds",
+          toSeconds(now - entry.dirtySince),
+          applyBuckets);
+      entry.applied = generation;
+      // Changes made during the apply count from its end.
+      entry.dirtySince = now;
+    }
+
+    if (entry.applied != entry.generation) {
+      if (succeeded or generation != entry.generation) {
+        // Changed while it was being applied.
+        enqueue(id, entry);
+      } else {
+        std::weak_ptr<bool> weak(alive);
+        eventBase.scheduleAt(
+            [this, weak, id, token]() {
+              if (weak.lock()) {
+                retry(id, token);
+              }
+            },
+            eventBase.now() + retryInterval);
+      }
+    }
+  }
+
+  // A worker just freed up so let anything waiting for one go.
+  ErrorHandler::executeWithCatch([this]() { launchReady(); });
+  reportGauges();
+}
+
+void ConfigApplier::retry(const devices::Id& id, uint64_t token) {
+  auto it = entries.find(id);
+  if (it == entries.end() or it->second.token != token) {
+    return;
+  }
+  auto& entry = it->second;
+  if (not entry.inFlight and entry.applied != entry.generation) {
+    enqueue(id, entry);
+    launchReady();
+  }
+  reportGauges();
+}
+
+void ConfigApplier::reportGauges() {
+  unsigned int dirty{0};
+  for (auto& entry : entries) {
+    if (entry.second.applied != entry.second.generation) {
+      ++dirty;
+    }
+  }
+  sink.setGauge("device.config.dirty", dirty);
+  sink.setGauge("device.config.apply_in_flight", inFlight);
+}
+
+} // namespace devmand
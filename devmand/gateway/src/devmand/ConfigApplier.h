@@ -0,0 +1,124 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
+#include <folly/io/async/EventBase.h>
+
+#include <devmand/MetricSink.h>
+#include <devmand/devices/Id.h>
+#include <devmand/utils/Time.h>
+
+namespace devmand {
+
+/*
+ * Applies the desired config of devices when it changes rather than
+ * re-applying every device's config on a timer. A change marks the device
+ * dirty and bumps its generation; only dirty devices are applied.
+ *
+ * Applies run on a pool of maxConcurrentApplies workers as they may block on
+ * the device, at most maxConcurrentApplies are outstanding at a time. A device
+ * is applied by at most one apply at a time and changes made while it is
+ * queued or being applied are coalesced into one more apply of the latest
+ * config. An apply which throws, returns a failed future or doesn't complete
+ * within applyTimeout is retried after retryInterval. One which times out
+ * keeps its slot and the device in flight until it does complete, the
+ * retry interval starts from there.
+ * How long applies took and how long changes took to be applied are exported
+ * to the metric sink as histograms.
+ *
+ * All methods must be called from the event base thread.
+ */
+class ConfigApplier final {
+ public:
+  using Apply = std::function<folly::Future<folly::Unit>()>;
+  using Generation = uint64_t;
+
+  ConfigApplier(
+      folly::EventBase& eventBase_,
+      MetricSink& sink_,
+      unsigned int maxConcurrentApplies_ = 4,
+      const std::chrono::milliseconds& retryInterval_ =
+          std::chrono::seconds(55),
+      const std::chrono::milliseconds& applyTimeout_ =
+          std::chrono::minutes(5));
+  ConfigApplier() = delete;
+  ~ConfigApplier();
+  ConfigApplier(const ConfigApplier&) = delete;
+  ConfigApplier& operator=(const ConfigApplier&) = delete;
+  ConfigApplier(ConfigApplier&&) = delete;
+  ConfigApplier& operator=(ConfigApplier&&) = delete;
+
+ public:
+  // Marks the config of a device changed, apply applies the latest config.
+  // Generations increase across all devices so they survive a re-add.
+  Generation markDirty(const devices::Id& id, Apply apply);
+
+  void del(const devices::Id& id);
+
+  // The last generation of a device which applied successfully.
+  Generation getAppliedGeneration(const devices::Id& id) const;
+
+  unsigned int getNumInFlight() const;
+
+ private:
+  struct Entry {
+    Apply apply;
+    uint64_t token;
+    Generation generation{0};
+    Generation applied{0};
+    // When the oldest change not yet applied was made.
+    utils::TimePoint dirtySince;
+    bool queued{false};
+    bool inFlight{false};
+  };
+
+ private:
+  void enqueue(const devices::Id& id, Entry& entry);
+  void launchReady();
+  void launch(const devices::Id& id, Entry& entry);
+  void finished(
+      const devices::Id& id,
+      uint64_t token,
+      Generation generation,
+      utils::TimePoint applyStart,
+      bool succeeded);
+  void retry(const devices::Id& id, uint64_t token);
+  void reportGauges();
+
+ private:
+  folly::EventBase& eventBase;
+  MetricSink& sink;
+  unsigned int maxConcurrentApplies;
+  std::chrono::milliseconds retryInterval;
+  std::chrono::milliseconds applyTimeout;
+
+  std::map<devices::Id, Entry> entries;
+
+  // Dirty devices waiting for a worker, each queued at most once.
+  std::deque<devices::Id> ready;
+
+  unsigned int inFlight{0};
+  uint64_t nextToken{0};
+  Generation nextGeneration{1};
+
+  // Expires with the applier so callbacks posted to the event base can tell
+  // it is gone.
+  std::shared_ptr<bool> alive{std::make_shared<bool>(true)};
+
+  folly::CPUThreadPoolExecutor workers;
+};
+
+} // namespace devmand
@@ -5,10 +5,102 @@
 // LICENSE file in the root directory of this source tree. An additional grant
 // of patent rights can be found in the PATENTS file in the same directory.
 
+#include <deque>
+#include <map>
+#include <utility>
+
+#include <folly/Format.h>
+#include <folly/Synchronized.h>
+
 #include <devmand/MetricSink.h>
 
 namespace devmand {
 
+namespace {
+
+class MetricFamilies final {
+ public:
+  // Leaked so that families outlive any static holding on to one
+  static MetricFamilies& get() {
+    static auto* families = new MetricFamilies;
+    return *families;
+  }
+
+  const MetricFamily& add(
+      const std::string& name,
+      const std::string& labelName) {
+    auto locked = table.wlock();
+    auto key = std::make_pair(name, labelName);
+    auto it = locked->index.find(key);
+    if (it != locked->index.end()) {
+      return *it->second;
+    }
+    locked->families.emplace_back(locked->families.size(), name, labelName);
+    auto* family = &locked->families.back();
+    locked->index.emplace(std::move(key), family);
+    return *family;
+  }
+
+ private:
+  struct Table {
+    // Families never move once registered
+    std::deque<MetricFamily> families;
+    std::map<std::pair<std::string, std::string>, const MetricFamily*> index;
+  };
+
+  folly::Synchronized<Table> table;
+};
+
+} // namespace
+
+const MetricFamily& MetricFamily::get(
+    const std::string& name,
+    const std::string& labelName) {
+  return MetricFamilies::get().add(name, labelName);
+}
+
+void MetricSample::set(const MetricFamily& family, double value) {
+  values.push_back(Value{&family, "", value});
+}
+
+void MetricSample::set(
+    const MetricFamily& family,
+    std::string familyLabelValue,
+    double value) {
+  values.push_back(Value{&family, std::move(familyLabelValue), value});
+}
+
+void MetricSink::setGauges(std::shared_ptr<const MetricSample> sample) {
+  for (auto& value : sample->getValues()) {
+    if (value.family->getLabelName().empty()) {
+      setGauge(
+          value.family->getName(),
+          value.value,
+          sample->getLabelName(),
+          sample->getLabelValue());
+    } else {
+      setGauge(
+          folly::sformat(
+              "{}[{}={}]",
+              value.family->getName(),
+              value.family->getLabelName(),
+              value.labelValue),
+          value.value,
+          sample->getLabelName(),
+          sample->getLabelValue());
+    }
+  }
+}
+
+void MetricSink::removeGauges(const std::string&, const std::string&) {}
+
+void MetricSink::observeHistogram(
+    const std::string&,
+    double,
+    const std::vector<double>&,
+    const std::string&,
+    const std::string&) {}
+
 void MetricSink::setGauge(const std::string& key, int value) {
   setGauge(key, static_cast<double>(value), "", "");
 }
@@ -7,10 +7,102 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace devmand {
 
+/* A gauge family registered up front, typically into a function local static,
+ * so that emitting a sample of it neither builds nor hashes its name. A family
+ * may have a label of its own, e.g. the interface index of an interface
+ * counter. Families are never unregistered.
+ */
+class MetricFamily final {
+ public:
+  static const MetricFamily& get(
+      const std::string& name,
+      const std::string& labelName = "");
+
+  MetricFamily(size_t id_, std::string name_, std::string labelName_)
+      : id(id_), name(std::move(name_)), labelName(std::move(labelName_)) {}
+  MetricFamily() = delete;
+  ~MetricFamily() = default;
+  MetricFamily(const MetricFamily&) = delete;
+  MetricFamily& operator=(const MetricFamily&) = delete;
+  MetricFamily(MetricFamily&&) = delete;
+  MetricFamily& operator=(MetricFamily&&) = delete;
+
+ public:
+  // Dense, starting at 0, in order of registration
+  size_t getId() const {
+    return id;
+  }
+
+  const std::string& getName() const {
+    return name;
+  }
+
+  const std::string& getLabelName() const {
+    return labelName;
+  }
+
+ private:
+  size_t id;
+  std::string name;
+  std::string labelName;
+};
+
+/* The gauges of one source, e.g. a device, from one poll. Emitted to the sink
+ * as a whole so the sink sees every value of the poll together.
+ */
+class MetricSample final {
+ public:
+  struct Value {
+    const MetricFamily* family;
+    std::string labelValue;
+    double value;
+  };
+
+  // The label identifying the source, added to every value
+  MetricSample(std::string labelName_ = "", std::string labelValue_ = "")
+      : labelName(std::move(labelName_)),
+        labelValue(std::move(labelValue_)) {}
+  ~MetricSample() = default;
+  MetricSample(const MetricSample&) = default;
+  MetricSample& operator=(const MetricSample&) = default;
+  MetricSample(MetricSample&&) = default;
+  MetricSample& operator=(MetricSample&&) = default;
+
+ public:
+  void set(const MetricFamily& family, double value);
+  void set(
+      const MetricFamily& family,
+      std::string familyLabelValue,
+      double value);
+
+  const std::string& getLabelName() const {
+    return labelName;
+  }
+
+  const std::string& getLabelValue() const {
+    return labelValue;
+  }
+
+  const std::vector<Value>& getValues() const {
+    return values;
+  }
+
+  bool empty() const {
+    return values.empty();
+  }
+
+ private:
+  std::string labelName;
+  std::string labelValue;
+  std::vector<Value> values;
+};
+
 /* An abstraction of a class which handles metrics. This represents a place for
  * metrics updates to go such as a time series database or a log.
  */
@@ -30,6 +122,29 @@ class MetricSink {
       const std::string& labelName,
       const std::string& labelValue) = 0;
 
+  /* Sets all gauges of a sample. Sinks which can't batch get the values one
+   * at a time, a family label is then folded into the key as
+   * "{name}[{label}={value}]" since they only take a single label.
+   */
+  virtual void setGauges(std::shared_ptr<const MetricSample> sample);
+
+  /* Forgets the gauges set by the samples of a source, e.g. a device which
+   * was deleted. Sinks which don't keep gauges per source ignore it.
+   */
+  virtual void removeGauges(
+      const std::string& labelName,
+      const std::string& labelValue);
+
+  /* Records an observation into the histogram with the given bucket
+   * boundaries. Sinks which don't support histograms ignore it.
+   */
+  virtual void observeHistogram(
+      const std::string& key,
+      double value,
+      const std::vector<double>& boundaries,
+      const std::string& labelName = "",
+      const std::string& labelValue = "");
+
   // Overloads
   void setGauge(const std::string& key, int value);
   void setGauge(const std::string& key, size_t value);
@@ -0,0 +1,166 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <devmand/PollScheduler.h>
+
+#include <folly/GLog.h>
+#include <folly/hash/Hash.h>
+
+#include <devmand/error/ErrorHandler.h>
+
+namespace devmand {
+
+// Buckets in seconds for both the poll lag and duration histograms.
+static const std::vector<double> pollBuckets{
+    0.01, 0.1, 0.5, 1.0, 5.0, 10.0, 30.0, 60.0};
+
+static double toSeconds(const utils::Clock::duration& duration) {
+  return std::chrono::duration_cast<std::chrono::duration<double>>(duration)
+      .count();
+}
+
+PollScheduler::PollScheduler(
+    folly::EventBase& eventBase_,
+    MetricSink& sink_,
+    unsigned int maxConcurrentPolls_,
+    const std::chrono::milliseconds& resolution_)
+    : eventBase(eventBase_),
+      sink(sink_),
+      maxConcurrentPolls(maxConcurrentPolls_),
+      resolution(resolution_),
+      timer(folly::AsyncTimeout::make(
+          eventBase,
+          [this]() noexcept { tick(); })) {}
+
+PollScheduler::~PollScheduler() {
+  timer->cancelTimeout();
+}
+
+std::chrono::milliseconds PollScheduler::getPhase(
+    const devices::Id& id,
+    const std::chrono::milliseconds& interval) {
+  if (interval.count() <= 0) {
+    return std::chrono::milliseconds(0);
+  }
+  auto hash = folly::hash::fnv64(id);
+  return std::chrono::milliseconds(
+      static_cast<std::chrono::milliseconds::rep>(
+          hash % static_cast<uint64_t>(interval.count())));
+}
+
+void PollScheduler::add(
+    const devices::Id& id,
+    const std::chrono::milliseconds& interval,
+    Poll poll) {
+  del(id);
+
+  auto due = utils::Time::now() + getPhase(id, interval);
+  entries.emplace(id, Entry{interval, std::move(poll), due, nextToken++});
+  dueQueue.emplace(due, id);
+}
+
+void PollScheduler::del(const devices::Id& id) {
+  auto it = entries.find(id);
+  if (it != entries.end()) {
+    // An outstanding poll still holds its slot until it completes.
+    dueQueue.erase(std::make_pair(it->second.due, id));
+    entries.erase(it);
+  }
+}
+
+void PollScheduler::start() {
+  if (started) {
+    return;
+  }
+  started = true;
+  std::weak_ptr<bool> weak(alive);
+  eventBase.runInEventBaseThread([this, weak]() {
+    if (weak.lock()) {
+      tick();
+    }
+  });
+}
+
+unsigned int PollScheduler::getNumInFlight() const {
+  return inFlight;
+}
+
+void PollScheduler::tick() {
+  ErrorHandler::executeWithCatch([this]() { launchDue(); });
+  sink.setGauge("device.poll.in_flight", inFlight);
+  sink.setGauge("device.poll.skipped", skipped);
+  timer->scheduleTimeout(static_cast<uint32_t>(resolution.count()));
+}
+
+void PollScheduler::launchDue() {
+  auto now = utils::Time::now();
+  while (not dueQueue.empty() and dueQueue.begin()->first <= now and
+         (maxConcurrentPolls == 0 or inFlight < maxConcurrentPolls)) {
+    auto id = dueQueue.begin()->second;
+    dueQueue.erase(dueQueue.begin());
+
+    auto& entry = entries.at(id);
+    if (entry.inFlight) {
+      LOG(INFO) << "Skipping poll of " << id
+                << " as the previous poll is outstanding";
+      ++skipped;
+    } else {
+      launch(id, entry, now);
+    }
+
+    // Keep the device on its phase even if we fell more than one interval
+    // behind.
+    do {
+      entry.due += entry.interval;
+    } while (entry.due <= now and entry.interval.count() > 0);
+    dueQueue.emplace(entry.due, id);
+  }
+}
+
+void PollScheduler::launch(
+    const devices::Id& id,
+    Entry& entry,
+    utils::TimePoint now) {
+  sink.observeHistogram(
+      "device.poll.lag_seconds", toSeconds(now - entry.due), pollBuckets);
+
+  entry.inFlight = true;
+  ++inFlight;
+
+  auto token = entry.token;
+  std::weak_ptr<bool> weak(alive);
+  auto& base = eventBase;
+  folly::makeFutureWith(entry.poll).thenTry(
+      [this, weak, &base, id, token, now](folly::Try<folly::Unit>&&) {
+        base.runInEventBaseThread([this, weak, id, token, now]() {
+          if (weak.lock()) {
+            finished(id, token, now);
+          }
+        });
+      });
+}
+
+void PollScheduler::finished(
+    const devices::Id& id,
+    uint64_t token,
+    utils::TimePoint pollStart) {
+  --inFlight;
+  sink.observeHistogram(
+      "device.poll.duration_seconds",
+      toSeconds(utils::Time::now() - pollStart),
+      pollBuckets);
+
+  auto it = entries.find(id);
+  if (it != entries.end() and it->second.token == token) {
+    it->second.inFlight = false;
+  }
+
+  // A slot just freed up so let anything waiting on the budget go.
+  ErrorHandler::executeWithCatch([this]() { launchDue(); });
+}
+
+} // namespace devmand
@@ -0,0 +1,121 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+
+#include <folly/futures/Future.h>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+
+#include <devmand/MetricSink.h>
+#include <devmand/devices/Id.h>
+#include <devmand/utils/Time.h>
+
+namespace devmand {
+
+/*
+ * Schedules device polls so they are spread across the poll interval rather
+ * than all firing on the same tick. Each device gets a stable phase offset
+ * within its interval derived from its id and is then polled once per
+ * interval at that offset.
+ *
+ * At most maxConcurrentPolls polls are outstanding at any time (0 means no
+ * limit). Polls which come due while the budget is exhausted wait for a free
+ * slot and a device whose previous poll is still outstanding skips the cycle.
+ * How late each poll started and how long it took are exported to the metric
+ * sink as histograms.
+ *
+ * All methods, and the destructor, must be called from the event base thread
+ * or once its loop has stopped.
+ */
+class PollScheduler final {
+ public:
+  using Poll = std::function<folly::Future<folly::Unit>()>;
+
+  PollScheduler(
+      folly::EventBase& eventBase_,
+      MetricSink& sink_,
+      unsigned int maxConcurrentPolls_ = 0,
+      const std::chrono::milliseconds& resolution_ =
+          std::chrono::milliseconds(100));
+  PollScheduler() = delete;
+  ~PollScheduler();
+  PollScheduler(const PollScheduler&) = delete;
+  PollScheduler& operator=(const PollScheduler&) = delete;
+  PollScheduler(PollScheduler&&) = delete;
+  PollScheduler& operator=(PollScheduler&&) = delete;
+
+ public:
+  // Adds a device to the schedule, replacing any previous entry for it.
+  void add(
+      const devices::Id& id,
+      const std::chrono::milliseconds& interval,
+      Poll poll);
+
+  void del(const devices::Id& id);
+
+  // Starts the scheduling tick. Devices may be added before or after.
+  void start();
+
+  unsigned int getNumInFlight() const;
+
+  // The offset within the interval at which a device is polled.
+  static std::chrono::milliseconds getPhase(
+      const devices::Id& id,
+      const std::chrono::milliseconds& interval);
+
+ private:
+  struct Entry {
+    std::chrono::milliseconds interval;
+    Poll poll;
+    utils::TimePoint due;
+    uint64_t token;
+    bool inFlight{false};
+  };
+
+  using DueQueue = std::set<std::pair<utils::TimePoint, devices::Id>>;
+
+ private:
+  void tick();
+  void launchDue();
+  void launch(const devices::Id& id, Entry& entry, utils::TimePoint now);
+  void finished(
+      const devices::Id& id,
+      uint64_t token,
+      utils::TimePoint pollStart);
+
+ private:
+  folly::EventBase& eventBase;
+  MetricSink& sink;
+  unsigned int maxConcurrentPolls;
+  std::chrono::milliseconds resolution;
+
+  std::map<devices::Id, Entry> entries;
+
+  // Every entry is queued exactly once, ordered by when it is next due.
+  DueQueue dueQueue;
+
+  unsigned int inFlight{0};
+  uint64_t skipped{0};
+  uint64_t nextToken{0};
+  bool started{false};
+
+  std::unique_ptr<folly::AsyncTimeout> timer;
+
+  // Expires with the scheduler so callbacks posted to the event base can tell
+  // it is gone.
+  std::shared_ptr<bool> alive{std::make_shared<bool>(true)};
+};
+
+} // namespace devmand
@@ -0,0 +1,106 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <devmand/UnifiedView.h>
+
+#include <folly/json.h>
+
+namespace devmand {
+
+DeviceState::DeviceState(
+    YangModelBundle&& bundle_,
+    uint64_t generation_,
+    bool stale_)
+    : bundle(std::move(bundle_)),
+      serialized(folly::toJson(bundle)),
+      generation(generation_),
+      stale(stale_) {}
+
+const YangModelBundle& DeviceState::getBundle() const {
+  return bundle;
+}
+
+const std::string& DeviceState::getSerialized() const {
+  return serialized;
+}
+
+uint64_t DeviceState::getGeneration() const {
+  return generation;
+}
+
+bool DeviceState::isStale() const {
+  return stale;
+}
+
+DeviceStatePtr UnifiedView::update(
+    const devices::Id& id,
+    YangModelBundle&& bundle) {
+  auto it = devices.find(id);
+  if (it != devices.end() and not it->second->isStale() and
+      it->second->getBundle() == bundle) {
+    return it->second;
+  }
+
+  auto state =
+      std::make_shared<const DeviceState>(std::move(bundle), ++generation);
+  devices.insert_or_assign(id, state);
+  return state;
+}
+
+DeviceStatePtr UnifiedView::restore(
+    const devices::Id& id,
+    YangModelBundle&& bundle) {
+  auto it = devices.find(id);
+  if (it != devices.end()) {
+    return it->second;
+  }
+
+  auto state = std::make_shared<const DeviceState>(
+      std::move(bundle), ++generation, true);
+  devices.emplace(id, state);
+  return state;
+}
+
+void UnifiedView::erase(const devices::Id& id) {
+  if (devices.erase(id) != 0) {
+    ++generation;
+  }
+}
+
+void UnifiedView::eraseStale() {
+  for (auto it = devices.begin(); it != devices.end();) {
+    if (it->second->isStale()) {
+      it = devices.erase(it);
+      ++generation;
+    } else {
+      ++it;
+    }
+  }
+}
+
+DeviceStatePtr UnifiedView::get(const devices::Id& id) const {
+  auto it = devices.find(id);
+  return it == devices.end() ? nullptr : it->second;
+}
+
+uint64_t UnifiedView::getGeneration() const {
+  return generation;
+}
+
+DeviceStates::const_iterator UnifiedView::begin() const {
+  return devices.begin();
+}
+
+DeviceStates::const_iterator UnifiedView::end() const {
+  return devices.end();
+}
+
+size_t UnifiedView::size() const {
+  return devices.size();
+}
+
+} // namespace devmand
@@ -7,9 +7,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 
+#include <folly/Synchronized.h>
 #include <folly/dynamic.h>
 
 #include <devmand/devices/Id.h>
@@ -18,7 +21,96 @@ namespace devmand {
 
 // TODO convert this to ydk?
 using YangModelBundle = folly::dynamic;
-using UnifiedView = std::map<devices::Id, YangModelBundle>;
+
+/*
+ * An immutable snapshot of the state of one device. Snapshots are shared
+ * between the unified view and everyone who has taken a copy of it so they
+ * must never be modified once published. The json form is serialized once
+ * when the snapshot is made and reused by every reader.
+ *
+ * A stale snapshot was restored from disk on startup rather than polled and
+ * is served only until the first poll of the device lands.
+ */
+class DeviceState final {
+ public:
+  DeviceState(
+      YangModelBundle&& bundle_,
+      uint64_t generation_,
+      bool stale_ = false);
+  DeviceState() = delete;
+  ~DeviceState() = default;
+  DeviceState(const DeviceState&) = delete;
+  DeviceState& operator=(const DeviceState&) = delete;
+  DeviceState(DeviceState&&) = delete;
+  DeviceState& operator=(DeviceState&&) = delete;
+
+ public:
+  const YangModelBundle& getBundle() const;
+  const std::string& getSerialized() const;
+  uint64_t getGeneration() const;
+  bool isStale() const;
+
+ private:
+  const YangModelBundle bundle;
+  const std::string serialized;
+  const uint64_t generation;
+  const bool stale;
+};
+
+using DeviceStatePtr = std::shared_ptr<const DeviceState>;
+using DeviceStates = std::map<devices::Id, DeviceStatePtr>;
+
+/*
+ * A versioned view of the state of all devices. Copying a view only copies
+ * the pointers to the per device snapshots so readers can take a consistent
+ * copy cheaply and hold on to it without blocking updates.
+ *
+ * Every change to a device bumps the view generation and stamps the new
+ * snapshot with it so consumers can tell which devices changed since they
+ * last looked.
+ */
+class UnifiedView final {
+ public:
+  UnifiedView() = default;
+  ~UnifiedView() = default;
+  UnifiedView(const UnifiedView&) = default;
+  UnifiedView& operator=(const UnifiedView&) = default;
+  UnifiedView(UnifiedView&&) = default;
+  UnifiedView& operator=(UnifiedView&&) = default;
+
+ public:
+  /*
+   * Replaces the state of a device. If the bundle is identical to the current
+   * snapshot nothing changes and the existing snapshot is kept, preserving its
+   * generation, unless that snapshot is stale. Returns the snapshot now in the
+   * view.
+   */
+  DeviceStatePtr update(const devices::Id& id, YangModelBundle&& bundle);
+
+  /*
+   * Adds a stale snapshot for a device which has none yet. Returns the
+   * snapshot now in the view.
+   */
+  DeviceStatePtr restore(const devices::Id& id, YangModelBundle&& bundle);
+
+  void erase(const devices::Id& id);
+
+  // Drops every snapshot which is still stale.
+  void eraseStale();
+
+  DeviceStatePtr get(const devices::Id& id) const;
+
+  uint64_t getGeneration() const;
+
+  DeviceStates::const_iterator begin() const;
+  DeviceStates::const_iterator end() const;
+  size_t size() const;
+
+ private:
+  DeviceStates devices;
+  uint64_t generation{0};
+};
+
 using SharedUnifiedView = folly::Synchronized<UnifiedView>;
 
 } // namespace devmand
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <set>
 #include <string>
@@ -40,6 +41,9 @@ struct DeviceConfig {
   std::string yangConfig;
   bool readonly{false};
 
+  // Seconds between polls of this device. 0 uses the default interval.
+  uint64_t pollInterval{0};
+
   std::map<std::string, ChannelConfig> channelConfigs;
 
   friend std::ostream& operator<<(std::ostream& out, const DeviceConfig& c) {
@@ -47,7 +51,8 @@ struct DeviceConfig {
         << "platform=" << c.platform << ", "
         << "ip=" << c.ip << ", "
         << "yangConfig=" << c.yangConfig << ", "
-        << "readonly=" << c.readonly << ", channels {";
+        << "readonly=" << c.readonly << ", "
+        << "pollInterval=" << c.pollInterval << ", channels {";
     for (auto& channel : c.channelConfigs) {
       out << channel.first << ", ";
     }
@@ -69,6 +74,7 @@ struct DeviceConfig {
                lhs.ip,
                lhs.yangConfig,
                lhs.readonly,
+               lhs.pollInterval,
                lhs.channelConfigs) ==
         std::tie(
                rhs.id,
@@ -76,6 +82,7 @@ struct DeviceConfig {
                rhs.ip,
                rhs.yangConfig,
                rhs.readonly,
+               rhs.pollInterval,
                rhs.channelConfigs);
   }
 
@@ -86,6 +93,7 @@ struct DeviceConfig {
                lhs.ip,
                lhs.yangConfig,
                lhs.readonly,
+               lhs.pollInterval,
                lhs.channelConfigs) !=
         std::tie(
                rhs.id,
@@ -93,6 +101,7 @@ struct DeviceConfig {
                rhs.ip,
                rhs.yangConfig,
                rhs.readonly,
+               rhs.pollInterval,
                rhs.channelConfigs);
   }
 };
@@ -53,16 +53,17 @@ SemiFuture<std::string> PromptAwareCli::executeRead(const ReadCommand cmd) {
               DisconnectedException("SSH session expired"));
         }
       })
-      .thenValue([params = promptAwareParameters, cmd](const string& output) {
+      .thenValue([params = promptAwareParameters, cmd](string output) {
         if (auto _session = params->session.lock()) {
           if (auto _cliFlavour = params->cliFlavour.lock()) {
             if (auto _executor = params->executor.lock()) {
               return _session->write(_cliFlavour->getNewline())
                   .via(_executor.get())
-                  .thenValue([params, output, cmd](...) {
+                  .thenValue([params, output = move(output), cmd](
+                                 ...) mutable {
                     MLOG(MDEBUG) << "[" << params->id << "] (" << cmd
                                  << ") written newline";
-                    return output;
+                    return move(output);
                   });
             }
           }
@@ -70,17 +71,19 @@ SemiFuture<std::string> PromptAwareCli::executeRead(const ReadCommand cmd) {
         return makeFuture<std::string>(
             DisconnectedException("SSH session expired"));
       })
-      .thenValue([params = promptAwareParameters, cmd](const string& output) {
+      .thenValue([params = promptAwareParameters, cmd](string output) {
         if (auto _session = params->session.lock()) {
           if (auto _executor = params->executor.lock()) {
             return _session->readUntilOutput(params->prompt)
                 .via(_executor.get())
-                .thenValue([id = params->id, output, cmd](
-                               const string& readUntilOutput) {
+                .thenValue([id = params->id, output = move(output), cmd](
+                               const string& readUntilOutput) mutable {
                   // this might never run, do not capture params
                   MLOG(MDEBUG) << "[" << id << "] (" << cmd
                                << ") readUntilOutput - read result";
-                  return output + readUntilOutput;
+                  // output is the large part, append to it instead of copying
+                  output.append(readUntilOutput);
+                  return move(output);
                 })
                 .semi();
           }
@@ -6,7 +6,6 @@
 // of patent rights can be found in the PATENTS file in the same directory.
 
 #include <devmand/channels/cli/ReadCachingCli.h>
-#include <folly/Optional.h>
 #include <folly/Synchronized.h>
 #include <folly/container/EvictingCacheMap.h>
 #include <magma_logging.h>
@@ -15,40 +14,120 @@ using devmand::channels::cli::Cli;
 using devmand::channels::cli::Command;
 using folly::EvictingCacheMap;
 using folly::Future;
-using folly::Optional;
 using folly::Synchronized;
 using std::shared_ptr;
 using std::string;
-using CliCache = Synchronized<EvictingCacheMap<string, string>>;
 
 namespace devmand::channels::cli {
 
-folly::SemiFuture<std::string> ReadCachingCli::executeRead(
-    const ReadCommand cmd) {
-  if (!cmd.skipCache()) {
-    Optional<string> cachedResult =
-        cache->withWLock([cmd, this](auto& cache_) -> Optional<string> {
-          if (cache_.exists(cmd.raw())) {
-            MLOG(MDEBUG) << "[" << id << "] "
-                         << "Found command: " << cmd << " in cache";
-            return Optional<string>(cache_.get(cmd.raw()));
-          } else {
-            return Optional<string>(folly::none);
-          }
-        });
-
-    if (cachedResult) {
-      return folly::SemiFuture<string>(*cachedResult.get_pointer());
+CliCache::Stripe::Stripe(size_t maxSize, size_t clearSize)
+    : entries(maxSize, clearSize) {}
+
+CliCache::CliCache(size_t stripeCount, size_t maxSize, size_t clearSize)
+    : cycle(0), hits(0), misses(0), coalesced(0) {
+  size_t stripeMaxSize = std::max<size_t>(1, maxSize / stripeCount);
+  size_t stripeClearSize = std::max<size_t>(1, clearSize / stripeCount);
+  for (size_t i = 0; i < stripeCount; i++) {
+    stripes.push_back(std::make_unique<Synchronized<Stripe>>(
+        folly::in_place, stripeMaxSize, stripeClearSize));
+  }
+}
+
+Synchronized<CliCache::Stripe>& CliCache::getStripe(const string& cmd) {
+  return *stripes[std::hash<string>()(cmd) % stripes.size()];
+}
+
+SemiFuture<string> CliCache::getOrExecute(
+    const string& cmd,
+    bool skipCache,
+    std::function<SemiFuture<string>()> execute,
+    folly::Executor* executor) {
+  uint64_t startedInCycle;
+  shared_ptr<SharedPromise<string>> promise;
+  {
+    auto stripe = getStripe(cmd).wlock();
+    // clear() bumps the cycle before it clears this stripe, so under the lock
+    // a read cannot be registered for an old cycle on a stripe already cleared
+    startedInCycle = cycle;
+    if (not skipCache) {
+      auto cached = stripe->entries.find(cmd);
+      if (cached != stripe->entries.end()) {
+        MLOG(MDEBUG) << "Found command: " << cmd << " in cache";
+        hits++;
+        return folly::makeSemiFuture(cached->second);
+      }
+      auto running = stripe->inFlight.find(cmd);
+      if (running != stripe->inFlight.end()) {
+        MLOG(MDEBUG) << "Joining execution of command: " << cmd;
+        coalesced++;
+        return running->second.promise->getSemiFuture();
+      }
+    }
+    misses++;
+    promise = std::make_shared<SharedPromise<string>>();
+    if (not skipCache) {
+      stripe->inFlight[cmd] = {startedInCycle, promise};
     }
   }
 
-  return cli->executeRead(cmd)
-      .via(executor.get())
-      .thenValue([=](string output) {
-        cache->wlock()->insert(cmd.raw(), output);
-        return output;
-      })
-      .semi();
+  SemiFuture<string> result = promise->getSemiFuture();
+  execute().via(executor).thenTry(
+      [cache = shared_from_this(), cmd, startedInCycle, promise](
+          folly::Try<string>&& output) {
+        cache->complete(cmd, startedInCycle, promise, move(output));
+      });
+  return result;
+}
+
+void CliCache::complete(
+    const string& cmd,
+    uint64_t startedInCycle,
+    shared_ptr<SharedPromise<string>> promise,
+    folly::Try<string>&& output) {
+  {
+    auto stripe = getStripe(cmd).wlock();
+    auto running = stripe->inFlight.find(cmd);
+    if (running != stripe->inFlight.end() &&
+        running->second.promise == promise) {
+      stripe->inFlight.erase(running);
+    }
+    if (output.hasValue() && startedInCycle == cycle) {
+      stripe->entries.set(cmd, output.value());
+    }
+  }
+  // complete waiting reads outside of the lock
+  promise->setTry(move(output));
+}
+
+void CliCache::clear() {
+  cycle++;
+  for (auto& stripe : stripes) {
+    auto locked = stripe->wlock();
+    locked->entries.clear();
+    // reads in flight finish for their callers, later reads go to the device
+    locked->inFlight.clear();
+  }
+}
+
+uint64_t CliCache::getHits() const {
+  return hits;
+}
+
+uint64_t CliCache::getMisses() const {
+  return misses;
+}
+
+uint64_t CliCache::getCoalesced() const {
+  return coalesced;
+}
+
+folly::SemiFuture<std::string> ReadCachingCli::executeRead(
+    const ReadCommand cmd) {
+  return cache->getOrExecute(
+      cmd.raw(),
+      cmd.skipCache(),
+      [cli = cli, cmd]() { return cli->executeRead(cmd); },
+      executor.get());
 }
 
 ReadCachingCli::ReadCachingCli(
@@ -86,7 +165,7 @@ ReadCachingCli::~ReadCachingCli() {
 }
 
 shared_ptr<CliCache> ReadCachingCli::createCache() {
-  return std::make_shared<CliCache>(EvictingCacheMap<string, string>(200, 10));
+  return std::make_shared<CliCache>(16, 200, 10);
 }
 
 } // namespace devmand::channels::cli
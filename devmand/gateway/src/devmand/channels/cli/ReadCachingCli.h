@@ -10,16 +10,77 @@
 #include <devmand/channels/cli/Cli.h>
 #include <folly/Synchronized.h>
 #include <folly/container/EvictingCacheMap.h>
+#include <folly/futures/SharedPromise.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace devmand::channels::cli {
 
 using folly::EvictingCacheMap;
 using folly::Future;
 using folly::SemiFuture;
+using folly::SharedPromise;
 using folly::Synchronized;
 using std::shared_ptr;
 using std::string;
-using CliCache = Synchronized<EvictingCacheMap<string, string>>;
+
+/*
+ * Command output cache of a single device. Commands are spread over lock
+ * striped evicting maps. A read of a command that is already being executed
+ * joins the execution in flight instead of going to the device again, so
+ * every distinct command hits the device once per poll cycle.
+ */
+class CliCache : public std::enable_shared_from_this<CliCache> {
+ private:
+  struct InFlight {
+    uint64_t cycle;
+    shared_ptr<SharedPromise<string>> promise;
+  };
+
+  struct Stripe {
+    EvictingCacheMap<string, string> entries;
+    std::map<string, InFlight> inFlight;
+
+    Stripe(size_t maxSize, size_t clearSize);
+  };
+
+  std::vector<std::unique_ptr<Synchronized<Stripe>>> stripes;
+  // outputs of reads started in an older cycle are not cached
+  std::atomic<uint64_t> cycle;
+  std::atomic<uint64_t> hits;
+  std::atomic<uint64_t> misses;
+  std::atomic<uint64_t> coalesced;
+
+  Synchronized<Stripe>& getStripe(const string& cmd);
+
+  void complete(
+      const string& cmd,
+      uint64_t startedInCycle,
+      shared_ptr<SharedPromise<string>> promise,
+      folly::Try<string>&& output);
+
+ public:
+  CliCache(size_t stripeCount, size_t maxSize, size_t clearSize);
+
+  /*
+   * Return cached output of cmd, join its execution in flight or run execute.
+   * With skipCache, execute always runs but its output is still cached.
+   */
+  SemiFuture<string> getOrExecute(
+      const string& cmd,
+      bool skipCache,
+      std::function<SemiFuture<string>()> execute,
+      folly::Executor* executor);
+
+  // Start a new poll cycle, dropping all cached outputs
+  void clear();
+
+  uint64_t getHits() const;
+  uint64_t getMisses() const;
+  uint64_t getCoalesced() const;
+};
 
 class ReadCachingCli : public Cli {
  private:
@@ -43,6 +43,33 @@ SshSessionAsync::SshSessionAsync(
 
 static const int EVENT_FINISH = 9999;
 
+ExpectedOutputMatcher::ExpectedOutputMatcher(string _expected)
+    : expected(_expected) {}
+
+folly::Optional<string> ExpectedOutputMatcher::append(const string& chunk) {
+  outputSoFar.append(chunk);
+  std::size_t found = outputSoFar.find(expected, searchFrom);
+  if (found == std::string::npos) {
+    // expected output might start in the tail of what we have so far
+    if (outputSoFar.length() >= expected.length()) {
+      searchFrom = outputSoFar.length() - expected.length() + 1;
+    }
+    return folly::none;
+  }
+
+  size_t consumedLength = found + expected.length();
+  unexpectedOutput = outputSoFar.substr(consumedLength);
+  outputSoFar.resize(found);
+  searchFrom = 0;
+  string result = std::move(outputSoFar);
+  outputSoFar.clear();
+  return result;
+}
+
+const string& ExpectedOutputMatcher::getUnexpectedOutput() const {
+  return unexpectedOutput;
+}
+
 folly::SemiFuture<Unit> SshSessionAsync::destroy() {
   // idempotency
   if (shutdown) {
@@ -161,7 +188,7 @@ Future<Unit> SshSessionAsync::write(const string& command) {
 Future<string> SshSessionAsync::readUntilOutput(const string& lastOutput) {
   this->readingState.currentLastOutput = lastOutput;
   this->readingState.promise = std::make_shared<Promise<string>>();
-  this->readingState.outputSoFar = "";
+  this->readingState.matcher = ExpectedOutputMatcher(lastOutput);
   matchingExpectedOutput.store(true);
   processDataInBuffer(); // we could have had something already waiting in the
                          // queue
@@ -213,29 +240,24 @@ void SshSessionAsync::matchExpectedOutput() {
     if (this->readingState.currentLastOutput.empty()) {
       matchingExpectedOutput.store(false);
       this->readingState.promise->setValue("");
+      return;
     }
 
-    while (this->readQueue.read_available() != 0) {
-      string output;
-      readQueue.pop(output);
-      this->readingState.outputSoFar.append(output);
-      std::size_t found = this->readingState.outputSoFar.find(
-          this->readingState.currentLastOutput);
-      if (found != std::string::npos) {
-        string final = this->readingState.outputSoFar.substr(0, found);
-
-        // Check for any outstanding output
-        size_t consumedLength =
-            final.length() + this->readingState.currentLastOutput.length();
-        if (consumedLength < this->readingState.outputSoFar.length()) {
+    string output;
+    while (readQueue.pop(output)) {
+      folly::Optional<string> final = this->readingState.matcher.append(output);
+      if (final.hasValue()) {
+        const string& unexpected =
+            this->readingState.matcher.getUnexpectedOutput();
+        if (not unexpected.empty()) {
           MLOG(MWARNING) << "[" << id << "] "
-                         << "Unexpected output from device: ("
-                         << this->readingState.outputSoFar.substr(
-                                consumedLength)
+                         << "Unexpected output from device: (" << unexpected
                          << "). This output will be lost";
         }
         matchingExpectedOutput.store(false);
-        this->readingState.promise->setValue(final);
+        // anything still queued belongs to the next readUntilOutput
+        this->readingState.promise->setValue(std::move(final.value()));
+        return;
       }
     }
   }
@@ -14,6 +14,7 @@
 #include <devmand/channels/cli/SshSession.h>
 #include <event2/event.h>
 #include <folly/executors/IOExecutor.h>
+#include <folly/Optional.h>
 #include <folly/executors/SerialExecutor.h>
 #include <folly/futures/Future.h>
 
@@ -40,6 +41,32 @@ using std::unique_ptr;
 
 void readCallback(evutil_socket_t fd, short, void* ptr);
 
+/*
+ * Accumulates output chunks until expected output appears in them. Each
+ * chunk is searched together with only the last expected.length() - 1
+ * characters of the previous ones, so large outputs arriving in many small
+ * packets are scanned once.
+ */
+class ExpectedOutputMatcher {
+ private:
+  string expected;
+  string outputSoFar;
+  string unexpectedOutput;
+  size_t searchFrom = 0;
+
+ public:
+  explicit ExpectedOutputMatcher(string _expected = "");
+
+  /*
+   * Append chunk and return everything that preceded expected output once it
+   * is found. Accumulated output is moved out of the matcher, anything
+   * following expected output is available in getUnexpectedOutput().
+   */
+  folly::Optional<string> append(const string& chunk);
+
+  const string& getUnexpectedOutput() const;
+};
+
 class SessionAsync {
  public:
   virtual Future<Unit> write(const string& command) = 0;
@@ -65,7 +92,7 @@ class SshSessionAsync : public std::enable_shared_from_this<SshSessionAsync>,
   struct ReadingState {
     shared_ptr<Promise<string>> promise;
     string currentLastOutput;
-    string outputSoFar;
+    ExpectedOutputMatcher matcher;
   } readingState;
 
   Future<Unit> waitForCallbacks();
@@ -16,6 +16,8 @@ TreeCache::TreeCache(shared_ptr<CliFlavour> _cliFlavour)
 
 void TreeCache::clear() {
   treeCache.clear();
+  changedSections.clear();
+  configBuffer = nullptr;
 }
 
 Optional<pair<string, vector<string>>> TreeCache::parseCommand(string cmd) {
@@ -32,7 +34,41 @@ Optional<pair<string, vector<string>>> TreeCache::parseCommand(string cmd) {
 
 void TreeCache::update(string output) {
   boost::replace_all(output, "\r", "");
-  treeCache = readConfigurationToMap(output, 0);
+  changedSections.clear();
+  if (configBuffer != nullptr && *configBuffer == output) {
+    return;
+  }
+
+  // views must point into a buffer that does not move, hence the shared_ptr
+  auto newBuffer = make_shared<const string>(move(output));
+  map<vector<string>, string_view> newTreeCache;
+  for (const auto& [firstLine, section] : tokenizeSections(
+           *newBuffer,
+           cliFlavour->getSingleIndentChar(),
+           cliFlavour->getConfigSubsectionEnd(),
+           0)) {
+    newTreeCache.emplace(
+        cliFlavour->splitSubcommands(string(firstLine)), section);
+  }
+
+  for (const auto& [key, section] : newTreeCache) {
+    auto previous = treeCache.find(key);
+    if (previous == treeCache.end() || previous->second != section) {
+      changedSections.insert(key);
+    }
+  }
+  for (const auto& entry : treeCache) {
+    if (newTreeCache.count(entry.first) == 0) {
+      changedSections.insert(entry.first);
+    }
+  }
+
+  treeCache.swap(newTreeCache);
+  configBuffer = newBuffer;
+}
+
+const set<vector<string>>& TreeCache::getChangedSections() {
+  return changedSections;
 }
 
 Optional<string> TreeCache::getSection(pair<string, vector<string>> cmd) {
@@ -48,8 +84,6 @@ bool TreeCache::isEmpty() {
 
 // public api end
 
-// used in StringUtils::getFirstLine
-static const regex firstLineRegex = regex("^([^\n]*)\n");
 class StringUtils {
  private:
   // trim from start (in place)
@@ -79,16 +113,6 @@ class StringUtils {
     ltrim(s);
     rtrim(s);
   }
-
-  static string getFirstLine(string input) {
-    smatch sm;
-    if (regex_search(input, sm, firstLineRegex)) {
-      return sm[1];
-    } else {
-      // no \n, return everything
-      return input;
-    }
-  }
 };
 
 size_t TreeCache::size() {
@@ -101,15 +125,15 @@ map<vector<string>, string> TreeCache::readConfigurationToMap(
     unsigned int indentationLevel) {
   // currently only one level of sections is supported, thus indentationLevel ==
   // 0
-  regex regexMatch = regex(createSectionPattern(indentationLevel));
-  smatch sm;
   map<vector<string>, string> result;
 
-  while (hasNextSection(regexMatch, sm, showRunningOutput)) {
-    string section = sm[1];
-    string firstLine = StringUtils::getFirstLine(section);
-    vector<string> args = cliFlavour->splitSubcommands(firstLine);
-    result.insert(make_pair(args, section));
+  for (const auto& [firstLine, section] : tokenizeSections(
+           showRunningOutput,
+           cliFlavour->getSingleIndentChar(),
+           cliFlavour->getConfigSubsectionEnd(),
+           indentationLevel)) {
+    vector<string> args = cliFlavour->splitSubcommands(string(firstLine));
+    result.insert(make_pair(args, string(section)));
   }
   // last piece of content that is not a section is ignored
   return result;
@@ -120,6 +144,43 @@ map<vector<string>, string> TreeCache::readConfigurationToMap(
   return readConfigurationToMap(showRunningOutput, 0);
 }
 
+vector<pair<string_view, string_view>> TreeCache::tokenizeSections(
+    string_view output,
+    Optional<char> maybeIndentChar,
+    const string& configSubsectionEnd,
+    unsigned int indentationLevel) {
+  string indent;
+  if (maybeIndentChar.hasValue()) {
+    indent.assign(indentationLevel, maybeIndentChar.value());
+  }
+  const string sectionEnd = indent + configSubsectionEnd;
+
+  vector<pair<string_view, string_view>> sections;
+  Optional<size_t> sectionStart;
+  string_view firstLine;
+  size_t lineStart = 0;
+  size_t lineEnd;
+  while ((lineEnd = output.find('\n', lineStart)) != string_view::npos) {
+    string_view line = output.substr(lineStart, lineEnd - lineStart);
+    if (not sectionStart) {
+      if (line.size() > indent.size() &&
+          line.compare(0, indent.size(), indent) == 0 &&
+          not isspace(static_cast<unsigned char>(line[indent.size()]))) {
+        sectionStart = lineStart;
+        firstLine = line;
+      }
+    } else if (line == sectionEnd) {
+      sections.emplace_back(
+          firstLine,
+          output.substr(
+              sectionStart.value(), lineEnd + 1 - sectionStart.value()));
+      sectionStart = none;
+    }
+    lineStart = lineEnd + 1;
+  }
+  return sections;
+}
+
 bool TreeCache::hasNextSection(regex& regexMatch, smatch& sm, string& content) {
   if (not sm.empty()) {
     // move content after previous section
@@ -171,11 +232,12 @@ Optional<pair<string, string>> TreeCache::splitSupportedCommand(string cmd) {
 }
 
 Optional<string> TreeCache::findMatchingSubset(
-    vector<string> subcommands,
-    map<vector<string>, string> treeCache) {
+    const vector<string>& subcommands,
+    const map<vector<string>, string_view>& treeCache) {
   // simplistic case: find whole key in map
-  if (treeCache.count(subcommands) == 1) {
-    return treeCache.at(subcommands);
+  auto it = treeCache.find(subcommands);
+  if (it != treeCache.end()) {
+    return string(it->second);
   }
   return none;
 }
@@ -7,6 +7,9 @@
 
 #pragma once
 #include <devmand/channels/cli/CliFlavour.h>
+#include <memory>
+#include <set>
+#include <string_view>
 
 namespace devmand::channels::cli {
 
@@ -22,8 +25,12 @@ using namespace folly;
 class TreeCache {
  private:
   shared_ptr<CliFlavour> cliFlavour;
+  // last running configuration, owns the text all sections point into
+  shared_ptr<const string> configBuffer;
   // section cache
-  map<vector<string>, string> treeCache;
+  map<vector<string>, string_view> treeCache;
+  // sections added, modified or removed by the last update
+  set<vector<string>> changedSections;
 
  public:
   // TODO: cache invalidation
@@ -45,10 +52,19 @@ class TreeCache {
    * Try to update cache with actual command output. Return true
    * iif cmd does not contain subsections and thus cache
    * was populated.
+   * Output identical to the previous one is not parsed again, otherwise
+   * sections whose text differs from the previous output are recorded in
+   * getChangedSections.
    */
   // FIXME: currently only one 'show running-config' command is supported.
   void update(string output);
 
+  /*
+   * Keys of sections that were added, modified or removed by the last
+   * update, so that consumers can refresh only those.
+   */
+  const set<vector<string>>& getChangedSections();
+
   /*
    * Try to get result of supported command subsection from cache.
    * If show running command with subcommands is passed, return result from
@@ -85,9 +101,25 @@ class TreeCache {
       string showRunningOutput,
       unsigned int indentationLevel);
 
+  /*
+   * Single pass over command output returning (first line, section) views
+   * into it. A section starts with a line indented by indentationLevel
+   * indent characters followed by a non whitespace character and ends with
+   * the first following line made of the same indentation and
+   * configSubsectionEnd. Lines outside of sections are skipped, as is the
+   * last line when it is not terminated by \n.
+   */
+  static vector<pair<string_view, string_view>> tokenizeSections(
+      string_view output,
+      Optional<char> maybeIndentChar,
+      const string& configSubsectionEnd,
+      unsigned int indentationLevel);
+
   /*
    * Iterate over sections. If previous match is detected, content will be
    * set to start after found section starting with newline.
+   * Regex based matching is quadratic on large outputs and is kept only as
+   * the reference tokenizeSections is tested against.
    */
   static bool hasNextSection(regex& regexMatch, smatch& sm, string& content);
 
@@ -114,8 +146,8 @@ class TreeCache {
    * characters.
    */
   static Optional<string> findMatchingSubset(
-      vector<string> subcommands,
-      map<vector<string>, string> treeCache);
+      const vector<string>& subcommands,
+      const map<vector<string>, string_view>& treeCache);
 };
 
 } // namespace devmand::channels::cli
@@ -15,14 +15,15 @@ using devmand::channels::cli::datastore::DatastoreException;
 using devmand::devices::cli::SchemaContext;
 using std::make_unique;
 
-Datastore::Datastore(DatastoreType type, SchemaContext& _schemaContext)
-    : schemaContext(_schemaContext) {
-  llly_ctx* pLyCtx = schemaContext.getLyContext();
-  datastoreState = make_shared<DatastoreState>(pLyCtx, type);
-}
+Datastore::Datastore(DatastoreType _type, SchemaContext& _schemaContext)
+    : type(_type), schemaContext(_schemaContext) {}
 
 unique_ptr<DatastoreTransaction> Datastore::newTx() {
   unique_lock<mutex> lock(_mutex);
+  if (datastoreState == nullptr) {
+    llly_ctx* pLyCtx = schemaContext.getLyContext();
+    datastoreState = make_shared<DatastoreState>(pLyCtx, type);
+  }
   checkIfTransactionRunning();
   setTransactionRunning();
   return make_unique<DatastoreTransaction>(datastoreState, schemaContext);
@@ -26,6 +26,8 @@ using std::unique_ptr;
 
 class Datastore {
  private:
+  DatastoreType type;
+  // Built by the first transaction, parsing the models if nothing did yet
   shared_ptr<DatastoreState> datastoreState;
   SchemaContext& schemaContext;
   std::mutex _mutex;
@@ -26,6 +26,7 @@ bool DatastoreTransaction::delete_(Path p) {
     MLOG(MDEBUG) << "Nothing to delete for: " << p;
     return false;
   }
+  touch(p);
 
   if (Path::ROOT == p && !p.getFirstModuleName().hasValue()) {
     datastoreState->freeTransactionRoots(); // delete all trees
@@ -132,6 +133,7 @@ vector<LydPair> DatastoreTransaction::splitNodeToRoots(lllyd_node* node) {
 }
 void DatastoreTransaction::merge(const Path path, const dynamic& aDynamic) {
   checkIfCommitted();
+  touch(path);
   dynamic withParents = appendAllParents(path, aDynamic);
   lllyd_node* pNode = dynamic2lydNode(withParents);
   vector<LydPair> pairsToMerge = splitNodeToRoots(pNode);
@@ -202,9 +204,23 @@ lllyd_node* DatastoreTransaction::computeRoot(lllyd_node* n) {
   return n;
 }
 
+void DatastoreTransaction::touch(const Path& path) {
+  if (Path::ROOT == path || not path.getFirstModuleName().hasValue()) {
+    touchedAll = true; // can't tell which trees change, diff everything
+    return;
+  }
+  touchedPaths.emplace(path);
+}
+
 map<Path, DatastoreDiff> DatastoreTransaction::diff() {
   map<Path, DatastoreDiff> allDiffs;
 
+  // group the touched subtrees by the tree (module) they belong to
+  map<string, vector<Path>> touchedByModule;
+  for (const auto& path : touchedPaths) {
+    touchedByModule[path.getFirstModuleName().value()].emplace_back(path);
+  }
+
   const vector<RootPair>& pairs =
       datastoreState->getCommittedRootAndTransactionRootPairs();
 
@@ -216,46 +232,172 @@ map<Path, DatastoreDiff> DatastoreTransaction::diff() {
       continue;
     }
 
-    // if everything was deleted make diff manually
-    if (pair.first != nullptr && pair.second == nullptr) {
-      const string path = makePrefixedSegment(pair.first);
-      allDiffs.emplace(make_pair(
-          path,
-          DatastoreDiff(
-              parseJson(toJson(pair.first)),
-              dynamic::object,
-              DatastoreDiffType::deleted,
-              Path(path))));
+    if (touchedAll) {
+      diffRoots(pair, allDiffs);
       continue;
     }
 
-    // if everything was created (no previous state available) make diff
-    // manually
-    if (pair.first == nullptr && pair.second != nullptr) {
-      string path = makePrefixedSegment(pair.second);
-      allDiffs.emplace(make_pair(
-          path,
-          DatastoreDiff(
-              dynamic::object,
-              parseJson(toJson(pair.second)),
-              DatastoreDiffType::create,
-              Path(path))));
-      continue;
+    lllyd_node* existing = pair.first == nullptr ? pair.second : pair.first;
+    auto touched = touchedByModule.find(existing->schema->module->name);
+    if (touched == touchedByModule.end()) {
+      continue; // untouched trees are identical to the committed ones
     }
 
-    map<Path, DatastoreDiff> diffs = libyangDiff(pair.first, pair.second);
-    allDiffs.insert(diffs.begin(), diffs.end());
+    vector<Path> subtrees;
+    for (const auto& path : touched->second) {
+      // subtrees under another touched subtree are covered by its diff
+      bool covered = false;
+      for (const auto& other : touched->second) {
+        covered = covered ||
+            (other != path && path.str().rfind(other.str() + "/", 0) == 0);
+      }
+      if (not covered) {
+        subtrees.emplace_back(path);
+      }
+    }
+
+    map<Path, DatastoreDiff> subtreeDiffs;
+    bool restricted = pair.first != nullptr && pair.second != nullptr;
+    for (const auto& path : subtrees) {
+      restricted = restricted && diffSubtree(pair, path, subtreeDiffs);
+    }
+
+    if (restricted) {
+      allDiffs.insert(subtreeDiffs.begin(), subtreeDiffs.end());
+    } else {
+      diffRoots(pair, allDiffs);
+    }
   }
 
   return allDiffs;
 }
 
+void DatastoreTransaction::diffRoots(
+    const RootPair& pair,
+    map<Path, DatastoreDiff>& allDiffs) {
+  // if everything was deleted make diff manually
+  if (pair.first != nullptr && pair.second == nullptr) {
+    const string path = makePrefixedSegment(pair.first);
+    allDiffs.emplace(make_pair(
+        path,
+        DatastoreDiff(
+            parseJson(toJson(pair.first)),
+            dynamic::object,
+            DatastoreDiffType::deleted,
+            Path(path))));
+    return;
+  }
+
+  // if everything was created (no previous state available) make diff
+  // manually
+  if (pair.first == nullptr && pair.second != nullptr) {
+    string path = makePrefixedSegment(pair.second);
+    allDiffs.emplace(make_pair(
+        path,
+        DatastoreDiff(
+            dynamic::object,
+            parseJson(toJson(pair.second)),
+            DatastoreDiffType::create,
+            Path(path))));
+    return;
+  }
+
+  map<Path, DatastoreDiff> diffs = libyangDiff(pair.first, pair.second);
+  allDiffs.insert(diffs.begin(), diffs.end());
+}
+
+lllyd_node* DatastoreTransaction::findUniqueNode(
+    lllyd_node* root,
+    const Path& path,
+    bool& ok) {
+  llly_set* pSet = findNode(root, path.str());
+  if (pSet == nullptr) {
+    return nullptr;
+  }
+  lllyd_node* result = nullptr;
+  if (pSet->number == 1) {
+    result = pSet->set.d[0];
+  } else if (pSet->number > 1) {
+    ok = false; // path does not identify a single subtree
+  }
+  llly_set_free(pSet);
+  return result;
+}
+
+// Diffs a single touched subtree, returns false if the subtree can't be
+// diffed on its own and the whole tree needs to be diffed instead.
+bool DatastoreTransaction::diffSubtree(
+    const RootPair& pair,
+    const Path& path,
+    map<Path, DatastoreDiff>& allDiffs) {
+  if (path.getDepth() <= 1) {
+    return false;
+  }
+
+  bool ok = true;
+  lllyd_node* before = findUniqueNode(pair.first, path, ok);
+  lllyd_node* after = findUniqueNode(pair.second, path, ok);
+  if (not ok) {
+    return false;
+  }
+
+  if (before != nullptr && after != nullptr) {
+    map<Path, DatastoreDiff> diffs = libyangDiff(before, after, false);
+    allDiffs.insert(diffs.begin(), diffs.end());
+    return true;
+  }
+
+  if (before == nullptr && after == nullptr) {
+    return true; // e.g. deleting something that did not exist
+  }
+
+  // The subtree only exists on one side, report the topmost node missing on
+  // the other side the same way libyang would: created nodes next to their
+  // parent from before, deleted nodes next to their parent from after.
+  bool created = after != nullptr;
+  lllyd_node* node = created ? after : before;
+  lllyd_node* other = created ? pair.first : pair.second;
+  lllyd_node* otherParent = nullptr;
+  while (node->parent != nullptr) {
+    otherParent =
+        findUniqueNode(other, Path(buildFullPath(node->parent, "")), ok);
+    if (not ok) {
+      return false;
+    }
+    if (otherParent != nullptr) {
+      break;
+    }
+    node = node->parent;
+  }
+  if (otherParent == nullptr) {
+    return false; // the whole tree differs
+  }
+
+  const Path nodePath(buildFullPath(node, ""));
+  dynamic nodeData = parseJson(toJson(node));
+  dynamic parentData = parseJson(toJson(otherParent));
+  allDiffs.emplace(
+      std::piecewise_construct,
+      std::forward_as_tuple(nodePath),
+      std::forward_as_tuple(
+          created ? parentData : nodeData,
+          created ? nodeData : parentData,
+          created ? DatastoreDiffType::create : DatastoreDiffType::deleted,
+          nodePath));
+  return true;
+}
+
 map<Path, DatastoreDiff> DatastoreTransaction::libyangDiff(
     lllyd_node* a,
-    lllyd_node* b) {
+    lllyd_node* b,
+    bool withSiblings) {
   checkIfCommitted();
 
-  lllyd_difflist* difflist = lllyd_diff(a, b, LLLYD_DIFFOPT_WITHDEFAULTS);
+  lllyd_difflist* difflist = lllyd_diff(
+      a,
+      b,
+      LLLYD_DIFFOPT_WITHDEFAULTS |
+          (withSiblings ? 0 : LLLYD_DIFFOPT_NOSIBLINGS));
   if (!difflist) {
     DatastoreException ex("Something went wrong, no diff possible");
     MLOG(MWARNING) << ex.what();
@@ -308,12 +450,12 @@ bool DatastoreTransaction::segmentDiffOneOrLess(
 }
 
 vector<Path> DatastoreTransaction::getRegisteredPath(
-    vector<DiffPath> registeredPaths,
-    Path path,
+    const DiffPathIndex& index,
+    const Path& path,
     DatastoreDiffType type) {
   vector<Path> result;
   const vector<DiffPath> registeredParentsToNotify =
-      pickClosestPath(path, registeredPaths, type);
+      pickClosestPath(path, index, type);
 
   if (registeredParentsToNotify.empty()) {
     MLOG(MDEBUG) << "Unhandled event for changed path: " << path.str();
@@ -329,56 +471,20 @@ vector<Path> DatastoreTransaction::getRegisteredPath(
   return result;
 }
 
-bool DatastoreTransaction::shouldHandleSubtree(
-    const DiffPath& registeredPath,
-    const Path& changedPath) {
-  return registeredPath.asterix &&
-      changedPath.isChildOfUnprefixed(registeredPath.path);
-}
-
-bool DatastoreTransaction::isExactPath(
-    const DiffPath& registeredPath,
-    const Path& changedPath) {
-  return registeredPath.path.unkeyed().unprefixAllSegments() ==
-      changedPath.unkeyed().unprefixAllSegments();
-}
-
-bool DatastoreTransaction::isAboveChange(
-    const DiffPath& registeredPath,
-    const Path& changedPath) {
-  return registeredPath.path.isChildOfUnprefixed(changedPath) &&
-      registeredPath.path.getDepth() <= changedPath.getDepth();
-}
-
-bool DatastoreTransaction::isPickableCreate(
-    DatastoreDiffType type,
-    const DiffPath& toNotifyPath,
-    const Path& changedPath) {
-  return isExactPath(toNotifyPath, changedPath) &&
-      type == DatastoreDiffType::create;
-}
-
-bool DatastoreTransaction::isPickableDelete(
-    DatastoreDiffType type,
-    const DiffPath& toNotifyPath,
-    const Path& changedPath) {
-  return isAboveChange(toNotifyPath, changedPath) &&
-      type == DatastoreDiffType::deleted;
-}
-
 vector<DiffPath> DatastoreTransaction::matchClosesUpdatePath(
-    Path& modifiedPath,
-    vector<DiffPath>& registeredPaths) {
+    const Path& modifiedPath,
+    const vector<DiffPathMatch>& candidates) {
   vector<DiffPath> result;
 
   unsigned int max = 0;
   DiffPath resultSoFar;
   bool found = false;
-  for (const auto& p : registeredPaths) {
-    if (modifiedPath.segmentDistance(p.path) > max &&
-        modifiedPath.isChildOfUnprefixed(p.path)) {
-      resultSoFar = p;
-      max = modifiedPath.segmentDistance(p.path);
+  for (const auto& candidate : candidates) {
+    unsigned int distance =
+        modifiedPath.segmentDistance(candidate.registered.path);
+    if (distance > max) {
+      resultSoFar = candidate.registered;
+      max = distance;
       found = true;
     }
   }
@@ -390,15 +496,18 @@ vector<DiffPath> DatastoreTransaction::matchClosesUpdatePath(
 }
 
 vector<DiffPath> DatastoreTransaction::pickClosestPath(
-    Path path,
-    vector<DiffPath> paths,
+    const Path& path,
+    const DiffPathIndex& index,
     DatastoreDiffType type) {
+  // every candidate is a registered path at or above the changed one
+  const vector<DiffPathMatch>& candidates = index.findAtOrAbove(path);
+
   if (type == DatastoreDiffType::deleted || type == DatastoreDiffType::create) {
     vector<DiffPath> result;
-    for (auto registeredPath : paths) {
-      if (shouldHandleSubtree(registeredPath, path) ||
-          isPickableCreate(type, registeredPath, path) ||
-          isPickableDelete(type, registeredPath, path)) {
+    for (const auto& candidate : candidates) {
+      // either registered for the whole subtree or for exactly this node
+      if (candidate.registered.asterix || candidate.exact) {
+        DiffPath registeredPath = candidate.registered;
         registeredPath.asterix = true;
         result.emplace_back(registeredPath);
       }
@@ -406,7 +515,7 @@ vector<DiffPath> DatastoreTransaction::pickClosestPath(
     return result;
   }
 
-  return matchClosesUpdatePath(path, paths);
+  return matchClosesUpdatePath(path, candidates);
 }
 
 DatastoreTransaction::~DatastoreTransaction() {
@@ -445,43 +554,47 @@ DatastoreDiffType DatastoreTransaction::getDiffType(LLLYD_DIFFTYPE type) {
 }
 
 string DatastoreTransaction::makePrefixedSegment(lllyd_node* node) {
-  std::stringstream path;
-  path << "/" << node->schema->module->name << ":" << node->schema->name;
-  return path.str();
+  string segment("/");
+  segment.append(node->schema->module->name)
+      .append(":")
+      .append(node->schema->name);
+  return segment;
 }
 
 void DatastoreTransaction::addKeysToPath(
     lllyd_node* node,
     std::stringstream& path) {
-  vector<string> keys;
   auto* list = (lllys_node_list*)node->schema;
   for (uint8_t i = 0; i < list->keys_size; i++) {
-    keys.emplace_back(string(list->keys[i]->name));
-  }
-  for (const auto& key : keys) {
+    string key(list->keys[i]->name);
     lllyd_node* child = node->child;
-    string childName(child->schema->name);
-    while (childName != key) {
-      child = node->next;
-      childName.assign(child->schema->name);
+    while (child != nullptr && key != child->schema->name) {
+      child = child->next;
+    }
+    if (child == nullptr) {
+      continue;
     }
     lllyd_node_leaf_list* leafChild = (lllyd_node_leaf_list*)child;
-    string keyValue(leafChild->value_str);
-    path << "[" << key << "='" << keyValue << "']";
+    path << "[" << key << "='" << leafChild->value_str << "']";
   }
 }
 
 string DatastoreTransaction::buildFullPath(lllyd_node* node, string pathSoFar) {
+  // collect the ancestors first so the path is built once, root to node
+  vector<lllyd_node*> nodes;
+  for (; node != nullptr; node = node->parent) {
+    nodes.push_back(node);
+  }
+
   std::stringstream path;
-  path << makePrefixedSegment(node);
-  if (node->schema->nodetype == LLLYS_LIST) {
-    addKeysToPath(node, path);
+  for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+    path << makePrefixedSegment(*it);
+    if ((*it)->schema->nodetype == LLLYS_LIST) {
+      addKeysToPath(*it, path);
+    }
   }
   path << pathSoFar;
-  if (node->parent == nullptr) {
-    return path.str();
-  }
-  return buildFullPath(node->parent, path.str());
+  return path.str();
 }
 
 void DatastoreTransaction::printDiffType(LLLYD_DIFFTYPE type) {
@@ -691,6 +804,7 @@ DiffResult DatastoreTransaction::diff(vector<DiffPath> registeredPaths) {
   checkIfCommitted();
   DiffResult result;
   std::set<Path> alreadyProcessedDiff;
+  const DiffPathIndex index(registeredPaths);
   const map<Path, DatastoreDiff>& diffs = diff();
 
   for (const auto& diffItem : diffs) { // take libyang diffs
@@ -699,7 +813,7 @@ DiffResult DatastoreTransaction::diff(vector<DiffPath> registeredPaths) {
     for (const auto& smallerDiffsItem :
          smallerDiffs) { // map the smaller ones to their registered path
       vector<Path> registeredPathsToNotify = getRegisteredPath(
-          registeredPaths,
+          index,
           smallerDiffsItem.second.keyedPath,
           smallerDiffsItem.second.type);
 
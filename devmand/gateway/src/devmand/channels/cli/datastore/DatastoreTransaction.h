@@ -9,6 +9,7 @@
 
 #include <devmand/channels/cli/datastore/DatastoreDiff.h>
 #include <devmand/channels/cli/datastore/DatastoreState.h>
+#include <devmand/channels/cli/datastore/DiffPathIndex.h>
 #include <devmand/devices/cli/schema/BindingContext.h>
 #include <devmand/devices/cli/schema/ModelRegistry.h>
 #include <devmand/devices/cli/schema/Path.h>
@@ -18,6 +19,7 @@
 #include <magma_logging.h>
 #include <ydk/types.hpp>
 #include <atomic>
+#include <set>
 
 using devmand::channels::cli::datastore::DatastoreDiff;
 using devmand::channels::cli::datastore::DatastoreDiffType;
@@ -35,6 +37,7 @@ using std::map;
 using std::multimap;
 using std::pair;
 using std::runtime_error;
+using std::set;
 using std::shared_ptr;
 using std::string;
 using std::vector;
@@ -42,15 +45,6 @@ using ydk::Entity;
 
 namespace devmand::channels::cli::datastore {
 
-struct DiffPath {
-  Path path;
-  bool asterix;
-
-  DiffPath() : path("/"), asterix(false) {}
-
-  DiffPath(const Path _path, bool _asterix) : path(_path), asterix(_asterix) {}
-};
-
 struct DiffResult {
   multimap<Path, DatastoreDiff> diffs;
   vector<Path> unhandledDiffs;
@@ -65,8 +59,12 @@ class DatastoreTransaction {
   lllyd_node* root = nullptr;
   atomic_bool hasCommited = ATOMIC_VAR_INIT(false);
   SchemaContext& schemaContext;
+  // Subtrees modified by this transaction, diff only looks at these
+  set<Path> touchedPaths;
+  bool touchedAll = false;
 
   static lllyd_node* computeRoot(lllyd_node* n);
+  void touch(const Path& path);
   int datastoreTypeToLydOption();
   lllyd_node* dynamic2lydNode(dynamic entity);
   static lllyd_node*
@@ -80,43 +78,35 @@ class DatastoreTransaction {
   string toJson(lllyd_node* initial);
   static void addKeysToPath(lllyd_node* node, std::stringstream& path);
   static string makePrefixedSegment(lllyd_node* node);
-  static bool shouldHandleSubtree(
-      const DiffPath& registeredPath,
-      const Path& changedPath);
-  static bool isExactPath(
-      const DiffPath& registeredPath,
-      const Path& changedPath);
-  static bool isAboveChange(
-      const DiffPath& registeredPath,
-      const Path& changedPath);
   static bool segmentDiffOneOrLess(
       const Path& noTotifyPath,
       const Path& changedPath);
-  static bool isPickableDelete(
-      DatastoreDiffType type,
-      const DiffPath& toNotifyPath,
-      const Path& changedPath);
-  static bool isPickableCreate(
-      DatastoreDiffType type,
-      const DiffPath& toNotifyPath,
-      const Path& changedPath);
   static dynamic appendAllParents(Path path, const dynamic& aDynamic);
   static Path unifyLength(Path registeredPath, Path keyedPath);
-  vector<DiffPath>
-  pickClosestPath(Path path, vector<DiffPath> paths, DatastoreDiffType type);
+  static vector<DiffPath> pickClosestPath(
+      const Path& path,
+      const DiffPathIndex& index,
+      DatastoreDiffType type);
   static vector<DiffPath> matchClosesUpdatePath(
-      Path& modifiedPath,
-      vector<DiffPath>& registeredPaths);
+      const Path& modifiedPath,
+      const vector<DiffPathMatch>& candidates);
   map<Path, DatastoreDiff> splitDiff(DatastoreDiff diff);
   void
   splitToMany(Path p, dynamic input, vector<std::pair<string, dynamic>>& v);
   vector<Path> getRegisteredPath(
-      vector<DiffPath> registeredPaths,
-      Path path,
+      const DiffPathIndex& index,
+      const Path& path,
       DatastoreDiffType type);
   dynamic read(Path path, lllyd_node* node);
   dynamic readAlreadyCommitted(Path path);
-  map<Path, DatastoreDiff> libyangDiff(lllyd_node* a, lllyd_node* b);
+  void diffRoots(const RootPair& pair, map<Path, DatastoreDiff>& allDiffs);
+  bool diffSubtree(
+      const RootPair& pair,
+      const Path& path,
+      map<Path, DatastoreDiff>& allDiffs);
+  lllyd_node* findUniqueNode(lllyd_node* root, const Path& path, bool& ok);
+  map<Path, DatastoreDiff>
+  libyangDiff(lllyd_node* a, lllyd_node* b, bool withSiblings = true);
   string appendKey(dynamic data, string path);
   llly_set* findNode(lllyd_node* node, string path);
 
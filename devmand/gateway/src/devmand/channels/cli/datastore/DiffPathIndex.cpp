@@ -0,0 +1,59 @@
+// Copyright (c) 2020-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <devmand/channels/cli/datastore/DiffPathIndex.h>
+#include <algorithm>
+
+namespace devmand::channels::cli::datastore {
+
+vector<string> DiffPathIndex::indexSegments(const Path& path) {
+  return path.unkeyed().unprefixAllSegments().getSegments();
+}
+
+DiffPathIndex::DiffPathIndex(const vector<DiffPath>& _registeredPaths)
+    : registeredPaths(_registeredPaths) {
+  for (unsigned long i = 0; i < registeredPaths.size(); ++i) {
+    Node* node = &root;
+    for (const auto& segment : indexSegments(registeredPaths[i].path)) {
+      auto& child = node->children[segment];
+      if (child == nullptr) {
+        child = std::make_unique<Node>();
+      }
+      node = child.get();
+    }
+    node->registered.push_back(i);
+  }
+}
+
+vector<DiffPathMatch> DiffPathIndex::findAtOrAbove(
+    const Path& changedPath) const {
+  vector<std::pair<unsigned long, bool>> found;
+  const vector<string>& segments = indexSegments(changedPath);
+
+  const Node* node = &root;
+  for (unsigned long depth = 0; node != nullptr; ++depth) {
+    bool exact = depth == segments.size();
+    for (const auto& index : node->registered) {
+      found.emplace_back(index, exact);
+    }
+    if (exact) {
+      break;
+    }
+    auto child = node->children.find(segments[depth]);
+    node = child == node->children.end() ? nullptr : child->second.get();
+  }
+
+  std::sort(found.begin(), found.end());
+  vector<DiffPathMatch> result;
+  result.reserve(found.size());
+  for (const auto& f : found) {
+    result.push_back(DiffPathMatch{registeredPaths[f.first], f.second});
+  }
+  return result;
+}
+
+} // namespace devmand::channels::cli::datastore
@@ -0,0 +1,60 @@
+// Copyright (c) 2020-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#pragma once
+
+#include <devmand/devices/cli/schema/Path.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace devmand::channels::cli::datastore {
+using devmand::devices::cli::Path;
+using std::map;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+struct DiffPath {
+  Path path;
+  bool asterix;
+
+  DiffPath() : path("/"), asterix(false) {}
+
+  DiffPath(const Path _path, bool _asterix) : path(_path), asterix(_asterix) {}
+};
+
+struct DiffPathMatch {
+  const DiffPath& registered;
+  bool exact; // registered path is the changed path itself, not a parent
+};
+
+// Prefix trie of registered diff paths keyed by their unprefixed, unkeyed
+// segments. Looking up the registered paths at or above a changed path is a
+// single walk down the trie instead of a comparison against every registered
+// path.
+class DiffPathIndex {
+ private:
+  struct Node {
+    map<string, unique_ptr<Node>> children;
+    vector<unsigned long> registered; // indexes into registeredPaths
+  };
+
+  vector<DiffPath> registeredPaths;
+  Node root;
+
+  static vector<string> indexSegments(const Path& path);
+
+ public:
+  explicit DiffPathIndex(const vector<DiffPath>& _registeredPaths);
+
+  // Registered paths at or above the changed path in registration order
+  vector<DiffPathMatch> findAtOrAbove(const Path& changedPath) const;
+};
+
+} // namespace devmand::channels::cli::datastore
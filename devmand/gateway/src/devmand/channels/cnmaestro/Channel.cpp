@@ -5,196 +5,270 @@
 // LICENSE file in the root directory of this source tree. An additional grant
 // of patent rights can be found in the PATENTS file in the same directory.
 
-#include <stdio.h>
-#include <iostream>
+#include <cctype>
+#include <stdexcept>
 
-#include <folly/Conv.h>
-#include <folly/Subprocess.h>
-#include <folly/executors/Async.h>
+#include <folly/Format.h>
+#include <folly/GLog.h>
+#include <folly/String.h>
 #include <folly/json.h>
 
+#include <devmand/Config.h>
 #include <devmand/channels/cnmaestro/Channel.h>
-#include <devmand/error/ErrorHandler.h>
 
 namespace devmand {
 namespace channels {
 namespace cnmaestro {
 
 namespace {
-// TODO: dynamically read in from local file.
-std::string accessTokenLead = "Authorization: Bearer ";
-const char* grantType = "grant_type=client_credentials";
-const char* ipHead = "https://";
-std::string curlPath = "/usr/bin/curl";
-std::string accessTokenPath = "api/v1/access/token";
-std::string devicesPath = "api/v1/devices";
-std::chrono::seconds curlTimeout(5);
-constexpr int operationTimeout = 28;
+const char* accessTokenPath = "/api/v1/access/token";
+const char* devicesPath = "/api/v1/devices";
+// The most cnMaestro returns per page.
+constexpr size_t pageSize = 100;
+const std::chrono::seconds requestTimeout(5);
+// Tokens are renewed this long before cnMaestro would expire them.
+const std::chrono::seconds tokenRefreshMargin(60);
+const std::chrono::seconds defaultTokenLifetime(3600);
+
+std::string normalizeMac(const std::string& mac) {
+  std::string normalized(mac);
+  for (auto& c : normalized) {
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+  }
+  return normalized;
+}
+
+std::string formEscape(const std::string& value) {
+  return folly::uriEscape<std::string>(value, folly::UriEscapeMode::QUERY);
+}
 } // namespace
 
 Channel::Channel(
-    const std::string& ipAddr_,
+    http::Engine& engine_,
+    const std::string& host,
     const std::string& clientId_,
     const std::string& clientSecret_)
-    : ipAddr(ipAddr_), clientId(clientId_), clientSecret(clientSecret_) {
-  std::string address = ipHead + ipAddr + "/";
-  accessTokenCommandPath = address + accessTokenPath;
-  allDevicesCommandPath = address + devicesPath;
-
-  clientIdString = std::string("client_id=") + clientId;
-  clientSecretString = std::string("client_secret=") + clientSecret;
+    : engine(engine_),
+      baseUrl(
+          host.find("://") == std::string::npos ? std::string("https://") + host
+                                                : host),
+      clientId(clientId_),
+      clientSecret(clientSecret_) {}
 
-  connected = false;
+http::Request Channel::makeRequest(
+    const std::string& method,
+    const std::string& path) {
+  http::Request request;
+  request.method = method;
+  request.url = baseUrl + path;
+  request.timeout = requestTimeout;
+  // On premises controllers come with a self signed certificate.
+  request.verifyPeer = false;
+  return request;
 }
 
-folly::dynamic Channel::setupChannel() {
-  // TODO: Convert to async
-  // auto promise = std::make_shared<folly::Promise<folly::dynamic>>();
-  // std::thread([=]{
-  //   promise->setWith(std::bind(connectChannel));
-  // }).detach();
-  //
-  // return promise->getFuture();
-  return connectChannel();
+folly::Future<std::string> Channel::getToken() {
+  std::shared_ptr<folly::SharedPromise<std::string>> refresh;
+  {
+    auto locked = state.wlock();
+    if (not locked->token.empty() and
+        utils::Time::now() < locked->tokenExpiry) {
+      return folly::makeFuture(locked->token);
+    }
+    if (locked->tokenRefresh != nullptr) {
+      return locked->tokenRefresh->getFuture();
+    }
+    refresh = locked->tokenRefresh =
+        std::make_shared<folly::SharedPromise<std::string>>();
+  }
+
+  auto request = makeRequest("POST", accessTokenPath);
+  request.headers.emplace("Content-Type", "application/x-www-form-urlencoded");
+  request.body = folly::sformat(
+      "grant_type=client_credentials&client_id={}&client_secret={}",
+      formEscape(clientId),
+      formEscape(clientSecret));
+
+  auto self = shared_from_this();
+  engine.request(std::move(request))
+      .thenValue([self, refresh](http::Response response) {
+        std::string token;
+        auto lifetime = defaultTokenLifetime;
+        std::string error;
+        if (response.isError()) {
+          error = response.get();
+        } else {
+          try {
+            auto parsed = folly::parseJson(response.get());
+            token = parsed["access_token"].asString();
+            auto* expiresIn = parsed.get_ptr("expires_in");
+            if (expiresIn != nullptr) {
+              lifetime = std::chrono::seconds(expiresIn->asInt());
+            }
+          } catch (const std::exception& e) {
+            error = e.what();
+          }
+        }
+
+        {
+          auto locked = self->state.wlock();
+          locked->tokenRefresh.reset();
+          if (error.empty()) {
+            locked->token = token;
+            locked->tokenExpiry = utils::Time::now() +
+                (lifetime > 2 * tokenRefreshMargin
+                     ? lifetime - tokenRefreshMargin
+                     : lifetime / 2);
+          }
+        }
+
+        // Fulfilled outside the lock as waiters may call straight back in.
+        if (error.empty()) {
+          refresh->setValue(std::move(token));
+        } else {
+          LOG(ERROR) << "Failed to get cnMaestro token from " << self->baseUrl
+                     << ": " << error;
+          refresh->setException(std::runtime_error(error));
+        }
+      });
+  return refresh->getFuture();
 }
 
-folly::dynamic Channel::connectChannel() {
-  std::vector<std::string> accessTokenCommand = {
-      curlPath,
-      accessTokenCommandPath,
-      "-X",
-      "POST",
-      "-k",
-      "-d",
-      grantType,
-      "-d",
-      clientIdString,
-      "-d",
-      clientSecretString,
-      "-m",
-      folly::to<std::string>(curlTimeout.count())};
-
-  auto returnedData = makeCall(accessTokenCommand);
-
-  folly::dynamic output;
-
-  if (not returnedData.isNull()) {
-    output = folly::parseJson(returnedData.asString());
-    accessToken = output["access_token"];
-    accessTokenPiece = accessTokenLead + accessToken;
-    connected = true;
-
-  } else {
-    connected = false;
-    output = returnedData;
+void Channel::dropToken(const std::string& token) {
+  auto locked = state.wlock();
+  // Another request may have renewed it already.
+  if (locked->token == token) {
+    locked->token.clear();
   }
-  return output;
 }
 
-folly::dynamic Channel::getDeviceInfo(const std::string& clientMac) {
-  // TODO: Convert to async
-  folly::dynamic output;
-  if (connected) {
-    std::string curlAccessTokenPath = allDevicesCommandPath + "/" + clientMac;
-    std::vector<std::string> statusCommand = {
-        curlPath,
-        curlAccessTokenPath,
-        "-X",
-        "GET",
-        "-k",
-        "-m",
-        folly::to<std::string>(curlTimeout.count()),
-        "-H",
-        accessTokenPiece.asString()};
-    output = makeCall(statusCommand);
-  } else {
-    LOG(ERROR) << "Device not connected. Retrying connection.";
-    output = connectChannel();
-  }
-  return output;
+folly::Future<http::Response> Channel::call(http::Request&& request) {
+  auto self = shared_from_this();
+  return getToken().thenValue(
+      [self, request = std::move(request)](std::string token) mutable {
+        auto authorized = request;
+        authorized.headers.emplace("Authorization", "Bearer " + token);
+        return self->engine.request(std::move(authorized))
+            .thenValue([self, token, request = std::move(request)](
+                           http::Response response) mutable
+                       -> folly::Future<http::Response> {
+              if (response.getStatus() != 401) {
+                return folly::makeFuture(std::move(response));
+              }
+              // The token was revoked, e.g. by a controller restart, so get a
+              // new one and retry once.
+              self->dropToken(token);
+              return self->getToken().thenValue(
+                  [self, request = std::move(request)](
+                      std::string fresh) mutable {
+                    request.headers.emplace("Authorization", "Bearer " + fresh);
+                    return self->engine.request(std::move(request));
+                  });
+            });
+      });
 }
 
-folly::dynamic Channel::makeCall(std::vector<std::string>& cmd) {
-  folly::Subprocess proc(
-      std::vector<std::string>{cmd}, folly::Subprocess::Options().pipeStdout());
-  auto p = proc.communicate();
-  folly::dynamic output;
-  auto exitStatus = proc.wait().exitStatus();
-  switch (exitStatus) {
-    case 0: {
-      output = p.first;
-      break;
-    }
-    case operationTimeout: {
-      LOG(ERROR) << "Timed out while trying to connect to cnmaestro channel: "
-                 << ipAddr;
-      connected = false;
-      break;
+folly::Future<Channel::SharedDevices> Channel::getDevices() {
+  std::shared_ptr<folly::SharedPromise<SharedDevices>> listing;
+  {
+    auto locked = state.wlock();
+    if (locked->devices != nullptr and
+        utils::Time::now() < locked->devicesExpiry) {
+      return folly::makeFuture(locked->devices);
     }
-    default: {
-      LOG(ERROR) << "Unexpectedely errored with exit status " << exitStatus
-                 << "whie trying to connect to cnmaestro channel " << ipAddr;
-      connected = false;
-      break;
+    if (locked->listing != nullptr) {
+      return locked->listing->getFuture();
     }
+    listing = locked->listing =
+        std::make_shared<folly::SharedPromise<SharedDevices>>();
   }
-  return output;
+
+  auto devices = std::make_shared<Devices>();
+  auto self = shared_from_this();
+  listDevices(devices, 0).thenTry(
+      [self, listing, devices](folly::Try<folly::Unit> result) {
+        {
+          auto locked = self->state.wlock();
+          locked->listing.reset();
+          if (result.hasValue()) {
+            // Every device of the controller polls within an interval so
+            // this lists once per cycle however many devices there are.
+            locked->devices = devices;
+            locked->devicesExpiry = utils::Time::now() +
+                std::chrono::seconds(FLAGS_poll_interval) / 2;
+          }
+        }
+
+        if (result.hasValue()) {
+          listing->setValue(devices);
+        } else {
+          LOG(ERROR) << "Failed to list cnMaestro devices of " << self->baseUrl
+                     << ": " << result.exception().what();
+          listing->setException(std::move(result.exception()));
+        }
+      });
+  return listing->getFuture();
 }
 
-void Channel::curlPut(
-    folly::dynamic& updateInfo,
-    const std::string& clientMac) {
-  // updateInfo is a limited json that only contains fields to be updated [no
-  // strict structure]
-  std::string updateString = toJson(updateInfo);
-  std::string putAccessStr = allDevicesCommandPath + "/" + clientMac;
-  std::vector<std::string> putCommand = {
-      curlPath,
-      putAccessStr,
-      "-X",
-      "PUT",
-      "-k",
-      "-m",
-      folly::to<std::string>(curlTimeout.count()),
-      "--header",
-      "Content-Type: application/json",
-      "-d",
-      updateString,
-      "-H",
-      accessTokenPiece.asString()};
-  folly::dynamic output = makeCall(putCommand);
-
-  return;
+folly::Future<folly::Unit> Channel::listDevices(
+    std::shared_ptr<Devices> devices,
+    size_t offset) {
+  auto self = shared_from_this();
+  auto path =
+      folly::sformat("{}?limit={}&offset={}", devicesPath, pageSize, offset);
+  return call(makeRequest("GET", path))
+      .thenValue([self, devices, offset](http::Response response)
+                     -> folly::Future<folly::Unit> {
+        if (response.isError()) {
+          throw std::runtime_error(response.get());
+        }
+
+        auto page = folly::parseJson(response.get());
+        const auto& data = page.at("data");
+        for (const auto& device : data) {
+          auto* mac = device.get_ptr("mac");
+          if (mac != nullptr and mac->isString()) {
+            devices->emplace(normalizeMac(mac->getString()), device);
+          }
+        }
+
+        auto next = offset + data.size();
+        auto* paging = page.get_ptr("paging");
+        auto* total = paging != nullptr ? paging->get_ptr("total") : nullptr;
+        if (data.empty() or total == nullptr or
+            next >= static_cast<size_t>(total->asInt())) {
+          return folly::unit;
+        }
+        return self->listDevices(devices, next);
+      });
 }
 
-void Channel::updateDevice(
-    folly::dynamic& updateInfo,
+folly::Future<folly::dynamic> Channel::getDeviceInfo(
     const std::string& clientMac) {
-  if (connected) {
-    curlPut(updateInfo, clientMac);
-  } else {
-    LOG(ERROR) << "No connection to cnmaestro; attempting to reconnect.";
-    auto output = connectChannel();
-  }
+  return getDevices().thenValue(
+      [mac = normalizeMac(clientMac)](SharedDevices devices) {
+        auto it = devices->find(mac);
+        return it != devices->end() ? it->second : folly::dynamic(nullptr);
+      });
 }
 
-// folly::Future<folly::dynamic>
-// Channel::asyncMsg(std::function<std::shared_ptr<httplib::Response>()> send){
-//   auto requestId = requestGuid++;
-//   auto result = outstandingRequests.emplace(
-//       std::piecewise_construct,
-//       std::forward_as_tuple(requestId),
-//       std::forward_as_tuple(folly::Promise<Response>{}));
-//   if (result.second) {
-//     std::thread t([this, send, requestId, ]()) {
-//       ErrorHandler::executeWithCatch([this, &send, requestId, ]()) {
-//         auto res = send();
-//         auto pResult = outstandingRequests.find(requestId);
-//         LOG(ERROR) << "Some error happened. More error handling needed.";
-//       }
-//     }
-//   }
-// }
+folly::Future<http::Response> Channel::updateDevice(
+    const folly::dynamic& updateInfo,
+    const std::string& clientMac) {
+  auto request =
+      makeRequest("PUT", folly::sformat("{}/{}", devicesPath, clientMac));
+  request.headers.emplace("Content-Type", "application/json");
+  request.body = folly::toJson(updateInfo);
+
+  auto self = shared_from_this();
+  return call(std::move(request)).thenValue([self](http::Response response) {
+    if (not response.isError()) {
+      // Make the next poll see the change.
+      self->state.wlock()->devices.reset();
+    }
+    return response;
+  });
+}
 
 } // namespace cnmaestro
 } // namespace channels
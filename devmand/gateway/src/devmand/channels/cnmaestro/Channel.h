@@ -7,26 +7,36 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 
+#include <folly/Synchronized.h>
 #include <folly/dynamic.h>
 #include <folly/futures/Future.h>
-#include <folly/json.h>
+#include <folly/futures/SharedPromise.h>
 
 #include <devmand/channels/Channel.h>
-// #include <devmand/channels/cnmaestro/Response.h>
+#include <devmand/channels/http/Engine.h>
+#include <devmand/utils/Time.h>
 
 namespace devmand {
 namespace channels {
 namespace cnmaestro {
 
-// using OutstandingRequests = std::map<unsigned int, folly::Promise<Response>>;
-
-class Channel final : public channels::Channel {
+/*
+ * A channel to a cnMaestro controller. It is shared by all devices the
+ * controller manages: the access token is cached until it expires and the
+ * devices are listed in bulk at most once per poll cycle rather than fetched
+ * one request per device.
+ */
+class Channel final : public channels::Channel,
+                      public std::enable_shared_from_this<Channel> {
  public:
+  // host may carry the scheme, e.g. "http://host:port", https otherwise.
   Channel(
-      const std::string& ipAddr_,
+      http::Engine& engine_,
+      const std::string& host,
       const std::string& clientId_,
       const std::string& clientSecret_);
   Channel() = delete;
@@ -37,29 +47,47 @@ class Channel final : public channels::Channel {
   Channel& operator=(Channel&&) = delete;
 
  public:
-  folly::dynamic setupChannel();
-  folly::dynamic getDeviceInfo(const std::string& clientMac);
-  void updateDevice(folly::dynamic& updateInfo, const std::string& clientMac);
+  // The controller's entry for the device, null if it doesn't manage it.
+  folly::Future<folly::dynamic> getDeviceInfo(const std::string& clientMac);
+
+  // updateInfo only holds the fields to change.
+  folly::Future<http::Response> updateDevice(
+      const folly::dynamic& updateInfo,
+      const std::string& clientMac);
+
+ private:
+  // Entries of the device listing by upper case mac.
+  using Devices = std::unordered_map<std::string, folly::dynamic>;
+  using SharedDevices = std::shared_ptr<const Devices>;
+
+  struct State {
+    std::string token;
+    utils::TimePoint tokenExpiry;
+    std::shared_ptr<folly::SharedPromise<std::string>> tokenRefresh;
+
+    SharedDevices devices;
+    utils::TimePoint devicesExpiry;
+    std::shared_ptr<folly::SharedPromise<SharedDevices>> listing;
+  };
 
  private:
-  void curlPut(folly::dynamic& updateInfo, const std::string& clientMac);
-  folly::dynamic connectChannel();
-  folly::dynamic makeCall(std::vector<std::string>& cmd);
+  http::Request makeRequest(const std::string& method, const std::string& path);
+  folly::Future<http::Response> call(http::Request&& request);
+
+  folly::Future<std::string> getToken();
+  void dropToken(const std::string& token);
+
+  folly::Future<SharedDevices> getDevices();
+  folly::Future<folly::Unit> listDevices(
+      std::shared_ptr<Devices> devices,
+      size_t offset);
 
  private:
-  folly::dynamic accessToken;
-  std::string ipAddr;
+  http::Engine& engine;
+  std::string baseUrl;
   std::string clientId;
   std::string clientSecret;
-  std::string accessTokenCommandPath;
-  std::string allDevicesCommandPath;
-  std::string clientIdString;
-  std::string clientSecretString;
-  folly::dynamic accessTokenPiece;
-  bool connected;
-
-  // unsigned int requestGuid{0};
-  // OutstandingRequests outstandingRequests;
+  folly::Synchronized<State> state;
 };
 
 } // namespace cnmaestro
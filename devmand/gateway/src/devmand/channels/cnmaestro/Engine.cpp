@@ -0,0 +1,43 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <devmand/channels/cnmaestro/Engine.h>
+
+namespace devmand {
+namespace channels {
+namespace cnmaestro {
+
+Engine::Engine(http::Engine& httpEngine_)
+    : channels::Engine("cnMaestro"), httpEngine(httpEngine_) {}
+
+std::shared_ptr<Channel> Engine::getChannel(
+    const std::string& host,
+    const std::string& clientId,
+    const std::string& clientSecret) {
+  auto locked = channels.wlock();
+  auto& weak = (*locked)[ChannelKey{host, clientId, clientSecret}];
+  auto channel = weak.lock();
+  if (channel == nullptr) {
+    channel =
+        std::make_shared<Channel>(httpEngine, host, clientId, clientSecret);
+    weak = channel;
+  }
+
+  // Forget the controllers no device uses anymore.
+  for (auto it = locked->begin(); it != locked->end();) {
+    if (it->second.expired()) {
+      it = locked->erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return channel;
+}
+
+} // namespace cnmaestro
+} // namespace channels
+} // namespace devmand
@@ -0,0 +1,57 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+#include <folly/Synchronized.h>
+
+#include <devmand/channels/Engine.h>
+#include <devmand/channels/cnmaestro/Channel.h>
+#include <devmand/channels/http/Engine.h>
+
+namespace devmand {
+namespace channels {
+namespace cnmaestro {
+
+/*
+ * Hands out one channel per cnMaestro controller and set of credentials so
+ * the devices it manages share the token and the device listing.
+ */
+class Engine final : public channels::Engine {
+ public:
+  Engine(http::Engine& httpEngine_);
+
+  Engine() = delete;
+  ~Engine() override = default;
+  Engine(const Engine&) = delete;
+  Engine& operator=(const Engine&) = delete;
+  Engine(Engine&&) = delete;
+  Engine& operator=(Engine&&) = delete;
+
+ public:
+  std::shared_ptr<Channel> getChannel(
+      const std::string& host,
+      const std::string& clientId,
+      const std::string& clientSecret);
+
+ private:
+  using ChannelKey = std::tuple<std::string, std::string, std::string>;
+
+ private:
+  http::Engine& httpEngine;
+  // Channels go away with the last device using them.
+  folly::Synchronized<std::map<ChannelKey, std::weak_ptr<Channel>>> channels;
+};
+
+} // namespace cnmaestro
+} // namespace channels
+} // namespace devmand
@@ -0,0 +1,314 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <stdexcept>
+
+#include <folly/Format.h>
+#include <folly/GLog.h>
+
+#include <devmand/channels/http/Engine.h>
+
+namespace devmand {
+namespace channels {
+namespace http {
+
+struct Engine::Transfer {
+  explicit Transfer(Request&& request_) : request(std::move(request_)) {}
+  Transfer() = delete;
+  ~Transfer() {
+    if (easy != nullptr) {
+      curl_easy_cleanup(easy);
+    }
+    curl_slist_free_all(headers);
+  }
+  Transfer(const Transfer&) = delete;
+  Transfer& operator=(const Transfer&) = delete;
+  Transfer(Transfer&&) = delete;
+  Transfer& operator=(Transfer&&) = delete;
+
+  Request request;
+  CURL* easy{nullptr};
+  curl_slist* headers{nullptr};
+  std::string received;
+  char error[CURL_ERROR_SIZE]{};
+  folly::Promise<Response> promise;
+};
+
+static void initCurl() {
+  static const bool initialized =
+      curl_global_init(CURL_GLOBAL_DEFAULT) == CURLE_OK;
+  if (not initialized) {
+    throw std::runtime_error("Failed to initialize libcurl");
+  }
+}
+
+static size_t onData(char* data, size_t size, size_t count, void* received) {
+  static_cast<std::string*>(received)->append(data, size * count);
+  return size * count;
+}
+
+// Everything the request needs must outlive the easy handle so it points into
+// the transfer rather than at copies.
+static bool prepare(
+    CURL* easy,
+    Request& request,
+    std::string& received,
+    char* error,
+    curl_slist*& headers) {
+  curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+  curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, onData);
+  curl_easy_setopt(easy, CURLOPT_WRITEDATA, &received);
+  curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, error);
+  curl_easy_setopt(
+      easy, CURLOPT_TIMEOUT_MS, static_cast<long>(request.timeout.count()));
+  curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+  // Accept whatever compression libcurl was built with.
+  curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+
+  if (request.method != "GET") {
+    curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, request.method.c_str());
+    curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.body.data());
+    curl_easy_setopt(
+        easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+  }
+
+  for (auto& header : request.headers) {
+    auto line = header.first + ": " + header.second;
+    auto* appended = curl_slist_append(headers, line.c_str());
+    if (appended == nullptr) {
+      return false;
+    }
+    headers = appended;
+  }
+  if (not request.body.empty()) {
+    // Don't wait a round trip for a 100 Continue before sending the body.
+    auto* appended = curl_slist_append(headers, "Expect:");
+    if (appended == nullptr) {
+      return false;
+    }
+    headers = appended;
+  }
+  curl_easy_setopt(easy, CURLOPT_HTTPHEADER, headers);
+
+  if (not request.verifyPeer) {
+    curl_easy_setopt(easy, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(easy, CURLOPT_SSL_VERIFYHOST, 0L);
+  }
+  return true;
+}
+
+Engine::SocketHandler::SocketHandler(Engine& engine_, curl_socket_t fd_)
+    : folly::EventHandler(&engine_.getEventBase()), engine(engine_), fd(fd_) {
+  folly::EventHandler::changeHandlerFD(folly::NetworkSocket::fromFd(fd));
+}
+
+void Engine::SocketHandler::watch(int what) {
+  uint16_t events = folly::EventHandler::PERSIST;
+  if ((what & CURL_POLL_IN) != 0) {
+    events |= folly::EventHandler::READ;
+  }
+  if ((what & CURL_POLL_OUT) != 0) {
+    events |= folly::EventHandler::WRITE;
+  }
+  registerHandler(events);
+}
+
+void Engine::SocketHandler::handlerReady(uint16_t events) noexcept {
+  int flags = 0;
+  if ((events & folly::EventHandler::READ) != 0) {
+    flags |= CURL_CSELECT_IN;
+  }
+  if ((events & folly::EventHandler::WRITE) != 0) {
+    flags |= CURL_CSELECT_OUT;
+  }
+  engine.socketAction(fd, flags);
+}
+
+Engine::Engine(
+    folly::EventBase& eventBase_,
+    long maxConnectionsPerHost,
+    long maxCachedConnections)
+    : channels::Engine("HTTP"), eventBase(eventBase_) {
+  initCurl();
+
+  timer = folly::AsyncTimeout::make(eventBase, [this]() noexcept {
+    socketAction(CURL_SOCKET_TIMEOUT, 0);
+  });
+
+  multi = curl_multi_init();
+  if (multi == nullptr) {
+    throw std::runtime_error("Failed to create libcurl multi handle");
+  }
+  curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, Engine::onSocket);
+  curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this);
+  curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, Engine::onTimer);
+  curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this);
+  // Requests over the limit queue for a kept alive connection to the host
+  // instead of opening yet another one.
+  curl_multi_setopt(
+      multi, CURLMOPT_MAX_HOST_CONNECTIONS, maxConnectionsPerHost);
+  curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, maxCachedConnections);
+}
+
+Engine::~Engine() {
+  // Nothing may call back into a half destroyed engine.
+  curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, nullptr);
+  curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, nullptr);
+  timer->cancelTimeout();
+  cancelLoopCallback();
+
+  for (auto& transfer : transfers) {
+    curl_multi_remove_handle(multi, transfer.first);
+    transfer.second->promise.setValue(ErrorResponse(folly::sformat(
+        "http error on {}: engine stopped", transfer.second->request.url)));
+  }
+  transfers.clear();
+  sockets.clear();
+  released.clear();
+  curl_multi_cleanup(multi);
+}
+
+folly::EventBase& Engine::getEventBase() {
+  return eventBase;
+}
+
+folly::Future<Response> Engine::request(Request&& request) {
+  auto transfer = std::make_unique<Transfer>(std::move(request));
+  auto future = transfer->promise.getFuture();
+
+  transfer->easy = curl_easy_init();
+  if (transfer->easy == nullptr or
+      not prepare(
+          transfer->easy,
+          transfer->request,
+          transfer->received,
+          transfer->error,
+          transfer->headers)) {
+    transfer->promise.setValue(ErrorResponse(folly::sformat(
+        "http error on {}: failed to prepare request",
+        transfer->request.url)));
+    return future;
+  }
+
+  eventBase.runInEventBaseThread(
+      [this, transfer = std::move(transfer)]() mutable {
+        start(std::move(transfer));
+      });
+  return future;
+}
+
+void Engine::start(std::unique_ptr<Transfer> transfer) {
+  incrementRequests();
+  auto* easy = transfer->easy;
+  auto& started = transfers.emplace(easy, std::move(transfer)).first->second;
+
+  auto result = curl_multi_add_handle(multi, easy);
+  if (result != CURLM_OK) {
+    started->promise.setValue(ErrorResponse(folly::sformat(
+        "http error on {}: {}",
+        started->request.url,
+        curl_multi_strerror(result))));
+    transfers.erase(easy);
+  }
+}
+
+int Engine::onSocket(
+    CURL*,
+    curl_socket_t fd,
+    int what,
+    void* engine_,
+    void*) {
+  auto& engine = *static_cast<Engine*>(engine_);
+  auto it = engine.sockets.find(fd);
+
+  if (what == CURL_POLL_REMOVE) {
+    if (it != engine.sockets.end()) {
+      it->second->unregisterHandler();
+      if (not engine.isLoopCallbackScheduled()) {
+        engine.eventBase.runInLoop(&engine);
+      }
+      engine.released.emplace_back(std::move(it->second));
+      engine.sockets.erase(it);
+    }
+    return 0;
+  }
+
+  if (it == engine.sockets.end()) {
+    it = engine.sockets
+             .emplace(fd, std::make_unique<SocketHandler>(engine, fd))
+             .first;
+  }
+  it->second->watch(what);
+  return 0;
+}
+
+void Engine::runLoopCallback() noexcept {
+  released.clear();
+}
+
+int Engine::onTimer(CURLM*, long timeoutMs, void* engine_) {
+  auto& engine = *static_cast<Engine*>(engine_);
+  if (timeoutMs < 0) {
+    engine.timer->cancelTimeout();
+  } else {
+    // libcurl must not be reentered from here so even 0 waits for the loop.
+    engine.timer->scheduleTimeout(static_cast<uint32_t>(timeoutMs));
+  }
+  return 0;
+}
+
+void Engine::socketAction(curl_socket_t fd, int flags) {
+  incrementIterations();
+  int running = 0;
+  auto result = curl_multi_socket_action(multi, fd, flags, &running);
+  if (result != CURLM_OK) {
+    LOG(ERROR) << "HTTP socket action failed: " << curl_multi_strerror(result);
+  }
+  finishTransfers();
+}
+
+void Engine::finishTransfers() {
+  CURLMsg* msg{nullptr};
+  int pending{0};
+  while ((msg = curl_multi_info_read(multi, &pending)) != nullptr) {
+    if (msg->msg != CURLMSG_DONE) {
+      continue;
+    }
+    // msg is invalid once the handle is removed.
+    CURL* easy = msg->easy_handle;
+    CURLcode result = msg->data.result;
+    curl_multi_remove_handle(multi, easy);
+
+    auto it = transfers.find(easy);
+    if (it == transfers.end()) {
+      continue;
+    }
+    auto transfer = std::move(it->second);
+    transfers.erase(it);
+
+    const auto& url = transfer->request.url;
+    long status{0};
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status);
+    if (result != CURLE_OK) {
+      transfer->promise.setValue(ErrorResponse(folly::sformat(
+          "http error on {}: {}",
+          url,
+          transfer->error[0] != '\0' ? transfer->error
+                                     : curl_easy_strerror(result))));
+    } else if (status >= 200 and status <= 299) {
+      transfer->promise.setValue(Response(transfer->received, status));
+    } else {
+      transfer->promise.setValue(ErrorResponse(
+          folly::sformat("http error {} on {}", status, url), status));
+    }
+  }
+}
+
+} // namespace http
+} // namespace channels
+} // namespace devmand
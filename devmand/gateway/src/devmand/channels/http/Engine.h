@@ -0,0 +1,118 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <curl/curl.h>
+
+#include <folly/futures/Future.h>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/io/async/EventHandler.h>
+
+#include <devmand/channels/Engine.h>
+#include <devmand/channels/http/Response.h>
+
+namespace devmand {
+namespace channels {
+namespace http {
+
+using Headers = std::multimap<std::string, std::string>;
+
+struct Request {
+  std::string method{"GET"};
+  std::string url;
+  Headers headers;
+  std::string body;
+  std::chrono::milliseconds timeout{std::chrono::seconds(20)};
+  // Only for controllers which are known to use self signed certificates.
+  bool verifyPeer{true};
+};
+
+/*
+ * Runs all HTTP requests of the process on the event base using a libcurl
+ * multi handle. libcurl tells us which sockets to watch and when to time out,
+ * so no thread blocks on a request. Connections are kept alive in the multi
+ * handle's cache and reused by later requests to the same host.
+ */
+class Engine final : public channels::Engine,
+                     private folly::EventBase::LoopCallback {
+ public:
+  Engine(
+      folly::EventBase& eventBase_,
+      long maxConnectionsPerHost = 4,
+      long maxCachedConnections = 64);
+
+  Engine() = delete;
+  ~Engine() override;
+  Engine(const Engine&) = delete;
+  Engine& operator=(const Engine&) = delete;
+  Engine(Engine&&) = delete;
+  Engine& operator=(Engine&&) = delete;
+
+ public:
+  // May be called from any thread, the future is fulfilled on the event base.
+  folly::Future<Response> request(Request&& request);
+
+  folly::EventBase& getEventBase();
+
+ private:
+  struct Transfer;
+
+  class SocketHandler final : public folly::EventHandler {
+   public:
+    SocketHandler(Engine& engine_, curl_socket_t fd_);
+    SocketHandler() = delete;
+    ~SocketHandler() override = default;
+    SocketHandler(const SocketHandler&) = delete;
+    SocketHandler& operator=(const SocketHandler&) = delete;
+    SocketHandler(SocketHandler&&) = delete;
+    SocketHandler& operator=(SocketHandler&&) = delete;
+
+   public:
+    void watch(int what);
+
+   private:
+    void handlerReady(uint16_t events) noexcept override;
+
+   private:
+    Engine& engine;
+    curl_socket_t fd;
+  };
+
+ private:
+  static int
+  onSocket(CURL* easy, curl_socket_t fd, int what, void* engine, void*);
+  static int onTimer(CURLM* multi, long timeoutMs, void* engine);
+
+  void runLoopCallback() noexcept override;
+
+  void start(std::unique_ptr<Transfer> transfer);
+  void socketAction(curl_socket_t fd, int flags);
+  void finishTransfers();
+
+ private:
+  folly::EventBase& eventBase;
+  CURLM* multi{nullptr};
+  std::unique_ptr<folly::AsyncTimeout> timer;
+  // Only touched from the event base thread.
+  std::map<CURL*, std::unique_ptr<Transfer>> transfers;
+  std::map<curl_socket_t, std::unique_ptr<SocketHandler>> sockets;
+  // Handlers of sockets libcurl is done with. They may be the caller of the
+  // socket action which released them so they are destroyed a loop later.
+  std::vector<std::unique_ptr<SocketHandler>> released;
+};
+
+} // namespace http
+} // namespace channels
+} // namespace devmand
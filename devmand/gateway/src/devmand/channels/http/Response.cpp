@@ -11,7 +11,9 @@ namespace devmand {
 namespace channels {
 namespace http {
 
-Response::Response(const std::string& msg_) : Response(msg_, false) {}
+Response::Response(const std::string& msg_, long status_)
+    : Response(msg_, false, status_) {}
+
 std::string Response::get() const {
   return msg;
 }
@@ -20,10 +22,15 @@ bool Response::isError() const {
   return isErr;
 }
 
-Response::Response(const std::string& msg_, bool isError_)
-    : msg(msg_), isErr(isError_) {}
+long Response::getStatus() const {
+  return status;
+}
+
+Response::Response(const std::string& msg_, bool isError_, long status_)
+    : msg(msg_), isErr(isError_), status(status_) {}
 
-ErrorResponse::ErrorResponse(const std::string& msg_) : Response(msg_, true) {}
+ErrorResponse::ErrorResponse(const std::string& msg_, long status_)
+    : Response(msg_, true, status_) {}
 
 } // namespace http
 } // namespace channels
@@ -15,7 +15,7 @@ namespace http {
 
 class Response {
  public:
-  Response(const std::string& msg_);
+  Response(const std::string& msg_, long status_ = 200);
   Response() = delete;
   ~Response() = default;
   Response(const Response&) = delete;
@@ -28,17 +28,21 @@ class Response {
 
   bool isError() const;
 
+  // The HTTP status, 0 if the request failed before one was received.
+  long getStatus() const;
+
  protected:
-  Response(const std::string& msg_, bool isError_);
+  Response(const std::string& msg_, bool isError_, long status_);
 
  private:
   std::string msg;
   const bool isErr{false};
+  const long status{0};
 };
 
 class ErrorResponse : public Response {
  public:
-  ErrorResponse(const std::string& msg);
+  ErrorResponse(const std::string& msg, long status = 0);
   ErrorResponse() = delete;
   ~ErrorResponse() = default;
   ErrorResponse(const ErrorResponse&) = delete;
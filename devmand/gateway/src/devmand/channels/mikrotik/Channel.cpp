@@ -11,7 +11,9 @@
 #include <chrono>
 #include <stdexcept>
 
+#include <folly/Conv.h>
 #include <folly/GLog.h>
+#include <folly/String.h>
 
 #include <devmand/channels/mikrotik/Channel.h>
 #include <devmand/channels/mikrotik/LengthComputation.h>
@@ -24,6 +26,7 @@ namespace mikrotik {
 
 const constexpr std::chrono::milliseconds connectTimeout(1);
 const constexpr std::chrono::seconds retryTime{10};
+const std::string tagPrefix{".tag="};
 
 Channel::Channel(
     folly::EventBase& _eventBase,
@@ -109,14 +112,123 @@ void Channel::write(const Word& word) {
   }
 }
 
-folly::Future<Reply> Channel::write(const Sentence&& sentence) {
-  outstandingRequests.emplace_back(folly::Promise<Reply>());
-  auto& promise = outstandingRequests.back();
+Sentence Channel::prepare(
+    Sentence sentence,
+    const std::vector<std::string>& proplist,
+    Tag tag) {
+  if (not proplist.empty()) {
+    sentence.emplace_back("=.proplist=" + folly::join(",", proplist));
+  }
+  sentence.emplace_back(folly::to<std::string>(tagPrefix, tag));
+  return sentence;
+}
+
+folly::Optional<Tag> Channel::getTag(const Sentence& sentence) {
   for (auto& word : sentence) {
-    writeWordAndLength(word);
+    if (word.compare(0, tagPrefix.size(), tagPrefix) == 0) {
+      auto tag = folly::tryTo<Tag>(
+          folly::StringPiece(word).subpiece(tagPrefix.size()));
+      if (tag.hasValue()) {
+        return *tag;
+      }
+    }
   }
-  terminateSentence();
-  return promise.getFuture();
+  return folly::none;
+}
+
+Attributes Channel::getAttributes(const Sentence& sentence) {
+  Attributes attributes;
+  for (auto& word : sentence) {
+    auto equals = word.find('=', 1);
+    if (word.empty() or word.front() != '=' or equals == std::string::npos) {
+      continue;
+    }
+    attributes.emplace(word.substr(1, equals - 1), word.substr(equals + 1));
+  }
+  return attributes;
+}
+
+void Channel::send(const Sentence& sentence) {
+  if (state == State::FullyConnected) {
+    for (auto& word : sentence) {
+      writeWordAndLength(word);
+    }
+    terminateSentence();
+  } else {
+    pendingOut.push_back(sentence);
+  }
+}
+
+folly::Future<Reply> Channel::query(
+    Sentence sentence,
+    const std::vector<std::string>& proplist) {
+  if (not eventBase.isInEventBaseThread()) {
+    return folly::via(
+        &eventBase,
+        [self = shared_from_this(),
+         sentence = std::move(sentence),
+         proplist]() mutable {
+          return self->query(std::move(sentence), proplist);
+        });
+  }
+
+  auto tag = nextTag++;
+  auto future = requests[tag].promise.getFuture();
+  send(prepare(std::move(sentence), proplist, tag));
+  return future;
+}
+
+void Channel::writeSentence(const Sentence& sentence) {
+  auto command = sentence.empty() ? std::string{} : sentence.front();
+  query(sentence).thenTry([command](folly::Try<Reply> reply) {
+    if (reply.hasException()) {
+      LOG(ERROR) << command << " failed: " << reply.exception().what();
+      return;
+    }
+    for (auto& replySentence : *reply) {
+      if (not replySentence.empty() and replySentence.front() == "!trap") {
+        LOG(ERROR) << command << " failed: "
+                   << getAttributes(replySentence)["message"];
+      }
+    }
+  });
+}
+
+Tag Channel::subscribe(
+    Sentence sentence,
+    const std::vector<std::string>& proplist,
+    Listener listener) {
+  auto tag = nextTag++;
+  auto add = [self = shared_from_this(),
+              tag,
+              sentence = prepare(std::move(sentence), proplist, tag),
+              listener = std::move(listener)]() mutable {
+    auto& subscription = self->subscriptions[tag];
+    subscription.sentence = std::move(sentence);
+    subscription.listener = std::move(listener);
+    // Otherwise it is sent once logged in.
+    if (self->state == State::FullyConnected) {
+      self->send(subscription.sentence);
+    }
+  };
+  if (eventBase.isInEventBaseThread()) {
+    add();
+  } else {
+    eventBase.runInEventBaseThread(std::move(add));
+  }
+  return tag;
+}
+
+void Channel::unsubscribe(Tag tag) {
+  // Always queued so that it runs after a subscribe queued before it.
+  eventBase.runInEventBaseThread([self = shared_from_this(), tag]() {
+    if (self->subscriptions.erase(tag) == 1 and
+        self->state == State::FullyConnected) {
+      // What the router still sends for the tag is dropped as unknown.
+      self->writeSentence(
+          {"/cancel", folly::to<std::string>("=tag=", tag)});
+    }
+  });
 }
 
 void Channel::complete(WriteTask::Id id) {
@@ -130,6 +242,7 @@ void Channel::disconnect() {
     socket = nullptr;
   }
   currentIn.clear();
+  data.clear();
   state = State::Disconnected;
   clearOutstandingRequests();
 }
@@ -143,8 +256,15 @@ bool Channel::isLoggedIn() const {
 }
 
 void Channel::connect() {
+  if (not eventBase.isInEventBaseThread()) {
+    eventBase.runInEventBaseThread(
+        [self = shared_from_this()]() { self->connect(); });
+    return;
+  }
+
   if (socket != nullptr) {
     LOG(INFO) << "Socket already connected so not connecting.";
+    return;
   }
 
   socket = folly::AsyncSocket::newSocket(&eventBase);
@@ -183,10 +303,15 @@ void Channel::tryReconnect() {
 }
 
 void Channel::clearOutstandingRequests() {
-  for (auto& request : outstandingRequests) {
-    request.setValue(Reply{});
+  // Commands in flight are lost with the connection. Subscriptions are kept
+  // and reissued on the next login.
+  auto lost = std::move(requests);
+  requests.clear();
+  pendingOut.clear();
+  for (auto& request : lost) {
+    request.second.promise.setException(
+        std::runtime_error("connection to the router was lost"));
   }
-  outstandingRequests.clear();
 }
 
 void Channel::getReadBuffer(void** bufReturn, size_t* lenReturn) {
@@ -202,7 +327,8 @@ void Channel::readDataAvailable(size_t len) noexcept {
 }
 
 void Channel::debugPrintHex(const std::string& prefix, const std::string& buf) {
-  LOG(INFO) << prefix << " " << StringUtils::asHexString(buf, " ");
+  // Verbose only, subscriptions keep data flowing all the time.
+  VLOG(2) << prefix << " " << StringUtils::asHexString(buf, " ");
 }
 
 bool Channel::readWord(Word& wordOut) {
@@ -227,9 +353,9 @@ void Channel::handleData() {
   Word word;
   while (readWord(word)) {
     if (word.empty()) {
-      LOG(INFO) << "End of sentence";
+      VLOG(2) << "End of sentence";
       if (not handle(currentIn)) {
-        LOG(ERROR) << "login failed";
+        LOG(ERROR) << "failed to handle sentence, reconnecting";
         if (socket != nullptr) {
           disconnect();
           tryReconnect();
@@ -238,7 +364,7 @@ void Channel::handleData() {
         currentIn.clear();
       }
     } else {
-      LOG(INFO) << "Read word [" << word << "]";
+      VLOG(2) << "Read word [" << word << "]";
       currentIn.emplace_back(word);
     }
   }
@@ -255,8 +381,13 @@ bool Channel::handle(const Sentence& sentence) {
       if (sentence.front() == "!done") {
         if (sentence.size() == 1) {
           state = State::FullyConnected;
-          writeSentence(currentOut);
-          currentOut.clear();
+          for (auto& subscription : subscriptions) {
+            send(subscription.second.sentence);
+          }
+          for (auto& pending : pendingOut) {
+            send(pending);
+          }
+          pendingOut.clear();
           return true;
         } else if (sentence.size() == 2 and sentence[1].size() > 5) {
           std::string code = sentence[1];
@@ -269,14 +400,55 @@ bool Channel::handle(const Sentence& sentence) {
       }
       return false;
     case State::FullyConnected:
-      LOG(ERROR) << "handle msg!";
-      return true;
+      return handleReply(sentence);
     case State::Disconnected:
     default:
       return false;
   }
 }
 
+bool Channel::handleReply(const Sentence& sentence) {
+  const auto& type = sentence.front();
+  if (type == "!fatal") {
+    LOG(ERROR) << "fatal reply: " << folly::join(" ", sentence);
+    return false;
+  }
+
+  auto tag = getTag(sentence);
+  if (not tag.hasValue()) {
+    // Everything is tagged once logged in so this isn't a reply of ours.
+    LOG(WARNING) << "dropping untagged " << type << " reply";
+    return true;
+  }
+
+  auto request = requests.find(*tag);
+  if (request != requests.end()) {
+    request->second.reply.push_back(sentence);
+    if (type == "!done") {
+      auto promise = std::move(request->second.promise);
+      auto reply = std::move(request->second.reply);
+      requests.erase(request);
+      promise.setValue(std::move(reply));
+    }
+    return true;
+  }
+
+  auto subscription = subscriptions.find(*tag);
+  if (subscription != subscriptions.end()) {
+    // Copied as the listener may unsubscribe.
+    auto listener = subscription->second.listener;
+    if (type == "!done") {
+      // Streaming commands only complete when they fail.
+      subscriptions.erase(subscription);
+    }
+    listener(sentence);
+    return true;
+  }
+
+  VLOG(1) << "dropping " << type << " reply of unknown tag " << *tag;
+  return true;
+}
+
 void Channel::readEOF() noexcept {
   LOG(ERROR) << "read eof";
   if (socket != nullptr) {
@@ -298,23 +470,10 @@ State Channel::getOperationalDatastore() const {
 }
 
 void Channel::enableSyslog() {
-  // TODO don't just assume success
-  writeWordAndLength("/system/logging/action/add");
-  writeWordAndLength("=name=syslog");
-  writeWordAndLength("=target=remote");
-  writeWordAndLength(folly::sformat("=remote={}", "192.168.90.100"));
-  terminateSentence();
-}
-
-void Channel::writeSentence(const Sentence& sentence) {
-  if (state == State::FullyConnected) {
-    for (auto& word : sentence) {
-      writeWordAndLength(word);
-    }
-    terminateSentence();
-  } else {
-    currentOut.insert(currentOut.end(), sentence.begin(), sentence.end());
-  }
+  writeSentence({"/system/logging/action/add",
+                 "=name=syslog",
+                 "=target=remote",
+                 folly::sformat("=remote={}", "192.168.90.100")});
 }
 
 } // namespace mikrotik
@@ -5,12 +5,16 @@
 // LICENSE file in the root directory of this source tree. An additional grant
 // of patent rights can be found in the PATENTS file in the same directory.
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <folly/Optional.h>
 #include <folly/futures/Future.h>
 #include <folly/io/async/AsyncSocket.h>
 #include <folly/io/async/EventBase.h>
@@ -39,7 +43,11 @@ enum class State {
 };
 
 using Reply = std::list<Sentence>;
-using OutstandingRequests = std::list<folly::Promise<Reply>>;
+using Tag = uint32_t;
+// Gets the replies of a subscription: a !re per update and, should the
+// command fail, its !trap and !done.
+using Listener = std::function<void(const Sentence&)>;
+using Attributes = std::map<std::string, std::string>;
 
 // This is implemented for post-v6.43
 class Channel : public channels::Channel,
@@ -61,6 +69,9 @@ class Channel : public channels::Channel,
   Channel& operator=(Channel&&) = delete;
 
  public:
+  // connect, query, writeSentence, subscribe and unsubscribe may be called
+  // from any thread, they are run on the event base. The rest must be called
+  // on the event base.
   void connect();
   void disconnect();
   void tryReconnect();
@@ -74,11 +85,45 @@ class Channel : public channels::Channel,
   void login();
   void loginDeprecated(const std::string& code);
 
-  folly::Future<Reply> write(const Sentence&& sentence);
+  // Every command is sent with a .tag and its replies are matched on it, so
+  // commands complete independently of each other. A non empty proplist
+  // limits the properties the router returns. The reply fails if the
+  // connection is lost before it is complete.
+  folly::Future<Reply> query(
+      Sentence sentence,
+      const std::vector<std::string>& proplist = {});
 
+  // Like query but nobody waits for the reply, failures are just logged.
   void writeSentence(const Sentence& sentence);
 
+  // Runs a streaming command, e.g. a listen or a print with follow or
+  // interval, until it is unsubscribed. It is reissued on every login.
+  Tag subscribe(
+      Sentence sentence,
+      const std::vector<std::string>& proplist,
+      Listener listener);
+  void unsubscribe(Tag tag);
+
+  // The =name=value words of a reply.
+  static Attributes getAttributes(const Sentence& sentence);
+
+ private:
+  struct Request {
+    folly::Promise<Reply> promise;
+    Reply reply;
+  };
+
+  struct Subscription {
+    Sentence sentence;
+    Listener listener;
+  };
+
  private:
+  static Sentence
+  prepare(Sentence sentence, const std::vector<std::string>& proplist, Tag tag);
+  static folly::Optional<Tag> getTag(const Sentence& sentence);
+
+  void send(const Sentence& sentence);
   void terminateSentence();
   void writeWordAndLength(const Word& word);
   void write(const Word& word);
@@ -93,6 +138,7 @@ class Channel : public channels::Channel,
 
   void handleData();
   bool handle(const Sentence& sentence);
+  bool handleReply(const Sentence& sentence);
   bool readWord(Word& wordOut);
 
   void clearOutstandingRequests();
@@ -106,13 +152,18 @@ class Channel : public channels::Channel,
   folly::SocketAddress address;
   std::shared_ptr<folly::AsyncSocket> socket;
   std::map<WriteTask::Id, WriteTask> writeTasks; // TODO make this bounded
-  State state{State::Disconnected};
+  // Read by isConnected and isLoggedIn from any thread.
+  std::atomic<State> state{State::Disconnected};
   bool reconnect{true};
   std::string username;
   std::string password;
   Sentence currentIn;
-  Sentence currentOut; // TODO do we need to sync this?
-  OutstandingRequests outstandingRequests;
+  // Sentences written before the login completed.
+  std::vector<Sentence> pendingOut;
+  // Allocated by the caller so subscribe can return the tag straight away.
+  std::atomic<Tag> nextTag{0};
+  std::map<Tag, Request> requests;
+  std::map<Tag, Subscription> subscriptions;
 
   constexpr static size_t maxBuffer{4096};
   Buffer currentBuffer;
@@ -25,6 +25,10 @@ folly::Future<Rtt> Channel::ping() {
   return engine.ping(pkt);
 }
 
+RttHistogram Channel::getRttHistogram() {
+  return engine.getRttHistogram(target);
+}
+
 RequestId Channel::genRandomRequestId() {
   std::random_device rd;
   std::mt19937 gen(rd());
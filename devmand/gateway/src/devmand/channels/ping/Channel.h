@@ -32,6 +32,7 @@ class Channel : public channels::Channel {
 
  public:
   folly::Future<Rtt> ping();
+  RttHistogram getRttHistogram();
 
  private:
   friend devmand::test::PingChannelTest_checkSequenceIdGeneration_Test;
@@ -19,6 +19,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <cmath>
 
 #include <folly/GLog.h>
 
@@ -111,62 +112,110 @@ const sockaddr_storage& IcmpPacket::getSrc() {
   return src;
 }
 
-auto IcmpPacket::send(int socket) const {
+void IcmpPacket::prepareSend(
+    mmsghdr& msg,
+    iovec& iov,
+    sockaddr_storage& dst) const {
   assert(packetType == PacketType::send);
-  sockaddr_storage dst;
-  addr.toSockaddrStorage(&dst);
   switch (ipv) {
     case IPVersion::v4:
-      return sendto(
-          socket,
-          &hdrV4,
-          sizeof(hdrV4),
-          0,
-          reinterpret_cast<const sockaddr*>(&dst),
-          sizeof(dst));
+      iov.iov_base = const_cast<icmphdr*>(&hdrV4);
+      iov.iov_len = sizeof(hdrV4);
+      break;
     case IPVersion::v6:
-      return sendto(
-          socket,
-          &hdrV6,
-          sizeof(hdrV6),
-          0,
-          reinterpret_cast<const sockaddr*>(&dst),
-          sizeof(dst));
+      iov.iov_base = const_cast<icmp6_hdr*>(&hdrV6);
+      iov.iov_len = sizeof(hdrV6);
+      break;
     default:
       throw DefaultSwitchError;
   }
+  msg = mmsghdr{};
+  msg.msg_hdr.msg_name = &dst;
+  msg.msg_hdr.msg_namelen = addr.toSockaddrStorage(&dst);
+  msg.msg_hdr.msg_iov = &iov;
+  msg.msg_hdr.msg_iovlen = 1;
 }
 
-void IcmpPacket::read(int socket) {
+void IcmpPacket::prepareRead(mmsghdr& msg, iovec& iov) {
   assert(packetType == PacketType::read);
   switch (ipv) {
     case IPVersion::v4:
-      success = recvfrom(
-                    socket,
-                    &hdrV4,
-                    sizeof(hdrV4),
-                    0,
-                    reinterpret_cast<sockaddr*>(&src),
-                    &srcLen) > 0;
+      iov.iov_base = &hdrV4;
+      iov.iov_len = sizeof(hdrV4);
       break;
     case IPVersion::v6:
-      success = recvfrom(
-                    socket,
-                    &hdrV6,
-                    sizeof(hdrV6),
-                    0,
-                    reinterpret_cast<sockaddr*>(&src),
-                    &srcLen) > 0;
+      iov.iov_base = &hdrV6;
+      iov.iov_len = sizeof(hdrV6);
       break;
     default:
       throw DefaultSwitchError;
   }
+  success = false;
+  srcLen = sizeof(src);
+  msg = mmsghdr{};
+  msg.msg_hdr.msg_name = &src;
+  msg.msg_hdr.msg_namelen = srcLen;
+  msg.msg_hdr.msg_iov = &iov;
+  msg.msg_hdr.msg_iovlen = 1;
+}
+
+void IcmpPacket::setReceived(unsigned int length) {
+  success = length > 0;
+}
+
+void RttHistogram::add(Rtt rtt) {
+  size_t bucket = 0;
+  for (Rtt v = rtt >> 1; v != 0 and bucket < numBuckets - 1; v >>= 1) {
+    ++bucket;
+  }
+  ++buckets[bucket];
+  ++replies;
+  min = std::min(min, rtt);
+  max = std::max(max, rtt);
+  sum += rtt;
+}
+
+Rtt RttHistogram::percentile(double p) const {
+  if (replies == 0) {
+    return 0;
+  }
+  auto rank = static_cast<uint64_t>(std::ceil(p / 100.0 * replies));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < numBuckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank and seen != 0) {
+      return i == numBuckets - 1 ? max : std::min(max, (Rtt{2} << i) - 1);
+    }
+  }
+  return max;
+}
+
+TimeoutWheel::TimeoutWheel(size_t numSlots) : slots(numSlots) {
+  assert(numSlots > 1);
+}
+
+void TimeoutWheel::schedule(Entry entry, size_t ticks) {
+  assert(ticks > 0 and ticks < slots.size());
+  slots[(cursor + ticks) % slots.size()].emplace_back(std::move(entry));
+}
+
+std::vector<TimeoutWheel::Entry> TimeoutWheel::advance() {
+  cursor = (cursor + 1) % slots.size();
+  std::vector<Entry> expired;
+  expired.swap(slots[cursor]);
+  return expired;
 }
 
-IcmpPacket Engine::read() {
-  IcmpPacket pkt(ipv);
-  pkt.read(icmpSocket);
-  return pkt;
+// A request is placed one tick beyond the timeout so that it is never
+// handed back before it has had the full timeout, whatever the phase of the
+// tick it was sent in.
+static size_t getTimeoutTicks(
+    const std::chrono::milliseconds& pingTimeout,
+    const std::chrono::milliseconds& timeoutFrequency) {
+  auto frequency =
+      std::max<std::chrono::milliseconds::rep>(timeoutFrequency.count(), 1);
+  auto ticks = (pingTimeout.count() + frequency - 1) / frequency;
+  return static_cast<size_t>(ticks) + 1;
 }
 
 Engine::Engine(
@@ -177,6 +226,8 @@ Engine::Engine(
     : channels::Engine("Ping"),
       folly::EventHandler(&_eventBase),
       eventBase(_eventBase),
+      timeoutTicks(getTimeoutTicks(pingTimeout_, timeoutFrequency_)),
+      state(folly::in_place, timeoutTicks + 1),
       ipv(ipv_),
       pingTimeout(pingTimeout_),
       timeoutFrequency(timeoutFrequency_) {
@@ -201,9 +252,23 @@ Engine::Engine(
     if (fcntl(icmpSocket, F_SETFL, O_NONBLOCK) < 0) {
       throw std::system_error(errno, std::generic_category());
     }
+    if (setsockopt(
+            icmpSocket,
+            SOL_SOCKET,
+            SO_RCVBUF,
+            &receiveBufferSize,
+            sizeof(receiveBufferSize)) < 0) {
+      auto err = std::system_error(errno, std::generic_category());
+      LOG(WARNING) << "Failed to raise the ICMP receive buffer: "
+                   << err.what();
+    }
     folly::EventHandler::changeHandlerFD(
         folly::NetworkSocket::fromFd(icmpSocket));
   }
+  readPackets.reserve(batchSize);
+  for (size_t i = 0; i < batchSize; ++i) {
+    readPackets.emplace_back(ipv);
+  }
   registerHandler(folly::EventHandler::READ | folly::EventHandler::PERSIST);
   start();
 }
@@ -223,13 +288,8 @@ Engine::~Engine() {
 }
 
 void Engine::start() {
-  // TODO I implement a very simple type of timeout here where ever n
-  // milliseconds we walk the pending requests and timeout ones that have
-  // exceeded their time. This is neither the most efficient (we walk the entire
-  // list) or the most accurate (we only guarentee and eventual timeout not a
-  // precise timeout). Given this usecase I dont think either of these are that
-  // important but I'm making this note so we know in the future we could
-  // improve this by using one of the nice timeout queues that exist.
+  // Each tick advances the timeout wheel by one slot, so timeouts are only
+  // as precise as timeoutFrequency.
   eventBase.runInEventBaseThread([this]() {
     EventBaseUtils::scheduleEvery(
         eventBase, [this]() { timeout(); }, timeoutFrequency);
@@ -237,21 +297,31 @@ void Engine::start() {
 }
 
 void Engine::timeout() {
-  sharedOutstandingRequests.withULockPtr([this](auto uOutstandingRequests) {
-    auto outstandingRequests = uOutstandingRequests.moveFromUpgradeToWrite();
-    // LOG(INFO) << "Processing ping timeouts";
-    for (auto it = outstandingRequests->begin();
-         it != outstandingRequests->end();) {
-      utils::TimePoint end = utils::Time::now();
-      if ((end - it->second.start) > pingTimeout) {
-        LOG(ERROR) << "Ping request timed out";
-        it->second.promise.setValue(0);
-        it = outstandingRequests->erase(it);
+  std::vector<folly::Promise<Rtt>> expired;
+  state.withWLock([this, &expired](auto& locked) {
+    utils::TimePoint now = utils::Time::now();
+    for (auto& entry : locked.timeoutWheel.advance()) {
+      auto request = locked.outstandingRequests.find(entry.first);
+      if (request == locked.outstandingRequests.end() or
+          request->second.generation != entry.second) {
+        // Answered already.
+        continue;
+      }
+      if ((now - request->second.start) > pingTimeout) {
+        expired.emplace_back(std::move(request->second.promise));
+        ++locked.histograms[entry.first.first].timeouts;
+        locked.outstandingRequests.erase(request);
       } else {
-        ++it;
+        // Sent late in its tick, give it another one.
+        locked.timeoutWheel.schedule(std::move(entry), 1);
       }
     }
   });
+
+  for (auto& promise : expired) {
+    LOG(ERROR) << "Ping request timed out";
+    promise.setValue(0);
+  }
 }
 
 folly::Future<Rtt> Engine::ping(const IcmpPacket& pkt) {
@@ -260,75 +330,173 @@ folly::Future<Rtt> Engine::ping(const IcmpPacket& pkt) {
     return folly::makeFuture<Rtt>(0);
   }
   incrementRequests();
-  return sharedOutstandingRequests.withULockPtr([this, &pkt](
-                                                    auto uOutstandingRequests) {
-    auto outstandingRequests = uOutstandingRequests.moveFromUpgradeToWrite();
-    auto request = outstandingRequests->emplace(
+  bool scheduleFlush{false};
+  auto future = state.withWLock([this, &pkt, &scheduleFlush](auto& locked) {
+    auto key = std::make_pair(pkt.getAddr(), pkt.getSequence());
+    auto request = locked.outstandingRequests.emplace(
         std::piecewise_construct,
-        std::forward_as_tuple(std::make_pair(pkt.getAddr(), pkt.getSequence())),
+        std::forward_as_tuple(key),
         std::forward_as_tuple(Request{}));
-    if (request.second) {
-      request.first->second.start = utils::Time::now();
-      auto result = pkt.send(icmpSocket);
-      if (result <= 0) {
-        switch (result) {
-          case EAGAIN: // case EWOULDBLOCK:
-            // TODO if the ping fail because of a kernel buffer I'm not going to
-            // implement retry logic as something is filling up the buffers. We
-            // should probably alarm if this is the case.
-            LOG(ERROR) << "Buffer full so ping failed";
-            break;
-          default:
-            // TODO BOOTCAMP get errno string from syserror
-            LOG(ERROR) << "Failed to send packet with errno " << errno;
-            break;
-        }
-        outstandingRequests->erase(request.first);
-        return folly::makeFuture<Rtt>(0);
-      } else {
-        auto ret = request.first->second.promise.getFuture();
-        return ret;
-      }
-    } else {
+    if (not request.second) {
       LOG(ERROR) << "ICMP Echo Id rollover with outstanding requests";
       return folly::makeFuture<Rtt>(0);
     }
+
+    request.first->second.start = utils::Time::now();
+    request.first->second.generation = ++locked.generation;
+    locked.timeoutWheel.schedule(
+        std::make_pair(key, locked.generation), timeoutTicks);
+    scheduleFlush = locked.sendQueue.empty();
+    locked.sendQueue.emplace_back(pkt.getAddr(), pkt.getSequence());
+    return request.first->second.promise.getFuture();
+  });
+
+  if (scheduleFlush) {
+    eventBase.runInEventBaseThread([this]() { flush(); });
+  }
+  return future;
+}
+
+void Engine::flush() {
+  std::vector<IcmpPacket> packets;
+  state.withWLock([&packets](auto& locked) {
+    packets.swap(locked.sendQueue);
+    // Measure from the actual send rather than from when it was queued.
+    utils::TimePoint now = utils::Time::now();
+    for (auto& pkt : packets) {
+      auto request = locked.outstandingRequests.find(
+          std::make_pair(pkt.getAddr(), pkt.getSequence()));
+      if (request != locked.outstandingRequests.end()) {
+        request->second.start = now;
+      }
+    }
+  });
+
+  std::vector<mmsghdr> msgs(packets.size());
+  std::vector<iovec> iovs(packets.size());
+  std::vector<sockaddr_storage> dsts(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    packets[i].prepareSend(msgs[i], iovs[i], dsts[i]);
+  }
+
+  size_t sent = 0;
+  while (sent < packets.size()) {
+    auto count = static_cast<unsigned int>(
+        std::min(batchSize, packets.size() - sent));
+    int result = sendmmsg(icmpSocket, msgs.data() + sent, count, 0);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      } else if (errno == EAGAIN or errno == EWOULDBLOCK) {
+        // TODO if the ping fail because of a kernel buffer I'm not going to
+        // implement retry logic as something is filling up the buffers. We
+        // should probably alarm if this is the case.
+        LOG(ERROR) << "Buffer full so " << packets.size() - sent
+                   << " pings failed";
+      } else {
+        auto err = std::system_error(errno, std::generic_category());
+        LOG(ERROR) << "Failed to send " << packets.size() - sent
+                   << " packets: " << err.what();
+      }
+      break;
+    }
+    sent += static_cast<size_t>(result);
+    // Replies to the first batches are already coming in, read them before
+    // they overflow the receive buffer while the rest goes out.
+    receive();
+  }
+
+  if (sent < packets.size()) {
+    packets.erase(packets.begin(), packets.begin() + sent);
+    fail(packets);
+  }
+}
+
+void Engine::fail(const std::vector<IcmpPacket>& unsent) {
+  std::vector<folly::Promise<Rtt>> failed;
+  state.withWLock([&unsent, &failed](auto& locked) {
+    for (auto& pkt : unsent) {
+      auto request = locked.outstandingRequests.find(
+          std::make_pair(pkt.getAddr(), pkt.getSequence()));
+      if (request != locked.outstandingRequests.end()) {
+        failed.emplace_back(std::move(request->second.promise));
+        locked.outstandingRequests.erase(request);
+      }
+    }
+  });
+  for (auto& promise : failed) {
+    promise.setValue(0);
+  }
+}
+
+RttHistogram Engine::getRttHistogram(const folly::IPAddress& addr) {
+  return state.withRLock([&addr](auto& locked) {
+    auto histogram = locked.histograms.find(addr);
+    return histogram != locked.histograms.end() ? histogram->second
+                                                : RttHistogram{};
   });
 }
 
 void Engine::handlerReady(uint16_t) noexcept {
-  // TODO end time isn't really precise here as we don't have a kernel time
-  // need to implement kernel timestamping
-  utils::TimePoint end = utils::Time::now();
-  for (IcmpPacket pkt = read(); pkt.wasSuccess(); pkt = read()) {
-    bool processed{false};
-    if (pkt.isEchoReply() and pkt.getCode() == 0) {
-      sharedOutstandingRequests.withULockPtr([this, &end, &pkt, &processed](
-                                                 auto uOutstandingRequests) {
-        auto outstandingRequests =
-            uOutstandingRequests.moveFromUpgradeToWrite();
-        auto src = pkt.getSrc();
-        auto request = outstandingRequests->find(std::make_pair(
-            folly::IPAddress(reinterpret_cast<sockaddr*>(&src)),
-            pkt.getSequence()));
-        if (request != outstandingRequests->end()) {
-          auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
-              end - request->second.start);
-          LOG(INFO) << "Received ICMP response after " << duration.count()
-                    << " microseconds";
-          request->second.promise.setValue(duration.count());
-          outstandingRequests->erase(request);
-          processed = true;
-        }
-      });
+  receive();
+}
+
+void Engine::receive() {
+  std::vector<std::pair<folly::Promise<Rtt>, Rtt>> replies;
+  for (;;) {
+    for (size_t i = 0; i < batchSize; ++i) {
+      readPackets[i].prepareRead(readMsgs[i], readIovs[i]);
+    }
+    int received =
+        recvmmsg(icmpSocket, readMsgs.data(), batchSize, MSG_DONTWAIT, nullptr);
+    if (received <= 0) {
+      break;
     }
 
-    if (not processed) {
-      LOG(INFO) << "Packet received with ICMP type "
-                << static_cast<int>(pkt.getType()) << " code "
-                << static_cast<int>(pkt.getCode());
+    // TODO end time isn't really precise here as we don't have a kernel time
+    // need to implement kernel timestamping
+    utils::TimePoint end = utils::Time::now();
+    state.withWLock([this, &end, &replies, received](auto& locked) {
+      for (int i = 0; i < received; ++i) {
+        auto& pkt = readPackets[i];
+        pkt.setReceived(readMsgs[i].msg_len);
+        if (not pkt.wasSuccess()) {
+          continue;
+        }
+
+        if (pkt.isEchoReply() and pkt.getCode() == 0) {
+          auto src = pkt.getSrc();
+          folly::IPAddress addr(reinterpret_cast<sockaddr*>(&src));
+          auto request = locked.outstandingRequests.find(
+              std::make_pair(addr, pkt.getSequence()));
+          if (request != locked.outstandingRequests.end()) {
+            auto duration =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    end - request->second.start);
+            locked.histograms[addr].add(duration.count());
+            replies.emplace_back(
+                std::move(request->second.promise), duration.count());
+            locked.outstandingRequests.erase(request);
+            continue;
+          }
+        }
+
+        LOG(INFO) << "Packet received with ICMP type "
+                  << static_cast<int>(pkt.getType()) << " code "
+                  << static_cast<int>(pkt.getCode());
+      }
+    });
+
+    if (static_cast<size_t>(received) < batchSize) {
+      break;
     }
   }
+
+  for (auto& reply : replies) {
+    LOG(INFO) << "Received ICMP response after " << reply.second
+              << " microseconds";
+    reply.first.setValue(reply.second);
+  }
 }
 
 } // namespace ping
@@ -7,11 +7,15 @@
 
 #pragma once
 
+#include <array>
+#include <limits>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <netinet/icmp6.h>
 #include <netinet/ip_icmp.h>
+#include <sys/socket.h>
 
 #include <folly/futures/Future.h>
 #include <folly/io/async/AsyncSocket.h>
@@ -31,6 +35,9 @@ using Rtt = uint64_t;
 struct Request {
   utils::TimePoint start;
   folly::Promise<Rtt> promise;
+  // Distinguishes this request from an earlier one with the same key which
+  // may still have an entry in the timeout wheel.
+  uint64_t generation{0};
 };
 
 enum IPVersion { v4, v6 };
@@ -38,8 +45,53 @@ enum PacketType { send, read };
 
 using RequestId = uint16_t;
 
-using OutstandingRequests =
-    std::map<std::pair<folly::IPAddress, RequestId>, Request>;
+using RequestKey = std::pair<folly::IPAddress, RequestId>;
+
+using OutstandingRequests = std::map<RequestKey, Request>;
+
+// Round trip times of one target in power of two buckets of microseconds.
+// Bucket i counts rtts in [2^i, 2^(i+1)), bucket 0 also takes 0 and the last
+// bucket everything above.
+struct RttHistogram {
+  static constexpr size_t numBuckets = 24;
+
+  void add(Rtt rtt);
+
+  // Upper bound of the bucket holding the given percentile (0-100).
+  Rtt percentile(double p) const;
+
+  std::array<uint64_t, numBuckets> buckets{};
+  uint64_t replies{0};
+  uint64_t timeouts{0};
+  Rtt min{std::numeric_limits<Rtt>::max()};
+  Rtt max{0};
+  Rtt sum{0};
+};
+
+// A hashed timing wheel of request keys. Every tick the cursor moves one
+// slot and the entries in that slot are handed back for expiry, so the cost
+// of a tick is proportional to what expires rather than to what is pending.
+class TimeoutWheel final {
+ public:
+  using Entry = std::pair<RequestKey, uint64_t>;
+
+  explicit TimeoutWheel(size_t numSlots);
+  TimeoutWheel() = delete;
+  ~TimeoutWheel() = default;
+  TimeoutWheel(const TimeoutWheel&) = delete;
+  TimeoutWheel& operator=(const TimeoutWheel&) = delete;
+  TimeoutWheel(TimeoutWheel&&) = default;
+  TimeoutWheel& operator=(TimeoutWheel&&) = default;
+
+ public:
+  // ticks must be in [1, numSlots).
+  void schedule(Entry entry, size_t ticks);
+  std::vector<Entry> advance();
+
+ private:
+  std::vector<std::vector<Entry>> slots;
+  size_t cursor{0};
+};
 
 // The data structure for icmp headers.
 // Generalized for v4 or v6.
@@ -65,8 +117,11 @@ class IcmpPacket final {
   const sockaddr_storage& getSrc();
 
  public:
-  auto send(int socket) const;
-  void read(int socket);
+  // Point a sendmmsg/recvmmsg entry at this packet. The packet must not move
+  // until the call using msg has returned.
+  void prepareSend(mmsghdr& msg, iovec& iov, sockaddr_storage& dst) const;
+  void prepareRead(mmsghdr& msg, iovec& iov);
+  void setReceived(unsigned int length);
 
  private:
   PacketType packetType;
@@ -102,19 +157,46 @@ class Engine : public channels::Engine, public folly::EventHandler {
   Engine& operator=(Engine&&) = delete;
 
  public:
+  // Queues the packet; everything queued within one event base loop is sent
+  // with a single sendmmsg.
   folly::Future<Rtt> ping(const IcmpPacket& pkt);
 
+  RttHistogram getRttHistogram(const folly::IPAddress& addr);
+
   // NOTE this must be called after the event base is running.
   void start();
 
+ private:
+  struct State {
+    explicit State(size_t wheelSlots) : timeoutWheel(wheelSlots) {}
+
+    OutstandingRequests outstandingRequests;
+    std::vector<IcmpPacket> sendQueue;
+    TimeoutWheel timeoutWheel;
+    std::map<folly::IPAddress, RttHistogram> histograms;
+    uint64_t generation{0};
+  };
+
+  static constexpr size_t batchSize = 64;
+  // Room for a few hundred replies, which come back all at once for a batch
+  // of targets on the same network. The kernel caps it at net.core.rmem_max.
+  static constexpr int receiveBufferSize = 1 << 20;
+
  private:
   virtual void handlerReady(uint16_t events) noexcept override;
+  void receive();
   void timeout();
-  IcmpPacket read();
+  void flush();
+  void fail(const std::vector<IcmpPacket>& unsent);
 
  private:
   folly::EventBase& eventBase;
-  folly::Synchronized<OutstandingRequests> sharedOutstandingRequests;
+  size_t timeoutTicks;
+  folly::Synchronized<State> state;
+  // Receive buffers, only touched from the event base thread.
+  std::vector<IcmpPacket> readPackets;
+  std::array<mmsghdr, batchSize> readMsgs{};
+  std::array<iovec, batchSize> readIovs{};
   int icmpSocket{-1};
   IPVersion ipv;
   bool failedIpv6Socket{false};
@@ -22,7 +22,10 @@ std::shared_ptr<Datastore> Datastore::make(
 }
 
 Datastore::Datastore(MetricSink& sink_, const Id& device_)
-    : sink(sink_), device(device_), datastore(folly::dynamic::object) {}
+    : sink(sink_),
+      device(device_),
+      datastore(folly::dynamic::object),
+      metrics(MetricSample("deviceID", device_)) {}
 
 folly::Future<folly::dynamic> Datastore::collect() {
   return folly::collect(std::move(requests))
@@ -32,18 +35,26 @@ folly::Future<folly::dynamic> Datastore::collect() {
           f();
         }
 
+        static const auto& deviceStatus = MetricFamily::get("device.status");
+        static const auto& requestDuration =
+            MetricFamily::get("device.request.duration.avg");
+
         s->datastore.withRLock([&s](auto& unlockedState) {
           auto status = YangUtils::lookup(
               unlockedState, "fbc-symphony-device:system/status");
           if (status != nullptr and status.isString()) {
-            s->setGauge("device.status", status.asString() == "UP" ? 1 : 0);
+            s->setGauge(deviceStatus, status.asString() == "UP" ? 1 : 0);
           } else {
-            s->setGauge("device.status", 0);
+            s->setGauge(deviceStatus, 0);
           }
         });
 
         auto averageRequestDuration = getAverageRequestDuration(reqs).count();
-        s->setGauge("device.request.duration.avg", averageRequestDuration);
+        s->setGauge(
+            requestDuration, static_cast<double>(averageRequestDuration));
+        auto sample = std::make_shared<MetricSample>("deviceID", s->device);
+        std::swap(*sample, *s->metrics.wlock());
+        s->sink.setGauges(sample);
 
         LOG(INFO) << s->device << " average request duration was "
                   << averageRequestDuration << " usec";
@@ -66,6 +77,17 @@ void Datastore::addFinally(std::function<void()>&& f) {
   finals.push_back(f);
 }
 
+void Datastore::setGauge(const MetricFamily& family, double value) {
+  metrics.wlock()->set(family, value);
+}
+
+void Datastore::setGauge(
+    const MetricFamily& family,
+    std::string familyLabelValue,
+    double value) {
+  metrics.wlock()->set(family, std::move(familyLabelValue), value);
+}
+
 void Datastore::addError(std::string&& error) {
   errorQueue.add(std::forward<std::string>(error));
 }
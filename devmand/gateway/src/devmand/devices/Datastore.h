@@ -68,6 +68,13 @@ class Datastore final : public std::enable_shared_from_this<Datastore>,
 
   void setGauge(const std::string& key, long unsigned int value);
 
+  // Adds a gauge to the sample emitted as a whole on collect.
+  void setGauge(const MetricFamily& family, double value);
+  void setGauge(
+      const MetricFamily& family,
+      std::string familyLabelValue,
+      double value);
+
   // Adds a callback to be executed on collect.
   void addFinally(std::function<void()>&& f);
 
@@ -95,6 +102,9 @@ class Datastore final : public std::enable_shared_from_this<Datastore>,
   // The state of an object formated according to the yang models supported.
   folly::Synchronized<folly::dynamic> datastore;
 
+  // The gauges of this poll, labeled with the device id.
+  folly::Synchronized<MetricSample> metrics;
+
   // This is a queue of errors occuring on this system.
   ErrorQueue errorQueue;
 
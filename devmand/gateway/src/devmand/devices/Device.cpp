@@ -22,8 +22,8 @@ Device::Device(Application& application, const Id& id_, bool readonly_)
     : app(application), id(id_), readonly(readonly_) {}
 
 Device::~Device() {
-  auto oldHostname =
-      YangUtils::lookup(operationalDatastore, "ietf-system:system/hostname");
+  auto oldHostname = YangUtils::lookup(
+      *operationalDatastore.rlock(), "ietf-system:system/hostname");
   if (oldHostname != nullptr) {
     app.getSyslogManager().removeIdentifier(oldHostname.asString(), id);
     app.getSyslogManager().restartTdAgentBitAsync();
@@ -44,14 +44,15 @@ void Device::setNativeConfig(const std::string&) {
 }
 
 folly::dynamic Device::lookup(const YangPath& path) const {
-  return YangUtils::lookup(intendedDatastore, path);
+  return YangUtils::lookup(*intendedDatastore.rlock(), path);
 }
 
-void Device::updateSharedView(SharedUnifiedView& sharedUnifiedView) {
+folly::Future<folly::Unit> Device::updateSharedView(
+    SharedUnifiedView& sharedUnifiedView) {
   Id idL = id;
 
   std::weak_ptr<Device> weak(shared_from_this());
-  ErrorHandler::thenError(
+  return ErrorHandler::thenError(
       getOperationalDatastore()
           ->collect()
           .thenValue([weak](auto data) {
@@ -59,7 +60,8 @@ void Device::updateSharedView(SharedUnifiedView& sharedUnifiedView) {
               auto newHostname =
                   YangUtils::lookup(data, "ietf-system:system/hostname");
               auto oldHostname = YangUtils::lookup(
-                  shared->operationalDatastore, "ietf-system:system/hostname");
+                  *shared->operationalDatastore.rlock(),
+                  "ietf-system:system/hostname");
               auto& sm = shared->app.getSyslogManager();
               if (newHostname == nullptr) {
                 if (oldHostname != nullptr) {
@@ -74,30 +76,26 @@ void Device::updateSharedView(SharedUnifiedView& sharedUnifiedView) {
                 sm.addIdentifier(newHostname.asString(), shared->id);
                 sm.restartTdAgentBitAsync();
               }
-              shared->operationalDatastore = data;
+              *shared->operationalDatastore.wlock() = data;
             } else {
               // The device is gone and it is its responsiblity to clean up ids.
             }
             return data;
           })
           .thenValue([idL, &sharedUnifiedView](auto data) {
-            sharedUnifiedView.withULockPtr([&idL, &data](auto uUnifiedView) {
-              auto unifiedView = uUnifiedView.moveFromUpgradeToWrite();
-
-              if (unifiedView->insert_or_assign(idL, data).second) {
-                LOG(ERROR) << "Failed to update unified view for " << idL;
-              }
-
-              LOG(INFO) << "state for " << idL << " is " << folly::toJson(data);
-            });
+            auto state =
+                sharedUnifiedView.wlock()->update(idL, std::move(data));
+            LOG(INFO) << "state for " << idL << " (generation "
+                      << state->getGeneration() << ") is "
+                      << state->getSerialized();
           }));
 }
 
-void Device::tryToApplyRunningDatastore() {
+folly::Future<folly::Unit> Device::tryToApplyRunningDatastore() {
   if (isReadonly()) {
     LOG(INFO) << "Not applying running datastore on device " << id
               << " as the device is read only.";
-    return;
+    return folly::makeFuture();
   }
 
   LOG(INFO) << "Applying running datastore on device " << id << " "
@@ -105,19 +103,20 @@ void Device::tryToApplyRunningDatastore() {
   if (not runningDatastore.empty()) {
     switch (getDeviceConfigType()) {
       case DeviceConfigType::YangJson: {
-        setIntendedDatastore(runningDatastore);
-        intendedDatastore = runningDatastore;
-        break;
+        auto applied = setIntendedDatastore(runningDatastore);
+        *intendedDatastore.wlock() = runningDatastore;
+        return applied;
       }
       case DeviceConfigType::NativeConfigJson:
         auto* nativeConfig = runningDatastore.get_ptr("native_config");
         if (nativeConfig != nullptr and nativeConfig->isString()) {
           setNativeConfig(nativeConfig->asString());
         }
-        intendedDatastore = runningDatastore;
+        *intendedDatastore.wlock() = runningDatastore;
         break;
     }
   }
+  return folly::makeFuture();
 }
 
 bool Device::isReadonly() const {
@@ -125,7 +124,7 @@ bool Device::isReadonly() const {
 }
 
 folly::dynamic Device::getIntendedDatastore() const {
-  return intendedDatastore;
+  return *intendedDatastore.rlock();
 }
 
 void Device::setRunningDatastore(const std::string& config) {
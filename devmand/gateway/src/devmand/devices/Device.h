@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include <folly/Synchronized.h>
 #include <folly/dynamic.h>
 #include <folly/futures/Future.h>
 
@@ -48,8 +49,9 @@ class Device : public std::enable_shared_from_this<Device> {
 
   /* This function asynchronously modifies the shared unified view (the common
    * way of looking at and operating on the network) with the state provided by
-   * get state, */
-  virtual void updateSharedView(SharedUnifiedView& sharedUnifiedView);
+   * get state. The returned future completes once the view is updated. */
+  virtual folly::Future<folly::Unit> updateSharedView(
+      SharedUnifiedView& sharedUnifiedView);
 
   Id getId() const;
 
@@ -62,15 +64,22 @@ class Device : public std::enable_shared_from_this<Device> {
 
   virtual DeviceConfigType getDeviceConfigType() const;
 
-  void tryToApplyRunningDatastore();
+  /*
+   * Applies the running datastore to the device. This is run by a config
+   * apply worker, not the event base, whenever the running datastore changes.
+   * The returned future fails if the device didn't take the config.
+   */
+  folly::Future<folly::Unit> tryToApplyRunningDatastore();
 
  protected:
   /*
    * Inherited method to override in device instances. This is called
    * by the json overload of apply config. This is normally what users will
-   * implement.
+   * implement. The returned future completes once the device took the config
+   * and fails, or it throws, if it didn't so that the config is retried.
    */
-  virtual void setIntendedDatastore(const folly::dynamic& config) = 0;
+  virtual folly::Future<folly::Unit> setIntendedDatastore(
+      const folly::dynamic& config) = 0;
 
   /*
    * Inherited method to override in device instances. This is called by the
@@ -92,8 +101,10 @@ class Device : public std::enable_shared_from_this<Device> {
   Id id;
   const bool readonly;
   folly::dynamic runningDatastore;
-  folly::dynamic intendedDatastore;
-  folly::dynamic operationalDatastore;
+  // Synced as it is set by the config apply workers.
+  folly::Synchronized<folly::dynamic> intendedDatastore;
+  // Synced as it is set by polls and read by the config apply workers.
+  folly::Synchronized<folly::dynamic> operationalDatastore;
   // TODO std::map<std::string, Platform> platforms;
 };
 
@@ -8,12 +8,14 @@
 #include <devmand/devices/cambium/Device.h>
 
 #include <iostream>
+#include <stdexcept>
 
+#include <folly/Format.h>
+#include <folly/GLog.h>
 #include <folly/dynamic.h>
 #include <folly/json.h>
 
 #include <devmand/Application.h>
-#include <devmand/error/ErrorHandler.h>
 
 namespace devmand {
 namespace devices {
@@ -43,24 +45,22 @@ Device::Device(
     const std::string& clientId_,
     const std::string& clientSecret_)
     : devices::Device(application, id_, readonly_),
-      channel(deviceIp_.str(), clientId_, clientSecret_),
+      channel(application.getCnMaestroEngine().getChannel(
+          deviceIp_.str(),
+          clientId_,
+          clientSecret_)),
       deviceIp(deviceIp_),
       clientMac(clientMac_) {
   lastUpdate = setupReturnData();
   setupOpenconfig(lastUpdate);
   setupOpenconfigInterfaces(lastUpdate);
   setupIpv4(lastUpdate, 0);
-  connect();
 }
 
 Device::~Device() {
   // TODO disconnect();
 }
 
-void Device::connect() {
-  auto retval = channel.setupChannel();
-}
-
 folly::dynamic Device::setupReturnData() {
   folly::dynamic data = folly::dynamic::object;
   data["ietf-system:system"] = folly::dynamic::object;
@@ -221,39 +221,52 @@ void Device::setupIpv4(folly::dynamic& data, int interfaceNum) {
 }
 
 std::shared_ptr<Datastore> Device::getOperationalDatastore() {
+  auto state = Datastore::make(app, getId());
+  state->addRequest(
+      channel->getDeviceInfo(clientMac)
+          .thenValue([state](folly::dynamic info) {
+            auto data = getOperational(std::move(info));
+            state->update(
+                [&data](auto& lockedState) { lockedState = std::move(data); });
+          })
+          .thenError(
+              folly::tag_t<std::exception>{},
+              [state](const std::exception& e) {
+                state->addError(e.what());
+                auto data = setupReturnData();
+                state->update([&data](auto& lockedState) {
+                  lockedState = std::move(data);
+                });
+              }));
+  return state;
+}
+
+folly::dynamic Device::getOperational(folly::dynamic info) {
   // TODO: Improve error handling
   folly::dynamic data = setupReturnData();
-  folly::dynamic returnedData = channel.getDeviceInfo(clientMac);
-
-  if (returnedData.isNull()) {
-    auto state = Datastore::make(app, getId());
-    state->update(
-        [&data](auto& lockedState) { lockedState = std::move(data); });
-    return state;
+  if (info.isNull()) {
+    return data;
   }
 
   setupOpenconfig(data);
   setupOpenconfigInterfaces(data);
   setupIpv4(data, 0);
 
-  folly::dynamic parsed = folly::parseJson(returnedData.asString());
-
   data["ietf-system:system"]["contact"] = "";
-  data["ietf-system:system"]["location"] = parsed["data"][0]["site"];
-  data["ietf-system:system"]["name"] = parsed["data"][0]["name"];
+  data["ietf-system:system"]["location"] = info["site"];
+  data["ietf-system:system"]["name"] = info["name"];
 
   // TODO: Check to see if the 1st one is "tmp". If it is, then override.
   // Otherwise, parse and find the right one to update. Normal IP
   // As of now, it is assumed that the first subinterface is for the gateway and
   // the second is for the VLAN.
   auto& interface = data["openconfig-interfaces:interfaces"]["interface"];
-  interface[0]["name"] = parsed["data"][0]["name"];
-  interface[0]["config"]["name"] = parsed["data"][0]["name"];
+  interface[0]["name"] = info["name"];
+  interface[0]["config"]["name"] = info["name"];
   interface[0]["subinterfaces"]["subinterface"][0]["openconfig-if-ip:ipv4"]
-           ["addresses"]["address"][0]["config"]["ip"] =
-               parsed["data"][0]["ip"];
+           ["addresses"]["address"][0]["config"]["ip"] = info["ip"];
   interface[0]["subinterfaces"]["subinterface"][0]["openconfig-if-ip:ipv4"]
-           ["addresses"]["address"][0]["ip"] = parsed["data"][0]["ip"];
+           ["addresses"]["address"][0]["ip"] = info["ip"];
 
   // VLAN
   if (data["openconfig-interfaces:interfaces"]["interface"].size() < 2) {
@@ -265,14 +278,12 @@ std::shared_ptr<Datastore> Device::getOperationalDatastore() {
   interface[1]["config"]["name"] = "VLAN_IP";
   interface[1]["subinterfaces"]["subinterface"][0]["openconfig-if-ip:ipv4"]
            ["addresses"]["address"][0]["config"]["ip"] =
-               parsed["data"][0]["config"]["variables"]["VLAN_1_IP"];
+               info["config"]["variables"]["VLAN_1_IP"];
   interface[0]["subinterfaces"]["subinterface"][0]["openconfig-if-ip:ipv4"]
            ["addresses"]["address"][0]["ip"] =
-               parsed["data"][0]["config"]["variables"]["VLAN_1_IP"];
+               info["config"]["variables"]["VLAN_1_IP"];
 
-  auto state = Datastore::make(app, getId());
-  state->update([&data](auto& lockedState) { lockedState = std::move(data); });
-  return state;
+  return data;
 }
 
 void Device::updateYang(
@@ -315,7 +326,8 @@ void Device::updateYang(
   }
 }
 
-void Device::setIntendedDatastore(const folly::dynamic& config) {
+folly::Future<folly::Unit> Device::setIntendedDatastore(
+    const folly::dynamic& config) {
   // TODO: Break out successfully so we don't waste lots of for looping
   // TODO: Figure why we couldn't declare the vector in one line.
   folly::dynamic updateJson = folly::dynamic::object;
@@ -337,10 +349,13 @@ void Device::setIntendedDatastore(const folly::dynamic& config) {
 
   updateYang(config, ssidsPath, 0, config, updateJson);
   updateYang(config, interfacesPath, 0, config, updateJson);
-  // TODO: when this is converted to a response class we may want to do
-  // something with the response.
-  channel.updateDevice(updateJson, clientMac);
-  // LOG(ERROR) << "Output of setRunningDatastore is: " << output;
+  return channel->updateDevice(updateJson, clientMac)
+      .thenValue([id = getId()](channels::http::Response response) {
+        if (response.isError()) {
+          throw std::runtime_error(
+              folly::sformat("Failed to update {}: {}", id, response.get()));
+        }
+      });
 }
 
 void Device::updateDevice(
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include <folly/IPAddress.h>
 #include <folly/dynamic.h>
 
@@ -43,12 +45,13 @@ class Device : public devices::Device {
 
  public:
   std::shared_ptr<Datastore> getOperationalDatastore() override;
-  void setIntendedDatastore(const folly::dynamic& config) override;
+  folly::Future<folly::Unit> setIntendedDatastore(
+      const folly::dynamic& config) override;
 
  private:
-  void connect();
-  void checkConnection();
-  folly::dynamic setupReturnData();
+  static folly::dynamic setupReturnData();
+  // Builds the state from the device's cnMaestro entry.
+  static folly::dynamic getOperational(folly::dynamic info);
   void updateDevice(
       const folly::dynamic& yangIn,
       std::vector<std::string>& path,
@@ -61,14 +64,13 @@ class Device : public devices::Device {
       folly::dynamic& updateJson);
 
   // TODO: Pull these out into their own file/library
-  void setupOpenconfig(folly::dynamic& dataIn);
-  void setupOpenconfigInterfaces(folly::dynamic& dataIn);
-  void addOpenconfigInterface(folly::dynamic& data);
-  void setupIpv4(folly::dynamic& dataIn, int interfaceNum);
+  static void setupOpenconfig(folly::dynamic& dataIn);
+  static void setupOpenconfigInterfaces(folly::dynamic& dataIn);
+  static void addOpenconfigInterface(folly::dynamic& data);
+  static void setupIpv4(folly::dynamic& dataIn, int interfaceNum);
 
  private:
-  channels::cnmaestro::Channel channel;
-  bool connected{false};
+  std::shared_ptr<channels::cnmaestro::Channel> channel;
   std::string deviceId;
   folly::IPAddress deviceIp;
   std::string clientMac;
@@ -76,9 +76,17 @@ std::shared_ptr<Datastore> PlaintextCliDevice::getOperationalDatastore() {
               << "Retrieving state";
 
   // Reset cache
-  cmdCache->wlock()->clear();
+  cmdCache->clear();
+
+  static const auto& cacheHits = MetricFamily::get("cli.cache.hits");
+  static const auto& cacheMisses = MetricFamily::get("cli.cache.misses");
+  static const auto& cacheCoalesced = MetricFamily::get("cli.cache.coalesced");
 
   auto state = Datastore::make(*reinterpret_cast<MetricSink*>(&app), getId());
+  state->setGauge(cacheHits, static_cast<double>(cmdCache->getHits()));
+  state->setGauge(cacheMisses, static_cast<double>(cmdCache->getMisses()));
+  state->setGauge(
+      cacheCoalesced, static_cast<double>(cmdCache->getCoalesced()));
 
   state->addRequest(
       channel->executeRead(stateCommand)
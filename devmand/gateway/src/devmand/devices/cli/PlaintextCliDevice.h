@@ -52,10 +52,12 @@ class PlaintextCliDevice : public Device {
   std::shared_ptr<Datastore> getOperationalDatastore() override;
 
  protected:
-  void setIntendedDatastore(const folly::dynamic& config) override {
+  folly::Future<folly::Unit> setIntendedDatastore(
+      const folly::dynamic& config) override {
     (void)config;
     MLOG(MERROR) << "[" << id << "] "
                  << "set config on unconfigurable device";
+    return folly::makeFuture();
   }
 
  private:
@@ -107,13 +107,14 @@ void StructuredUbntDevice::reconcile(DeviceAccess& access) {
   reconcileTx->commit();
 }
 
-void StructuredUbntDevice::setIntendedDatastore(const dynamic& config) {
+Future<Unit> StructuredUbntDevice::setIntendedDatastore(
+    const dynamic& config) {
   MLOG(MINFO) << "[" << id << "] "
               << "Writing config";
   std::this_thread::sleep_for(std::chrono::seconds(3));
 
   // Reset cache
-  cmdCache->wlock()->clear();
+  cmdCache->clear();
   treeCache->clear(); // FIXME this is not threadsafe
 
   DeviceAccess access = DeviceAccess(channel, id, getCPUExecutor());
@@ -149,7 +150,7 @@ void StructuredUbntDevice::setIntendedDatastore(const dynamic& config) {
     MLOG(MINFO) << "[" << id << "] "
                 << "No updates detected";
     tx->abort();
-    return;
+    return folly::makeFuture();
   }
 
   MLOG(MINFO) << "[" << id << "] "
@@ -159,6 +160,7 @@ void StructuredUbntDevice::setIntendedDatastore(const dynamic& config) {
 
   MLOG(MINFO) << "[" << id << "] "
               << "Config written successfully";
+  return folly::makeFuture();
 }
 
 shared_ptr<Datastore> StructuredUbntDevice::getOperationalDatastore() {
@@ -166,10 +168,18 @@ shared_ptr<Datastore> StructuredUbntDevice::getOperationalDatastore() {
               << "Retrieving state";
 
   // Reset cache
-  cmdCache->wlock()->clear();
+  cmdCache->clear();
   treeCache->clear(); // FIXME this is not threadsafe
 
+  static const auto& cacheHits = MetricFamily::get("cli.cache.hits");
+  static const auto& cacheMisses = MetricFamily::get("cli.cache.misses");
+  static const auto& cacheCoalesced = MetricFamily::get("cli.cache.coalesced");
+
   auto state = Datastore::make(*reinterpret_cast<MetricSink*>(&app), getId());
+  state->setGauge(cacheHits, static_cast<double>(cmdCache->getHits()));
+  state->setGauge(cacheMisses, static_cast<double>(cmdCache->getMisses()));
+  state->setGauge(
+      cacheCoalesced, static_cast<double>(cmdCache->getCoalesced()));
   state->setStatus(true);
   //  return state;
   DeviceAccess access = DeviceAccess(channel, id, getCPUExecutor());
@@ -58,7 +58,8 @@ class StructuredUbntDevice : public Device {
   std::shared_ptr<Datastore> getOperationalDatastore() override;
 
  protected:
-  void setIntendedDatastore(const folly::dynamic& config) override;
+  folly::Future<folly::Unit> setIntendedDatastore(
+      const folly::dynamic& config) override;
 
  private:
   std::shared_ptr<Channel> channel;
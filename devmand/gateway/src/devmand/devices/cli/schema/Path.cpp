@@ -9,7 +9,11 @@
 #include <boost/algorithm/string/join.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <devmand/devices/cli/schema/Path.h>
+#include <folly/Synchronized.h>
+#include <deque>
 #include <regex>
+#include <string_view>
+#include <unordered_map>
 
 namespace devmand {
 namespace devices {
@@ -18,196 +22,270 @@ namespace cli {
 using namespace std;
 using namespace folly;
 
-const string Path::PATH_SEPARATOR = "/";
-const Path Path::ROOT = Path(PATH_SEPARATOR);
+namespace {
 
-Path::Path(const string& _path) : path(_path) {
-  if (_path.empty()) {
-    throw InvalidPathException(path, "Empty path");
-  }
-  // equivalent to _path.startsWith(PATH_SEPARATOR)
-  if (_path.rfind(PATH_SEPARATOR, 0) != 0) {
-    throw InvalidPathException(path, "Not an absolute path");
+// Interned strings are never released, there is one per distinct module
+// prefix and node name seen, which is bounded by the loaded models.
+class PathAtoms {
+ public:
+  static PathAtoms& get() {
+    // Leaked on purpose, static paths may outlive any other static
+    static auto* atoms = new PathAtoms();
+    return *atoms;
   }
 
-  // TODO
-  // path should not contain leading/trailing whitespace
-  // pre-cache segments and unkeyed version
-}
+  const PathAtom* intern(StringPiece text) {
+    string_view key(text.data(), text.size());
+    {
+      auto locked = table.rlock();
+      auto it = locked->index.find(key);
+      if (it != locked->index.end()) {
+        return it->second;
+      }
+    }
 
-// TODO description
-vector<string> Path::getSegments() const {
-  if (ROOT == *this) {
-    return vector<string>();
+    auto locked = table.wlock();
+    auto it = locked->index.find(key);
+    if (it != locked->index.end()) {
+      return it->second;
+    }
+    locked->atoms.push_back(PathAtom{text.str()});
+    const PathAtom* atom = &locked->atoms.back();
+    locked->index.emplace(string_view(atom->text), atom);
+    return atom;
   }
 
-  // Keys could contain path separators, so split segments of unkeyed version
-  //  and use them to extract segments with keys
-  vector<string> unkeyedSegments;
-  boost::split(
-      unkeyedSegments,
-      unkeyed().path,
-      boost::is_any_of(Path::PATH_SEPARATOR),
-      boost::token_compress_on);
-
-  string pathCopy = path;
-  vector<string> segments;
+ private:
+  struct Table {
+    // Atoms never move once interned
+    deque<PathAtom> atoms;
+    unordered_map<string_view, const PathAtom*> index;
+  };
 
-  // skip the first empty segment since the path is always absolute
-  for (unsigned int i = 1; i < unkeyedSegments.size(); ++i) {
-    if (i == unkeyedSegments.size() - 1) {
-      segments.push_back(pathCopy.substr(1));
-      break;
-    }
+  Synchronized<Table> table;
+};
 
-    pathCopy = pathCopy.substr(unkeyedSegments[i].length() + 1);
+} // namespace
 
-    unsigned long nextSegmentStart =
-        pathCopy.find(PATH_SEPARATOR + unkeyedSegments[i + 1]);
-    segments.push_back(
-        unkeyedSegments[i] + pathCopy.substr(0, nextSegmentStart));
+const string Path::PATH_SEPARATOR = "/";
+const Path Path::ROOT = Path(PATH_SEPARATOR);
 
-    pathCopy = pathCopy.substr(nextSegmentStart);
+bool Path::Segment::operator==(const Segment& rhs) const {
+  if (not sameNode(rhs)) {
+    return false;
   }
-  return segments;
+  if (keys == nullptr or rhs.keys == nullptr) {
+    return keys == rhs.keys;
+  }
+  return keys == rhs.keys or keys->text == rhs.keys->text;
 }
 
-static const auto PREFIXED_SEGMENT = regex("([^:]+):([^:]+)");
+bool Path::Segment::sameNode(const Segment& rhs) const {
+  return prefix == rhs.prefix and name == rhs.name;
+}
 
-const Path Path::prefixAllSegments() const {
-  if (ROOT == *this) {
-    return ROOT;
+bool Path::Segment::unkeyedEquals(StringPiece unkeyed) const {
+  if (prefix == nullptr) {
+    return unkeyed == name->text;
   }
+  return unkeyed.size() == prefix->text.size() + 1 + name->text.size() and
+      unkeyed.startsWith(prefix->text) and
+      unkeyed[prefix->text.size()] == ':' and unkeyed.endsWith(name->text);
+}
 
-  vector<string> unkeyedSegments = unkeyed().getSegments();
+string Path::Segment::unkeyedStr() const {
+  return prefix == nullptr ? name->text : prefix->text + ":" + name->text;
+}
 
-  string pathCopy = path;
-  stringstream newPath;
-  newPath << PATH_SEPARATOR;
+string Path::Segment::str() const {
+  return keys == nullptr ? unkeyedStr() : unkeyedStr() + keys->text;
+}
 
-  string lastPrefix = "";
-  for (unsigned int i = 0; i < unkeyedSegments.size(); ++i) {
-    smatch match;
-    if (regex_match(unkeyedSegments[i], match, PREFIXED_SEGMENT)) {
-      lastPrefix = match[1];
-      newPath << unkeyedSegments[i];
-    } else {
-      newPath << lastPrefix << ":" << unkeyedSegments[i];
+Path::Segment Path::parseSegment(StringPiece segment) {
+  // Keys could contain path separators or colons, so split them off first
+  string unkeyed;
+  string keys;
+  bool inKeys = false;
+  for (char c : segment) {
+    if (c == '[') {
+      inKeys = true;
     }
-
-    if (i == unkeyedSegments.size() - 1) {
-      newPath << pathCopy.substr(unkeyedSegments[i].length() + 1);
-      break;
+    (inKeys ? keys : unkeyed) += c;
+    if (c == ']') {
+      inKeys = false;
     }
+  }
 
-    pathCopy = pathCopy.substr(unkeyedSegments[i].length() + 1);
+  auto& atoms = PathAtoms::get();
+  Segment parsed;
+  // A prefix is only recognized in a segment with a single colon, with
+  // something on either side of it
+  auto colon = unkeyed.find(':');
+  if (colon != string::npos and colon != 0 and colon != unkeyed.size() - 1 and
+      unkeyed.find(':', colon + 1) == string::npos) {
+    StringPiece unkeyedPiece(unkeyed);
+    parsed.prefix = atoms.intern(unkeyedPiece.subpiece(0, colon));
+    parsed.name = atoms.intern(unkeyedPiece.subpiece(colon + 1));
+  } else {
+    parsed.name = atoms.intern(unkeyed);
+  }
+  if (not keys.empty()) {
+    parsed.keys = makeKeyList(move(keys));
+  }
+  return parsed;
+}
 
-    unsigned long nextSegmentStart =
-        pathCopy.find(PATH_SEPARATOR + unkeyedSegments[i + 1]);
-    newPath << pathCopy.substr(0, nextSegmentStart) << PATH_SEPARATOR;
+shared_ptr<const Path::KeyList> Path::makeKeyList(string text) {
+  auto parsed = parseKeys(text);
+  return make_shared<const KeyList>(KeyList{move(text), move(parsed)});
+}
 
-    pathCopy = pathCopy.substr(nextSegmentStart);
+vector<Path::Segment> Path::parseSegments(const string& path) {
+  vector<Segment> segments;
+  // skip the leading separator since the path is always absolute
+  size_t start = 1;
+  bool inKeys = false;
+  for (size_t i = 1; i <= path.size(); ++i) {
+    if (i == path.size() or (path[i] == '/' and not inKeys)) {
+      if (i > start) {
+        segments.push_back(
+            parseSegment(StringPiece(path.data() + start, i - start)));
+      }
+      start = i + 1;
+    } else if (path[i] == '[') {
+      inKeys = true;
+    } else if (path[i] == ']') {
+      inKeys = false;
+    }
   }
-
-  return Path(newPath.str());
+  return segments;
 }
 
-const Path Path::unprefixAllSegments() const {
-  if (ROOT == *this) {
-    return ROOT;
+Path::Path(const string& _path) : path(_path) {
+  if (_path.empty()) {
+    throw InvalidPathException(path, "Empty path");
+  }
+  // equivalent to _path.startsWith(PATH_SEPARATOR)
+  if (_path.rfind(PATH_SEPARATOR, 0) != 0) {
+    throw InvalidPathException(path, "Not an absolute path");
   }
 
-  vector<string> unkeyedSegments = unkeyed().getSegments();
+  // TODO
+  // path should not contain leading/trailing whitespace
+  segments = parseSegments(path);
+}
 
-  string pathCopy = path;
-  stringstream newPath;
-  newPath << PATH_SEPARATOR;
+Path::Path(vector<Segment>&& _segments) : segments(move(_segments)) {
+  if (segments.empty()) {
+    path = PATH_SEPARATOR;
+  }
+  for (const auto& segment : segments) {
+    path += PATH_SEPARATOR;
+    path += segment.str();
+  }
+}
 
-  for (unsigned int i = 0; i < unkeyedSegments.size(); ++i) {
-    smatch match;
-    if (regex_match(unkeyedSegments[i], match, PREFIXED_SEGMENT)) {
-      newPath << match[2];
-    } else {
-      newPath << unkeyedSegments[i];
-    }
+vector<string> Path::getSegments() const {
+  vector<string> result;
+  result.reserve(segments.size());
+  for (const auto& segment : segments) {
+    result.push_back(segment.str());
+  }
+  return result;
+}
 
-    if (i == unkeyedSegments.size() - 1) {
-      newPath << pathCopy.substr(unkeyedSegments[i].length() + 1);
-      break;
+const Path Path::prefixAllSegments() const {
+  vector<Segment> prefixed = segments;
+  const PathAtom* lastPrefix = nullptr;
+  for (auto& segment : prefixed) {
+    if (segment.prefix != nullptr) {
+      lastPrefix = segment.prefix;
+    } else if (lastPrefix != nullptr) {
+      segment.prefix = lastPrefix;
+    } else {
+      // Nothing to inherit, keep the separator with an empty prefix
+      segment.name = PathAtoms::get().intern(":" + segment.name->text);
     }
-
-    pathCopy = pathCopy.substr(unkeyedSegments[i].length() + 1);
-
-    unsigned long nextSegmentStart =
-        pathCopy.find(PATH_SEPARATOR + unkeyedSegments[i + 1]);
-    newPath << pathCopy.substr(0, nextSegmentStart) << PATH_SEPARATOR;
-
-    pathCopy = pathCopy.substr(nextSegmentStart);
   }
+  return Path(move(prefixed));
+}
 
-  return Path(newPath.str());
+const Path Path::unprefixAllSegments() const {
+  vector<Segment> unprefixed = segments;
+  for (auto& segment : unprefixed) {
+    segment.prefix = nullptr;
+  }
+  return Path(move(unprefixed));
 }
 
 bool Path::isChildOfUnprefixed(const Path& parent) const {
-  return unprefixAllSegments().isChildOf(parent.unprefixAllSegments());
+  if (parent.segments.size() > segments.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < parent.segments.size(); ++i) {
+    if (segments[i].name != parent.segments[i].name) {
+      return false;
+    }
+  }
+  return true;
 }
 
 bool Path::isLastSegmentKeyed() const {
-  if (ROOT == *this) {
+  if (segments.empty()) {
     return false;
   }
-  return unkeyed().getLastSegment() != getLastSegment();
+  return segments.back().keys != nullptr;
 }
 
 Optional<string> Path::getFirstModuleName() const {
-  vector<string> segments = getSegments();
-  for (unsigned int i = 0; i < segments.size(); ++i) {
-    smatch match;
-    if (regex_match(segments[i], match, PREFIXED_SEGMENT)) {
-      return Optional<string>(match[1]);
+  for (const auto& segment : segments) {
+    if (segment.prefix != nullptr) {
+      return Optional<string>(segment.prefix->text);
     }
   }
   return none;
 }
 
-static const auto KEYS_IN_PATH = regex("\\[([^\\]]+)\\]");
-
 const Path Path::unkeyed() const {
-  return Path(regex_replace(path, KEYS_IN_PATH, ""));
+  vector<Segment> unkeyedSegments = segments;
+  for (auto& segment : unkeyedSegments) {
+    segment.keys = nullptr;
+  }
+  return Path(move(unkeyedSegments));
 }
 
 string Path::getLastSegment() const {
-  if (ROOT == *this) {
+  if (segments.empty()) {
     throw InvalidPathException("Invalid operation on root path");
   }
-  return getSegments().back();
+  return segments.back().str();
+}
+
+string Path::getUnkeyedSegment(u_long index) const {
+  return segments.at(index).unkeyedStr();
 }
 
 u_long Path::getDepth() const {
-  return unkeyed().getSegments().size();
+  return segments.size();
 }
 
 bool Path::isChildOf(const Path& parent) const {
-  auto thisSegments = unkeyed().getSegments();
-  auto parentSegments = parent.unkeyed().getSegments();
-  return includes(
-      thisSegments.begin(),
-      thisSegments.end(),
-      parentSegments.begin(),
-      parentSegments.end());
+  if (parent.segments.size() > segments.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < parent.segments.size(); ++i) {
+    if (not segments[i].sameNode(parent.segments[i])) {
+      return false;
+    }
+  }
+  return true;
 }
 
 const Path Path::getParent() const {
-  if (ROOT == *this) {
+  if (segments.empty()) {
     throw InvalidPathException("Invalid operation on root path");
   }
-  vector<string> segments = getSegments();
-
-  if (segments.size() == 1) {
-    return ROOT;
-  }
-
-  return joinSegments(vector<string>(segments.begin(), segments.end() - 1));
+  return Path(vector<Segment>(segments.begin(), segments.end() - 1));
 }
 
 const Path Path::getChild(string childSegment) const {
@@ -222,15 +300,20 @@ const Path Path::getChild(string childSegment) const {
             childSegment);
   }
 
-  if (ROOT == *this) {
-    return Path(path + childSegment);
+  Path child = *this;
+  if (not segments.empty()) {
+    child.path += PATH_SEPARATOR;
   }
-
-  return Path(path + PATH_SEPARATOR + childSegment);
+  child.path += childSegment;
+  // The child segment is allowed to hold more than one segment
+  for (auto& segment : parseSegments(PATH_SEPARATOR + childSegment)) {
+    child.segments.push_back(segment);
+  }
+  return child;
 }
 
 const Path Path::addKeys(Keys keys) const {
-  if (ROOT == *this) {
+  if (segments.empty()) {
     throw InvalidPathException("Invalid operation on root path");
   }
 
@@ -242,49 +325,49 @@ const Path Path::addKeys(Keys keys) const {
     throw InvalidPathException("Unable to add keys to path with keys: " + path);
   }
 
-  return Path(path + serializeKeys(keys));
+  string serializedKeys = serializeKeys(keys);
+  if (segments.back().keys != nullptr) {
+    // Keys which didn't parse, leave it to the parser to combine them
+    return Path(path + serializedKeys);
+  }
+
+  Path keyed = *this;
+  keyed.path += serializedKeys;
+  keyed.segments.back().keys = makeKeyList(move(serializedKeys));
+  return keyed;
 }
 
 Path::Keys Path::getKeys() const {
-  if (ROOT == *this) {
+  if (segments.empty()) {
     throw InvalidPathException("Invalid operation on root path");
   }
 
-  smatch match;
-  string lastSegment = getLastSegment();
-  regex_search(lastSegment, match, KEYS_IN_PATH);
-  string keysAsString = match[0];
-  return parseKeys(keysAsString);
+  const auto& keys = segments.back().keys;
+  return keys == nullptr ? dynamic::object() : keys->parsed;
 }
 
 Path::Keys Path::getKeysFromSegment(string segment) const {
-  if (ROOT == *this) {
+  if (segments.empty()) {
     throw InvalidPathException("Invalid operation on root path");
   }
 
-  auto unkeyedPath = unkeyed().getSegments();
-  auto it = find(unkeyedPath.begin(), unkeyedPath.end(), segment);
-  if (it == unkeyedPath.end()) {
-    throw InvalidPathException(path, "Cannot find segment: " + segment);
-  }
-  long index = distance(unkeyedPath.begin(), it);
-  if (index < 0) {
-    throw InvalidPathException(path, "Cannot find segment: " + segment);
+  for (const auto& candidate : segments) {
+    if (candidate.unkeyedEquals(segment)) {
+      return candidate.keys == nullptr ? dynamic::object()
+                                       : candidate.keys->parsed;
+    }
   }
-
-  smatch match;
-  string lastSegment = getSegments()[u_int(index)];
-  regex_search(lastSegment, match, KEYS_IN_PATH);
-  string keysAsString = match[0];
-  return parseKeys(keysAsString);
+  throw InvalidPathException(path, "Cannot find segment: " + segment);
 }
 
 // TODO make Keys a proper class and move serialize/parse there
 
-static const auto KEY_IN_PATH = regex("([^=]*)=\'([^\']*)\'");
-static const string KEY_SEPARATOR = ",";
-
 const Path::Keys Path::parseKeys(string keys) {
+  // Local so that they are initialized before any static path is parsed
+  static const auto KEYS_IN_PATH = regex("\\[([^\\]]+)\\]");
+  static const auto KEY_IN_PATH = regex("([^=]*)=\'([^\']*)\'");
+  static const string KEY_SEPARATOR = ",";
+
   smatch removeArrayBrackets;
   regex_match(keys, removeArrayBrackets, KEYS_IN_PATH);
   keys = removeArrayBrackets[1];
@@ -363,11 +446,9 @@ string Path::str() const {
 }
 
 unsigned int Path::segmentDistance(Path other) const {
-  const vector<string>& otherSegments = other.getSegments();
-  const vector<string>& segments = getSegments();
   unsigned int j = 0;
-  for (; j < otherSegments.size() && j < segments.size(); ++j) {
-    if (otherSegments[j] != segments[j]) {
+  for (; j < other.segments.size() && j < segments.size(); ++j) {
+    if (!(other.segments[j] == segments[j])) {
       return j;
     }
   }
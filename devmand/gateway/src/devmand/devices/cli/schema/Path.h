@@ -11,7 +11,10 @@
 #include <magma_logging.h>
 
 #include <folly/dynamic.h>
+#include <memory>
 #include <ostream>
+#include <string>
+#include <vector>
 
 namespace devmand {
 namespace devices {
@@ -20,12 +23,52 @@ namespace cli {
 using namespace folly;
 using namespace std;
 
+/*
+ * A module prefix or node name, interned for the lifetime of the process.
+ * Equal strings are interned once, so interned strings compare by address.
+ */
+struct PathAtom {
+  string text;
+};
+
+/*
+ * A YANG path such as /module:container/list[key='value']/leaf. The path is
+ * split into segments once at construction. Prefixes and node names come from
+ * the models and are interned, so they compare by address. Key lists hold
+ * device data, so they are parsed once and shared by the copies of a path
+ * rather than interned, and go away with the last path using them.
+ */
 class Path {
  public:
   typedef dynamic Keys;
 
  private:
+  // The bracketed key list of a segment and the keys parsed from it
+  struct KeyList {
+    string text;
+    dynamic parsed;
+  };
+
+  struct Segment {
+    const PathAtom* prefix{nullptr}; // the module prefix, if any
+    const PathAtom* name{nullptr};
+    shared_ptr<const KeyList> keys; // the bracketed key list, if any
+
+    bool operator==(const Segment& rhs) const;
+    // Same prefix and name, keys aside
+    bool sameNode(const Segment& rhs) const;
+    bool unkeyedEquals(StringPiece unkeyed) const;
+    string str() const;
+    string unkeyedStr() const;
+  };
+
   string path;
+  vector<Segment> segments;
+
+  explicit Path(vector<Segment>&& _segments);
+  static vector<Segment> parseSegments(const string& path);
+  static Segment parseSegment(StringPiece segment);
+  static shared_ptr<const KeyList> makeKeyList(string text);
 
  public:
   // Path separator for YANG is a single char: '/'
@@ -39,6 +82,7 @@ class Path {
   const Path unkeyed() const;
   vector<string> getSegments() const;
   string getLastSegment() const;
+  string getUnkeyedSegment(u_long index) const;
   const Path prefixAllSegments() const;
   const Path unprefixAllSegments() const;
   bool isChildOfUnprefixed(const Path& parent) const;
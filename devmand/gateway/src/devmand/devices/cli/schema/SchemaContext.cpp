@@ -5,6 +5,8 @@
 // LICENSE file in the root directory of this source tree. An additional grant
 // of patent rights can be found in the PATENTS file in the same directory.
 
+#include <algorithm>
+
 #include <boost/filesystem.hpp>
 #include <devmand/devices/cli/schema/SchemaContext.h>
 
@@ -13,26 +15,12 @@ namespace devmand::devices::cli {
 const SchemaContext SchemaContext::NO_MODELS(nullptr);
 
 vector<string> SchemaContext::getKeys(Path path) const {
-  if (not isPathValid(path)) {
-    throw InvalidPathException(
-        path.str(), "Not valid according to model from " + model);
-  }
-  if (not isList(path)) {
+  auto node = getNode(path);
+  if (node.kind != SchemaIndex::Kind::LIST) {
     throw InvalidPathException(
         path.str(), "Not a list according to model from " + model);
   }
-  llly_set* pSet = getNodes(path);
-  lllys_node* node = pSet->set.s[0];
-  vector<string> result;
-
-  if (node->nodetype == LLLYS_LIST) {
-    auto* list = (lllys_node_list*)node;
-    for (uint8_t i = 0; i < list->keys_size; i++) {
-      result.emplace_back(string(list->keys[i]->name));
-    }
-  }
-  llly_set_free(pSet);
-  return result;
+  return node.keys;
 }
 
 bool SchemaContext::isList(Path path) const {
@@ -40,58 +28,18 @@ bool SchemaContext::isList(Path path) const {
     return false;
   }
 
-  llly_set* pSet = getNodes(path);
-  auto result = pSet->set.s[0]->nodetype == LLLYS_LIST;
-  llly_set_free(pSet);
-  return result;
-}
-
-static vector<LLLY_DATA_TYPE> resolveType(lllys_type type) {
-  if (-1 == type.base) {
-    MLOG(MDEBUG) << "We have a problem";
-  }
-  if (LLLY_TYPE_DER == type.base) {
-    MLOG(MDEBUG) << "We have a problem";
-  }
-  if (LLLY_TYPE_UNION == type.base) {
-    vector<LLLY_DATA_TYPE> unionTypes;
-    for (lllys_type* subtype = type.info.uni.types;
-         subtype < type.info.uni.types + type.info.uni.count;
-         ++subtype) {
-      unionTypes.push_back(subtype->base);
-    }
-    return unionTypes;
-  }
-
-  // follow leafref to actual type
-  if (LLLY_TYPE_LEAFREF == type.base) {
-    while (type.info.lref.target) {
-      type = type.info.lref.target->type;
-    }
-    return vector<LLLY_DATA_TYPE>{type.base};
-  }
-  return vector<LLLY_DATA_TYPE>{type.base};
+  return getNode(path).kind == SchemaIndex::Kind::LIST;
 }
 
 vector<LLLY_DATA_TYPE> SchemaContext::leafType(Path path) const {
-  llly_set* pSet = getNodes(path);
-  lllys_node* node = pSet->set.s[0];
-  vector<string> result;
-
-  vector<LLLY_DATA_TYPE> resolvedTypes;
-  if (node->nodetype == LLLYS_LEAF) {
-    resolvedTypes = resolveType(((lllys_node_leaf*)node)->type);
-  } else if (node->nodetype == LLLYS_LEAFLIST) {
-    resolvedTypes = resolveType(((lllys_node_leaflist*)node)->type);
-  } else {
-    llly_set_free(pSet);
+  auto node = getNode(path);
+  if (node.kind != SchemaIndex::Kind::LEAF and
+      node.kind != SchemaIndex::Kind::LEAFLIST) {
     throw InvalidPathException(
         path.str(),
         "Unable to lookup leaf type, path is not pointing to a leaf");
   }
-
-  llly_set_free(pSet);
-  return resolvedTypes;
+  return node.types;
 }
 
 bool SchemaContext::isConfig(Path path) const {
@@ -99,20 +47,16 @@ bool SchemaContext::isConfig(Path path) const {
     return true;
   }
 
-  llly_set* pSet = getNodes(path);
-  auto result = pSet->set.s[0]->flags & LLLYS_CONFIG_W;
-  llly_set_free(pSet);
-  return result;
+  return getNode(path).config;
 }
 
-void SchemaContext::loadModules(llly_ctx* context, const Model& _model) {
+void SchemaContext::loadModules(llly_ctx* context, const string& dir) {
   int modelCount = 0;
   int failedModelCount = 0;
 
   try {
     for (boost::filesystem::directory_entry& p :
-         boost::filesystem::directory_iterator(
-             boost::filesystem::path(_model.getDir()))) {
+         boost::filesystem::directory_iterator(boost::filesystem::path(dir))) {
       if (!boost::filesystem::is_regular_file(p)) {
         continue;
       }
@@ -129,14 +73,14 @@ void SchemaContext::loadModules(llly_ctx* context, const Model& _model) {
 
     if (failedModelCount == modelCount) {
       throw SchemaContextException(
-          "Unable to parse schema context from " + _model.getDir() +
+          "Unable to parse schema context from " + dir +
           " due to: Failed to parse all models: " +
           to_string(failedModelCount));
     }
   } catch (boost::filesystem::filesystem_error& e) {
     throw SchemaContextException(
-        "Unable to parse schema context from " + _model.getDir() +
-        " due to: " + e.what());
+        "Unable to parse schema context from " + dir + " due to: " +
+        e.what());
   }
 }
 
@@ -144,20 +88,46 @@ bool SchemaContext::isPathValid(Path path) const {
   if (path == Path::ROOT) {
     return true;
   }
+  if (index == nullptr) {
+    return false;
+  }
 
-  void* schema =
-      llly_path_data2schema(ctx, const_cast<char*>(path.str().c_str()));
-
-  auto result = schema != nullptr;
-  free(schema);
-  return result;
+  return index->find(path.unkeyed().prefixAllSegments().str()).hasValue();
 }
 
 SchemaContext::~SchemaContext() {
-  llly_ctx_destroy(ctx, nullptr);
+  if (ctx != nullptr) {
+    llly_ctx_destroy(ctx, nullptr);
+  }
 }
 
-SchemaContext::SchemaContext(const Model& _model) : model(_model.getDir()) {
+SchemaContext::SchemaContext(const Model& _model, const string& cacheDir)
+    : ctx(nullptr), model(_model.getDir()) {
+  SchemaIndex::Hash hash;
+  try {
+    hash = SchemaIndex::hashModelDir(model);
+  } catch (boost::filesystem::filesystem_error& e) {
+    throw SchemaContextException(
+        "Unable to parse schema context from " + model + " due to: " +
+        e.what());
+  }
+
+  auto indexFile = getIndexFile(cacheDir, model);
+  index = SchemaIndex::load(indexFile, hash);
+  if (index != nullptr) {
+    MLOG(MDEBUG) << "Loaded schema index for " << model << " from "
+                 << indexFile;
+    return;
+  }
+
+  ctx = createLyContext(model);
+  index = SchemaIndex::build(ctx, hash);
+  MLOG(MINFO) << "Built schema index for " << model << " with "
+              << index->size() << " nodes";
+  index->save(indexFile);
+}
+
+llly_ctx* SchemaContext::createLyContext(const string& dir) {
   // set extensions and user_types for non-YDK libyang
   setenv(
       "LLLIBYANG_EXTENSIONS_PLUGINS_DIR",
@@ -165,38 +135,37 @@ SchemaContext::SchemaContext(const Model& _model) : model(_model.getDir()) {
       false);
   setenv(
       "LIBYANG_USER_TYPES_PLUGINS_DIR", LIBYANG_USER_TYPES_PLUGINS_DIR, false);
-  ctx = llly_ctx_new(_model.getDir().c_str(), LLLY_CTX_ALLIMPLEMENTED);
-  loadModules(ctx, _model);
+  llly_ctx* context = llly_ctx_new(dir.c_str(), LLLY_CTX_ALLIMPLEMENTED);
+  try {
+    loadModules(context, dir);
+  } catch (...) {
+    llly_ctx_destroy(context, nullptr);
+    throw;
+  }
+  return context;
 }
 
-llly_set* SchemaContext::getNodes(Path path) const {
-  if (not isPathValid(path)) {
-    throw InvalidPathException(
-        path.str(), "Not valid according to model from " + model);
-  }
-  char* schemaPath =
-      llly_path_data2schema(ctx, const_cast<char*>(path.str().c_str()));
-  Path schemaPathPrefixed(schemaPath);
-  if (schemaPath != nullptr) {
-    free(schemaPath);
-  }
-  llly_set* pSet = llly_ctx_find_path(
-      ctx,
-      const_cast<char*>(schemaPathPrefixed.prefixAllSegments().str().c_str()));
+string SchemaContext::getIndexFile(const string& cacheDir, const string& dir) {
+  // One index per model directory, named after the directory
+  string name = dir;
+  std::replace(name.begin(), name.end(), '/', '_');
+  return cacheDir + "/" + name + ".idx";
+}
 
-  if (pSet == nullptr || pSet->number != 1) {
-    // shouldn't happen
+SchemaIndex::Node SchemaContext::getNode(Path path) const {
+  folly::Optional<SchemaIndex::Node> node;
+  if (index != nullptr) {
+    node = index->find(path.unkeyed().prefixAllSegments().str());
+  }
+  if (not node.hasValue()) {
     throw InvalidPathException(
-        path.str(),
-        "Unable to find schema node, but path seems valid according to model from " +
-            model);
+        path.str(), "Not valid according to model from " + model);
   }
-
-  return pSet;
+  return std::move(*node);
 }
 
 bool SchemaContext::operator==(const SchemaContext& rhs) const {
-  return ctx == rhs.ctx;
+  return this == &rhs;
 }
 
 bool SchemaContext::operator!=(const SchemaContext& rhs) const {
@@ -204,6 +173,14 @@ bool SchemaContext::operator!=(const SchemaContext& rhs) const {
 }
 
 llly_ctx* SchemaContext::getLyContext() const {
+  if (index == nullptr) {
+    return ctx;
+  }
+
+  std::lock_guard<std::mutex> lock(ctxLock);
+  if (ctx == nullptr) {
+    ctx = createLyContext(model);
+  }
   return ctx;
 }
 } // namespace devmand::devices::cli
@@ -12,7 +12,10 @@
 
 #include <devmand/devices/cli/schema/Model.h>
 #include <devmand/devices/cli/schema/Path.h>
+#include <devmand/devices/cli/schema/SchemaIndex.h>
 #include <libyang/libyang.h>
+#include <memory>
+#include <mutex>
 
 namespace devmand::devices::cli {
 
@@ -20,23 +23,34 @@ using devmand::devices::cli::Path;
 using std::string;
 using std::vector;
 
+/*
+ * Schema lookups are answered from a SchemaIndex cached under cacheDir and
+ * rebuilt whenever the models change. The models themselves are only parsed
+ * by libyang when the index has to be rebuilt or when the libyang context is
+ * asked for, e.g. by the first transaction on a datastore.
+ */
 class SchemaContext {
  private:
-  llly_ctx* ctx;
+  mutable std::mutex ctxLock;
+  mutable llly_ctx* ctx;
   string model = "NO_MODELS";
-  llly_set* getNodes(Path path) const;
+  std::unique_ptr<SchemaIndex> index;
+  SchemaIndex::Node getNode(Path path) const;
 
  public:
   // Special empty schema context, indicating no models are present
   static const SchemaContext NO_MODELS;
 
-  SchemaContext(const Model& model);
+  SchemaContext(
+      const Model& model,
+      const string& cacheDir = DEVMAND_SCHEMA_CACHE_DIR);
   ~SchemaContext();
   SchemaContext(const SchemaContext&) = delete;
   SchemaContext& operator=(const SchemaContext&) = delete;
   SchemaContext(SchemaContext&&) = delete;
   SchemaContext& operator=(SchemaContext&&) = delete;
 
+  // Parses the models on first use
   llly_ctx* getLyContext() const;
   bool isPathValid(Path path) const;
   bool isList(Path p) const;
@@ -50,7 +64,9 @@ class SchemaContext {
 
  private:
   SchemaContext(llly_ctx* _ctx) : ctx(_ctx){};
-  static void loadModules(llly_ctx* context, const Model& _model);
+  static void loadModules(llly_ctx* context, const string& dir);
+  static llly_ctx* createLyContext(const string& dir);
+  static string getIndexFile(const string& cacheDir, const string& dir);
 };
 
 class SchemaContextException : public runtime_error {
@@ -0,0 +1,357 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+
+#include <boost/filesystem.hpp>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/hash/SpookyHashV2.h>
+
+#include <devmand/devices/cli/schema/SchemaIndex.h>
+
+namespace devmand::devices::cli {
+
+using folly::StringPiece;
+
+// Bump whenever the layout below or the way nodes are resolved changes
+static constexpr uint32_t indexVersion = 1;
+static constexpr char indexMagic[8] = {'D', 'V', 'M', 'S', 'C', 'H', 'M', 'A'};
+
+// Written in host byte order, the index never leaves the host
+struct SchemaIndex::Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t recordCount;
+  uint64_t hash[2];
+};
+
+// Offsets point into the string blob following the records
+struct SchemaIndex::Record {
+  uint32_t pathOffset;
+  uint32_t pathLength;
+  // Key names separated by spaces
+  uint32_t keysOffset;
+  uint32_t keysLength;
+  // One byte per LLLY_DATA_TYPE
+  uint32_t typesOffset;
+  uint32_t typesLength;
+  uint8_t kind;
+  uint8_t config;
+  uint8_t padding[2];
+};
+
+static vector<LLLY_DATA_TYPE> resolveType(lllys_type type) {
+  if (-1 == type.base) {
+    MLOG(MDEBUG) << "We have a problem";
+  }
+  if (LLLY_TYPE_DER == type.base) {
+    MLOG(MDEBUG) << "We have a problem";
+  }
+  if (LLLY_TYPE_UNION == type.base) {
+    vector<LLLY_DATA_TYPE> unionTypes;
+    for (lllys_type* subtype = type.info.uni.types;
+         subtype < type.info.uni.types + type.info.uni.count;
+         ++subtype) {
+      unionTypes.push_back(subtype->base);
+    }
+    return unionTypes;
+  }
+
+  // follow leafref to actual type
+  if (LLLY_TYPE_LEAFREF == type.base) {
+    while (type.info.lref.target) {
+      type = type.info.lref.target->type;
+    }
+    return vector<LLLY_DATA_TYPE>{type.base};
+  }
+  return vector<LLLY_DATA_TYPE>{type.base};
+}
+
+using IndexedNodes = vector<std::pair<string, SchemaIndex::Node>>;
+
+static void collectNodes(
+    const lllys_node* parent,
+    const lllys_module* module,
+    const string& parentPath,
+    IndexedNodes& nodes) {
+  const lllys_node* node = nullptr;
+  while ((node = lllys_getnext(node, parent, module, 0)) != nullptr) {
+    SchemaIndex::Node indexed{};
+    switch (node->nodetype) {
+      case LLLYS_CONTAINER:
+        indexed.kind = SchemaIndex::Kind::CONTAINER;
+        break;
+      case LLLYS_LIST:
+        indexed.kind = SchemaIndex::Kind::LIST;
+        for (uint8_t i = 0; i < ((lllys_node_list*)node)->keys_size; i++) {
+          indexed.keys.emplace_back(((lllys_node_list*)node)->keys[i]->name);
+        }
+        break;
+      case LLLYS_LEAF:
+        indexed.kind = SchemaIndex::Kind::LEAF;
+        indexed.types = resolveType(((lllys_node_leaf*)node)->type);
+        break;
+      case LLLYS_LEAFLIST:
+        indexed.kind = SchemaIndex::Kind::LEAFLIST;
+        indexed.types = resolveType(((lllys_node_leaflist*)node)->type);
+        break;
+      default:
+        // RPCs, notifications and anydata have no place in the datastores
+        continue;
+    }
+    indexed.config = (node->flags & LLLYS_CONFIG_W) != 0;
+
+    string path = parentPath + "/" + lllys_node_module(node)->name + ":" +
+        node->name;
+    if (node->nodetype == LLLYS_CONTAINER or node->nodetype == LLLYS_LIST) {
+      collectNodes(node, nullptr, path, nodes);
+    }
+    nodes.emplace_back(std::move(path), std::move(indexed));
+  }
+}
+
+SchemaIndex::SchemaIndex(folly::MemoryMapping&& _mapping)
+    : mapping(std::move(_mapping)) {
+  data = mapping->range();
+}
+
+SchemaIndex::SchemaIndex(string&& _buffer) : buffer(std::move(_buffer)) {
+  data = folly::ByteRange(StringPiece(buffer));
+}
+
+std::unique_ptr<SchemaIndex> SchemaIndex::load(const string& file, Hash hash) {
+  struct stat st {};
+  if (::stat(file.c_str(), &st) != 0 or st.st_size == 0) {
+    return nullptr;
+  }
+
+  std::unique_ptr<SchemaIndex> index;
+  try {
+    index.reset(new SchemaIndex(folly::MemoryMapping(file.c_str())));
+  } catch (const std::exception& e) {
+    MLOG(MWARNING) << "Unable to map schema index " << file << ": "
+                   << e.what();
+    return nullptr;
+  }
+
+  if (not index->isValid(hash)) {
+    MLOG(MINFO) << "Schema index " << file << " is out of date";
+    return nullptr;
+  }
+  return index;
+}
+
+std::unique_ptr<SchemaIndex> SchemaIndex::build(llly_ctx* ctx, Hash hash) {
+  static_assert(sizeof(Header) == 32, "Unexpected header padding");
+  static_assert(sizeof(Record) == 28, "Unexpected record padding");
+
+  IndexedNodes nodes;
+  uint32_t moduleIndex = 0;
+  const lllys_module* module;
+  while ((module = llly_ctx_get_module_iter(ctx, &moduleIndex)) != nullptr) {
+    if (module->implemented) {
+      collectNodes(nullptr, module, "", nodes);
+    }
+  }
+  std::sort(nodes.begin(), nodes.end(), [](auto& lhs, auto& rhs) {
+    return lhs.first < rhs.first;
+  });
+  // Augments of the same target by several modules would collide, the
+  // first one wins
+  nodes.erase(
+      std::unique(
+          nodes.begin(),
+          nodes.end(),
+          [](auto& lhs, auto& rhs) { return lhs.first == rhs.first; }),
+      nodes.end());
+
+  Header header{};
+  std::memcpy(header.magic, indexMagic, sizeof(indexMagic));
+  header.version = indexVersion;
+  header.recordCount = static_cast<uint32_t>(nodes.size());
+  header.hash[0] = hash[0];
+  header.hash[1] = hash[1];
+
+  vector<Record> records;
+  records.reserve(nodes.size());
+  string strings;
+  auto addString = [&strings](StringPiece str, uint32_t& offset,
+                              uint32_t& length) {
+    offset = static_cast<uint32_t>(strings.size());
+    length = static_cast<uint32_t>(str.size());
+    strings.append(str.data(), str.size());
+  };
+  for (auto& node : nodes) {
+    Record record{};
+    addString(node.first, record.pathOffset, record.pathLength);
+    addString(
+        folly::join(' ', node.second.keys),
+        record.keysOffset,
+        record.keysLength);
+    string types;
+    for (auto type : node.second.types) {
+      types += static_cast<char>(type);
+    }
+    addString(types, record.typesOffset, record.typesLength);
+    record.kind = static_cast<uint8_t>(node.second.kind);
+    record.config = node.second.config;
+    records.push_back(record);
+  }
+
+  string buffer(reinterpret_cast<const char*>(&header), sizeof(header));
+  buffer.append(
+      reinterpret_cast<const char*>(records.data()),
+      records.size() * sizeof(Record));
+  buffer.append(strings);
+  return std::unique_ptr<SchemaIndex>(new SchemaIndex(std::move(buffer)));
+}
+
+SchemaIndex::Hash SchemaIndex::hashModelDir(const string& dir) {
+  vector<boost::filesystem::path> files;
+  for (auto& entry : boost::filesystem::directory_iterator(dir)) {
+    if (boost::filesystem::is_regular_file(entry) and
+        entry.path().extension() == ".yang") {
+      files.push_back(entry.path());
+    }
+  }
+  // Directory order is arbitrary, the hash must not be
+  std::sort(files.begin(), files.end());
+
+  folly::hash::SpookyHashV2 spooky;
+  spooky.Init(indexVersion, indexVersion);
+  string contents;
+  for (auto& file : files) {
+    auto name = file.filename().string();
+    spooky.Update(name.data(), name.size() + 1);
+    if (not folly::readFile(file.c_str(), contents)) {
+      throw boost::filesystem::filesystem_error(
+          "Unable to read model",
+          file,
+          boost::system::error_code(errno, boost::system::generic_category()));
+    }
+    spooky.Update(contents.data(), contents.size());
+  }
+
+  Hash hash{};
+  spooky.Final(&hash[0], &hash[1]);
+  return hash;
+}
+
+bool SchemaIndex::save(const string& file) const {
+  auto dir = boost::filesystem::path(file).parent_path();
+  boost::system::error_code dirError;
+  if (not dir.empty() and
+      not boost::filesystem::create_directories(dir, dirError) and dirError) {
+    MLOG(MWARNING) << "Unable to create schema index directory " << dir
+                   << ": " << dirError.message();
+    return false;
+  }
+
+  auto tmpFile = file + ".tmp";
+  int fd = ::open(tmpFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  bool written = fd >= 0 and
+      folly::writeFull(fd, data.data(), data.size()) ==
+          static_cast<ssize_t>(data.size()) and
+      ::fdatasync(fd) == 0;
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  if (not written or ::rename(tmpFile.c_str(), file.c_str()) != 0) {
+    auto err = std::system_error(errno, std::generic_category());
+    MLOG(MWARNING) << "Unable to save schema index " << file << ": "
+                   << err.what();
+    ::unlink(tmpFile.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool SchemaIndex::isValid(Hash hash) const {
+  if (data.size() < sizeof(Header)) {
+    return false;
+  }
+  auto& header = getHeader();
+  if (std::memcmp(header.magic, indexMagic, sizeof(indexMagic)) != 0 or
+      header.version != indexVersion or header.hash[0] != hash[0] or
+      header.hash[1] != hash[1]) {
+    return false;
+  }
+
+  size_t recordsEnd =
+      sizeof(Header) + size_t{header.recordCount} * sizeof(Record);
+  if (data.size() < recordsEnd) {
+    return false;
+  }
+  // A truncated or otherwise damaged file must not send lookups out of bounds
+  size_t stringsSize = data.size() - recordsEnd;
+  auto inBounds = [stringsSize](uint32_t offset, uint32_t length) {
+    return size_t{offset} + length <= stringsSize;
+  };
+  const Record* records = getRecords();
+  for (uint32_t i = 0; i < header.recordCount; i++) {
+    auto& record = records[i];
+    if (not inBounds(record.pathOffset, record.pathLength) or
+        not inBounds(record.keysOffset, record.keysLength) or
+        not inBounds(record.typesOffset, record.typesLength) or
+        record.kind > static_cast<uint8_t>(Kind::LEAFLIST)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const SchemaIndex::Header& SchemaIndex::getHeader() const {
+  return *reinterpret_cast<const Header*>(data.data());
+}
+
+const SchemaIndex::Record* SchemaIndex::getRecords() const {
+  return reinterpret_cast<const Record*>(data.data() + sizeof(Header));
+}
+
+StringPiece SchemaIndex::getString(uint32_t offset, uint32_t length) const {
+  auto strings = data.data() + sizeof(Header) + size() * sizeof(Record);
+  return StringPiece(
+      reinterpret_cast<const char*>(strings) + offset, size_t{length});
+}
+
+folly::Optional<SchemaIndex::Node> SchemaIndex::find(StringPiece path) const {
+  const Record* begin = getRecords();
+  const Record* end = begin + size();
+  auto it = std::lower_bound(
+      begin, end, path, [this](const Record& record, StringPiece value) {
+        return getString(record.pathOffset, record.pathLength) < value;
+      });
+  if (it == end or getString(it->pathOffset, it->pathLength) != path) {
+    return folly::none;
+  }
+
+  Node node{};
+  node.kind = static_cast<Kind>(it->kind);
+  node.config = it->config != 0;
+  auto keys = getString(it->keysOffset, it->keysLength);
+  if (not keys.empty()) {
+    folly::split(' ', keys, node.keys);
+  }
+  for (char type : getString(it->typesOffset, it->typesLength)) {
+    node.types.push_back(
+        static_cast<LLLY_DATA_TYPE>(static_cast<unsigned char>(type)));
+  }
+  return node;
+}
+
+size_t SchemaIndex::size() const {
+  return getHeader().recordCount;
+}
+
+} // namespace devmand::devices::cli
@@ -0,0 +1,87 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#pragma once
+
+#define LOG_WITH_GLOG
+#include <magma_logging.h>
+
+#include <folly/Optional.h>
+#include <folly/Range.h>
+#include <folly/system/MemoryMapping.h>
+#include <libyang/libyang.h>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace devmand::devices::cli {
+
+using std::string;
+using std::vector;
+
+/*
+ * A compiled index of every data node in a set of YANG models, keyed by the
+ * node's unkeyed, fully prefixed path. The index is built once from a
+ * libyang context, saved, and mapped straight from disk on later starts so
+ * that schema lookups need neither the models parsed nor libyang's path
+ * resolution.
+ *
+ * The file is a header, records sorted by path for binary search, and a blob
+ * of the strings the records point into. It is only used when its version
+ * and the content hash of the model directory it was built from match.
+ */
+class SchemaIndex {
+ public:
+  using Hash = std::array<uint64_t, 2>;
+
+  enum class Kind : uint8_t { CONTAINER, LIST, LEAF, LEAFLIST };
+
+  struct Node {
+    Kind kind;
+    bool config;
+    vector<string> keys;
+    vector<LLLY_DATA_TYPE> types;
+  };
+
+  ~SchemaIndex() = default;
+  SchemaIndex(const SchemaIndex&) = delete;
+  SchemaIndex& operator=(const SchemaIndex&) = delete;
+  SchemaIndex(SchemaIndex&&) = delete;
+  SchemaIndex& operator=(SchemaIndex&&) = delete;
+
+  // Returns nullptr if there is no usable index in the file
+  static std::unique_ptr<SchemaIndex> load(const string& file, Hash hash);
+  static std::unique_ptr<SchemaIndex> build(llly_ctx* ctx, Hash hash);
+
+  // Hash of the names and contents of all .yang files in a directory
+  static Hash hashModelDir(const string& dir);
+
+  // Written to a temporary file first so readers never see a partial index
+  bool save(const string& file) const;
+
+  folly::Optional<Node> find(folly::StringPiece path) const;
+  size_t size() const;
+
+ private:
+  struct Header;
+  struct Record;
+
+  SchemaIndex(folly::MemoryMapping&& _mapping);
+  SchemaIndex(string&& _buffer);
+
+  bool isValid(Hash hash) const;
+  const Header& getHeader() const;
+  const Record* getRecords() const;
+  folly::StringPiece getString(uint32_t offset, uint32_t length) const;
+
+  folly::Optional<folly::MemoryMapping> mapping;
+  string buffer;
+  folly::ByteRange data;
+};
+
+} // namespace devmand::devices::cli
@@ -13,35 +13,48 @@ namespace cli {
 
 // TODO: reconnect, error handling - connection issues, wrong services
 // provided etc
-GrpcCliHandler::GrpcCliHandler(const string _id, shared_ptr<Executor> _executor)
-    : id(_id), executor(_executor) {}
+GrpcCliHandler::GrpcCliHandler(
+    const string _id,
+    shared_ptr<Executor> _executor,
+    shared_ptr<GrpcCompletionQueue> _completionQueue)
+    : id(_id),
+      executor(_executor),
+      completionQueue(
+          _completionQueue != nullptr ? _completionQueue
+                                      : make_shared<GrpcCompletionQueue>(_id)) {
+}
 
-CliResponse* GrpcCliHandler::handleCliRequest(
-    const DeviceAccess& device,
+Future<CliResponse> GrpcCliHandler::handleCliRequest(
+    shared_ptr<Cli> cli,
     const CliRequest& cliRequest,
     bool writingAllowed) const {
   if (not writingAllowed && cliRequest.write()) {
     MLOG(MWARNING) << "[" << id << "] "
                    << "Plugin requested to write command which is forbidden: "
                    << cliRequest.cmd();
-    throw runtime_error("Forbidden to execute write commands");
+    return makeFuture<CliResponse>(
+        runtime_error("Forbidden to execute write commands"));
   }
-  string cliOutput;
+  SemiFuture<string> cliOutput = makeSemiFuture(string());
   if (cliRequest.write()) {
     const WriteCommand& command = WriteCommand::create(cliRequest.cmd());
     MLOG(MDEBUG) << "[" << id << "] "
                  << "Got cli request: " << command;
-    cliOutput = device.cli()->executeWrite(command).via(executor.get()).get();
+    cliOutput = cli->executeWrite(command);
   } else {
     const ReadCommand& command = ReadCommand::create(cliRequest.cmd());
     MLOG(MDEBUG) << "[" << id << "] "
                  << "Got cli request: " << command;
-    cliOutput = device.cli()->executeRead(command).via(executor.get()).get();
+    cliOutput = cli->executeRead(command);
   }
-  CliResponse* cliResponse = new CliResponse();
-  cliResponse->set_output(cliOutput);
-  cliResponse->set_id(cliRequest.id());
-  return cliResponse;
+  return move(cliOutput)
+      .via(executor.get())
+      .thenValue([requestId = cliRequest.id()](string output) {
+        CliResponse cliResponse;
+        cliResponse.set_output(move(output));
+        cliResponse.set_id(requestId);
+        return cliResponse;
+      });
 }
 
 } // namespace cli
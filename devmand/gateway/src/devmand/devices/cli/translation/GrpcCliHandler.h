@@ -10,9 +10,13 @@
 #include <devmand/channels/cli/plugin/protocpp/Common.pb.h>
 #include <devmand/channels/cli/plugin/protocpp/ReaderPlugin.grpc.pb.h>
 #include <devmand/devices/cli/translation/DeviceAccess.h>
+#include <devmand/devices/cli/translation/GrpcCompletionQueue.h>
 #include <folly/Executor.h>
+#include <folly/futures/Future.h>
 #include <grpc++/grpc++.h>
 #include <chrono>
+#include <memory>
+#include <mutex>
 
 namespace devmand {
 namespace devices {
@@ -27,88 +31,185 @@ using namespace std::chrono;
 
 typedef high_resolution_clock clock;
 
-class GrpcCliHandler {
+/*
+ * Handlers must be owned by a shared_ptr: every RPC in progress keeps its
+ * handler alive until the RPC completes.
+ */
+class GrpcCliHandler : public enable_shared_from_this<GrpcCliHandler> {
  protected:
   const string id;
 
  private:
   shared_ptr<Executor> executor;
+  shared_ptr<GrpcCompletionQueue> completionQueue;
+
+  // State of a single RPC, shared by callbacks of its async operations
+  template <class RequestClass, class ResponseClass>
+  struct Call {
+    ClientContext context;
+    // guards stream until the call is started, see finish
+    mutex startMutex;
+    unique_ptr<ClientAsyncReaderWriter<RequestClass, ResponseClass>> stream;
+    RequestClass request;
+    ResponseClass response;
+    Status status;
+    Promise<ResponseClass> promise;
+    shared_ptr<Cli> cli;
+    clock::time_point startTime = clock::now();
+    long int spentInCliMillis = 0;
+    bool writingAllowed = false;
+    bool failed = false;
+  };
 
  public:
-  GrpcCliHandler(const string _id, shared_ptr<Executor> _executor);
+  GrpcCliHandler(
+      const string _id,
+      shared_ptr<Executor> _executor,
+      // shared by handlers of one plugin, own queue is created if null
+      shared_ptr<GrpcCompletionQueue> _completionQueue = nullptr);
 
  private:
-  // Handle single cli request, writing response back
-  CliResponse* handleCliRequest(
-      const DeviceAccess& device,
+  // Handle single cli request, producing response to write back
+  Future<CliResponse> handleCliRequest(
+      shared_ptr<Cli> cli,
       const CliRequest& cliRequest,
       bool writingAllowed) const;
 
-  // Loop while remote plugin sends CLI requests, exit when final response is
-  // received
   template <class RequestClass, class ResponseClass>
-  long handleCliRequests(
-      const DeviceAccess& device,
-      ClientReaderWriter<RequestClass, ResponseClass>* stream,
-      ResponseClass* response,
-      bool writingAllowed) const {
-    long int spentInCliMillis = 0;
-    while (stream->Read(response) && response->has_clirequest()) {
-      auto cliStartTime = clock::now();
-      CliResponse* cliResponse =
-          handleCliRequest(device, response->clirequest(), writingAllowed);
-      RequestClass nextRequest;
-      nextRequest.set_allocated_cliresponse(cliResponse);
-      spentInCliMillis +=
-          (duration_cast<milliseconds>(clock::now() - cliStartTime)).count();
-      stream->Write(nextRequest);
+  void write(shared_ptr<Call<RequestClass, ResponseClass>> call) const {
+    call->stream->Write(
+        call->request,
+        completionQueue->tag([self = shared_from_this(), call](bool ok) {
+          if (ok) {
+            self->readNext(call);
+          } else {
+            self->finishCall(call);
+          }
+        }));
+  }
+
+  // Read next message from remote plugin. While it sends CLI requests, execute
+  // them and write responses back, finish the call once final response is
+  // received.
+  template <class RequestClass, class ResponseClass>
+  void readNext(shared_ptr<Call<RequestClass, ResponseClass>> call) const {
+    call->stream->Read(
+        &call->response,
+        completionQueue->tag([self = shared_from_this(), call](bool ok) {
+          if (not ok or not call->response.has_clirequest()) {
+            // final response is in `response`
+            self->finishCall(call);
+            return;
+          }
+          auto cliStartTime = clock::now();
+          self->handleCliRequest(
+                  call->cli,
+                  call->response.clirequest(),
+                  call->writingAllowed)
+              .via(self->executor.get())
+              .thenTry([self, call, cliStartTime](Try<CliResponse> t) {
+                if (t.hasException()) {
+                  self->failCall(call, t.exception());
+                  return;
+                }
+                call->spentInCliMillis +=
+                    (duration_cast<milliseconds>(clock::now() - cliStartTime))
+                        .count();
+                call->request = RequestClass();
+                *call->request.mutable_cliresponse() = move(t.value());
+                self->write(call);
+              });
+        }));
+  }
+
+  // Cancel the RPC after a local failure, the plugin cannot continue without
+  // output of the CLI command it requested
+  template <class RequestClass, class ResponseClass>
+  void failCall(
+      shared_ptr<Call<RequestClass, ResponseClass>> call,
+      exception_wrapper e) const {
+    MLOG(MWARNING) << "[" << id << "] CLI request failed: " << e.what();
+    call->failed = true;
+    call->promise.setException(e);
+    call->context.TryCancel();
+    finishCall(call);
+  }
+
+  template <class RequestClass, class ResponseClass>
+  void finishCall(shared_ptr<Call<RequestClass, ResponseClass>> call) const {
+    if (completionQueue->isShutdown()) {
+      if (not call->failed) {
+        call->promise.setException(runtime_error("Plugin is shutting down"));
+      }
+      return;
     }
-    // final response is in `response`
-    return spentInCliMillis;
+    call->stream->Finish(
+        &call->status,
+        completionQueue->tag([self = shared_from_this(), call](bool) {
+          auto totalMillis =
+              (duration_cast<milliseconds>(clock::now() - call->startTime))
+                  .count();
+          MLOG(MDEBUG) << "[" << self->id << "] Total duration: "
+                       << totalMillis << " ms, "
+                       << "in grpc: " << (totalMillis - call->spentInCliMillis)
+                       << " ms, "
+                       << "in cli " << call->spentInCliMillis << " ms";
+          if (call->failed) {
+            return;
+          }
+          if (call->status.ok()) {
+            call->promise.setValue(move(call->response));
+          } else {
+            MLOG(MWARNING) << "[" << self->id << "] Error "
+                           << call->status.error_code() << ": "
+                           << call->status.error_message();
+            call->promise.setException(runtime_error("RPC failed"));
+          }
+        }));
   }
 
  protected:
   // Do the actual RPC request, handle Cli requests and transform final response
-  // using closure resultTransformer.
+  // using closure resultTransformer. Nothing blocks while the plugin or the
+  // device is working, all RPCs of a plugin are driven by its completion queue.
+  // Write commands requested by the plugin fail the call unless writingAllowed.
   template <class RequestClass, class ResponseClass, class ResultClass>
   Future<ResultClass> finish(
       RequestClass request,
       const DeviceAccess& device,
-      function<unique_ptr<ClientReaderWriter<RequestClass, ResponseClass>>(
-          ClientContext*)> rpc,
+      bool writingAllowed,
+      function<unique_ptr<ClientAsyncReaderWriter<RequestClass, ResponseClass>>(
+          ClientContext*,
+          CompletionQueue*,
+          void*)> rpc,
       function<Future<ResultClass>(ResponseClass)> resultTransformer) const {
-    auto startTime = clock::now();
-    ClientContext context;
-    unique_ptr<ClientReaderWriter<RequestClass, ResponseClass>> stream(
-        rpc(&context)); // TODO async
-
-    if (not stream) {
-      MLOG(MWARNING) << "[" << id << "] Cannot connect";
-      return makeFuture<ResultClass>(runtime_error("Cannot connect"));
-    }
-
-    // send the request
-    stream->Write(request);
-
-    // start reading responses
-    ResponseClass response;
-    long spentInCliMillis = handleCliRequests<RequestClass, ResponseClass>(
-        device, stream.get(), &response, true);
-
-    auto totalMillis =
-        (duration_cast<milliseconds>(clock::now() - startTime)).count();
-    MLOG(MDEBUG) << "[" << id << "] Total duration: " << totalMillis << " ms, "
-                 << "in grpc: " << (totalMillis - spentInCliMillis) << " ms, "
-                 << "in cli " << spentInCliMillis << " ms";
-    Status status = stream->Finish();
-
-    if (status.ok()) {
-      return resultTransformer(response);
-    } else {
-      MLOG(MWARNING) << "[" << id << "] Error " << status.error_code() << ": "
-                     << status.error_message();
-      return makeFuture<ResultClass>(runtime_error("RPC failed"));
+    auto call = make_shared<Call<RequestClass, ResponseClass>>();
+    call->request = move(request);
+    call->cli = device.cli();
+    call->writingAllowed = writingAllowed;
+    completionQueue->addCall(
+        shared_ptr<ClientContext>(call, &call->context));
+    Future<ResultClass> result = call->promise.getFuture()
+                                     .via(executor.get())
+                                     .thenValue(resultTransformer);
+    {
+      // the start tag may complete before stream is assigned
+      lock_guard<mutex> lock(call->startMutex);
+      call->stream = rpc(
+          &call->context,
+          completionQueue->get(),
+          completionQueue->tag([self = shared_from_this(), call](bool ok) {
+            lock_guard<mutex> startLock(call->startMutex);
+            if (not ok) {
+              MLOG(MWARNING) << "[" << self->id << "] Cannot connect";
+              call->promise.setException(runtime_error("Cannot connect"));
+              return;
+            }
+            // send the request, then start reading responses
+            self->write(call);
+          }));
     }
+    return result;
   }
 };
 
@@ -0,0 +1,83 @@
+// Copyright (c) 2020-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <devmand/devices/cli/translation/GrpcCompletionQueue.h>
+
+#include <algorithm>
+
+namespace devmand {
+namespace devices {
+namespace cli {
+
+GrpcCompletionQueue::GrpcCompletionQueue(const string _id)
+    : state(make_shared<State>(_id)), pump([s = state]() { run(s); }) {}
+
+GrpcCompletionQueue::~GrpcCompletionQueue() {
+  state->shutdown = true;
+  {
+    // Cancelled calls complete their pending operations with ok == false
+    lock_guard<mutex> lock(state->callsMutex);
+    for (auto& call : state->calls) {
+      if (auto context = call.lock()) {
+        context->TryCancel();
+      }
+    }
+    state->calls.clear();
+  }
+  state->queue.Shutdown();
+  if (pump.get_id() == this_thread::get_id()) {
+    // released from a callback, the pump finishes draining on its own
+    pump.detach();
+  } else {
+    pump.join();
+  }
+}
+
+void GrpcCompletionQueue::run(shared_ptr<State> state) {
+  void* tag;
+  bool ok;
+  while (state->queue.Next(&tag, &ok)) {
+    unique_ptr<function<void(bool)>> callback(
+        static_cast<function<void(bool)>*>(tag));
+    try {
+      (*callback)(ok);
+    } catch (const exception& e) {
+      MLOG(MERROR) << "[" << state->id << "] Completion callback failed: "
+                   << e.what();
+    }
+  }
+  MLOG(MDEBUG) << "[" << state->id << "] Completion queue drained";
+}
+
+grpc::CompletionQueue* GrpcCompletionQueue::get() {
+  return &state->queue;
+}
+
+bool GrpcCompletionQueue::isShutdown() const {
+  return state->shutdown;
+}
+
+void* GrpcCompletionQueue::tag(function<void(bool)> callback) {
+  return new function<void(bool)>(move(callback));
+}
+
+void GrpcCompletionQueue::addCall(weak_ptr<grpc::ClientContext> context) {
+  lock_guard<mutex> lock(state->callsMutex);
+  state->calls.erase(
+      remove_if(
+          state->calls.begin(),
+          state->calls.end(),
+          [](const weak_ptr<grpc::ClientContext>& call) {
+            return call.expired();
+          }),
+      state->calls.end());
+  state->calls.push_back(move(context));
+}
+
+} // namespace cli
+} // namespace devices
+} // namespace devmand
@@ -0,0 +1,79 @@
+// Copyright (c) 2020-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#pragma once
+
+#define LOG_WITH_GLOG
+#include <magma_logging.h>
+
+#include <grpc++/grpc++.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace devmand {
+namespace devices {
+namespace cli {
+
+using namespace std;
+
+/*
+ * Completion queue shared by all async calls to a single plugin, drained by
+ * one thread. Calls register callbacks as tags, so no thread is blocked
+ * while a plugin or a device is working on a request. Calls still in progress
+ * when the queue is destroyed are cancelled.
+ */
+class GrpcCompletionQueue {
+ private:
+  // Shared with the pump thread so that the last owner of the queue may
+  // release it from one of the queue's own callbacks
+  struct State {
+    explicit State(const string& _id) : id(_id) {}
+
+    const string id;
+    grpc::CompletionQueue queue;
+    atomic_bool shutdown{false};
+    mutex callsMutex;
+    vector<weak_ptr<grpc::ClientContext>> calls;
+  };
+
+  shared_ptr<State> state;
+  thread pump;
+
+  static void run(shared_ptr<State> state);
+
+ public:
+  explicit GrpcCompletionQueue(const string _id);
+  ~GrpcCompletionQueue();
+
+  GrpcCompletionQueue(const GrpcCompletionQueue&) = delete;
+  GrpcCompletionQueue& operator=(const GrpcCompletionQueue&) = delete;
+
+  grpc::CompletionQueue* get();
+
+  bool isShutdown() const;
+
+  /*
+   * Wrap callback into a tag for an async operation. Callback is invoked
+   * exactly once on the queue thread with the operation's ok flag, it must
+   * not block.
+   */
+  void* tag(function<void(bool)> callback);
+
+  /*
+   * Track the context of a call in progress so that it can be cancelled on
+   * shutdown. The call stops being tracked once the context expires.
+   */
+  void addCall(weak_ptr<grpc::ClientContext> context);
+};
+
+} // namespace cli
+} // namespace devices
+} // namespace devmand
@@ -20,8 +20,9 @@ using namespace devmand::channels::cli;
 GrpcListReader::GrpcListReader(
     shared_ptr<grpc::Channel> channel,
     const string _id,
-    shared_ptr<Executor> _executor)
-    : GrpcCliHandler(_id, _executor),
+    shared_ptr<Executor> _executor,
+    shared_ptr<GrpcCompletionQueue> _completionQueue)
+    : GrpcCliHandler(_id, _executor, _completionQueue),
       stub_(devmand::channels::cli::plugin::ReaderPlugin::NewStub(channel)) {}
 
 Future<vector<dynamic>> GrpcListReader::readKeys(
@@ -36,7 +37,10 @@ Future<vector<dynamic>> GrpcListReader::readKeys(
   return finish<ReadRequest, ReadResponse, vector<dynamic>>(
       request,
       device,
-      [this](auto context) { return stub_->Read(context); },
+      false,
+      [this](auto context, auto cq, auto tag) {
+        return stub_->AsyncRead(context, cq, tag);
+      },
       [this](auto response) -> vector<dynamic> {
         dynamic result = parseJson(response.actualreadresponse().json());
         if (not result.isArray()) {
@@ -31,7 +31,8 @@ class GrpcListReader : public ListReader, public GrpcCliHandler {
   GrpcListReader(
       shared_ptr<grpc::Channel> channel,
       const string id,
-      shared_ptr<Executor> executor);
+      shared_ptr<Executor> executor,
+      shared_ptr<GrpcCompletionQueue> completionQueue = nullptr);
 
   Future<vector<dynamic>> readKeys(const Path& path, const DeviceAccess& device)
       const override;
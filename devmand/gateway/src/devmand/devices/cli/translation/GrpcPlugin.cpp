@@ -49,6 +49,7 @@ GrpcPlugin::GrpcPlugin(
     : channel(_channel),
       id(_id),
       executor(_executor),
+      completionQueue(make_shared<GrpcCompletionQueue>(_id)),
       capabilities(_capabilities) {}
 
 DeviceType GrpcPlugin::getDeviceType() const {
@@ -62,13 +63,14 @@ DeviceType GrpcPlugin::getDeviceType() const {
 void GrpcPlugin::provideReaders(ReaderRegistryBuilder& registry) const {
   for (int i = 0; i < capabilities.readers_size(); i++) {
     Path path(capabilities.readers().Get(i).path());
-    auto remoteReaderPlugin = make_shared<GrpcReader>(channel, id, executor);
+    auto remoteReaderPlugin =
+        make_shared<GrpcReader>(channel, id, executor, completionQueue);
     registry.add(path, remoteReaderPlugin);
   }
   for (int i = 0; i < capabilities.listreaders_size(); i++) {
     Path path(capabilities.listreaders().Get(i).path());
     auto remoteReaderPlugin =
-        make_shared<GrpcListReader>(channel, id, executor);
+        make_shared<GrpcListReader>(channel, id, executor, completionQueue);
     registry.addList(path, remoteReaderPlugin);
   }
 }
@@ -82,7 +84,8 @@ void GrpcPlugin::provideWriters(WriterRegistryBuilder& registry) const {
          depIdx++) {
       dependencies.push_back(Path(writerCapability.dependencies(depIdx)));
     }
-    auto remoteWriterPlugin = make_shared<GrpcWriter>(channel, id, executor);
+    auto remoteWriterPlugin = make_shared<GrpcWriter>(
+        channel, id, executor, completionQueue);
     registry.add(path, remoteWriterPlugin, dependencies);
   }
 }
@@ -12,6 +12,7 @@
 
 #include <devmand/channels/cli/plugin/protocpp/PluginRegistration.pb.h>
 #include <devmand/channels/cli/plugin/protocpp/ReaderPlugin.grpc.pb.h>
+#include <devmand/devices/cli/translation/GrpcCompletionQueue.h>
 #include <devmand/devices/cli/translation/PluginRegistry.h>
 #include <grpc++/grpc++.h>
 
@@ -28,6 +29,8 @@ class GrpcPlugin : public Plugin {
   shared_ptr<grpc::Channel> channel;
   const string id;
   shared_ptr<Executor> executor;
+  // drives RPCs of all readers and writers of this plugin
+  shared_ptr<GrpcCompletionQueue> completionQueue;
   devmand::channels::cli::plugin::CapabilitiesResponse capabilities;
 
   GrpcPlugin(
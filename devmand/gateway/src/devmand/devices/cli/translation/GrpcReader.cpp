@@ -6,7 +6,6 @@
 // of patent rights can be found in the PATENTS file in the same directory.
 
 #include <devmand/devices/cli/translation/GrpcReader.h>
-// TODO make async
 
 namespace devmand {
 namespace devices {
@@ -21,8 +20,9 @@ using namespace devmand::channels::cli;
 GrpcReader::GrpcReader(
     shared_ptr<grpc::Channel> channel,
     const string _id,
-    shared_ptr<Executor> _executor)
-    : GrpcCliHandler(_id, _executor),
+    shared_ptr<Executor> _executor,
+    shared_ptr<GrpcCompletionQueue> _completionQueue)
+    : GrpcCliHandler(_id, _executor, _completionQueue),
       stub_(devmand::channels::cli::plugin::ReaderPlugin::NewStub(channel)) {}
 
 Future<dynamic> GrpcReader::read(const Path& path, const DeviceAccess& device)
@@ -36,7 +36,10 @@ Future<dynamic> GrpcReader::read(const Path& path, const DeviceAccess& device)
   return finish<ReadRequest, ReadResponse, dynamic>(
       request,
       device,
-      [this](auto context) { return stub_->Read(context); },
+      false,
+      [this](auto context, auto cq, auto tag) {
+        return stub_->AsyncRead(context, cq, tag);
+      },
       [](auto response) {
         return makeFuture(parseJson(response.actualreadresponse().json()));
       });
@@ -31,7 +31,8 @@ class GrpcReader : public Reader, public GrpcCliHandler {
   GrpcReader(
       shared_ptr<grpc::Channel> channel,
       const string id,
-      shared_ptr<Executor> executor);
+      shared_ptr<Executor> executor,
+      shared_ptr<GrpcCompletionQueue> completionQueue = nullptr);
 
   Future<dynamic> read(const Path& path, const DeviceAccess& device)
       const override;
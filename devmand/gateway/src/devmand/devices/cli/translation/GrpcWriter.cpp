@@ -6,7 +6,6 @@
 // of patent rights can be found in the PATENTS file in the same directory.
 
 #include <devmand/devices/cli/translation/GrpcWriter.h>
-// TODO: make async
 
 namespace devmand {
 namespace devices {
@@ -21,8 +20,9 @@ using namespace devmand::channels::cli;
 GrpcWriter::GrpcWriter(
     shared_ptr<grpc::Channel> channel,
     const string _id,
-    shared_ptr<Executor> _executor)
-    : GrpcCliHandler(_id, _executor),
+    shared_ptr<Executor> _executor,
+    shared_ptr<GrpcCompletionQueue> _completionQueue)
+    : GrpcCliHandler(_id, _executor, _completionQueue),
       stub_(devmand::channels::cli::plugin::WriterPlugin::NewStub(channel)) {}
 
 Future<Unit> GrpcWriter::create(
@@ -39,7 +39,10 @@ Future<Unit> GrpcWriter::create(
   return finish<CreateRequest, CreateResponse, Unit>(
       request,
       device,
-      [this](auto context) { return stub_->Create(context); },
+      true,
+      [this](auto context, auto cq, auto tag) {
+        return stub_->AsyncCreate(context, cq, tag);
+      },
       [](auto) { return Future<Unit>(); });
 }
 
@@ -59,7 +62,10 @@ Future<Unit> GrpcWriter::update(
   return finish<UpdateRequest, UpdateResponse, Unit>(
       request,
       device,
-      [this](auto context) { return stub_->Update(context); },
+      true,
+      [this](auto context, auto cq, auto tag) {
+        return stub_->AsyncUpdate(context, cq, tag);
+      },
       [](auto) { return Future<Unit>(); });
 }
 
@@ -77,7 +83,10 @@ Future<Unit> GrpcWriter::remove(
   return finish<RemoveRequest, RemoveResponse, Unit>(
       request,
       device,
-      [this](auto context) { return stub_->Remove(context); },
+      true,
+      [this](auto context, auto cq, auto tag) {
+        return stub_->AsyncRemove(context, cq, tag);
+      },
       [](auto) { return Future<Unit>(); });
 }
 
@@ -31,7 +31,8 @@ class GrpcWriter : public Writer, public GrpcCliHandler {
   GrpcWriter(
       shared_ptr<grpc::Channel> channel,
       const string id,
-      shared_ptr<Executor> executor);
+      shared_ptr<Executor> executor,
+      shared_ptr<GrpcCompletionQueue> completionQueue = nullptr);
 
   Future<Unit> create(const Path& path, dynamic cfg, const DeviceAccess& device)
       const override;
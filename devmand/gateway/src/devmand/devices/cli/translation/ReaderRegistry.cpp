@@ -24,7 +24,7 @@ Future<dynamic> CompositeReader::read(
     bool config,
     const DeviceAccess& device) const {
   if (shouldDelegate(path)) {
-    auto childName = path.unkeyed().getSegments()[registeredPath.getDepth()];
+    auto childName = path.getUnkeyedSegment(registeredPath.getDepth());
     if (children.find(childName) == children.end()) {
       return Future<dynamic>(ReadException(
           device.id(),
@@ -132,8 +132,8 @@ ostream& operator<<(ostream& os, const CompositeReader& reader) {
 }
 
 bool CompositeReader::shouldDelegate(const Path& path) const {
-  return path.unkeyed() != registeredPath &&
-      path.unkeyed().getDepth() > registeredPath.getDepth();
+  // A deeper path can't be the registered path itself
+  return path.getDepth() > registeredPath.getDepth();
 }
 
 CompositeReader::CompositeReader(
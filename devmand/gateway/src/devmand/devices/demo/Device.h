@@ -34,9 +34,11 @@ class Device : public devices::Device {
   static folly::dynamic getDemoDatastore();
 
  protected:
-  void setIntendedDatastore(const folly::dynamic& config) override {
+  folly::Future<folly::Unit> setIntendedDatastore(
+      const folly::dynamic& config) override {
     (void)config;
     LOG(ERROR) << "set config on unconfigurable device";
+    return folly::makeFuture();
   }
 };
 
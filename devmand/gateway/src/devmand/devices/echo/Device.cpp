@@ -21,14 +21,17 @@ std::shared_ptr<devices::Device> Device::createDevice(
 Device::Device(Application& application, const Id& id_, bool readonly_)
     : devices::Device(application, id_, readonly_) {}
 
-void Device::setIntendedDatastore(const folly::dynamic& config) {
-  state = config;
+folly::Future<folly::Unit> Device::setIntendedDatastore(
+    const folly::dynamic& config) {
+  *state.wlock() = config;
+  return folly::makeFuture();
 }
 
 std::shared_ptr<Datastore> Device::getOperationalDatastore() {
   auto stateCopy =
       Datastore::make(*reinterpret_cast<MetricSink*>(&app), getId());
-  stateCopy->update([this](auto& lockedDatastore) { lockedDatastore = state; });
+  stateCopy->update(
+      [this](auto& lockedDatastore) { lockedDatastore = *state.rlock(); });
   return stateCopy;
 }
 
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <folly/Synchronized.h>
+
 #include <devmand/devices/Device.h>
 
 namespace devmand {
@@ -32,10 +34,12 @@ class Device : public devices::Device {
   std::shared_ptr<Datastore> getOperationalDatastore() override;
 
  protected:
-  void setIntendedDatastore(const folly::dynamic& config) override;
+  folly::Future<folly::Unit> setIntendedDatastore(
+      const folly::dynamic& config) override;
 
  private:
-  folly::dynamic state;
+  // Set by a config apply worker and read by polls.
+  folly::Synchronized<folly::dynamic> state;
 };
 
 } // namespace echo
@@ -8,6 +8,7 @@
 #include <devmand/devices/frinx/Device.h>
 
 #include <iostream>
+#include <stdexcept>
 
 #include <folly/dynamic.h>
 #include <folly/json.h>
@@ -87,7 +88,7 @@ Device::Device(
     const std::string& deviceUsername_,
     const std::string& devicePassword_)
     : devices::Device(application, id_, readonly_),
-      channel(controllerHost, controllerPort),
+      channel(application.getHttpEngine(), controllerHost, controllerPort),
       headers({{"Authorization", authorization_},
                {"Accept", contentTypeJson},
                {"Content-Type", contentTypeJson}}),
@@ -160,7 +161,8 @@ void Device::checkConnection() {
       }));
 }
 
-void Device::setIntendedDatastore(const folly::dynamic& config) {
+folly::Future<folly::Unit> Device::setIntendedDatastore(
+    const folly::dynamic& config) {
   auto ep = folly::sformat(setRunningDatastoreEpTemplate, deviceId);
   folly::dynamic yang{folly::dynamic::object};
   const folly::dynamic* ints{nullptr};
@@ -168,7 +170,13 @@ void Device::setIntendedDatastore(const folly::dynamic& config) {
       (ints = config.get_ptr("openconfig-interfaces:interfaces")) != nullptr) {
     yang["frinx-openconfig-interfaces:interfaces"] = *ints;
   }
-  channel.asyncPut(headers, ep, folly::toJson(yang), contentTypeJson);
+  return channel.asyncPut(headers, ep, folly::toJson(yang), contentTypeJson)
+      .thenValue([ep](channels::http::Response response) {
+        if (response.isError()) {
+          throw std::runtime_error(
+              folly::sformat(errorTemplate, ep, response.get()));
+        }
+      });
 }
 
 std::shared_ptr<Datastore> Device::getOperationalDatastore() {
@@ -53,7 +53,8 @@ class Device : public devices::Device {
   std::shared_ptr<Datastore> getOperationalDatastore() override;
 
  protected:
-  void setIntendedDatastore(const folly::dynamic& config) override;
+  folly::Future<folly::Unit> setIntendedDatastore(
+      const folly::dynamic& config) override;
 
  private:
   void connect();
@@ -62,7 +63,7 @@ class Device : public devices::Device {
  private:
   channels::http::Channel channel;
   bool connected{false};
-  httplib::Headers headers;
+  channels::http::Headers headers;
 
   folly::IPAddress deviceIp;
   int devicePort;
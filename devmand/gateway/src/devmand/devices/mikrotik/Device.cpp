@@ -7,7 +7,13 @@
 
 #include <devmand/devices/mikrotik/Device.h>
 
+#include <stdexcept>
+
+#include <folly/Conv.h>
+#include <folly/Format.h>
+
 #include <devmand/Application.h>
+#include <devmand/Config.h>
 #include <devmand/devices/mikrotik/Mib.h>
 #include <devmand/models/device/Model.h>
 #include <devmand/models/wifi/Model.h>
@@ -19,6 +25,18 @@ namespace mikrotik {
 
 static constexpr const unsigned short mikrotikPort = 8728;
 
+using Counter = models::interface::Table::Counter;
+
+// The counters the router streams and the /interface properties they are.
+static const std::map<Counter, std::string> streamedCounters{
+    {Counter::IN_OCTETS, "rx-byte"},
+    {Counter::OUT_OCTETS, "tx-byte"},
+    {Counter::IN_DISCARDS, "rx-drop"},
+    {Counter::OUT_DISCARDS, "tx-drop"},
+    {Counter::IN_ERRORS, "rx-error"},
+    {Counter::OUT_ERRORS, "tx-error"},
+};
+
 std::shared_ptr<devices::Device> Device::createDevice(
     Application& app,
     const cartography::DeviceConfig& deviceConfig) {
@@ -67,9 +85,108 @@ Device::Device(
           folly::SocketAddress(_ip, mikrotikPort),
           _username,
           _password)) {
+  // The router pushes the counters every poll interval over the one API
+  // connection instead of them being walked over SNMP on every poll.
+  std::vector<std::string> proplist{".id", "name"};
+  for (auto& counter : streamedCounters) {
+    proplist.emplace_back(counter.second);
+  }
+  statsTag = mikrotikCh->subscribe(
+      {"/interface/print",
+       "=stats=",
+       folly::to<std::string>("=interval=", FLAGS_poll_interval)},
+      proplist,
+      [weakStats = std::weak_ptr<folly::Synchronized<Stats>>(stats)](
+          const channels::mikrotik::Sentence& sentence) {
+        if (auto shared = weakStats.lock()) {
+          updateStats(*shared->wlock(), sentence);
+        }
+      });
   mikrotikCh->connect();
 }
 
+Device::~Device() {
+  mikrotikCh->unsubscribe(statsTag);
+}
+
+void Device::updateStats(
+    Stats& stats,
+    const channels::mikrotik::Sentence& sentence) {
+  const auto& type = sentence.front();
+  if (type == "!re") {
+    auto attributes = channels::mikrotik::Channel::getAttributes(sentence);
+    auto id = attributes.find(".id");
+    if (id == attributes.end()) {
+      return;
+    }
+    if (attributes.count(".dead") != 0) {
+      stats.interfaces.erase(id->second);
+    } else {
+      // Updates only carry what changed.
+      for (auto& attribute : attributes) {
+        stats.interfaces[id->second][attribute.first] = attribute.second;
+      }
+    }
+    stats.lastUpdate = utils::Time::now();
+  } else if (type == "!trap" or type == "!done") {
+    LOG(ERROR) << "interface stats stream stopped: "
+               << channels::mikrotik::Channel::getAttributes(
+                      sentence)["message"];
+    stats.failed = true;
+  }
+}
+
+bool Device::isLive(const Stats& stats) {
+  return not stats.failed and not stats.interfaces.empty() and
+      utils::Time::now() - stats.lastUpdate <
+      std::chrono::seconds(2 * FLAGS_poll_interval);
+}
+
+bool Device::isCounterPolled(Counter counter) const {
+  return streamedCounters.count(counter) == 0 or not isLive(*stats->rlock());
+}
+
+void Device::completeInterfaces(
+    models::interface::Table& table,
+    Datastore& state) {
+  auto locked = stats->rlock();
+  if (not isLive(*locked)) {
+    return;
+  }
+
+  std::map<std::string, const channels::mikrotik::Attributes*> byName;
+  for (auto& interface : locked->interfaces) {
+    auto name = interface.second.find("name");
+    if (name != interface.second.end()) {
+      byName.emplace(name->second, &interface.second);
+    }
+  }
+
+  for (auto& interface : table) {
+    if (not interface.name.hasValue()) {
+      continue;
+    }
+    auto streamed = byName.find(*interface.name);
+    if (streamed == byName.end()) {
+      continue;
+    }
+    auto index = folly::to<std::string>(interface.index);
+    for (auto& counter : streamedCounters) {
+      auto property = streamed->second->find(counter.second);
+      if (property == streamed->second->end()) {
+        continue;
+      }
+      auto value = folly::tryTo<uint64_t>(property->second);
+      if (not value.hasValue()) {
+        continue;
+      }
+      interface.setCounter(counter.first, *value);
+      state.setGauge(
+          getCounterFamily(counter.first), index, static_cast<double>(*value));
+    }
+  }
+}
+
 std::shared_ptr<Datastore> Device::getOperationalDatastore() {
   auto state = snmpv2::Device::getOperationalDatastore();
 
@@ -311,18 +428,22 @@ std::shared_ptr<Datastore> Device::getOperationalDatastore() {
 }
 
 // TODO convert the device to have the concept of an intended config
-void Device::setIntendedDatastore(const folly::dynamic& config) {
+folly::Future<folly::Unit> Device::setIntendedDatastore(
+    const folly::dynamic& config) {
+  // Copied out as the polls replace it while this runs on an apply worker.
   auto oldInterfaces = YangUtils::lookup(
-      operationalDatastore, "openconfig-interfaces:interfaces/interface");
+      *operationalDatastore.rlock(),
+      "openconfig-interfaces:interfaces/interface");
   auto newInterfaces =
       YangUtils::lookup(config, "openconfig-interfaces:interfaces/interface");
 
   // TODO eh, this is very inefficient but this will go away once we switch
   // to a crud engine so its not worth making it better.
   if (newInterfaces == nullptr) {
-    return;
+    return folly::makeFuture();
   }
 
+  std::vector<channels::mikrotik::Sentence> sentences;
   for (auto& interface : newInterfaces) {
     folly::dynamic state;
     if (oldInterfaces != nullptr) {
@@ -349,16 +470,37 @@ void Device::setIntendedDatastore(const folly::dynamic& config) {
     if (enabled != nullptr and enabled.isBool()) {
       bool isEnabled = enabled.asBool();
       if (isEnabled and not isUp) {
-        mikrotikCh->writeSentence(
+        sentences.push_back(
             {"/interface/enable", "=numbers=" + interface["name"].asString()});
         LOG(INFO) << "Interface up " << interface["name"];
       } else if (not isEnabled and isUp) {
-        mikrotikCh->writeSentence(
+        sentences.push_back(
             {"/interface/disable", "=numbers=" + interface["name"].asString()});
         LOG(INFO) << "Interface down " << interface["name"];
       }
     }
   }
+
+  std::vector<folly::Future<channels::mikrotik::Reply>> replies;
+  for (auto& sentence : sentences) {
+    replies.emplace_back(mikrotikCh->query(sentence));
+  }
+  // Fails if the connection is lost or the router rejects a command, so that
+  // the config is applied again.
+  return folly::collect(std::move(replies))
+      .thenValue([id = getId()](std::vector<channels::mikrotik::Reply> all) {
+        for (auto& reply : all) {
+          for (auto& sentence : reply) {
+            if (not sentence.empty() and sentence.front() == "!trap") {
+              throw std::runtime_error(folly::sformat(
+                  "{} rejected the config: {}",
+                  id,
+                  channels::mikrotik::Channel::getAttributes(
+                      sentence)["message"]));
+            }
+          }
+        }
+      });
 }
 
 } // namespace mikrotik
@@ -7,9 +7,16 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <string>
+
+#include <folly/Synchronized.h>
+
 #include <devmand/devices/snmpv2/Device.h>
 
 #include <devmand/channels/mikrotik/Channel.h>
+#include <devmand/utils/Time.h>
 
 namespace devmand {
 namespace devices {
@@ -33,7 +40,7 @@ class Device : public snmpv2::Device {
       oid proto[] = {});
 
   Device() = delete;
-  virtual ~Device() = default;
+  ~Device() override;
   Device(const Device&) = delete;
   Device& operator=(const Device&) = delete;
   Device(Device&&) = delete;
@@ -47,10 +54,34 @@ class Device : public snmpv2::Device {
   std::shared_ptr<Datastore> getOperationalDatastore() override;
 
  protected:
-  void setIntendedDatastore(const folly::dynamic& config) override;
+  folly::Future<folly::Unit> setIntendedDatastore(
+      const folly::dynamic& config) override;
+
+  bool isCounterPolled(
+      models::interface::Table::Counter counter) const override;
+  void completeInterfaces(models::interface::Table& table, Datastore& state)
+      override;
+
+ private:
+  // What the router last streamed of each interface, by .id.
+  struct Stats {
+    std::map<std::string, channels::mikrotik::Attributes> interfaces;
+    utils::TimePoint lastUpdate;
+    bool failed{false};
+  };
+
+  static void updateStats(
+      Stats& stats,
+      const channels::mikrotik::Sentence& sentence);
+
+  // Whether the streamed stats are recent enough to stand in for a poll.
+  static bool isLive(const Stats& stats);
 
  private:
   std::shared_ptr<channels::mikrotik::Channel> mikrotikCh;
+  std::shared_ptr<folly::Synchronized<Stats>> stats{
+      std::make_shared<folly::Synchronized<Stats>>()};
+  channels::mikrotik::Tag statsTag{0};
 };
 
 } // namespace mikrotik
@@ -51,10 +51,10 @@ std::shared_ptr<Datastore> Device::getOperationalDatastore() {
           lockedState, "ping", "agent", "device", rtt);
     });
 
-    state->setGauge<unsigned long int>(
+    static const auto& pingRtt = MetricFamily::get(
         "/fbc-symphony-device:system/latencies/"
-        "latency[type=ping and src=agent and dst=device]/rtt",
-        rtt);
+        "latency[type=ping and src=agent and dst=device]/rtt");
+    state->setGauge(pingRtt, static_cast<double>(rtt));
   }));
   return state;
 }
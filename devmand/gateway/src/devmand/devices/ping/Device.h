@@ -36,9 +36,11 @@ class Device : public devices::Device {
   std::shared_ptr<Datastore> getOperationalDatastore() override;
 
  protected:
-  void setIntendedDatastore(const folly::dynamic& config) override {
+  folly::Future<folly::Unit> setIntendedDatastore(
+      const folly::dynamic& config) override {
     (void)config;
     LOG(ERROR) << "set config on unconfigurable device";
+    return folly::makeFuture();
   }
 
  protected:
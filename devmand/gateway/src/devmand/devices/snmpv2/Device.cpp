@@ -8,6 +8,7 @@
 #include <iostream>
 #include <stdexcept>
 
+#include <folly/Conv.h>
 #include <folly/Format.h>
 
 #include <devmand/Application.h>
@@ -15,7 +16,6 @@
 #include <devmand/devices/Datastore.h>
 #include <devmand/devices/snmpv2/Device.h>
 #include <devmand/error/ErrorHandler.h>
-#include <devmand/models/interface/Model.h>
 
 namespace devmand {
 namespace devices {
@@ -98,14 +98,24 @@ Device::Device(
 
 std::shared_ptr<Datastore> Device::getOperationalDatastore() {
   using IfMib = devmand::channels::snmp::IfMib;
-  using IModel = devmand::models::interface::Model;
 
   std::shared_ptr<Datastore> state = ping::Device::getOperationalDatastore();
 
+  // A poll which fails before the interfaces are known reports none.
+  interfaces->wlock()->reset();
   state->update([](auto& lockedState) {
-    IModel::init(lockedState);
     lockedState["ietf-system:system"] = folly::dynamic::object;
   });
+  std::weak_ptr<devices::Device> weak(this->shared_from_this());
+  state->addFinally([this, weak, state, table = interfaces]() {
+    auto lockedTable = table->wlock();
+    if (auto sharedDevice = weak.lock()) {
+      completeInterfaces(*lockedTable, *state);
+    }
+    state->update([&lockedTable](auto& lockedState) {
+      lockedTable->materialize(lockedState);
+    });
+  });
 
   state->addRequest(
       IfMib::getSystemName(snmpChannel).thenValue([state](auto v) {
@@ -126,7 +136,6 @@ std::shared_ptr<Datastore> Device::getOperationalDatastore() {
           lockedState["ietf-system:system"]["location"] = v;
         });
       }));
-  std::weak_ptr<devices::Device> weak(this->shared_from_this());
   // TODO: state::addRequest is for individual requests. We use it here so that
   // State::collect doesn't miss any requests, since they're nested. Figure out
   // a way to track individual requests again.
@@ -148,173 +157,114 @@ std::shared_ptr<Datastore> Device::getOperationalDatastore() {
   return state;
 }
 
+const MetricFamily& Device::getCounterFamily(
+    models::interface::Table::Counter counter) {
+  // TODO: instead of doing this per device type, move to
+  //   traversing the resulting device model and
+  //   creating metrics in a more general fashion
+  return MetricFamily::get(
+      folly::sformat(
+          "/openconfig-interfaces:interface/interface/state/counters/{}",
+          models::interface::Table::getCounterName(counter)),
+      "ifindex");
+}
+
 folly::Future<folly::Unit> Device::addToStateWithInterfaceIndices(
     std::shared_ptr<Datastore> state,
     const devmand::channels::snmp::InterfaceIndicies& interfaceIndices) {
   using IfMib = devmand::channels::snmp::IfMib;
-  using IModel = devmand::models::interface::Model;
-
-  std::vector<folly::Future<folly::Unit>> allFutures;
-  allFutures.push_back(
-      IfMib::getInterfaceNames(snmpChannel, interfaceIndices)
-          .thenValue([state](auto results) {
-            state->update([&results](auto& lockedState) {
-              for (auto result : results) {
-                IModel::updateInterface(
-                    lockedState, result.index, "name", result.value);
-                IModel::updateInterface(
-                    lockedState, result.index, "state/name", result.value);
-                IModel::updateInterface(
-                    lockedState, result.index, "config/name", result.value);
-              }
-            });
-          }));
-  allFutures.push_back(
-      IfMib::getInterfaceOperStatuses(snmpChannel, interfaceIndices)
-          .thenValue([state](auto results) {
-            state->update([&results](auto& lockedState) {
-              for (auto result : results) {
-                // TODO this is not valid according to the model but
-                // we need to fix the front-end.
-                IModel::updateInterface(
-                    lockedState, result.index, "oper-status", result.value);
-                IModel::updateInterface(
-                    lockedState,
-                    result.index,
-                    "state/oper-status",
-                    result.value);
-              }
-            });
-          }));
-  allFutures.push_back(
-      IfMib::getInterfaceAdminStatuses(snmpChannel, interfaceIndices)
-          .thenValue([state](auto results) {
-            state->update([&results](auto& lockedState) {
-              for (auto result : results) {
-                bool isEnabled = result.value == "UP";
-                IModel::updateInterface(
-                    lockedState,
-                    result.index,
-                    "state/admin-status",
-                    result.value);
-                IModel::updateInterface(
-                    lockedState, result.index, "config/enabled", isEnabled);
-                IModel::updateInterface(
-                    lockedState, result.index, "state/enabled", isEnabled);
-              }
-            });
-          }));
-  allFutures.push_back(
-      IfMib::getInterfaceMtus(snmpChannel, interfaceIndices)
-          .thenValue([state](auto results) {
-            state->update([&results](auto& lockedState) {
-              for (auto result : results) {
-                IModel::updateInterface(
-                    lockedState, result.index, "config/mtu", result.value);
-                IModel::updateInterface(
-                    lockedState, result.index, "state/mtu", result.value);
-              }
-            });
-          }));
-  allFutures.push_back(
-      IfMib::getInterfaceTypes(snmpChannel, interfaceIndices)
-          .thenValue([state](auto results) {
-            state->update([&results](auto& lockedState) {
-              for (auto result : results) {
-                int ifMibType = folly::to<int>(result.value);
-                std::string interfaceType = getTypeString(ifMibType);
-                IModel::updateInterface(
-                    lockedState, result.index, "config/type", interfaceType);
-                IModel::updateInterface(
-                    lockedState, result.index, "state/type", interfaceType);
+  using Table = devmand::models::interface::Table;
+  using Counter = Table::Counter;
 
-                bool loopbackMode = isLoopBack(ifMibType);
-                IModel::updateInterface(
-                    lockedState,
-                    result.index,
-                    "config/loopback-mode",
-                    loopbackMode);
-                IModel::updateInterface(
-                    lockedState,
-                    result.index,
-                    "state/loopback-mode",
-                    loopbackMode);
-              }
-            });
-          }));
+  interfaces->wlock()->reset(interfaceIndices);
 
-  allFutures.push_back(
-      IfMib::getInterfaceDescriptions(snmpChannel, interfaceIndices)
-          .thenValue([state](auto results) {
-            state->update([&results](auto& lockedState) {
-              for (auto result : results) {
-                IModel::updateInterface(
-                    lockedState,
-                    result.index,
-                    "config/description",
-                    result.value);
-                IModel::updateInterface(
-                    lockedState,
-                    result.index,
-                    "state/description",
-                    result.value);
-              }
-            });
-          }));
+  std::vector<folly::Future<folly::Unit>> allFutures;
+  // Applies set to the slot of the interface of every result.
+  auto addResults = [this, &allFutures](
+                        folly::Future<channels::snmp::InterfacePairs>&& future,
+                        auto set) {
+    allFutures.push_back(std::move(future).thenValue(
+        [table = interfaces, set](auto results) {
+          auto lockedTable = table->wlock();
+          for (auto& result : results) {
+            set(lockedTable->get(result.index), result.value);
+          }
+        }));
+  };
 
-  allFutures.push_back(
-      IfMib::getInterfaceLastChange(snmpChannel, interfaceIndices)
-          .thenValue([state](auto results) {
-            state->update([&results](auto& lockedState) {
-              for (auto result : results) {
-                IModel::updateInterface(
-                    lockedState,
-                    result.index,
-                    "state/last-change",
-                    result.value);
-              }
-            });
-          }));
+  addResults(
+      IfMib::getInterfaceNames(snmpChannel, interfaceIndices),
+      [](auto& interface, auto& value) { interface.name = value; });
+  addResults(
+      IfMib::getInterfaceOperStatuses(snmpChannel, interfaceIndices),
+      [](auto& interface, auto& value) { interface.operStatus = value; });
+  addResults(
+      IfMib::getInterfaceAdminStatuses(snmpChannel, interfaceIndices),
+      [](auto& interface, auto& value) {
+        interface.adminStatus = value;
+        interface.enabled = value == "UP";
+      });
+  addResults(
+      IfMib::getInterfaceMtus(snmpChannel, interfaceIndices),
+      [](auto& interface, auto& value) { interface.mtu = value; });
+  addResults(
+      IfMib::getInterfaceTypes(snmpChannel, interfaceIndices),
+      [](auto& interface, auto& value) {
+        int ifMibType = folly::to<int>(value);
+        interface.type = getTypeString(ifMibType);
+        interface.loopbackMode = isLoopBack(ifMibType);
+      });
+  addResults(
+      IfMib::getInterfaceDescriptions(snmpChannel, interfaceIndices),
+      [](auto& interface, auto& value) { interface.description = value; });
+  addResults(
+      IfMib::getInterfaceLastChange(snmpChannel, interfaceIndices),
+      [](auto& interface, auto& value) { interface.lastChange = value; });
 
   auto addRequest = [this, &state, &allFutures, &interfaceIndices](
-                        const std::string& oid, const std::string& path) {
+                        const std::string& oid, Counter counter) {
+    if (not isCounterPolled(counter)) {
+      return;
+    }
+    const auto* family = &getCounterFamily(counter);
     allFutures.push_back(
         IfMib::getInterfaceField(snmpChannel, interfaceIndices, oid)
-            .thenValue([state, path](auto results) {
-              state->update([&results, &state, &path](auto& lockedState) {
-                for (auto result : results) {
-                  IModel::updateInterface(
-                      lockedState, result.index, path, result.value);
-                  // TODO: instead of doing this per device type, move to
-                  //   traversing the resulting device model and
-                  //   creating metrics in a more general fashion
-                  state->setGauge(
-                      folly::sformat(
-                          "/{}/interface[ifindex={}]/{}",
-                          "openconfig-interfaces:interface",
-                          result.index,
-                          path),
-                      folly::to<float>(result.value));
+            .thenValue([state, table = interfaces, counter, family](
+                           auto results) {
+              auto lockedTable = table->wlock();
+              for (auto& result : results) {
+                auto value = folly::tryTo<uint64_t>(result.value);
+                if (not value.hasValue()) {
+                  LOG(WARNING) << "Ignoring non numeric "
+                               << Table::getCounterName(counter) << " "
+                               << result.value << " of interface "
+                               << result.index;
+                  continue;
                 }
-              });
+                lockedTable->get(result.index).setCounter(counter, *value);
+                state->setGauge(
+                    *family,
+                    folly::to<std::string>(result.index),
+                    static_cast<double>(*value));
+              }
             }));
   };
 
   // TODO if devices don't support the 64 bit version should we revert to 32?
-  addRequest(".1.3.6.1.2.1.31.1.1.1.6.", "state/counters/in-octets");
-  addRequest(".1.3.6.1.2.1.31.1.1.1.7.", "state/counters/in-unicast-pkts");
-  addRequest(".1.3.6.1.2.1.31.1.1.1.9.", "state/counters/in-broadcast-pkts");
-  addRequest(".1.3.6.1.2.1.31.1.1.1.8.", "state/counters/in-multicast-pkts");
-  addRequest(".1.3.6.1.2.1.2.2.1.13.", "state/counters/in-discards");
-  addRequest(".1.3.6.1.2.1.2.2.1.14.", "state/counters/in-errors");
-  addRequest(".1.3.6.1.2.1.2.2.1.15.", "state/counters/in-unknown-protos");
+  addRequest(".1.3.6.1.2.1.31.1.1.1.6.", Counter::IN_OCTETS);
+  addRequest(".1.3.6.1.2.1.31.1.1.1.7.", Counter::IN_UNICAST_PKTS);
+  addRequest(".1.3.6.1.2.1.31.1.1.1.9.", Counter::IN_BROADCAST_PKTS);
+  addRequest(".1.3.6.1.2.1.31.1.1.1.8.", Counter::IN_MULTICAST_PKTS);
+  addRequest(".1.3.6.1.2.1.2.2.1.13.", Counter::IN_DISCARDS);
+  addRequest(".1.3.6.1.2.1.2.2.1.14.", Counter::IN_ERRORS);
+  addRequest(".1.3.6.1.2.1.2.2.1.15.", Counter::IN_UNKNOWN_PROTOS);
 
-  addRequest(".1.3.6.1.2.1.31.1.1.1.6.", "state/counters/out-octets");
-  addRequest(".1.3.6.1.2.1.31.1.1.1.11.", "state/counters/out-unicast-pkts");
-  addRequest(".1.3.6.1.2.1.31.1.1.1.13.", "state/counters/out-broadcast-pkts");
-  addRequest(".1.3.6.1.2.1.31.1.1.1.12.", "state/counters/out-multicast-pkts");
-  addRequest(".1.3.6.1.2.1.2.2.1.19.", "state/counters/out-discards");
-  addRequest(".1.3.6.1.2.1.2.2.1.20.", "state/counters/out-errors");
+  addRequest(".1.3.6.1.2.1.31.1.1.1.6.", Counter::OUT_OCTETS);
+  addRequest(".1.3.6.1.2.1.31.1.1.1.11.", Counter::OUT_UNICAST_PKTS);
+  addRequest(".1.3.6.1.2.1.31.1.1.1.13.", Counter::OUT_BROADCAST_PKTS);
+  addRequest(".1.3.6.1.2.1.31.1.1.1.12.", Counter::OUT_MULTICAST_PKTS);
+  addRequest(".1.3.6.1.2.1.2.2.1.19.", Counter::OUT_DISCARDS);
+  addRequest(".1.3.6.1.2.1.2.2.1.20.", Counter::OUT_ERRORS);
 
   // TODO how should I get state/logical? Perhaps based on type?
 
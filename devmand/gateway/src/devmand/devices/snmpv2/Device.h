@@ -7,9 +7,14 @@
 
 #pragma once
 
+#include <memory>
+
+#include <folly/Synchronized.h>
+
 #include <devmand/channels/snmp/Channel.h>
 #include <devmand/channels/snmp/IfMib.h>
 #include <devmand/devices/ping/Device.h>
+#include <devmand/models/interface/Table.h>
 
 namespace devmand {
 namespace devices {
@@ -48,13 +53,36 @@ class Device : public ping::Device {
       const devmand::channels::snmp::InterfaceIndicies& interfaceIndices);
 
  protected:
-  void setIntendedDatastore(const folly::dynamic& config) override {
+  folly::Future<folly::Unit> setIntendedDatastore(
+      const folly::dynamic& config) override {
     (void)config;
     LOG(ERROR) << "set config on unconfigurable device";
+    return folly::makeFuture();
+  }
+
+  // Lets a device get some counters another way than walking the IF-MIB.
+  virtual bool isCounterPolled(models::interface::Table::Counter) const {
+    return true;
   }
 
+  // Called with the polled interfaces just before they're added to the state.
+  virtual void completeInterfaces(
+      models::interface::Table& table,
+      Datastore& state) {
+    (void)table;
+    (void)state;
+  }
+
+  // The metric family of an interface counter, labelled by ifindex.
+  static const MetricFamily& getCounterFamily(
+      models::interface::Table::Counter counter);
+
  protected:
   channels::snmp::Channel snmpChannel;
+
+  // Filled in by each poll and materialized into the state on collect.
+  std::shared_ptr<folly::Synchronized<models::interface::Table>> interfaces{
+      std::make_shared<folly::Synchronized<models::interface::Table>>()};
 };
 
 } // namespace snmpv2
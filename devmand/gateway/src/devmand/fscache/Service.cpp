@@ -5,14 +5,28 @@
 // LICENSE file in the root directory of this source tree. An additional grant
 // of patent rights can be found in the PATENTS file in the same directory.
 
+#include <folly/GLog.h>
+
+#include <devmand/Application.h>
+#include <devmand/Config.h>
+#include <devmand/error/ErrorHandler.h>
 #include <devmand/fscache/Service.h>
 
 namespace devmand {
 namespace fscache {
 
+// The log is compacted once it is this many times the size of the records
+// still live in it, but never while it is smaller than minCompactionSize.
+static constexpr size_t compactionRatio = 4;
+static constexpr size_t minCompactionSize = 1 << 20;
+
+// Restored states of devices which haven't been polled after this many poll
+// intervals are dropped, most likely the devices were removed while devmand
+// was down.
+static constexpr int stalePollIntervals = 3;
+
 Service::Service(Application& application)
-    : ::devmand::Service(application) { // TODO
-}
+    : ::devmand::Service(application), log(FLAGS_fscache_path) {}
 
 void Service::setGauge(
     const std::string&,
@@ -20,11 +34,110 @@ void Service::setGauge(
     const std::string&,
     const std::string&) {}
 
-void Service::start() {}
+void Service::setGauges(std::shared_ptr<const MetricSample>) {}
+
+void Service::start() {
+  restore();
+  thread = std::thread([this]() { run(); });
+}
 
-void Service::wait() {}
+void Service::wait() {
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
 
-void Service::stop() {}
+void Service::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  stopped.notify_all();
+}
+
+void Service::restore() {
+  auto states = log.load();
+  size_t restored{0};
+  app.getSharedUnifiedView().withWLock([this, &states, &restored](auto& view) {
+    for (auto& state : states) {
+      auto snapshot = view.restore(state.first, std::move(state.second));
+      if (snapshot->isStale()) {
+        auto recordSize = StateLog::getRecordSize(
+            state.first, snapshot->getSerialized().size());
+        persisted[state.first] =
+            PersistedState{snapshot->getGeneration(), recordSize};
+        liveSize += recordSize;
+        ++restored;
+      }
+    }
+  });
+  restoredAt = utils::Time::now();
+  LOG(INFO) << "Restored " << restored << " device states from "
+            << FLAGS_fscache_path;
+}
+
+void Service::run() {
+  std::chrono::seconds interval(FLAGS_fscache_sync_interval);
+  std::unique_lock<std::mutex> lock(mutex);
+  while (not stopping) {
+    stopped.wait_for(lock, interval, [this]() { return stopping; });
+    lock.unlock();
+    // Also runs once more on stop so that the latest states make it to disk.
+    ErrorHandler::executeWithCatch([this]() { persist(); });
+    lock.lock();
+  }
+}
+
+void Service::persist() {
+  if (not staleErased and
+      utils::Time::now() - restoredAt >
+          stalePollIntervals * std::chrono::seconds(FLAGS_poll_interval)) {
+    app.getSharedUnifiedView().wlock()->eraseStale();
+    staleErased = true;
+  }
+
+  auto unifiedView = app.getUnifiedView();
+  size_t appended{0};
+  for (auto& device : unifiedView) {
+    auto& last = persisted[device.first];
+    if (last.generation == device.second->getGeneration()) {
+      continue;
+    }
+
+    auto recordSize =
+        log.append(device.first, device.second->getSerialized());
+    if (recordSize != 0) {
+      liveSize = liveSize - last.recordSize + recordSize;
+      last = PersistedState{device.second->getGeneration(), recordSize};
+      ++appended;
+    }
+  }
+
+  for (auto it = persisted.begin(); it != persisted.end();) {
+    if (unifiedView.get(it->first) == nullptr) {
+      log.appendErase(it->first);
+      liveSize -= it->second.recordSize;
+      it = persisted.erase(it);
+      ++appended;
+    } else {
+      ++it;
+    }
+  }
+
+  if (appended == 0) {
+    return;
+  }
+  log.sync();
+
+  if (log.getSize() > minCompactionSize and
+      log.getSize() > compactionRatio * liveSize) {
+    std::map<devices::Id, std::string> states;
+    for (auto& device : unifiedView) {
+      states.emplace(device.first, device.second->getSerialized());
+    }
+    log.compact(states);
+  }
+}
 
 } // namespace fscache
 } // namespace devmand
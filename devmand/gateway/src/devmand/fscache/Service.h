@@ -7,11 +7,24 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
 #include <devmand/Service.h>
+#include <devmand/devices/Id.h>
+#include <devmand/fscache/StateLog.h>
+#include <devmand/utils/Time.h>
 
 namespace devmand {
 namespace fscache {
 
+/*
+ * Persists the unified view to local disk so that after a restart the last
+ * known state of every device is served straight away, marked stale, instead
+ * of nothing until every device has been polled again.
+ */
 class Service : public ::devmand::Service {
  public:
   Service(Application& application);
@@ -31,8 +44,31 @@ class Service : public ::devmand::Service {
       double value,
       const std::string& labelName,
       const std::string& labelValue) override;
+  void setGauges(std::shared_ptr<const MetricSample> sample) override;
+
+ private:
+  void restore();
+  void persist();
+  void run();
 
  private:
+  struct PersistedState {
+    uint64_t generation{0};
+    size_t recordSize{0};
+  };
+
+  StateLog log;
+
+  // Only touched from the persisting thread once it has started.
+  std::map<devices::Id, PersistedState> persisted;
+  size_t liveSize{0};
+  utils::TimePoint restoredAt{};
+  bool staleErased{false};
+
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable stopped;
+  bool stopping{false};
 };
 
 } // namespace fscache
@@ -0,0 +1,247 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <system_error>
+
+#include <folly/FileUtil.h>
+#include <folly/GLog.h>
+#include <folly/Range.h>
+#include <folly/hash/Checksum.h>
+#include <folly/json.h>
+#include <folly/system/MemoryMapping.h>
+
+#include <devmand/fscache/StateLog.h>
+
+namespace devmand {
+namespace fscache {
+
+// Records are written in host byte order, the log never leaves the host.
+static constexpr char magic[8] = {'D', 'V', 'M', 'S', 'T', 'A', 'T', '1'};
+static constexpr size_t headerSize = 3 * sizeof(uint32_t);
+
+static std::string makeRecord(
+    const devices::Id& id,
+    uint32_t stateLength,
+    folly::StringPiece state) {
+  uint32_t idLength = static_cast<uint32_t>(id.size());
+  std::string record(headerSize, '\0');
+  record.reserve(headerSize + id.size() + state.size());
+  std::memcpy(&record[sizeof(uint32_t)], &idLength, sizeof(idLength));
+  std::memcpy(&record[2 * sizeof(uint32_t)], &stateLength, sizeof(stateLength));
+  record.append(id);
+  record.append(state.data(), state.size());
+
+  uint32_t crc = folly::crc32c(
+      reinterpret_cast<const uint8_t*>(record.data()) + sizeof(uint32_t),
+      record.size() - sizeof(uint32_t));
+  std::memcpy(&record[0], &crc, sizeof(crc));
+  return record;
+}
+
+StateLog::StateLog(const std::string& path_) : path(path_) {}
+
+StateLog::~StateLog() {
+  close();
+}
+
+std::map<devices::Id, YangModelBundle> StateLog::load() {
+  close();
+
+  std::map<devices::Id, YangModelBundle> states;
+  size_t validEnd = 0;
+  struct stat st {};
+  if (::stat(path.c_str(), &st) == 0 and st.st_size > 0) {
+    folly::MemoryMapping mapping(path.c_str());
+    auto data = mapping.range();
+
+    if (data.size() >= sizeof(magic) and
+        std::memcmp(data.data(), magic, sizeof(magic)) == 0) {
+      // Only remember where the latest record of each device is, the states
+      // are parsed straight out of the mapping once the log is replayed.
+      std::map<devices::Id, folly::StringPiece> latest;
+      size_t offset = sizeof(magic);
+      validEnd = offset;
+      while (offset + headerSize <= data.size()) {
+        uint32_t crc{0}, idLength{0}, stateLength{0};
+        std::memcpy(&crc, data.data() + offset, sizeof(crc));
+        std::memcpy(
+            &idLength,
+            data.data() + offset + sizeof(uint32_t),
+            sizeof(idLength));
+        std::memcpy(
+            &stateLength,
+            data.data() + offset + 2 * sizeof(uint32_t),
+            sizeof(stateLength));
+
+        bool erased = stateLength == tombstoneLength;
+        size_t length = size_t{idLength} + (erased ? 0 : stateLength);
+        if (offset + headerSize + length > data.size() or
+            folly::crc32c(
+                data.data() + offset + sizeof(uint32_t),
+                headerSize - sizeof(uint32_t) + length) != crc) {
+          break;
+        }
+
+        auto record =
+            reinterpret_cast<const char*>(data.data()) + offset + headerSize;
+        devices::Id id(record, idLength);
+        if (erased) {
+          latest.erase(id);
+        } else {
+          latest[id] = folly::StringPiece(record + idLength, stateLength);
+        }
+        offset += headerSize + length;
+        validEnd = offset;
+      }
+
+      if (validEnd != data.size()) {
+        LOG(WARNING) << "Dropping " << data.size() - validEnd
+                     << " bytes of torn records from " << path;
+      }
+
+      for (auto& entry : latest) {
+        try {
+          states.emplace(entry.first, folly::parseJson(entry.second));
+        } catch (const std::exception& e) {
+          LOG(ERROR) << "Failed to parse persisted state of " << entry.first
+                     << ": " << e.what();
+        }
+      }
+    } else {
+      LOG(WARNING) << "Unrecognized state log " << path << ", starting over";
+    }
+  }
+
+  open();
+  if (fd >= 0) {
+    if (validEnd == 0) {
+      if (::ftruncate(fd, 0) != 0 or
+          folly::writeFull(fd, magic, sizeof(magic)) !=
+              static_cast<ssize_t>(sizeof(magic))) {
+        auto err = std::system_error(errno, std::generic_category());
+        LOG(ERROR) << "Failed to initialize " << path << ": " << err.what();
+        close();
+      }
+      size = sizeof(magic);
+    } else {
+      if (::ftruncate(fd, static_cast<off_t>(validEnd)) != 0) {
+        auto err = std::system_error(errno, std::generic_category());
+        LOG(ERROR) << "Failed to truncate " << path << ": " << err.what();
+        close();
+      }
+      size = validEnd;
+    }
+  }
+
+  return states;
+}
+
+size_t StateLog::append(const devices::Id& id, const std::string& serialized) {
+  return write(makeRecord(
+      id, static_cast<uint32_t>(serialized.size()), serialized));
+}
+
+size_t StateLog::appendErase(const devices::Id& id) {
+  return write(makeRecord(id, tombstoneLength, folly::StringPiece()));
+}
+
+size_t StateLog::write(const std::string& record) {
+  if (fd < 0) {
+    return 0;
+  }
+
+  if (folly::writeFull(fd, record.data(), record.size()) !=
+      static_cast<ssize_t>(record.size())) {
+    auto err = std::system_error(errno, std::generic_category());
+    LOG(ERROR) << "Failed to append to " << path << ": " << err.what();
+    // Don't leave half a record for the next one to be appended after.
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      close();
+    }
+    return 0;
+  }
+
+  size += record.size();
+  return record.size();
+}
+
+void StateLog::sync() {
+  if (fd >= 0 and ::fdatasync(fd) != 0) {
+    auto err = std::system_error(errno, std::generic_category());
+    LOG(ERROR) << "Failed to sync " << path << ": " << err.what();
+  }
+}
+
+void StateLog::compact(const std::map<devices::Id, std::string>& states) {
+  std::string contents(magic, sizeof(magic));
+  for (auto& state : states) {
+    contents.append(makeRecord(
+        state.first, static_cast<uint32_t>(state.second.size()), state.second));
+  }
+
+  auto compactPath = path + ".compact";
+  int compactFd =
+      ::open(compactPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  bool written = compactFd >= 0 and
+      folly::writeFull(compactFd, contents.data(), contents.size()) ==
+          static_cast<ssize_t>(contents.size()) and
+      ::fdatasync(compactFd) == 0;
+  if (compactFd >= 0) {
+    ::close(compactFd);
+  }
+  if (not written or ::rename(compactPath.c_str(), path.c_str()) != 0) {
+    auto err = std::system_error(errno, std::generic_category());
+    LOG(ERROR) << "Failed to compact " << path << ": " << err.what();
+    ::unlink(compactPath.c_str());
+    return;
+  }
+
+  LOG(INFO) << "Compacted " << path << " from " << size << " to "
+            << contents.size() << " bytes";
+  close();
+  open();
+  size = contents.size();
+}
+
+size_t StateLog::getSize() const {
+  return size;
+}
+
+size_t StateLog::getRecordSize(const devices::Id& id, size_t stateLength) {
+  return headerSize + id.size() + stateLength;
+}
+
+void StateLog::open() {
+  auto slash = path.rfind('/');
+  if (slash != std::string::npos and slash != 0) {
+    // Only the last level is created, the rest is up to packaging.
+    ::mkdir(path.substr(0, slash).c_str(), 0755);
+  }
+
+  fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd < 0) {
+    auto err = std::system_error(errno, std::generic_category());
+    LOG(ERROR) << "Failed to open " << path << ": " << err.what()
+               << ", device states will not be persisted";
+  }
+}
+
+void StateLog::close() {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+} // namespace fscache
+} // namespace devmand
@@ -0,0 +1,79 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include <devmand/UnifiedView.h>
+#include <devmand/devices/Id.h>
+
+namespace devmand {
+namespace fscache {
+
+/*
+ * An append only log of serialized device states. Replaying the log and
+ * keeping the last record of every device gives the latest persisted state.
+ * After a fixed header the log is a sequence of records
+ *
+ *   uint32 crc32c of the rest of the record
+ *   uint32 id length
+ *   uint32 state length, or tombstoneLength when the device was removed
+ *   id bytes
+ *   state bytes
+ *
+ * A record torn by a crash in the middle of an append fails its checksum and
+ * it, along with anything after it, is cut off on load.
+ */
+class StateLog final {
+ public:
+  StateLog(const std::string& path_);
+  StateLog() = delete;
+  ~StateLog();
+  StateLog(const StateLog&) = delete;
+  StateLog& operator=(const StateLog&) = delete;
+  StateLog(StateLog&&) = delete;
+  StateLog& operator=(StateLog&&) = delete;
+
+ public:
+  /*
+   * Maps the log and returns the latest state of every device in it. Opens
+   * the log for appending; until this is called appends are dropped.
+   */
+  std::map<devices::Id, YangModelBundle> load();
+
+  // Returns the size of the record written.
+  size_t append(const devices::Id& id, const std::string& serialized);
+  size_t appendErase(const devices::Id& id);
+
+  // Flushes appended records to disk.
+  void sync();
+
+  // Atomically replaces the log with one record per device.
+  void compact(const std::map<devices::Id, std::string>& states);
+
+  size_t getSize() const;
+
+  static size_t getRecordSize(const devices::Id& id, size_t stateLength);
+
+ private:
+  size_t write(const std::string& record);
+  void open();
+  void close();
+
+ private:
+  std::string path;
+  int fd{-1};
+  size_t size{0};
+
+  static constexpr uint32_t tombstoneLength = UINT32_MAX;
+};
+
+} // namespace fscache
+} // namespace devmand
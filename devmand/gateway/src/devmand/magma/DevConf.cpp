@@ -157,6 +157,9 @@ cartography::DeviceConfigs DevConf::parseYamlDeviceConfigs(
       deviceConfig.platform = device["platform"].as<std::string>();
       deviceConfig.ip = device["ip"].as<std::string>();
       deviceConfig.readonly = device["readonly"].as<bool>();
+      if (device["pollInterval"]) {
+        deviceConfig.pollInterval = device["pollInterval"].as<uint64_t>();
+      }
 
       if (device["yangConfig"]) {
         deviceConfig.yangConfig =
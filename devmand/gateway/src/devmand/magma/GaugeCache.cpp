@@ -0,0 +1,124 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <MetricsSingleton.h>
+
+#include <devmand/magma/GaugeCache.h>
+
+namespace devmand {
+namespace magma {
+
+namespace {
+
+class MetricsSingletonRegistry final : public GaugeCache::Registry {
+ public:
+  prometheus::Gauge& getGauge(
+      const std::string& name,
+      const std::map<std::string, std::string>& labels) override {
+    return ::magma::service303::MetricsSingleton::Instance().GetGauge(
+        name.c_str(), labels);
+  }
+
+  void removeGauge(
+      const std::string& name,
+      const std::map<std::string, std::string>& labels) override {
+    ::magma::service303::MetricsSingleton::Instance().RemoveGauge(
+        name.c_str(), labels);
+  }
+};
+
+} // namespace
+
+GaugeCache::GaugeCache()
+    : GaugeCache(std::make_unique<MetricsSingletonRegistry>()) {}
+
+GaugeCache::GaugeCache(std::unique_ptr<Registry> registry_)
+    : registry(std::move(registry_)) {}
+
+void GaugeCache::set(const MetricSample& sample) {
+  // Held for the whole sample so that samples of a source don't interleave.
+  auto locked = sources.wlock();
+  auto& source =
+      (*locked)[sample.getLabelName() + "=" + sample.getLabelValue()];
+  if (source.samples == 0) {
+    source.labelName = sample.getLabelName();
+    source.labelValue = sample.getLabelValue();
+  }
+  auto current = ++source.samples;
+
+  auto& families = source.families;
+  for (auto& value : sample.getValues()) {
+    auto id = value.family->getId();
+    if (families.size() <= id) {
+      families.resize(id + 1);
+    }
+    families[id].family = value.family;
+    auto& resolved = families[id].gauges[value.labelValue];
+    if (resolved.gauge == nullptr) {
+      resolved.gauge = &registry->getGauge(
+          value.family->getName(),
+          getLabels(source, *value.family, value.labelValue));
+    }
+    resolved.gauge->Set(value.value);
+    resolved.sample = current;
+  }
+
+  // Whatever the source didn't report this time, e.g. an interface which
+  // went away, would otherwise be exported with its last value forever.
+  for (auto& family : families) {
+    for (auto it = family.gauges.begin(); it != family.gauges.end();) {
+      if (it->second.sample != current) {
+        removeGauge(source, family, it->first);
+        it = family.gauges.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+void GaugeCache::remove(
+    const std::string& labelName,
+    const std::string& labelValue) {
+  auto locked = sources.wlock();
+  auto it = locked->find(labelName + "=" + labelValue);
+  if (it == locked->end()) {
+    return;
+  }
+  for (auto& family : it->second.families) {
+    for (auto& gauge : family.gauges) {
+      removeGauge(it->second, family, gauge.first);
+    }
+  }
+  locked->erase(it);
+}
+
+void GaugeCache::removeGauge(
+    const SourceGauges& source,
+    const FamilyGauges& family,
+    const std::string& familyLabelValue) {
+  registry->removeGauge(
+      family.family->getName(),
+      getLabels(source, *family.family, familyLabelValue));
+}
+
+std::map<std::string, std::string> GaugeCache::getLabels(
+    const SourceGauges& source,
+    const MetricFamily& family,
+    const std::string& familyLabelValue) {
+  std::map<std::string, std::string> labels;
+  if (not source.labelName.empty() and not source.labelValue.empty()) {
+    labels.emplace(source.labelName, source.labelValue);
+  }
+  if (not family.getLabelName().empty()) {
+    labels.emplace(family.getLabelName(), familyLabelValue);
+  }
+  return labels;
+}
+
+} // namespace magma
+} // namespace devmand
@@ -0,0 +1,89 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/Synchronized.h>
+
+#include <devmand/MetricSink.h>
+
+#include <prometheus/gauge.h>
+
+namespace devmand {
+namespace magma {
+
+/*
+ * Gauges resolved from the metrics registry, by the label of the sample
+ * source, then by family id and the family label value. Resolving a gauge
+ * builds a label map and hashes it, so it is only done once per gauge.
+ * A gauge missing from a sample of its source is removed, as are all of a
+ * source's gauges when the source is removed.
+ */
+class GaugeCache final {
+ public:
+  // Where the gauges live, the service303 metrics singleton by default.
+  class Registry {
+   public:
+    virtual ~Registry() = default;
+    virtual prometheus::Gauge& getGauge(
+        const std::string& name,
+        const std::map<std::string, std::string>& labels) = 0;
+    virtual void removeGauge(
+        const std::string& name,
+        const std::map<std::string, std::string>& labels) = 0;
+  };
+
+  GaugeCache();
+  explicit GaugeCache(std::unique_ptr<Registry> registry_);
+  ~GaugeCache() = default;
+  GaugeCache(const GaugeCache&) = delete;
+  GaugeCache& operator=(const GaugeCache&) = delete;
+  GaugeCache(GaugeCache&&) = delete;
+  GaugeCache& operator=(GaugeCache&&) = delete;
+
+ public:
+  void set(const MetricSample& sample);
+  void remove(const std::string& labelName, const std::string& labelValue);
+
+ private:
+  struct ResolvedGauge {
+    prometheus::Gauge* gauge{nullptr};
+    uint64_t sample{0};
+  };
+  struct FamilyGauges {
+    const MetricFamily* family{nullptr};
+    std::unordered_map<std::string, ResolvedGauge> gauges;
+  };
+  struct SourceGauges {
+    std::string labelName;
+    std::string labelValue;
+    uint64_t samples{0};
+    std::vector<FamilyGauges> families;
+  };
+
+  static std::map<std::string, std::string> getLabels(
+      const SourceGauges& source,
+      const MetricFamily& family,
+      const std::string& familyLabelValue);
+  void removeGauge(
+      const SourceGauges& source,
+      const FamilyGauges& family,
+      const std::string& familyLabelValue);
+
+ private:
+  std::unique_ptr<Registry> registry;
+  folly::Synchronized<std::unordered_map<std::string, SourceGauges>> sources;
+};
+
+} // namespace magma
+} // namespace devmand
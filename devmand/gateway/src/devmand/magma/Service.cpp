@@ -7,10 +7,13 @@
 
 #include <MetricsSingleton.h>
 
+#include <utility>
+
 #include <folly/GLog.h>
 #include <folly/json.h>
 
 #include <devmand/Application.h>
+#include <devmand/Config.h>
 #include <devmand/magma/Service.h>
 #include <orc8r/protos/service303.grpc.pb.h>
 #include <orc8r/protos/service303.pb.h>
@@ -30,31 +33,67 @@ Service::Service(Application& application)
 std::list<std::map<std::string, std::string>> Service::getOperationalStates() {
   auto unifiedView = app.getUnifiedView();
   std::list<std::map<std::string, std::string>> states;
+  auto now = utils::Time::now();
+  std::chrono::seconds refresh{FLAGS_state_report_refresh_interval};
+
+  reportedStates.withWLock([&](auto& reported) {
+    // Forget devices which are no longer in the view.
+    for (auto it = reported.begin(); it != reported.end();) {
+      if (unifiedView.get(it->first) == nullptr) {
+        it = reported.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    for (auto& device : unifiedView) {
+      auto& last = reported[device.first];
+      bool changed = last.generation != device.second->getGeneration();
+
+      if (not changed and refresh.count() != 0 and
+          now - last.lastReported < refresh) {
+        continue;
+      }
+
+      if (changed) {
+        folly::dynamic deviceState = folly::dynamic::object;
+        deviceState["raw_state"] = device.second->getSerialized();
+        if (device.second->isStale()) {
+          // Restored from disk after a restart, not polled yet.
+          deviceState["stale"] = true;
+        }
+        last.value = folly::toJson(deviceState);
+        last.generation = device.second->getGeneration();
+      }
+      last.lastReported = now;
+
+      states.emplace_back(std::map<std::string, std::string>{
+          {"type", orc8rDeviceType},
+          {"device_id", device.first},
+          {"value", last.value}});
+    }
+  });
 
-  for (auto& device : unifiedView) {
-    std::string deviceId = device.first;
-    folly::dynamic deviceState = folly::dynamic::object;
-    deviceState["raw_state"] = folly::toJson(device.second);
-
-    std::map<std::string, std::string> state = {
-        {"type", orc8rDeviceType},
-        {"device_id", deviceId},
-        {"value", folly::toJson(deviceState)}};
-    states.push_back(state);
-  }
   return states;
 }
 
 std::map<std::string, std::string> Service::getServiceInfo() {
   auto unifiedView = app.getUnifiedView();
 
-  folly::dynamic devices = folly::dynamic::object;
+  // Stitch together the already serialized device states rather than
+  // rebuilding and reserializing one large dynamic.
+  std::string devices{"{"};
   for (auto& device : unifiedView) {
-    devices[device.first] = device.second;
+    if (devices.size() != 1) {
+      devices += ',';
+    }
+    devices += folly::toJson(device.first);
+    devices += ':';
+    devices += device.second->getSerialized();
   }
+  devices += '}';
 
-  return std::map<std::string, std::string>{
-      {"devmand", folly::toJson(devices)}};
+  return std::map<std::string, std::string>{{"devmand", devices}};
 }
 
 void Service::setGauge(
@@ -81,6 +120,79 @@ void Service::setGaugeVA(
   va_end(labels);
 }
 
+void Service::setGauges(std::shared_ptr<const MetricSample> sample) {
+  gauges.set(*sample);
+}
+
+void Service::removeGauges(
+    const std::string& labelName,
+    const std::string& labelValue) {
+  gauges.remove(labelName, labelValue);
+}
+
+// The service303 histogram api takes its bucket boundaries as varargs so
+// expand the vector into an argument pack of a matching size.
+static constexpr size_t maxHistogramBoundaries = 16;
+
+template <class Observe, size_t... Index>
+static void expandBoundaries(
+    Observe&& observe,
+    const std::vector<double>& boundaries,
+    std::index_sequence<Index...>) {
+  observe(sizeof...(Index), boundaries[Index]...);
+}
+
+template <size_t Count = 0, class Observe>
+static void withBoundaries(
+    Observe&& observe,
+    const std::vector<double>& boundaries) {
+  if constexpr (Count > maxHistogramBoundaries) {
+    LOG(ERROR) << "Too many histogram boundaries " << boundaries.size();
+  } else {
+    if (boundaries.size() == Count) {
+      expandBoundaries(observe, boundaries, std::make_index_sequence<Count>{});
+    } else {
+      withBoundaries<Count + 1>(observe, boundaries);
+    }
+  }
+}
+
+void Service::observeHistogram(
+    const std::string& key,
+    double value,
+    const std::vector<double>& boundaries,
+    const std::string& labelName,
+    const std::string& labelValue) {
+  withBoundaries(
+      [&](size_t count, auto... bounds) {
+        if (labelName.empty() or labelValue.empty()) {
+          observeHistogramVA(key, value, 0, count, bounds...);
+        } else {
+          observeHistogramVA(
+              key,
+              value,
+              1,
+              labelName.c_str(),
+              labelValue.c_str(),
+              count,
+              bounds...);
+        }
+      },
+      boundaries);
+}
+
+void Service::observeHistogramVA(
+    const std::string& key,
+    double value,
+    size_t labelCount,
+    ...) {
+  va_list args;
+  va_start(args, labelCount);
+  ::magma::service303::MetricsSingleton::Instance().ObserveHistogram(
+      key.c_str(), value, labelCount, args);
+  va_end(args);
+}
+
 void Service::start() {
   magmaService.Start();
 }
@@ -7,7 +7,16 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+#include <vector>
+
+#include <folly/Synchronized.h>
+
 #include <devmand/Service.h>
+#include <devmand/devices/Id.h>
+#include <devmand/magma/GaugeCache.h>
+#include <devmand/utils/Time.h>
 
 #include <MagmaService.h>
 
@@ -33,9 +42,24 @@ class Service : public ::devmand::Service {
       double value,
       const std::string& labelName,
       const std::string& labelValue) override;
+  void setGauges(std::shared_ptr<const MetricSample> sample) override;
+  void removeGauges(
+      const std::string& labelName,
+      const std::string& labelValue) override;
+  void observeHistogram(
+      const std::string& key,
+      double value,
+      const std::vector<double>& boundaries,
+      const std::string& labelName,
+      const std::string& labelValue) override;
 
  private:
   void setGaugeVA(const std::string& key, double value, size_t labelCount, ...);
+  void observeHistogramVA(
+      const std::string& key,
+      double value,
+      size_t labelCount,
+      ...);
 
   std::list<std::map<std::string, std::string>> getOperationalStates();
   std::map<std::string, std::string> getServiceInfo();
@@ -43,8 +67,23 @@ class Service : public ::devmand::Service {
   // The key that will tell orc8r how to store these states
   static constexpr auto orc8rDeviceType = "symphony_device";
 
+ private:
+  /*
+   * What was last handed to the state reporter for a device. The value is
+   * only rebuilt when the generation of the device state changes.
+   */
+  struct ReportedState {
+    uint64_t generation{0};
+    std::string value;
+    utils::TimePoint lastReported{};
+  };
+
  private:
   ::magma::service303::MagmaService magmaService;
+
+  folly::Synchronized<std::map<devices::Id, ReportedState>> reportedStates;
+
+  GaugeCache gauges;
 };
 
 } // namespace magma
@@ -37,9 +37,10 @@ int main(int argc, char* argv[]) {
 
   app.init(devConf);
 
-  // Add services which export the unified view
+  // Add services which export the unified view. fscache goes first so the
+  // persisted states are restored before anything is reported.
+  app.addService(std::make_unique<devmand::fscache::Service>(app));
   app.addService(std::make_unique<devmand::magma::Service>(app));
-  // app.addService(std::make_unique<devmand::fscache::Service>(app));
 
   using namespace devmand::devices;
 
@@ -0,0 +1,154 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <folly/Conv.h>
+
+#include <devmand/models/interface/Model.h>
+#include <devmand/models/interface/Table.h>
+
+namespace devmand {
+namespace models {
+namespace interface {
+
+static constexpr const char* counterNames[Table::counterCount] = {
+    "in-octets",
+    "in-unicast-pkts",
+    "in-broadcast-pkts",
+    "in-multicast-pkts",
+    "in-discards",
+    "in-errors",
+    "in-unknown-protos",
+    "out-octets",
+    "out-unicast-pkts",
+    "out-broadcast-pkts",
+    "out-multicast-pkts",
+    "out-discards",
+    "out-errors",
+};
+
+const char* Table::getCounterName(Counter counter) {
+  return counterNames[static_cast<size_t>(counter)];
+}
+
+void Table::Interface::setCounter(Counter counter, uint64_t value) {
+  counters[static_cast<size_t>(counter)] = value;
+  countersSet.set(static_cast<size_t>(counter));
+}
+
+void Table::reset(const std::vector<int>& indices) {
+  slots.clear();
+  used = 0;
+  for (int index : indices) {
+    get(index);
+  }
+}
+
+Table::Interface& Table::get(int index) {
+  auto it = slots.find(index);
+  if (it != slots.end()) {
+    return interfaces[it->second];
+  }
+
+  if (used == interfaces.size()) {
+    interfaces.emplace_back();
+  }
+  auto& interface = interfaces[used];
+  // Clear what the last poll set; the counters are just masked.
+  interface.index = index;
+  interface.name.reset();
+  interface.operStatus.reset();
+  interface.adminStatus.reset();
+  interface.enabled.reset();
+  interface.mtu.reset();
+  interface.type.reset();
+  interface.loopbackMode.reset();
+  interface.description.reset();
+  interface.lastChange.reset();
+  interface.countersSet.reset();
+  slots.emplace(index, used);
+  return interfaces[used++];
+}
+
+size_t Table::size() const {
+  return used;
+}
+
+std::vector<Table::Interface>::iterator Table::begin() {
+  return interfaces.begin();
+}
+
+std::vector<Table::Interface>::iterator Table::end() {
+  return interfaces.begin() + static_cast<std::ptrdiff_t>(used);
+}
+
+static void setBoth(
+    folly::dynamic& config,
+    folly::dynamic& state,
+    const char* key,
+    const folly::dynamic& value) {
+  config[key] = value;
+  state[key] = value;
+}
+
+void Table::materialize(folly::dynamic& state) const {
+  Model::init(state);
+  auto& list = state["openconfig-interfaces:interfaces"]["interface"];
+  for (size_t i = 0; i < used; ++i) {
+    auto& entry = interfaces[i];
+    folly::dynamic interface = folly::dynamic::object;
+    auto& istate = interface["state"] = folly::dynamic::object;
+    auto& counters = istate["counters"] = folly::dynamic::object;
+    auto& config = interface["config"] = folly::dynamic::object;
+
+    // Interfaces are named after their index until ifName is known.
+    interface["name"] = config["name"] =
+        entry.name ? *entry.name : folly::to<std::string>(entry.index);
+    istate["ifindex"] = entry.index;
+    if (entry.name) {
+      istate["name"] = *entry.name;
+    }
+    if (entry.operStatus) {
+      // TODO this is not valid according to the model but
+      // we need to fix the front-end.
+      interface["oper-status"] = istate["oper-status"] = *entry.operStatus;
+    }
+    if (entry.adminStatus) {
+      istate["admin-status"] = *entry.adminStatus;
+    }
+    if (entry.enabled) {
+      setBoth(config, istate, "enabled", *entry.enabled);
+    }
+    if (entry.mtu) {
+      setBoth(config, istate, "mtu", *entry.mtu);
+    }
+    if (entry.type) {
+      setBoth(config, istate, "type", *entry.type);
+    }
+    if (entry.loopbackMode) {
+      setBoth(config, istate, "loopback-mode", *entry.loopbackMode);
+    }
+    if (entry.description) {
+      setBoth(config, istate, "description", *entry.description);
+    }
+    if (entry.lastChange) {
+      istate["last-change"] = *entry.lastChange;
+    }
+    // 64 bit counters are strings in the JSON encoding of YANG.
+    for (size_t c = 0; c < counterCount; ++c) {
+      if (entry.countersSet.test(c)) {
+        counters[counterNames[c]] =
+            folly::to<std::string>(entry.counters[c]);
+      }
+    }
+
+    list.push_back(std::move(interface));
+  }
+}
+
+} // namespace interface
+} // namespace models
+} // namespace devmand
@@ -0,0 +1,105 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/Optional.h>
+#include <folly/dynamic.h>
+
+namespace devmand {
+namespace models {
+namespace interface {
+
+/*
+ * The interfaces of a device indexed by ifIndex. Polls write the values they
+ * get straight into an interface's slot and the openconfig-interfaces tree is
+ * only built from the table once, when the state is collected. The table is
+ * kept across polls so slots are reused rather than reallocated.
+ */
+class Table final {
+ public:
+  enum class Counter : size_t {
+    IN_OCTETS,
+    IN_UNICAST_PKTS,
+    IN_BROADCAST_PKTS,
+    IN_MULTICAST_PKTS,
+    IN_DISCARDS,
+    IN_ERRORS,
+    IN_UNKNOWN_PROTOS,
+    OUT_OCTETS,
+    OUT_UNICAST_PKTS,
+    OUT_BROADCAST_PKTS,
+    OUT_MULTICAST_PKTS,
+    OUT_DISCARDS,
+    OUT_ERRORS,
+    COUNT
+  };
+
+  static constexpr size_t counterCount = static_cast<size_t>(Counter::COUNT);
+
+  struct Interface {
+    int index{0};
+    folly::Optional<std::string> name;
+    folly::Optional<std::string> operStatus;
+    folly::Optional<std::string> adminStatus;
+    folly::Optional<bool> enabled;
+    folly::Optional<std::string> mtu;
+    folly::Optional<std::string> type;
+    folly::Optional<bool> loopbackMode;
+    folly::Optional<std::string> description;
+    folly::Optional<std::string> lastChange;
+
+    std::array<uint64_t, counterCount> counters{};
+    std::bitset<counterCount> countersSet;
+
+    void setCounter(Counter counter, uint64_t value);
+  };
+
+ public:
+  Table() = default;
+  ~Table() = default;
+  Table(const Table&) = delete;
+  Table& operator=(const Table&) = delete;
+  Table(Table&&) = delete;
+  Table& operator=(Table&&) = delete;
+
+ public:
+  // Starts a poll of these interfaces, in this order, with nothing set.
+  void reset(const std::vector<int>& indices = {});
+
+  // Returns the slot of an interface, adding one if it wasn't polled.
+  Interface& get(int index);
+
+  size_t size() const;
+
+  // The interfaces of the current poll.
+  std::vector<Interface>::iterator begin();
+  std::vector<Interface>::iterator end();
+
+  // Adds the interfaces to the state as openconfig-interfaces.
+  void materialize(folly::dynamic& state) const;
+
+  // The name of a counter in openconfig-interfaces, e.g. in-octets.
+  static const char* getCounterName(Counter counter);
+
+ private:
+  // Only the first size entries are in use, the rest are kept for reuse.
+  std::vector<Interface> interfaces;
+  size_t used{0};
+  std::unordered_map<int, size_t> slots;
+};
+
+} // namespace interface
+} // namespace models
+} // namespace devmand
@@ -0,0 +1,225 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <folly/futures/Future.h>
+
+#include <devmand/ConfigApplier.h>
+#include <devmand/MetricSink.h>
+#include <devmand/test/EventBaseTest.h>
+#include <devmand/test/TestUtils.h>
+
+namespace devmand {
+namespace test {
+
+class ConfigApplierTest : public EventBaseTest, public MetricSink {
+ public:
+  ConfigApplierTest() = default;
+  ~ConfigApplierTest() override = default;
+  ConfigApplierTest(const ConfigApplierTest&) = delete;
+  ConfigApplierTest& operator=(const ConfigApplierTest&) = delete;
+  ConfigApplierTest(ConfigApplierTest&&) = delete;
+  ConfigApplierTest& operator=(ConfigApplierTest&&) = delete;
+
+ public:
+  void setGauge(
+      const std::string&,
+      double,
+      const std::string&,
+      const std::string&) override {}
+
+  void observeHistogram(
+      const std::string& key,
+      double,
+      const std::vector<double>&,
+      const std::string&,
+      const std::string&) override {
+    if (key == "device.config.apply_latency_seconds") {
+      ++latencyObservations;
+    }
+  }
+
+ protected:
+  std::atomic<unsigned int> latencyObservations{0};
+};
+
+TEST_F(ConfigApplierTest, appliesOnlyDirtyDevices) {
+  ConfigApplier applier(eventBase, *this);
+  std::atomic<unsigned int> applies{0};
+  ConfigApplier::Generation generation{0};
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    generation = applier.markDirty("device1", [&applies]() {
+      ++applies;
+      return folly::makeFuture();
+    });
+  });
+
+  EXPECT_BECOMES_TRUE(applies == 1);
+  EXPECT_BECOMES_TRUE(latencyObservations == 1);
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    EXPECT_EQ(generation, applier.getAppliedGeneration("device1"));
+  });
+
+  // Nothing changed so nothing is applied again.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(1u, applies.load());
+
+  eventBase.runInEventBaseThreadAndWait([&]() { applier.del("device1"); });
+  stop();
+}
+
+TEST_F(ConfigApplierTest, coalescesChangesDuringAnApply) {
+  ConfigApplier applier(eventBase, *this);
+  folly::Promise<folly::Unit> blocked;
+  auto unblocked = blocked.getFuture();
+  std::atomic<unsigned int> applies{0};
+  auto apply = [&]() {
+    if (++applies == 1) {
+      std::move(unblocked).get();
+    }
+    return folly::makeFuture();
+  };
+
+  ConfigApplier::Generation last{0};
+  eventBase.runInEventBaseThreadAndWait(
+      [&]() { applier.markDirty("device1", apply); });
+  EXPECT_BECOMES_TRUE(applies == 1);
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    for (int i = 0; i < 5; ++i) {
+      last = applier.markDirty("device1", apply);
+    }
+  });
+
+  blocked.setValue();
+  EXPECT_BECOMES_TRUE(latencyObservations == 2);
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    EXPECT_EQ(last, applier.getAppliedGeneration("device1"));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(2u, applies.load());
+
+  eventBase.runInEventBaseThreadAndWait([&]() { applier.del("device1"); });
+  stop();
+}
+
+TEST_F(ConfigApplierTest, respectsConcurrencyBudget) {
+  ConfigApplier applier(eventBase, *this, 1);
+  folly::Promise<folly::Unit> blocked;
+  auto unblocked = blocked.getFuture();
+  std::atomic<unsigned int> applies{0};
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    for (auto id : {"device1", "device2", "device3"}) {
+      applier.markDirty(id, [&]() {
+        if (++applies == 1) {
+          std::move(unblocked).get();
+        }
+        return folly::makeFuture();
+      });
+    }
+  });
+
+  // Only the first apply may run until it completes.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(1u, applies.load());
+
+  blocked.setValue();
+  EXPECT_BECOMES_TRUE(latencyObservations == 3);
+  EXPECT_EQ(3u, applies.load());
+
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    for (auto id : {"device1", "device2", "device3"}) {
+      applier.del(id);
+    }
+  });
+  stop();
+}
+
+TEST_F(ConfigApplierTest, retriesFailedApplies) {
+  ConfigApplier applier(eventBase, *this, 1, std::chrono::milliseconds(10));
+  std::atomic<unsigned int> applies{0};
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    applier.markDirty("device1", [&applies]() -> folly::Future<folly::Unit> {
+      if (++applies < 3) {
+        throw std::runtime_error("device unreachable");
+      }
+      return folly::makeFuture();
+    });
+  });
+
+  EXPECT_BECOMES_TRUE(applies == 3);
+  EXPECT_BECOMES_TRUE(latencyObservations == 1);
+
+  eventBase.runInEventBaseThreadAndWait([&]() { applier.del("device1"); });
+  stop();
+}
+
+TEST_F(ConfigApplierTest, retriesAppliesWhichFailLater) {
+  ConfigApplier applier(eventBase, *this, 1, std::chrono::milliseconds(10));
+  std::atomic<unsigned int> applies{0};
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    applier.markDirty("device1", [&]() {
+      // Like a device rejecting the config after the command was sent.
+      return folly::via(&eventBase).thenValue([&applies](folly::Unit) {
+        if (++applies < 3) {
+          throw std::runtime_error("config rejected");
+        }
+      });
+    });
+  });
+
+  EXPECT_BECOMES_TRUE(applies == 3);
+  EXPECT_BECOMES_TRUE(latencyObservations == 1);
+
+  eventBase.runInEventBaseThreadAndWait([&]() { applier.del("device1"); });
+  stop();
+}
+
+TEST_F(ConfigApplierTest, retriesAppliesWhichTimeOutOnceTheyComplete) {
+  ConfigApplier applier(
+      eventBase,
+      *this,
+      1,
+      std::chrono::milliseconds(10),
+      std::chrono::milliseconds(50));
+  std::atomic<unsigned int> applies{0};
+  // Like commands sent to a router which only answers long after.
+  folly::Promise<folly::Unit> late;
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    applier.markDirty("device1", [&]() {
+      if (++applies == 1) {
+        return late.getFuture();
+      }
+      return folly::makeFuture();
+    });
+  });
+
+  // Well past the timeout and the retry interval it is still in flight.
+  EXPECT_BECOMES_TRUE(applies == 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_EQ(1u, applies.load());
+  eventBase.runInEventBaseThreadAndWait(
+      [&]() { EXPECT_EQ(1u, applier.getNumInFlight()); });
+
+  // Completing after the timeout still fails it, so it is retried.
+  late.setValue();
+  EXPECT_BECOMES_TRUE(applies == 2);
+  EXPECT_BECOMES_TRUE(latencyObservations == 1);
+
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    EXPECT_EQ(0u, applier.getNumInFlight());
+    applier.del("device1");
+  });
+  stop();
+}
+
+} // namespace test
+} // namespace devmand
@@ -0,0 +1,451 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include <folly/Conv.h>
+#include <folly/Format.h>
+#include <folly/dynamic.h>
+#include <folly/io/IOBuf.h>
+#include <folly/io/async/AsyncServerSocket.h>
+#include <folly/io/async/AsyncSocket.h>
+#include <folly/json.h>
+
+#include <devmand/Config.h>
+#include <devmand/channels/cnmaestro/Channel.h>
+#include <devmand/channels/http/Engine.h>
+#include <devmand/test/EventBaseTest.h>
+
+namespace devmand {
+namespace test {
+
+using channels::http::Engine;
+using channels::http::Request;
+using channels::http::Response;
+
+struct HttpReply {
+  int status{404};
+  std::string body{"missing"};
+};
+
+// Answers a request given its head, i.e. request line and headers, and body.
+using HttpHandler =
+    std::function<HttpReply(const std::string& head, const std::string& body)>;
+
+// Serves GET /ping and 404s everything else.
+static HttpReply servePing(const std::string& head, const std::string&) {
+  if (head.find("GET /ping ") == 0) {
+    return HttpReply{200, "pong"};
+  }
+  return HttpReply{};
+}
+
+// Serves requests with HTTP/1.1 keep alive.
+class HttpConnection final
+    : public folly::AsyncTransportWrapper::ReadCallback {
+ public:
+  HttpConnection(folly::EventBase& eventBase, int fd, HttpHandler handler_)
+      : socket(folly::AsyncSocket::newSocket(
+            &eventBase,
+            folly::NetworkSocket::fromFd(fd))),
+        handler(std::move(handler_)) {
+    socket->setReadCB(this);
+  }
+  HttpConnection() = delete;
+  ~HttpConnection() override = default;
+  HttpConnection(const HttpConnection&) = delete;
+  HttpConnection& operator=(const HttpConnection&) = delete;
+  HttpConnection(HttpConnection&&) = delete;
+  HttpConnection& operator=(HttpConnection&&) = delete;
+
+ public:
+  void getReadBuffer(void** bufReturn, size_t* lenReturn) override {
+    *bufReturn = reinterpret_cast<void*>(buffer);
+    *lenReturn = maxBuffer;
+  }
+
+  void readDataAvailable(size_t len) noexcept override {
+    received.append(buffer, len);
+    size_t end;
+    while ((end = received.find("\r\n\r\n")) != std::string::npos) {
+      auto head = received.substr(0, end + 2);
+      auto length = getContentLength(head);
+      if (received.size() < end + 4 + length) {
+        // The rest of the body is still on its way.
+        break;
+      }
+      auto body = received.substr(end + 4, length);
+      received.erase(0, end + 4 + length);
+
+      auto reply = handler(head, body);
+      auto response = folly::sformat(
+          "HTTP/1.1 {} X\r\nContent-Length: {}\r\n\r\n{}",
+          reply.status,
+          reply.body.size(),
+          reply.body);
+      socket->writeChain(nullptr, folly::IOBuf::copyBuffer(response));
+    }
+  }
+
+  void readEOF() noexcept override {}
+
+  void readErr(const folly::AsyncSocketException&) noexcept override {}
+
+ private:
+  static size_t getContentLength(const std::string& head) {
+    std::string lower(head);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) {
+      return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    });
+    auto header = lower.find("\r\ncontent-length:");
+    if (header == std::string::npos) {
+      return 0;
+    }
+    return std::stoul(lower.substr(header + 17));
+  }
+
+ private:
+  constexpr static size_t maxBuffer{4096};
+  std::shared_ptr<folly::AsyncSocket> socket;
+  HttpHandler handler;
+  char buffer[maxBuffer];
+  std::string received;
+};
+
+/*
+ * A cnMaestro controller managing numDevices devices. It hands out the
+ * tokens token1, token2, ... and answers requests bearing any token up to
+ * revokedTokens with 401.
+ */
+class CnMaestro final {
+ public:
+  static std::string getMac(int device) {
+    return folly::sformat(
+        "AA:BB:CC:DD:{:02X}:{:02X}", device / 256, device % 256);
+  }
+
+  HttpReply handle(const std::string& head, const std::string& body) {
+    if (head.find("POST /api/v1/access/token ") == 0) {
+      if (body.find("client_id=id&client_secret=secret") == std::string::npos) {
+        return HttpReply{401, "{}"};
+      }
+      return HttpReply{
+          200,
+          folly::sformat(
+              "{{\"access_token\":\"token{}\",\"expires_in\":3600}}",
+              ++tokenRequests)};
+    }
+
+    if (not isAuthorized(head)) {
+      ++unauthorized;
+      return HttpReply{401, "{}"};
+    }
+
+    if (head.find("GET /api/v1/devices?") == 0) {
+      ++listRequests;
+      auto limit = getParameter(head, "limit=");
+      auto offset = getParameter(head, "offset=");
+      folly::dynamic data = folly::dynamic::array;
+      for (int i = offset; i < std::min(offset + limit, numDevices); ++i) {
+        data.push_back(folly::dynamic::object("mac", getMac(i))(
+            "name", folly::sformat("device{}", i)));
+      }
+      return HttpReply{
+          200,
+          folly::toJson(folly::dynamic::object("data", std::move(data))(
+              "paging",
+              folly::dynamic::object("limit", limit)("offset", offset)(
+                  "total", numDevices)))};
+    }
+
+    if (head.find("PUT /api/v1/devices/") == 0) {
+      ++updates;
+      return HttpReply{200, "{}"};
+    }
+
+    return HttpReply{};
+  }
+
+ private:
+  bool isAuthorized(const std::string& head) {
+    const std::string bearer{"\r\nAuthorization: Bearer token"};
+    auto start = head.find(bearer);
+    if (start == std::string::npos) {
+      return false;
+    }
+    start += bearer.size();
+    auto token =
+        folly::tryTo<int>(head.substr(start, head.find("\r\n", start) - start));
+    return token.hasValue() and token.value() > revokedTokens.load();
+  }
+
+  static int getParameter(const std::string& head, const std::string& name) {
+    auto start = head.find(name) + name.size();
+    return folly::to<int>(
+        head.substr(start, head.find_first_of("& ", start) - start));
+  }
+
+ public:
+  int numDevices{0};
+  std::atomic<int> revokedTokens{0};
+  std::atomic<int> tokenRequests{0};
+  std::atomic<int> listRequests{0};
+  std::atomic<int> updates{0};
+  std::atomic<int> unauthorized{0};
+};
+
+class HttpEngineTest : public folly::AsyncServerSocket::AcceptCallback,
+                       public EventBaseTest {
+ public:
+  HttpEngineTest() = default;
+  ~HttpEngineTest() override = default;
+  HttpEngineTest(const HttpEngineTest&) = delete;
+  HttpEngineTest& operator=(const HttpEngineTest&) = delete;
+  HttpEngineTest(HttpEngineTest&&) = delete;
+  HttpEngineTest& operator=(HttpEngineTest&&) = delete;
+
+ protected:
+  void listen() {
+    eventBase.runInEventBaseThreadAndWait([this]() {
+      lsocket = folly::AsyncServerSocket::newSocket(&eventBase);
+      lsocket->bind(folly::SocketAddress("127.0.0.1", 0));
+      lsocket->addAcceptCallback(this, &eventBase);
+      lsocket->listen(100);
+      lsocket->startAccepting();
+      port = lsocket->getAddress().getPort();
+    });
+  }
+
+  std::string url(const std::string& path) {
+    return folly::sformat("http://127.0.0.1:{}{}", port, path);
+  }
+
+  Response get(Engine& engine, const std::string& path) {
+    Request request;
+    request.url = url(path);
+    return engine.request(std::move(request)).get(std::chrono::seconds(10));
+  }
+
+  std::shared_ptr<channels::cnmaestro::Channel> serveCnMaestro(Engine& engine) {
+    handler = [this](const std::string& head, const std::string& body) {
+      return cnMaestro.handle(head, body);
+    };
+    listen();
+    return std::make_shared<channels::cnmaestro::Channel>(
+        engine, url(""), "id", "secret");
+  }
+
+ public:
+  void connectionAccepted(
+      int fd,
+      const folly::SocketAddress&) noexcept override {
+    ++accepted;
+    connections.emplace_back(
+        std::make_unique<HttpConnection>(eventBase, fd, handler));
+  }
+
+  void acceptError(const std::exception&) noexcept override {
+    FAIL() << "accept error";
+  }
+
+ protected:
+  std::atomic<int> accepted{0};
+  uint16_t port{0};
+  std::shared_ptr<folly::AsyncServerSocket> lsocket{nullptr};
+  HttpHandler handler{servePing};
+  std::vector<std::unique_ptr<HttpConnection>> connections;
+  CnMaestro cnMaestro;
+};
+
+TEST_F(HttpEngineTest, keepsConnectionsAlive) {
+  listen();
+  Engine engine(eventBase);
+  for (int i = 0; i < 3; ++i) {
+    auto response = get(engine, "/ping");
+    EXPECT_FALSE(response.isError()) << response.get();
+    EXPECT_EQ(200, response.getStatus());
+    EXPECT_EQ("pong", response.get());
+  }
+  EXPECT_EQ(1, accepted.load());
+  EXPECT_EQ(3u, engine.getNumRequests());
+  stop();
+}
+
+TEST_F(HttpEngineTest, requestsQueueForTheHostLimit) {
+  listen();
+  Engine engine(eventBase, 1);
+  std::vector<folly::Future<Response>> responses;
+  for (int i = 0; i < 5; ++i) {
+    Request request;
+    request.url = url("/ping");
+    responses.emplace_back(engine.request(std::move(request)));
+  }
+  for (auto& response : responses) {
+    EXPECT_EQ("pong", std::move(response).get(std::chrono::seconds(10)).get());
+  }
+  EXPECT_EQ(1, accepted.load());
+  stop();
+}
+
+TEST_F(HttpEngineTest, errorStatusIsErrorResponse) {
+  listen();
+  Engine engine(eventBase);
+  auto response = get(engine, "/missing");
+  EXPECT_TRUE(response.isError());
+  EXPECT_EQ(404, response.getStatus());
+  stop();
+}
+
+TEST_F(HttpEngineTest, refusedConnectionIsErrorResponse) {
+  // Bind and close again to get a port nobody listens on.
+  listen();
+  eventBase.runInEventBaseThreadAndWait([this]() { lsocket = nullptr; });
+  Engine engine(eventBase);
+  auto response = get(engine, "/ping");
+  EXPECT_TRUE(response.isError());
+  EXPECT_EQ(0, response.getStatus());
+  stop();
+}
+
+TEST_F(HttpEngineTest, cnMaestroRefreshesTheTokenOnceForAllWaiters) {
+  Engine engine(eventBase);
+  auto channel = serveCnMaestro(engine);
+  auto update = folly::dynamic::object("name", "renamed");
+
+  // Started on the event base so that all wait for the token refresh.
+  std::vector<folly::Future<Response>> responses;
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    for (int i = 0; i < 5; ++i) {
+      responses.emplace_back(
+          channel->updateDevice(update, CnMaestro::getMac(i)));
+    }
+  });
+  for (auto& response : responses) {
+    EXPECT_EQ(
+        200, std::move(response).get(std::chrono::seconds(10)).getStatus());
+  }
+  EXPECT_EQ(1, cnMaestro.tokenRequests.load());
+
+  // And later requests use the cached token.
+  auto response = channel->updateDevice(update, CnMaestro::getMac(0))
+                      .get(std::chrono::seconds(10));
+  EXPECT_EQ(200, response.getStatus());
+  EXPECT_EQ(1, cnMaestro.tokenRequests.load());
+  EXPECT_EQ(6, cnMaestro.updates.load());
+  EXPECT_EQ(0, cnMaestro.unauthorized.load());
+  stop();
+}
+
+TEST_F(HttpEngineTest, cnMaestroRetriesOnceWithANewTokenOn401) {
+  Engine engine(eventBase);
+  auto channel = serveCnMaestro(engine);
+  auto update = folly::dynamic::object("name", "renamed");
+
+  EXPECT_EQ(
+      200,
+      channel->updateDevice(update, CnMaestro::getMac(0))
+          .get(std::chrono::seconds(10))
+          .getStatus());
+  EXPECT_EQ(1, cnMaestro.tokenRequests.load());
+
+  // The controller forgot token1, e.g. it restarted.
+  cnMaestro.revokedTokens = 1;
+  EXPECT_EQ(
+      200,
+      channel->updateDevice(update, CnMaestro::getMac(0))
+          .get(std::chrono::seconds(10))
+          .getStatus());
+  EXPECT_EQ(2, cnMaestro.tokenRequests.load());
+  EXPECT_EQ(1, cnMaestro.unauthorized.load());
+  EXPECT_EQ(2, cnMaestro.updates.load());
+
+  // A 401 for the new token as well is returned rather than retried again.
+  cnMaestro.revokedTokens = 3;
+  auto response = channel->updateDevice(update, CnMaestro::getMac(0))
+                      .get(std::chrono::seconds(10));
+  EXPECT_TRUE(response.isError());
+  EXPECT_EQ(401, response.getStatus());
+  EXPECT_EQ(3, cnMaestro.tokenRequests.load());
+  EXPECT_EQ(3, cnMaestro.unauthorized.load());
+  EXPECT_EQ(2, cnMaestro.updates.load());
+  stop();
+}
+
+TEST_F(HttpEngineTest, cnMaestroListsAllPages) {
+  cnMaestro.numDevices = 250;
+  Engine engine(eventBase);
+  auto channel = serveCnMaestro(engine);
+
+  for (int i : {0, 99, 100, 249}) {
+    auto info = channel->getDeviceInfo(CnMaestro::getMac(i))
+                    .get(std::chrono::seconds(10));
+    ASSERT_TRUE(info.isObject()) << i;
+    EXPECT_EQ(folly::sformat("device{}", i), info["name"].asString());
+  }
+  // Macs are matched regardless of case.
+  EXPECT_TRUE(channel->getDeviceInfo("aa:bb:cc:dd:00:01")
+                  .get(std::chrono::seconds(10))
+                  .isObject());
+  EXPECT_TRUE(channel->getDeviceInfo(CnMaestro::getMac(250))
+                  .get(std::chrono::seconds(10))
+                  .isNull());
+  EXPECT_EQ(3, cnMaestro.listRequests.load());
+  stop();
+}
+
+TEST_F(HttpEngineTest, cnMaestroCachesTheListingForHalfAPollInterval) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_poll_interval = 2;
+  cnMaestro.numDevices = 10;
+  Engine engine(eventBase);
+  auto channel = serveCnMaestro(engine);
+  auto getInfo = [&channel](int device) {
+    return channel->getDeviceInfo(CnMaestro::getMac(device))
+        .get(std::chrono::seconds(10));
+  };
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(getInfo(i).isObject());
+  }
+  EXPECT_EQ(1, cnMaestro.listRequests.load());
+
+  // Past half the poll interval all devices share a single new listing.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  std::vector<folly::Future<folly::dynamic>> infos;
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    for (int i = 0; i < 10; ++i) {
+      infos.emplace_back(channel->getDeviceInfo(CnMaestro::getMac(i)));
+    }
+  });
+  for (auto& info : infos) {
+    EXPECT_TRUE(std::move(info).get(std::chrono::seconds(10)).isObject());
+  }
+  EXPECT_EQ(2, cnMaestro.listRequests.load());
+
+  // An update drops the listing so that the next poll sees it.
+  auto update = folly::dynamic::object("name", "renamed");
+  EXPECT_EQ(
+      200,
+      channel->updateDevice(update, CnMaestro::getMac(0))
+          .get(std::chrono::seconds(10))
+          .getStatus());
+  EXPECT_TRUE(getInfo(0).isObject());
+  EXPECT_EQ(3, cnMaestro.listRequests.load());
+  stop();
+}
+
+} // namespace test
+} // namespace devmand
@@ -0,0 +1,157 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <folly/Conv.h>
+#include <folly/GLog.h>
+#include <gtest/gtest.h>
+
+#include <devmand/models/interface/Model.h>
+#include <devmand/models/interface/Table.h>
+
+namespace devmand {
+namespace test {
+
+using Model = models::interface::Model;
+using Table = models::interface::Table;
+
+static std::vector<int> getIndices(int ports) {
+  std::vector<int> indices;
+  for (int i = 0; i < ports; ++i) {
+    // Sparse like the ifIndex of most switches.
+    indices.push_back(1000 + i * 3);
+  }
+  return indices;
+}
+
+// Polls the ports into the state a value at a time as the SNMP device did.
+static void pollModel(folly::dynamic& state, const std::vector<int>& indices) {
+  Model::init(state);
+  for (int index : indices) {
+    auto name = folly::to<std::string>("eth", index);
+    Model::updateInterface(state, index, "name", name);
+    Model::updateInterface(state, index, "state/name", name);
+    Model::updateInterface(state, index, "config/name", name);
+    Model::updateInterface(state, index, "oper-status", "UP");
+    Model::updateInterface(state, index, "state/oper-status", "UP");
+    Model::updateInterface(state, index, "state/admin-status", "UP");
+    Model::updateInterface(state, index, "config/enabled", true);
+    Model::updateInterface(state, index, "state/enabled", true);
+    Model::updateInterface(state, index, "config/mtu", "1500");
+    Model::updateInterface(state, index, "state/mtu", "1500");
+    for (size_t c = 0; c < Table::counterCount; ++c) {
+      Model::updateInterface(
+          state,
+          index,
+          folly::to<std::string>(
+              "state/counters/",
+              Table::getCounterName(static_cast<Table::Counter>(c))),
+          folly::to<std::string>(index * c));
+    }
+  }
+}
+
+static void pollTable(Table& table, const std::vector<int>& indices) {
+  table.reset(indices);
+  for (int index : indices) {
+    auto& interface = table.get(index);
+    interface.name = folly::to<std::string>("eth", index);
+    interface.operStatus = "UP";
+    interface.adminStatus = "UP";
+    interface.enabled = true;
+    interface.mtu = "1500";
+    for (size_t c = 0; c < Table::counterCount; ++c) {
+      interface.setCounter(
+          static_cast<Table::Counter>(c), static_cast<uint64_t>(index * c));
+    }
+  }
+}
+
+TEST(InterfaceTableTest, materializesLikeModel) {
+  auto indices = getIndices(4);
+  folly::dynamic expected = folly::dynamic::object;
+  pollModel(expected, indices);
+
+  Table table;
+  pollTable(table, indices);
+  folly::dynamic actual = folly::dynamic::object;
+  table.materialize(actual);
+
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(InterfaceTableTest, unpolledInterfaceIsNamedAfterIndex) {
+  Table table;
+  table.reset({7});
+  table.get(9).setCounter(Table::Counter::IN_ERRORS, 3);
+  EXPECT_EQ(2u, table.size());
+
+  folly::dynamic expected = folly::dynamic::object;
+  Model::init(expected);
+  Model::updateInterface(expected, 7, "state/ifindex", 7);
+  Model::updateInterface(expected, 9, "state/counters/in-errors", "3");
+
+  folly::dynamic actual = folly::dynamic::object;
+  table.materialize(actual);
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(InterfaceTableTest, resetForgetsLastPoll) {
+  Table table;
+  table.reset({1, 2});
+  table.get(1).description = "uplink";
+  auto* slot = &table.get(2);
+
+  table.reset({2});
+  EXPECT_EQ(1u, table.size());
+  // Slots are reused in order.
+  EXPECT_NE(slot, &table.get(2));
+  EXPECT_FALSE(table.get(2).description.hasValue());
+  EXPECT_FALSE(table.get(2).countersSet.any());
+}
+
+TEST(InterfaceTableTest, pollingBenchmark) {
+  for (int ports : {48, 96, 512}) {
+    auto indices = getIndices(ports);
+    const int polls = 10;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < polls; ++i) {
+      folly::dynamic state = folly::dynamic::object;
+      pollModel(state, indices);
+    }
+    auto modelTime = std::chrono::steady_clock::now() - start;
+
+    Table table;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < polls; ++i) {
+      pollTable(table, indices);
+      folly::dynamic state = folly::dynamic::object;
+      table.materialize(state);
+      EXPECT_EQ(
+          static_cast<size_t>(ports),
+          state["openconfig-interfaces:interfaces"]["interface"].size());
+    }
+    auto tableTime = std::chrono::steady_clock::now() - start;
+
+    LOG(INFO) << ports << " ports, " << polls << " polls: model "
+              << std::chrono::duration_cast<std::chrono::microseconds>(
+                     modelTime)
+                     .count()
+              << "us, table "
+              << std::chrono::duration_cast<std::chrono::microseconds>(
+                     tableTime)
+                     .count()
+              << "us";
+  }
+}
+
+} // namespace test
+} // namespace devmand
@@ -0,0 +1,145 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <devmand/magma/GaugeCache.h>
+
+namespace devmand {
+namespace test {
+
+// Gauges by "name{label=value,...}", standing in for the service303 registry.
+class StubRegistry : public magma::GaugeCache::Registry {
+ public:
+  prometheus::Gauge& getGauge(
+      const std::string& name,
+      const std::map<std::string, std::string>& labels) override {
+    ++lookups;
+    auto& gauge = gauges[getKey(name, labels)];
+    if (gauge == nullptr) {
+      gauge = std::make_unique<prometheus::Gauge>();
+    }
+    return *gauge;
+  }
+
+  void removeGauge(
+      const std::string& name,
+      const std::map<std::string, std::string>& labels) override {
+    gauges.erase(getKey(name, labels));
+  }
+
+  static std::string getKey(
+      const std::string& name,
+      const std::map<std::string, std::string>& labels) {
+    std::string key = name + "{";
+    for (auto& label : labels) {
+      if (key.back() != '{') {
+        key += ",";
+      }
+      key += label.first + "=" + label.second;
+    }
+    return key + "}";
+  }
+
+  double get(const std::string& key) {
+    auto gauge = gauges.find(key);
+    return gauge == gauges.end() ? -1 : gauge->second->Value();
+  }
+
+ public:
+  std::map<std::string, std::unique_ptr<prometheus::Gauge>> gauges;
+  unsigned int lookups{0};
+};
+
+class MagmaGaugeCacheTest : public ::testing::Test {
+ public:
+  MagmaGaugeCacheTest() = default;
+  ~MagmaGaugeCacheTest() override = default;
+  MagmaGaugeCacheTest(const MagmaGaugeCacheTest&) = delete;
+  MagmaGaugeCacheTest& operator=(const MagmaGaugeCacheTest&) = delete;
+  MagmaGaugeCacheTest(MagmaGaugeCacheTest&&) = delete;
+  MagmaGaugeCacheTest& operator=(MagmaGaugeCacheTest&&) = delete;
+
+ protected:
+  StubRegistry* registry{new StubRegistry};
+  magma::GaugeCache cache{std::unique_ptr<StubRegistry>(registry)};
+  const MetricFamily& status{MetricFamily::get("test.gauge.status")};
+  const MetricFamily& octets{
+      MetricFamily::get("test.gauge.octets", "ifindex")};
+};
+
+TEST_F(MagmaGaugeCacheTest, resolvesGaugesOnce) {
+  for (int i = 0; i < 3; i++) {
+    MetricSample sample("deviceID", "dev1");
+    sample.set(status, i);
+    sample.set(octets, "1", 10 * i);
+    cache.set(sample);
+  }
+
+  EXPECT_EQ(2u, registry->lookups);
+  EXPECT_EQ(2u, registry->gauges.size());
+  EXPECT_EQ(2, registry->get("test.gauge.status{deviceID=dev1}"));
+  EXPECT_EQ(
+      20, registry->get("test.gauge.octets{deviceID=dev1,ifindex=1}"));
+}
+
+TEST_F(MagmaGaugeCacheTest, removesLabelsMissingFromASample) {
+  MetricSample first("deviceID", "dev1");
+  first.set(octets, "1", 10);
+  first.set(octets, "2", 20);
+  cache.set(first);
+  EXPECT_EQ(2u, registry->gauges.size());
+
+  // Interface 2 went away
+  MetricSample second("deviceID", "dev1");
+  second.set(octets, "1", 11);
+  cache.set(second);
+  EXPECT_EQ(1u, registry->gauges.size());
+  EXPECT_EQ(
+      11, registry->get("test.gauge.octets{deviceID=dev1,ifindex=1}"));
+
+  // And came back, it has to be resolved again
+  MetricSample third("deviceID", "dev1");
+  third.set(octets, "1", 12);
+  third.set(octets, "2", 22);
+  cache.set(third);
+  EXPECT_EQ(2u, registry->gauges.size());
+  EXPECT_EQ(3u, registry->lookups);
+  EXPECT_EQ(
+      22, registry->get("test.gauge.octets{deviceID=dev1,ifindex=2}"));
+}
+
+TEST_F(MagmaGaugeCacheTest, removesGaugesOfARemovedSource) {
+  MetricSample dev1("deviceID", "dev1");
+  dev1.set(status, 1);
+  dev1.set(octets, "1", 10);
+  cache.set(dev1);
+  MetricSample dev2("deviceID", "dev2");
+  dev2.set(status, 2);
+  cache.set(dev2);
+  EXPECT_EQ(3u, registry->gauges.size());
+
+  cache.remove("deviceID", "dev1");
+  EXPECT_EQ(1u, registry->gauges.size());
+  EXPECT_EQ(2, registry->get("test.gauge.status{deviceID=dev2}"));
+
+  // Unknown sources are ignored
+  cache.remove("deviceID", "dev3");
+  EXPECT_EQ(1u, registry->gauges.size());
+
+  // A source coming back starts afresh
+  cache.set(dev1);
+  EXPECT_EQ(3u, registry->gauges.size());
+  EXPECT_EQ(1, registry->get("test.gauge.status{deviceID=dev1}"));
+}
+
+} // namespace test
+} // namespace devmand
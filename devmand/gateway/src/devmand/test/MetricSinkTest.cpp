@@ -0,0 +1,67 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <devmand/MetricSink.h>
+
+namespace devmand {
+namespace test {
+
+class MetricSinkTest : public ::testing::Test, public MetricSink {
+ public:
+  MetricSinkTest() = default;
+  ~MetricSinkTest() override = default;
+  MetricSinkTest(const MetricSinkTest&) = delete;
+  MetricSinkTest& operator=(const MetricSinkTest&) = delete;
+  MetricSinkTest(MetricSinkTest&&) = delete;
+  MetricSinkTest& operator=(MetricSinkTest&&) = delete;
+
+ public:
+  void setGauge(
+      const std::string& key,
+      double value,
+      const std::string& labelName,
+      const std::string& labelValue) override {
+    gauges[key + " " + labelName + "=" + labelValue] = value;
+  }
+
+ protected:
+  std::map<std::string, double> gauges;
+};
+
+TEST_F(MetricSinkTest, familiesAreRegisteredOnce) {
+  auto& family = MetricFamily::get("test.family", "label");
+  EXPECT_EQ(&family, &MetricFamily::get("test.family", "label"));
+  EXPECT_NE(&family, &MetricFamily::get("test.family"));
+  EXPECT_NE(family.getId(), MetricFamily::get("test.other").getId());
+  EXPECT_EQ("test.family", family.getName());
+  EXPECT_EQ("label", family.getLabelName());
+}
+
+TEST_F(MetricSinkTest, unbatchedSinkGetsEveryValue) {
+  auto& status = MetricFamily::get("test.status");
+  auto& counter = MetricFamily::get("test.counter", "ifindex");
+
+  auto sample = std::make_shared<MetricSample>("deviceID", "dev1");
+  sample->set(status, 1);
+  sample->set(counter, "1", 10);
+  sample->set(counter, "2", 20);
+  setGauges(sample);
+
+  EXPECT_EQ(3u, gauges.size());
+  EXPECT_EQ(1, gauges["test.status deviceID=dev1"]);
+  EXPECT_EQ(10, gauges["test.counter[ifindex=1] deviceID=dev1"]);
+  EXPECT_EQ(20, gauges["test.counter[ifindex=2] deviceID=dev1"]);
+}
+
+} // namespace test
+} // namespace devmand
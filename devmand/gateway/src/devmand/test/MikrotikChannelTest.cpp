@@ -5,8 +5,13 @@
 // LICENSE file in the root directory of this source tree. An additional grant
 // of patent rights can be found in the PATENTS file in the same directory.
 
+#include <chrono>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
+#include <folly/Conv.h>
+#include <folly/Synchronized.h>
 #include <folly/dynamic.h>
 #include <folly/io/async/AsyncServerSocket.h>
 #include <folly/json.h>
@@ -48,13 +53,13 @@ class MikrotikChannelTest : public folly::AsyncServerSocket::AcceptCallback,
   void connectionAccepted(
       int fd,
       const folly::SocketAddress&) noexcept override {
-    acceptNotifier.notify();
     asocket = folly::AsyncSocket::newSocket(
         &eventBase, folly::NetworkSocket::fromFd(fd));
     asocket->setReadCB(this);
 
     // Only accept once so tests are predicatable. Recall listen if needed.
     lsocket = nullptr;
+    acceptNotifier.notify();
   }
 
   void acceptError(const std::exception&) noexcept override {
@@ -68,6 +73,7 @@ class MikrotikChannelTest : public folly::AsyncServerSocket::AcceptCallback,
   }
 
   void readDataAvailable(size_t len) noexcept override {
+    received.wlock()->append(buffer, len);
     if (not checkReads) {
       return;
     }
@@ -90,11 +96,81 @@ class MikrotikChannelTest : public folly::AsyncServerSocket::AcceptCallback,
   // This is test code so just make async sync.
   void write(const std::string& buf) {
     assert(asocket != nullptr);
-    asocket->write(this, buf.data(), buf.length());
+    eventBase.runInEventBaseThread(
+        [this, &buf]() { asocket->write(this, buf.data(), buf.length()); });
 
     writeNotifier.wait();
   }
 
+  // Writes a sentence the way the router does.
+  void write(const channels::mikrotik::Sentence& sentence) {
+    std::string buf;
+    for (auto& word : sentence) {
+      buf += channels::mikrotik::computeLength(
+          static_cast<uint32_t>(word.length()));
+      buf += word;
+    }
+    buf += channels::mikrotik::computeLength(0);
+    write(buf);
+  }
+
+  // Waits for the next sentence the channel sent.
+  channels::mikrotik::Sentence readSentence() {
+    for (int i = 0; i < 500; ++i) {
+      {
+        auto locked = received.wlock();
+        channels::mikrotik::Sentence sentence;
+        size_t offset{0};
+        while (offset < locked->size()) {
+          auto length = channels::mikrotik::readLength(
+              locked->data() + offset, locked->size() - offset);
+          if (length.lengthSize == 0 or
+              offset + length.lengthSize + length.contentLength >
+                  locked->size()) {
+            break;
+          }
+          std::string word{locked->data() + offset + length.lengthSize,
+                           length.contentLength};
+          offset += length.lengthSize + length.contentLength;
+          if (word.empty()) {
+            locked->erase(0, offset);
+            return sentence;
+          }
+          sentence.emplace_back(std::move(word));
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ADD_FAILURE() << "no sentence was sent";
+    return {""};
+  }
+
+  static std::string getTag(const channels::mikrotik::Sentence& sentence) {
+    for (auto& word : sentence) {
+      if (word.compare(0, 5, ".tag=") == 0) {
+        return word.substr(5);
+      }
+    }
+    return "";
+  }
+
+  // Accepts the channel's connection and completes its login.
+  std::shared_ptr<channels::mikrotik::Channel> connectAndLogin(
+      std::shared_ptr<channels::mikrotik::Channel> channel = nullptr) {
+    checkReads = false;
+    listen();
+    if (channel == nullptr) {
+      channel = std::make_shared<channels::mikrotik::Channel>(
+          eventBase, folly::SocketAddress("127.0.0.1", 1337), "foo", "bar");
+    }
+    channel->connect();
+    acceptNotifier.wait();
+    EXPECT_EQ("/login", readSentence().front());
+    write(channels::mikrotik::Sentence{"!done"});
+    EXPECT_BECOMES_TRUE(channel->isLoggedIn());
+    return channel;
+  }
+
   void writeSuccess() noexcept override {
     writeNotifier.notify();
   }
@@ -117,6 +193,7 @@ class MikrotikChannelTest : public folly::AsyncServerSocket::AcceptCallback,
   size_t bufferLength{maxBuffer};
   char buffer[maxBuffer];
   bool checkReads{true};
+  folly::Synchronized<std::string> received;
 };
 
 TEST_F(MikrotikChannelTest, checkNotConnected) {
@@ -327,5 +404,122 @@ TEST_F(MikrotikChannelTest, DISABLED_checkLoginSuccessDeprecated) {
   stop();
 }
 
+TEST_F(MikrotikChannelTest, checkGetAttributes) {
+  checkReads = false;
+  auto attributes = channels::mikrotik::Channel::getAttributes(
+      {"!re", "=.id=*1", "=name=ether1", "=comment=a=b", "=.dead=", ".tag=3"});
+  EXPECT_EQ(4, attributes.size());
+  EXPECT_EQ("*1", attributes[".id"]);
+  EXPECT_EQ("ether1", attributes["name"]);
+  EXPECT_EQ("a=b", attributes["comment"]);
+  EXPECT_EQ(1, attributes.count(".dead"));
+  EXPECT_EQ(0, attributes.count(".tag"));
+  stop();
+}
+
+TEST_F(MikrotikChannelTest, demultiplexesRepliesByTag) {
+  auto channel = connectAndLogin();
+  auto interfaces = channel->query({"/interface/print"}, {"name"});
+  auto addresses = channel->query({"/ip/address/print"});
+
+  auto interfacesSent = readSentence();
+  EXPECT_EQ("/interface/print", interfacesSent.front());
+  EXPECT_EQ("=.proplist=name", interfacesSent[1]);
+  auto addressesSent = readSentence();
+  EXPECT_EQ("/ip/address/print", addressesSent.front());
+  auto interfacesTag = ".tag=" + getTag(interfacesSent);
+  auto addressesTag = ".tag=" + getTag(addressesSent);
+  EXPECT_NE(interfacesTag, addressesTag);
+
+  // The replies of both commands are interleaved.
+  write(channels::mikrotik::Sentence{"!re", "=name=ether1", interfacesTag});
+  write(channels::mikrotik::Sentence{"!re", "=address=10.0.0.1", addressesTag});
+  write(channels::mikrotik::Sentence{"!re", "=name=ether2", interfacesTag});
+  write(channels::mikrotik::Sentence{"!done", interfacesTag});
+  write(channels::mikrotik::Sentence{"!done", addressesTag});
+
+  auto interfacesReply = std::move(interfaces).get(std::chrono::seconds(5));
+  ASSERT_EQ(3, interfacesReply.size());
+  auto it = interfacesReply.begin();
+  EXPECT_EQ("ether1", channels::mikrotik::Channel::getAttributes(*it)["name"]);
+  ++it;
+  EXPECT_EQ("ether2", channels::mikrotik::Channel::getAttributes(*it)["name"]);
+  auto addressesReply = std::move(addresses).get(std::chrono::seconds(5));
+  ASSERT_EQ(2, addressesReply.size());
+  EXPECT_EQ(
+      "10.0.0.1",
+      channels::mikrotik::Channel::getAttributes(
+          addressesReply.front())["address"]);
+  stop();
+}
+
+TEST_F(MikrotikChannelTest, completesOutOfOrder) {
+  auto channel = connectAndLogin();
+  auto first = channel->query({"/interface/print"});
+  auto second = channel->query({"/system/identity/print"});
+  auto firstTag = ".tag=" + getTag(readSentence());
+  auto secondTag = ".tag=" + getTag(readSentence());
+
+  write(channels::mikrotik::Sentence{"!done", secondTag});
+  EXPECT_EQ(1, std::move(second).get(std::chrono::seconds(5)).size());
+  EXPECT_FALSE(first.isReady());
+
+  write(channels::mikrotik::Sentence{"!done", firstTag});
+  EXPECT_EQ(1, std::move(first).get(std::chrono::seconds(5)).size());
+  stop();
+}
+
+TEST_F(MikrotikChannelTest, reissuesSubscriptionsOnLogin) {
+  auto channel = std::make_shared<channels::mikrotik::Channel>(
+      eventBase, folly::SocketAddress("127.0.0.1", 1337), "foo", "bar");
+  folly::Synchronized<std::vector<std::string>> updates;
+  auto tag = channel->subscribe(
+      {"/interface/listen"},
+      {},
+      [&updates](const channels::mikrotik::Sentence& sentence) {
+        updates.wlock()->push_back(
+            channels::mikrotik::Channel::getAttributes(sentence)["name"]);
+      });
+  auto tagWord = folly::to<std::string>(".tag=", tag);
+
+  // Made before the connection so it is sent once logged in.
+  connectAndLogin(channel);
+  auto subscribed = readSentence();
+  EXPECT_EQ("/interface/listen", subscribed.front());
+  EXPECT_EQ(tagWord, subscribed.back());
+  write(channels::mikrotik::Sentence{"!re", "=name=ether1", tagWord});
+  EXPECT_BECOMES_TRUE(updates.rlock()->size() == 1);
+
+  // It is sent again, under the same tag, once logged in again.
+  write(channels::mikrotik::Sentence{"!fatal", "session terminated"});
+  EXPECT_BECOMES_TRUE(not channel->isConnected());
+  connectAndLogin(channel);
+  subscribed = readSentence();
+  EXPECT_EQ("/interface/listen", subscribed.front());
+  EXPECT_EQ(tagWord, subscribed.back());
+  write(channels::mikrotik::Sentence{"!re", "=name=ether2", tagWord});
+  EXPECT_BECOMES_TRUE(updates.rlock()->size() == 2);
+
+  // Nothing is delivered once it is unsubscribed.
+  channel->unsubscribe(tag);
+  EXPECT_EQ("/cancel", readSentence().front());
+  write(channels::mikrotik::Sentence{"!re", "=name=ether3", tagWord});
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(2, updates.rlock()->size());
+  stop();
+}
+
+TEST_F(MikrotikChannelTest, failsRequestsOnFatal) {
+  auto channel = connectAndLogin();
+  auto reply = channel->query({"/interface/print"});
+  readSentence();
+
+  write(channels::mikrotik::Sentence{"!fatal", "session terminated"});
+  EXPECT_THROW(
+      std::move(reply).get(std::chrono::seconds(5)), std::runtime_error);
+  EXPECT_BECOMES_TRUE(not channel->isConnected());
+  stop();
+}
+
 } // namespace test
 } // namespace devmand
@@ -5,6 +5,12 @@
 // LICENSE file in the root directory of this source tree. An additional grant
 // of patent rights can be found in the PATENTS file in the same directory.
 
+#include <chrono>
+
+#include <folly/Format.h>
+#include <folly/GLog.h>
+#include <folly/futures/Future.h>
+
 #include <devmand/channels/ping/Channel.h>
 #include <devmand/test/EventBaseTest.h>
 #include <devmand/test/TestUtils.h>
@@ -71,6 +77,77 @@ TEST_F(PingChannelTest, checkMultiPing) {
   stop();
 }
 
+TEST_F(PingChannelTest, checkRttHistogram) {
+  channels::ping::Engine engine(eventBase);
+  auto channel = std::make_shared<channels::ping::Channel>(engine, local);
+  EXPECT_EQ(0u, channel->getRttHistogram().replies);
+  auto rtt = channel->ping().get();
+  auto histogram = channel->getRttHistogram();
+  EXPECT_EQ(1u, histogram.replies);
+  EXPECT_EQ(rtt, histogram.min);
+  EXPECT_EQ(rtt, histogram.max);
+  EXPECT_EQ(rtt, histogram.percentile(50));
+  stop();
+}
+
+TEST(TimeoutWheelTest, expiresAfterTicks) {
+  channels::ping::TimeoutWheel wheel(4);
+  channels::ping::RequestKey key{folly::IPAddress("127.0.0.1"), 1};
+  wheel.schedule(std::make_pair(key, 1), 3);
+  EXPECT_TRUE(wheel.advance().empty());
+  EXPECT_TRUE(wheel.advance().empty());
+  auto expired = wheel.advance();
+  ASSERT_EQ(1u, expired.size());
+  EXPECT_EQ(key, expired.front().first);
+  EXPECT_TRUE(wheel.advance().empty());
+}
+
+// Pings a batch of loopback addresses at once, the kernel answers for all of
+// 127.0.0.0/8 so every reply arrives while the batch is still going out.
+static std::chrono::milliseconds pingLoopbackBatch(
+    channels::ping::Engine& engine,
+    int numTargets) {
+  std::vector<std::shared_ptr<channels::ping::Channel>> channels;
+  for (int i = 0; i < numTargets; i++) {
+    folly::IPAddress target(
+        folly::sformat("127.0.{}.{}", i / 250, i % 250 + 1));
+    channels.push_back(
+        std::make_shared<channels::ping::Channel>(engine, target));
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<folly::Future<channels::ping::Rtt>> futures;
+  for (auto& channel : channels) {
+    futures.push_back(channel->ping());
+  }
+  auto rtts = folly::collectAll(futures).get();
+  auto end = std::chrono::steady_clock::now();
+
+  for (auto& rtt : rtts) {
+    EXPECT_NE(0, rtt.value());
+  }
+  for (auto& channel : channels) {
+    EXPECT_EQ(1u, channel->getRttHistogram().replies);
+  }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(end - begin);
+}
+
+TEST_F(PingChannelTest, checkLoopbackBatch) {
+  channels::ping::Engine engine(eventBase);
+  pingLoopbackBatch(engine, 4 * channels::ping::Engine::batchSize);
+  stop();
+}
+
+// Throughput measurement, run it with --gtest_also_run_disabled_tests.
+TEST_F(PingChannelTest, DISABLED_benchmarkLoopbackBatch) {
+  static const int NUM_TARGETS = 1000;
+  channels::ping::Engine engine(eventBase);
+  auto duration = pingLoopbackBatch(engine, NUM_TARGETS);
+  LOG(INFO) << "Pinged " << NUM_TARGETS << " loopback addresses in "
+            << duration.count() << " ms";
+  stop();
+}
+
 static bool isIncrementing(std::vector<uint16_t> nums, int increment) {
   for (size_t i = 1; i < nums.size(); i++) {
     uint16_t prev = nums[i - 1];
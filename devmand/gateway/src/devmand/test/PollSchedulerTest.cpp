@@ -0,0 +1,109 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include <devmand/MetricSink.h>
+#include <devmand/PollScheduler.h>
+#include <devmand/test/EventBaseTest.h>
+#include <devmand/test/TestUtils.h>
+
+namespace devmand {
+namespace test {
+
+class PollSchedulerTest : public EventBaseTest, public MetricSink {
+ public:
+  PollSchedulerTest() = default;
+  ~PollSchedulerTest() override = default;
+  PollSchedulerTest(const PollSchedulerTest&) = delete;
+  PollSchedulerTest& operator=(const PollSchedulerTest&) = delete;
+  PollSchedulerTest(PollSchedulerTest&&) = delete;
+  PollSchedulerTest& operator=(PollSchedulerTest&&) = delete;
+
+ public:
+  void setGauge(
+      const std::string&,
+      double,
+      const std::string&,
+      const std::string&) override {}
+
+  void observeHistogram(
+      const std::string& key,
+      double,
+      const std::vector<double>&,
+      const std::string&,
+      const std::string&) override {
+    if (key == "device.poll.lag_seconds") {
+      ++lagObservations;
+    }
+  }
+
+ protected:
+  std::atomic<unsigned int> lagObservations{0};
+};
+
+TEST_F(PollSchedulerTest, phaseIsStableAndWithinInterval) {
+  std::chrono::milliseconds interval(55000);
+  auto phase = PollScheduler::getPhase("device1", interval);
+  EXPECT_EQ(phase, PollScheduler::getPhase("device1", interval));
+  EXPECT_LT(phase, interval);
+  EXPECT_EQ(
+      std::chrono::milliseconds(0),
+      PollScheduler::getPhase("device1", std::chrono::milliseconds(0)));
+  stop();
+}
+
+TEST_F(PollSchedulerTest, pollsRepeatedly) {
+  PollScheduler scheduler(eventBase, *this, 0, std::chrono::milliseconds(10));
+  std::atomic<unsigned int> polls{0};
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    scheduler.add("device1", std::chrono::milliseconds(50), [&polls]() {
+      ++polls;
+      return folly::makeFuture();
+    });
+    scheduler.start();
+  });
+
+  EXPECT_BECOMES_TRUE(polls >= 3);
+  EXPECT_BECOMES_TRUE(lagObservations >= 3);
+
+  eventBase.runInEventBaseThreadAndWait([&]() { scheduler.del("device1"); });
+  stop();
+}
+
+TEST_F(PollSchedulerTest, respectsConcurrencyBudget) {
+  PollScheduler scheduler(eventBase, *this, 1, std::chrono::milliseconds(10));
+  folly::Promise<folly::Unit> first;
+  std::atomic<unsigned int> polls{0};
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    for (auto id : {"device1", "device2", "device3"}) {
+      scheduler.add(id, std::chrono::milliseconds(1), [&]() {
+        return ++polls == 1 ? first.getFuture() : folly::makeFuture();
+      });
+    }
+    scheduler.start();
+  });
+
+  // Only the first poll may run until it completes.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(1u, polls.load());
+
+  first.setValue();
+  EXPECT_BECOMES_TRUE(polls >= 3);
+
+  eventBase.runInEventBaseThreadAndWait([&]() {
+    for (auto id : {"device1", "device2", "device3"}) {
+      scheduler.del(id);
+    }
+  });
+  stop();
+}
+
+} // namespace test
+} // namespace devmand
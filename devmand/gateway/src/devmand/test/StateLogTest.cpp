@@ -0,0 +1,123 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <folly/json.h>
+
+#include <devmand/fscache/StateLog.h>
+
+namespace devmand {
+namespace fscache {
+namespace test {
+
+static std::string getFilename() {
+  std::string ret = "/tmp/";
+  auto* testInfo = ::testing::UnitTest::GetInstance()->current_test_info();
+  ret += testInfo->name();
+  ::unlink(ret.c_str());
+  return ret;
+}
+
+static size_t getFileSize(const std::string& filename) {
+  struct stat st {};
+  ::stat(filename.c_str(), &st);
+  return static_cast<size_t>(st.st_size);
+}
+
+TEST(StateLogTest, latestRecordWins) {
+  auto filename = getFilename();
+  {
+    StateLog log(filename);
+    EXPECT_TRUE(log.load().empty());
+    log.append("dev1", folly::toJson(folly::dynamic::object("a", 1)));
+    log.append("dev2", folly::toJson(folly::dynamic::object("b", 1)));
+    log.append("dev1", folly::toJson(folly::dynamic::object("a", 2)));
+    log.appendErase("dev2");
+    log.sync();
+  }
+
+  StateLog log(filename);
+  auto states = log.load();
+  ASSERT_EQ(1u, states.size());
+  EXPECT_EQ(2, states["dev1"]["a"].asInt());
+}
+
+TEST(StateLogTest, tornRecordIsDropped) {
+  auto filename = getFilename();
+  size_t intact{0};
+  {
+    StateLog log(filename);
+    log.load();
+    log.append("dev1", folly::toJson(folly::dynamic::object("a", 1)));
+    intact = log.getSize();
+    log.append("dev2", folly::toJson(folly::dynamic::object("b", 1)));
+  }
+  // Cut the last record short as a crash in the middle of an append would.
+  ASSERT_EQ(0, ::truncate(filename.c_str(), getFileSize(filename) - 3));
+
+  {
+    StateLog log(filename);
+    auto states = log.load();
+    ASSERT_EQ(1u, states.size());
+    EXPECT_EQ(1u, states.count("dev1"));
+    EXPECT_EQ(intact, log.getSize());
+    EXPECT_EQ(intact, getFileSize(filename));
+
+    // Appends go after the last intact record.
+    log.append("dev3", folly::toJson(folly::dynamic::object("c", 1)));
+  }
+
+  StateLog log(filename);
+  auto states = log.load();
+  EXPECT_EQ(2u, states.size());
+  EXPECT_EQ(1u, states.count("dev3"));
+}
+
+TEST(StateLogTest, compactKeepsLatest) {
+  auto filename = getFilename();
+  auto state = folly::toJson(folly::dynamic::object("a", 1));
+  {
+    StateLog log(filename);
+    log.load();
+    for (int i = 0; i < 100; i++) {
+      log.append("dev1", state);
+    }
+    auto before = log.getSize();
+    log.compact({{"dev1", state}});
+    EXPECT_LT(log.getSize(), before);
+    EXPECT_EQ(log.getSize(), getFileSize(filename));
+
+    log.append("dev2", state);
+  }
+
+  StateLog log(filename);
+  auto states = log.load();
+  EXPECT_EQ(2u, states.size());
+  EXPECT_EQ(1, states["dev1"]["a"].asInt());
+}
+
+TEST(StateLogTest, unrecognizedLogStartsOver) {
+  auto filename = getFilename();
+  {
+    FILE* file = fopen(filename.c_str(), "w");
+    ASSERT_NE(nullptr, file);
+    fputs("not a state log", file);
+    fclose(file);
+  }
+
+  StateLog log(filename);
+  EXPECT_TRUE(log.load().empty());
+  EXPECT_EQ(log.getSize(), getFileSize(filename));
+}
+
+} // namespace test
+} // namespace fscache
+} // namespace devmand
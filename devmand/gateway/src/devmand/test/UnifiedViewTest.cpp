@@ -0,0 +1,82 @@
+// Copyright (c) 2016-present, Facebook, Inc.
+// All rights reserved.
+//
+// This source code is licensed under the BSD-style license found in the
+// LICENSE file in the root directory of this source tree. An additional grant
+// of patent rights can be found in the PATENTS file in the same directory.
+
+#include <gtest/gtest.h>
+
+#include <folly/json.h>
+
+#include <devmand/UnifiedView.h>
+
+namespace devmand {
+namespace test {
+
+TEST(UnifiedViewTest, UpdateBumpsGeneration) {
+  UnifiedView view;
+  EXPECT_EQ(0u, view.getGeneration());
+
+  auto first = view.update("dev1", folly::dynamic::object("a", 1));
+  EXPECT_EQ(1u, first->getGeneration());
+  EXPECT_EQ(folly::toJson(first->getBundle()), first->getSerialized());
+
+  auto second = view.update("dev2", folly::dynamic::object("b", 2));
+  EXPECT_EQ(2u, second->getGeneration());
+  EXPECT_EQ(2u, view.getGeneration());
+  EXPECT_EQ(2u, view.size());
+}
+
+TEST(UnifiedViewTest, UnchangedStateKeepsSnapshot) {
+  UnifiedView view;
+  auto first = view.update("dev1", folly::dynamic::object("a", 1));
+  auto again = view.update("dev1", folly::dynamic::object("a", 1));
+  EXPECT_EQ(first.get(), again.get());
+  EXPECT_EQ(1u, view.getGeneration());
+
+  auto changed = view.update("dev1", folly::dynamic::object("a", 2));
+  EXPECT_NE(first.get(), changed.get());
+  EXPECT_EQ(2u, changed->getGeneration());
+}
+
+TEST(UnifiedViewTest, CopiesShareSnapshots) {
+  UnifiedView view;
+  view.update("dev1", folly::dynamic::object("a", 1));
+
+  UnifiedView copy = view;
+  EXPECT_EQ(view.get("dev1").get(), copy.get("dev1").get());
+
+  // Updating the original leaves the copy untouched.
+  view.update("dev1", folly::dynamic::object("a", 2));
+  EXPECT_EQ(1, copy.get("dev1")->getBundle()["a"].asInt());
+  EXPECT_EQ(2, view.get("dev1")->getBundle()["a"].asInt());
+
+  view.erase("dev1");
+  EXPECT_EQ(nullptr, view.get("dev1"));
+  EXPECT_NE(nullptr, copy.get("dev1"));
+}
+
+TEST(UnifiedViewTest, RestoredStateIsStaleUntilPolled) {
+  UnifiedView view;
+  auto restored = view.restore("dev1", folly::dynamic::object("a", 1));
+  EXPECT_TRUE(restored->isStale());
+
+  // A restore never replaces a state which is already there.
+  auto again = view.restore("dev1", folly::dynamic::object("a", 2));
+  EXPECT_EQ(restored.get(), again.get());
+
+  // The first poll replaces the snapshot even when nothing changed.
+  auto polled = view.update("dev1", folly::dynamic::object("a", 1));
+  EXPECT_NE(restored.get(), polled.get());
+  EXPECT_FALSE(polled->isStale());
+  EXPECT_LT(restored->getGeneration(), polled->getGeneration());
+
+  view.restore("dev2", folly::dynamic::object("b", 1));
+  view.eraseStale();
+  EXPECT_EQ(nullptr, view.get("dev2"));
+  EXPECT_EQ(polled.get(), view.get("dev1").get());
+}
+
+} // namespace test
+} // namespace devmand
@@ -141,6 +141,38 @@ TEST_F(CliScaleTest, DISABLED_scale) {
   }
   MLOG(MWARNING) << "Closed";
 }
+
+/*
+ * Throughput of matching prompt in a large show output delivered in small
+ * SSH packets, as in the scale test above but without the network.
+ */
+TEST_F(CliScaleTest, matchPromptInLargeOutput) {
+  const string prompt = "\nswitch#";
+  const size_t packetSize = 256;
+  string output;
+  for (int i = 0; output.length() < 4 * 1024 * 1024; i++) {
+    output += "interface 0/" + to_string(i) +
+        "\ndescription 'port'\nswitchport mode access\nexit\n";
+  }
+  const string stream = output + prompt;
+
+  chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+  sshsession::ExpectedOutputMatcher matcher(prompt);
+  Optional<string> result;
+  for (size_t offset = 0; offset < stream.length() and not result.hasValue();
+       offset += packetSize) {
+    result = matcher.append(stream.substr(offset, packetSize));
+  }
+  chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+  ASSERT_TRUE(result.hasValue());
+  EXPECT_EQ(output, result.value());
+  MLOG(MWARNING)
+      << "Matching prompt in " << stream.length() << " bytes in "
+      << packetSize << " byte packets took "
+      << chrono::duration_cast<chrono::milliseconds>(end - begin).count()
+      << " ms";
+}
 } // namespace cli
 } // namespace test
 } // namespace devmand
@@ -29,6 +29,7 @@
 #include <ydk_openconfig/openconfig_interfaces.hpp>
 #include <ydk_openconfig/openconfig_vlan_types.hpp>
 #include <algorithm>
+#include <chrono>
 
 namespace devmand {
 namespace test {
@@ -1104,6 +1105,94 @@ TEST_F(DatastoreTest, threeIndenpendentTreesCreateReadTest) {
   EXPECT_EQ(toPrettyJson(multimap.begin()->second.before), "{}");
 }
 
+static dynamic largeInterfaces(unsigned int count) {
+  dynamic interfaces = dynamic::array;
+  for (unsigned int i = 0; i < count; ++i) {
+    const string name = "0/" + to_string(i);
+    dynamic counters = dynamic::object;
+    for (const auto& counter :
+         {"in-broadcast-pkts",
+          "in-discards",
+          "in-errors",
+          "in-multicast-pkts",
+          "in-octets",
+          "in-unicast-pkts",
+          "out-broadcast-pkts",
+          "out-discards",
+          "out-errors",
+          "out-multicast-pkts",
+          "out-octets",
+          "out-unicast-pkts"}) {
+      counters[counter] = to_string(i);
+    }
+    interfaces.push_back(dynamic::object("name", name)(
+        "config",
+        dynamic::object("name", name)("enabled", true)("mtu", 1500)(
+            "description", "ifc " + name)(
+            "type", "iana-if-type:ethernetCsmacd"))(
+        "state",
+        dynamic::object("name", name)("enabled", true)("mtu", 1518)(
+            "description", "ifc " + name)("admin-status", "UP")(
+            "oper-status", "DOWN")("type", "iana-if-type:ethernetCsmacd")(
+            "counters", counters)));
+  }
+  return dynamic::object(
+      "openconfig-interfaces:interfaces",
+      dynamic::object("interface", interfaces));
+}
+
+// Benchmark of a one leaf change in a ~10k node config, the diff should only
+// look at the changed subtree.
+TEST_F(DatastoreTest, diffOneLeafInLargeConfig) {
+  Datastore datastore(Datastore::operational(), schemaContext);
+  auto transaction = datastore.newTx();
+  transaction->overwrite(Path("/"), largeInterfaces(350));
+  transaction->commit();
+
+  vector<DiffPath> paths;
+  paths.emplace_back(
+      Path(
+          "/openconfig-interfaces:interfaces/openconfig-interfaces:interface"
+          "/openconfig-interfaces:state/openconfig-interfaces:counters"),
+      false);
+  paths.emplace_back(
+      Path(
+          "/openconfig-interfaces:interfaces/openconfig-interfaces:interface"
+          "/openconfig-interfaces:config"),
+      false);
+
+  const unsigned int iterations = 20;
+  auto begin = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i) {
+    transaction = datastore.newTx();
+    Path countersPath(
+        "/openconfig-interfaces:interfaces/interface[name='0/200']"
+        "/state/counters");
+    dynamic counters = transaction->read(countersPath);
+    counters["openconfig-interfaces:counters"]["out-errors"] =
+        to_string(1000 + i);
+    transaction->merge(countersPath, counters);
+
+    const std::multimap<Path, DatastoreDiff>& diffs =
+        transaction->diff(paths).diffs;
+    EXPECT_EQ(1u, diffs.size());
+    EXPECT_EQ(
+        diffs.begin()->second.keyedPath.str(),
+        "/openconfig-interfaces:interfaces/openconfig-interfaces:interface"
+        "[name='0/200']"
+        "/openconfig-interfaces:state/openconfig-interfaces:counters");
+    transaction->commit();
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  MLOG(MINFO) << "One leaf diff in large config took on average "
+              << std::chrono::duration_cast<std::chrono::microseconds>(
+                     end - begin)
+                      .count() /
+          iterations
+              << " us";
+}
+
 } // namespace cli
 } // namespace test
 } // namespace devmand
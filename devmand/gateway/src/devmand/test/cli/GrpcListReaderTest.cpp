@@ -95,10 +95,11 @@ class GrpcListReaderTest : public ::testing::Test {
 TEST_F(GrpcListReaderTest, testDummyReader) {
   auto grpcClientChannel =
       grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
-  GrpcListReader tested(grpcClientChannel, "tested", testExec);
+  auto tested =
+      make_shared<GrpcListReader>(grpcClientChannel, "tested", testExec);
   Path path = "/somepath";
   DeviceAccess deviceAccess = DeviceAccess(cli, "test", testExec);
-  vector<dynamic> result = tested.readKeys(path, deviceAccess).get();
+  vector<dynamic> result = tested->readKeys(path, deviceAccess).get();
   EXPECT_EQ(result.size(), 3);
   for (int i = 0; i < 3; i++) {
     dynamic expected = dynamic::object;
@@ -18,6 +18,7 @@
 #include <grpc++/grpc++.h>
 #include <gtest/gtest.h>
 #include <devmand/devices/cli/UbntInterfacePlugin.cpp>
+#include <chrono>
 #include <thread>
 
 namespace devmand {
@@ -112,6 +113,36 @@ class DummyReader : public ReaderPlugin::Service {
   }
 };
 
+// request a single command, then wait until the client answers or cancels
+class CommandReader : public ReaderPlugin::Service {
+ public:
+  CommandReader(string _cmd, bool _write) : cmd(_cmd), write(_write) {}
+
+  Promise<bool> cancelled;
+
+  Status Read(
+      ServerContext* context,
+      ServerReaderWriter<ReadResponse, ReadRequest>* stream) {
+    ReadRequest readRequest;
+    if (stream->Read(&readRequest)) {
+      ReadResponse readResponse;
+      CliRequest* cliRequest = new CliRequest();
+      cliRequest->set_cmd(cmd);
+      cliRequest->set_write(write);
+      readResponse.set_allocated_clirequest(cliRequest);
+      stream->Write(readResponse);
+      while (stream->Read(&readRequest)) {
+      }
+    }
+    cancelled.setValue(context->IsCancelled());
+    return Status::OK;
+  }
+
+ private:
+  string cmd;
+  bool write;
+};
+
 class GrpcReaderTest : public ::testing::Test {
  protected:
   shared_ptr<CPUThreadPoolExecutor> testExec;
@@ -150,12 +181,66 @@ class GrpcReaderTest : public ::testing::Test {
 TEST_F(GrpcReaderTest, testDummyReader) {
   auto grpcClientChannel =
       grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
-  GrpcReader tested(grpcClientChannel, "tested", testExec);
+  auto tested = make_shared<GrpcReader>(grpcClientChannel, "tested", testExec);
   DeviceAccess deviceAccess = DeviceAccess(mockedCli, "test", testExec);
-  dynamic result = tested.read(somePath, deviceAccess).get();
+  dynamic result = tested->read(somePath, deviceAccess).get();
   EXPECT_EQ(result["path"], somePath.str());
 }
 
+TEST_F(GrpcReaderTest, testConcurrentReads) {
+  auto grpcClientChannel =
+      grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
+  auto tested = make_shared<GrpcReader>(grpcClientChannel, "tested", testExec);
+  DeviceAccess deviceAccess = DeviceAccess(mockedCli, "test", testExec);
+  // more reads than executor threads, none of them may block a thread
+  vector<Future<dynamic>> reads;
+  for (int i = 0; i < 20; i++) {
+    reads.push_back(tested->read(somePath, deviceAccess));
+  }
+  for (auto& read : reads) {
+    dynamic result = move(read).get();
+    EXPECT_EQ(result["path"], somePath.str());
+  }
+}
+
+TEST_F(GrpcReaderTest, testCliFailureCancelsCall) {
+  CommandReader failing("unknown command", false);
+  string failingAddress = "127.0.0.1:" + to_string(port + 1);
+  auto failingServer = startServer(failingAddress, failing);
+  auto grpcClientChannel =
+      grpc::CreateChannel(failingAddress, grpc::InsecureChannelCredentials());
+  auto tested = make_shared<GrpcReader>(grpcClientChannel, "tested", testExec);
+  DeviceAccess deviceAccess = DeviceAccess(mockedCli, "test", testExec);
+
+  auto timeout = std::chrono::seconds(5);
+  auto result = tested->read(somePath, deviceAccess);
+  EXPECT_THROW(move(result).get(timeout), runtime_error);
+  EXPECT_TRUE(failing.cancelled.getFuture().get(timeout));
+  failingServer->Shutdown();
+  failingServer->Wait();
+}
+
+TEST_F(GrpcReaderTest, testForbiddenWriteRejected) {
+  CommandReader writing("configure terminal", true);
+  string writingAddress = "127.0.0.1:" + to_string(port + 1);
+  auto writingServer = startServer(writingAddress, writing);
+  auto grpcClientChannel =
+      grpc::CreateChannel(writingAddress, grpc::InsecureChannelCredentials());
+  auto tested = make_shared<GrpcReader>(grpcClientChannel, "tested", testExec);
+  DeviceAccess deviceAccess = DeviceAccess(mockedCli, "test", testExec);
+
+  auto timeout = std::chrono::seconds(5);
+  try {
+    tested->read(somePath, deviceAccess).get(timeout);
+    FAIL() << "Reader executed a write command";
+  } catch (const runtime_error& e) {
+    EXPECT_EQ(string("Forbidden to execute write commands"), e.what());
+  }
+  EXPECT_TRUE(writing.cancelled.getFuture().get(timeout));
+  writingServer->Shutdown();
+  writingServer->Wait();
+}
+
 } // namespace cli
 } // namespace test
 } // namespace devmand
@@ -130,6 +130,48 @@ TEST_F(PathTest, segmentKeys) {
       1);
 }
 
+TEST_F(PathTest, parentAndChild) {
+  Path ifc = "/openconfig-interfaces:interfaces/interface[name='0/1']";
+  Path config = ifc.getChild("config");
+  ASSERT_EQ(
+      config, "/openconfig-interfaces:interfaces/interface[name='0/1']/config");
+  ASSERT_EQ(config.getDepth(), 3);
+  ASSERT_EQ(config.getParent(), ifc);
+  ASSERT_EQ(config.getParent().getParent().getParent(), Path::ROOT);
+  ASSERT_TRUE(config.isChildOf(ifc.unkeyed()));
+  ASSERT_FALSE(ifc.isChildOf(config));
+  ASSERT_EQ(config.getUnkeyedSegment(1), "interface");
+  ASSERT_EQ(
+      config.getUnkeyedSegment(0), "openconfig-interfaces:interfaces");
+
+  // A child segment may span several segments and carry keys
+  Path nested = Path::ROOT.getChild("m:a/b[k='x/y']/c");
+  ASSERT_EQ(nested.getDepth(), 3);
+  ASSERT_EQ(nested.getKeysFromSegment("b"), dynamic::object("k", "x/y"));
+  ASSERT_EQ(nested.getParent().getLastSegment(), "b[k='x/y']");
+}
+
+TEST_F(PathTest, addKeys) {
+  Path ifc = "/openconfig-interfaces:interfaces/interface";
+  Path keyed = ifc.addKeys(dynamic::object("name", "0/1"));
+  ASSERT_EQ(keyed, "/openconfig-interfaces:interfaces/interface[name='0/1']");
+  ASSERT_TRUE(keyed.isLastSegmentKeyed());
+  ASSERT_EQ(keyed.getKeys(), dynamic::object("name", "0/1"));
+  ASSERT_EQ(keyed.unkeyed(), ifc);
+  // The same as the path parsed from its string
+  ASSERT_EQ(keyed.segmentDistance(Path(keyed.str())), keyed.getDepth());
+  EXPECT_THROW(
+      keyed.addKeys(dynamic::object("name", "0/2")), InvalidPathException);
+}
+
+TEST_F(PathTest, segmentDistance) {
+  Path a = "/m:a/b[k='1']/c";
+  ASSERT_EQ(a.segmentDistance("/m:a/b[k='1']/d"), 2);
+  ASSERT_EQ(a.segmentDistance("/m:a/b[k='2']/c"), 1);
+  ASSERT_EQ(a.segmentDistance("/a/b[k='1']/c"), 0);
+  ASSERT_EQ(a.segmentDistance(Path::ROOT), 0);
+}
+
 } // namespace cli
 } // namespace test
 } // namespace devmand
@@ -87,6 +87,44 @@ TEST_F(ReadCachingCliTest, cleanDestructOnError) {
   EXPECT_THROW(move(future).via(testExec.get()).get(10s), runtime_error);
 }
 
+TEST_F(ReadCachingCliTest, coalesceConcurrentReads) {
+  shared_ptr<AsyncCli> delegate = getMockCli<EchoCli>(1, testExec);
+  shared_ptr<CliCache> cache = ReadCachingCli::createCache();
+  auto testedCli = make_shared<ReadCachingCli>(
+      "test",
+      delegate,
+      cache,
+      std::make_shared<folly::IOThreadPoolExecutor>(
+          1, std::make_shared<folly::NamedThreadFactory>("rccli")));
+
+  vector<SemiFuture<string>> futures;
+  for (int i = 0; i < 5; i++) {
+    futures.push_back(
+        testedCli->executeRead(ReadCommand::create("show interfaces")));
+  }
+  for (auto& future : futures) {
+    ASSERT_EQ(move(future).via(testExec.get()).get(10s), "show interfaces");
+  }
+  EXPECT_EQ(1, cache->getMisses());
+  EXPECT_EQ(4, cache->getCoalesced());
+
+  ASSERT_EQ(
+      testedCli->executeRead(ReadCommand::create("show interfaces"))
+          .via(testExec.get())
+          .get(10s),
+      "show interfaces");
+  EXPECT_EQ(1, cache->getHits());
+
+  // new poll cycle goes to the device again
+  cache->clear();
+  ASSERT_EQ(
+      testedCli->executeRead(ReadCommand::create("show interfaces"))
+          .via(testExec.get())
+          .get(10s),
+      "show interfaces");
+  EXPECT_EQ(2, cache->getMisses());
+}
+
 } // namespace cli
 } // namespace test
 } // namespace devmand
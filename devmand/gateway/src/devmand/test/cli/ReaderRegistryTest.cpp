@@ -15,6 +15,7 @@
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/json.h>
 #include <gtest/gtest.h>
+#include <chrono>
 
 namespace devmand {
 namespace test {
@@ -327,6 +328,72 @@ TEST_F(ReaderRegistryTest, withSchemaContextBadPath) {
   executor->join();
 }
 
+TEST_F(ReaderRegistryTest, deepTreeDispatchBenchmark) {
+  static const int DEPTH = 16;
+  static const int LIST_DEPTH = 4;
+  static const int READS = 2000;
+  auto executor = make_shared<CPUThreadPoolExecutor>(2);
+  DeviceAccess mockDevice{nullptr, "rest", executor};
+  ReaderRegistryBuilder reg;
+
+  // /bench:c0/c1/c2/list/c4/.../c15 with a reader on every node
+  string registered = "/bench:c0";
+  string keyed = "/bench:c0";
+  for (int i = 1; i < DEPTH; i++) {
+    if (i == LIST_DEPTH - 1) {
+      registered += "/list";
+      keyed += "/list[id='1']";
+      reg.addList(
+          Path(registered), [](const Path& path, const DeviceAccess& device) {
+            (void)path;
+            (void)device;
+            return Future<vector<dynamic>>(
+                vector<dynamic>{dynamic::object("id", "1")});
+          });
+      continue;
+    }
+    registered += "/c" + to_string(i);
+    keyed += "/c" + to_string(i);
+    reg.add(Path(registered), [](const Path& path, const DeviceAccess& device) {
+      (void)device;
+      return Future<dynamic>(dynamic::object(
+          "depth", static_cast<int64_t>(path.getDepth())));
+    });
+  }
+  auto r = reg.build();
+
+  Path leaf(keyed);
+  ASSERT_EQ(DEPTH, leaf.getDepth());
+  auto data = r->readConfiguration(leaf, mockDevice).get();
+  ASSERT_EQ(DEPTH, data["c15"]["depth"].asInt());
+
+  chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+  for (int i = 0; i < READS; i++) {
+    r->readConfiguration(leaf, mockDevice).get();
+  }
+  chrono::steady_clock::time_point end = chrono::steady_clock::now();
+  MLOG(MINFO) << "Dispatched " << READS << " reads at depth " << DEPTH
+              << " in "
+              << chrono::duration_cast<chrono::milliseconds>(end - begin)
+                     .count()
+              << " ms";
+
+  begin = chrono::steady_clock::now();
+  for (int i = 0; i < READS; i++) {
+    leaf.getParent().getChild("c15").isChildOf(Path(registered));
+  }
+  end = chrono::steady_clock::now();
+  MLOG(MINFO) << "Walked " << READS << " parent/child paths at depth " << DEPTH
+              << " in "
+              << chrono::duration_cast<chrono::microseconds>(end - begin)
+                     .count()
+              << " us";
+
+  // Let the executor finish
+  via(executor.get(), []() {}).get();
+  executor->join();
+}
+
 } // namespace cli
 } // namespace test
 } // namespace devmand
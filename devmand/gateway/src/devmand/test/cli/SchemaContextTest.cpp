@@ -8,10 +8,13 @@
 #define LOG_WITH_GLOG
 #include <magma_logging.h>
 
+#include <boost/filesystem.hpp>
 #include <devmand/devices/cli/schema/Path.h>
 #include <devmand/devices/cli/schema/SchemaContext.h>
 #include <devmand/test/cli/utils/Log.h>
 #include <gtest/gtest.h>
+#include <unistd.h>
+#include <algorithm>
 
 namespace devmand::test::cli {
 
@@ -65,4 +68,86 @@ TEST_F(SchemaContextTest, checkValidPath) {
   EXPECT_FALSE(context.isPathValid(pathToNonExistentNode));
 }
 
+TEST_F(SchemaContextTest, leafType) {
+  Path leaf = Path("/openconfig-interfaces:interfaces/interface/config/mtu");
+  EXPECT_EQ(vector<LLLY_DATA_TYPE>{LLLY_TYPE_UINT16}, context.leafType(leaf));
+  EXPECT_THROW(
+      context.leafType(Path("/openconfig-interfaces:interfaces/interface")),
+      InvalidPathException);
+}
+
+static string getCacheDir() {
+  string dir = "/tmp/";
+  dir += ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  return dir;
+}
+
+static string getIndexFile(const string& cacheDir) {
+  string name = Model::OPENCONFIG_2_4_3.getDir();
+  std::replace(name.begin(), name.end(), '/', '_');
+  return cacheDir + "/" + name + ".idx";
+}
+
+TEST_F(SchemaContextTest, cachedIndexIsReused) {
+  auto cacheDir = getCacheDir();
+  auto indexFile = getIndexFile(cacheDir);
+  ::unlink(indexFile.c_str());
+
+  Path list = Path(
+      "/openconfig-interfaces:interfaces/interface/subinterfaces/subinterface/openconfig-if-ip:ipv4/addresses/address");
+  Path state = Path("/openconfig-interfaces:interfaces/interface/state");
+  {
+    SchemaContext built(Model::OPENCONFIG_2_4_3, cacheDir);
+    EXPECT_EQ(0, ::access(indexFile.c_str(), R_OK));
+  }
+
+  SchemaContext cached(Model::OPENCONFIG_2_4_3, cacheDir);
+  EXPECT_TRUE(cached.isList(list));
+  EXPECT_EQ(vector<string>{"ip"}, cached.getKeys(list));
+  EXPECT_FALSE(cached.isConfig(state));
+  EXPECT_FALSE(cached.isPathValid(Path("/openconfig-interfaces:nope")));
+  // Datastores still need the models parsed
+  EXPECT_NE(nullptr, cached.getLyContext());
+}
+
+TEST_F(SchemaContextTest, damagedIndexIsRebuilt) {
+  auto cacheDir = getCacheDir();
+  auto indexFile = getIndexFile(cacheDir);
+  {
+    SchemaContext built(Model::OPENCONFIG_2_4_3, cacheDir);
+  }
+  // Cut into the records
+  ASSERT_EQ(0, ::truncate(indexFile.c_str(), 64));
+
+  SchemaContext rebuilt(Model::OPENCONFIG_2_4_3, cacheDir);
+  EXPECT_TRUE(
+      rebuilt.isList(Path("/openconfig-interfaces:interfaces/interface")));
+}
+
+TEST_F(SchemaContextTest, missingCacheDirsAreCreated) {
+  boost::filesystem::remove_all(getCacheDir());
+  auto cacheDir = getCacheDir() + "/devmand/schema";
+  {
+    SchemaContext built(Model::OPENCONFIG_2_4_3, cacheDir);
+  }
+  EXPECT_EQ(0, ::access(getIndexFile(cacheDir).c_str(), R_OK));
+}
+
+TEST_F(SchemaContextTest, indexIsKeyedByModelHash) {
+  auto file = getIndexFile(getCacheDir());
+  auto hash = SchemaIndex::hashModelDir(Model::OPENCONFIG_2_4_3.getDir());
+  EXPECT_EQ(hash, SchemaIndex::hashModelDir(Model::OPENCONFIG_2_4_3.getDir()));
+
+  auto index = SchemaIndex::build(context.getLyContext(), hash);
+  ASSERT_TRUE(index->save(file));
+  auto loaded = SchemaIndex::load(file, hash);
+  ASSERT_NE(nullptr, loaded);
+  EXPECT_EQ(index->size(), loaded->size());
+  EXPECT_TRUE(loaded->find("/openconfig-interfaces:interfaces").hasValue());
+
+  SchemaIndex::Hash changed = hash;
+  changed[0]++;
+  EXPECT_EQ(nullptr, SchemaIndex::load(file, changed));
+}
+
 } // namespace devmand::test::cli
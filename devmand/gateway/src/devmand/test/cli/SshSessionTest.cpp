@@ -30,6 +30,7 @@ using namespace devmand::channels::cli;
 using namespace devmand::test::utils::ssh;
 using namespace std;
 using namespace folly;
+using devmand::channels::cli::sshsession::ExpectedOutputMatcher;
 using devmand::channels::cli::sshsession::readCallback;
 using devmand::channels::cli::sshsession::SshSession;
 using devmand::channels::cli::sshsession::SshSessionAsync;
@@ -124,6 +125,27 @@ TEST_F(SshSessionTest, empty) {
   // This tests the SSH server, to make sure it can cleanly start and close
 }
 
+TEST(ExpectedOutputMatcherTest, matchAcrossChunks) {
+  ExpectedOutputMatcher matcher("switch#");
+  EXPECT_FALSE(matcher.append("interface 0/1\nexit\nswi").hasValue());
+  EXPECT_FALSE(matcher.append("tc").hasValue());
+  Optional<string> output = matcher.append("h# ");
+  ASSERT_TRUE(output.hasValue());
+  EXPECT_EQ("interface 0/1\nexit\n", output.value());
+  EXPECT_EQ(" ", matcher.getUnexpectedOutput());
+}
+
+TEST(ExpectedOutputMatcherTest, matchPartialPrefix) {
+  ExpectedOutputMatcher matcher("aab");
+  EXPECT_FALSE(matcher.append("xa").hasValue());
+  EXPECT_FALSE(matcher.append("a").hasValue());
+  EXPECT_FALSE(matcher.append("a").hasValue());
+  Optional<string> output = matcher.append("b");
+  ASSERT_TRUE(output.hasValue());
+  EXPECT_EQ("xa", output.value());
+  EXPECT_EQ("", matcher.getUnexpectedOutput());
+}
+
 } // namespace cli
 } // namespace test
 } // namespace devmand
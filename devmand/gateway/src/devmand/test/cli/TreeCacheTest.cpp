@@ -2,6 +2,11 @@
 
 #include <magma_logging.h>
 
+#include <algorithm>
+#include <chrono>
+
+#include <boost/algorithm/string/replace.hpp>
+
 #include <devmand/channels/cli/Cli.h>
 #include <devmand/channels/cli/TreeCacheCli.h>
 #include <devmand/test/TestUtils.h>
@@ -212,4 +217,135 @@ TEST_F(TreeCacheTest, parseSH_RUN_UBNT_REAL) {
       "]");
 }
 
+// Reference split of the previous, regex based, implementation
+static map<vector<string>, string> regexSplit(
+    const shared_ptr<CliFlavour>& flavour,
+    string content) {
+  regex regexMatch = regex(TreeCache::createSectionPattern(
+      flavour->getSingleIndentChar(), flavour->getConfigSubsectionEnd(), 0));
+  smatch sm;
+  map<vector<string>, string> result;
+  while (TreeCache::hasNextSection(regexMatch, sm, content)) {
+    string section = sm[1];
+    string firstLine = section.substr(0, section.find('\n'));
+    result.insert(make_pair(flavour->splitSubcommands(firstLine), section));
+  }
+  return result;
+}
+
+// A switch with interfaceCount recorded interface sections, ~5 lines each
+static string largeUbiquitiConfig(unsigned int interfaceCount) {
+  string config = "!Current Configuration:\n!\nvlan database\nvlan 100\nexit\n";
+  for (unsigned int i = 0; i < interfaceCount; ++i) {
+    config += "\ninterface 0/" + to_string(i) +
+        "\n"
+        "description 'port " +
+        to_string(i) +
+        "'\n"
+        "switchport mode access\n"
+        "switchport access vlan 100\n"
+        "exit\n";
+  }
+  return config;
+}
+
+TEST_F(TreeCacheTest, tokenizeSections_matchesRegex) {
+  for (const char* content :
+       {testdata::SH_RUN_UBIQUITI,
+        testdata::SH_RUN_CISCO,
+        testdata::SH_RUN_INT_GI4,
+        testdata::SH_RUN_TWO_IFC}) {
+    EXPECT_EQ(
+        regexSplit(ubiquitiFlavour, content),
+        tested_ubiquiti->readConfigurationToMap(content));
+    EXPECT_EQ(
+        regexSplit(ciscoFlavour, content),
+        tested_cisco->readConfigurationToMap(content));
+  }
+  string large = largeUbiquitiConfig(200);
+  EXPECT_EQ(
+      regexSplit(ubiquitiFlavour, large),
+      tested_ubiquiti->readConfigurationToMap(large));
+}
+
+TEST_F(TreeCacheTest, tokenizeSections_unterminatedLastLine) {
+  auto sections = TreeCache::tokenizeSections(
+      "section1\nfoo\nexit\nsection2\nexit", none, "exit", 0);
+  EXPECT_EQ(1, sections.size());
+  EXPECT_EQ("section1", sections[0].first);
+  EXPECT_EQ("section1\nfoo\nexit\n", sections[0].second);
+}
+
+TEST_F(TreeCacheTest, update_changedSections) {
+  string config = largeUbiquitiConfig(10);
+  tested_ubiquiti->clear();
+  tested_ubiquiti->update(config);
+  EXPECT_EQ(12, tested_ubiquiti->getChangedSections().size());
+
+  // same output again, nothing to refresh
+  tested_ubiquiti->update(config);
+  EXPECT_TRUE(tested_ubiquiti->getChangedSections().empty());
+  EXPECT_EQ(12, tested_ubiquiti->size());
+
+  boost::replace_all(config, "'port 3'", "'uplink'");
+  tested_ubiquiti->update(config);
+  set<vector<string>> expected = {vector<string>{"interface", "0/3"}};
+  EXPECT_EQ(expected, tested_ubiquiti->getChangedSections());
+  EXPECT_EQ(
+      "interface 0/3\n"
+      "description 'uplink'\n"
+      "switchport mode access\n"
+      "switchport access vlan 100\n"
+      "exit\n",
+      tested_ubiquiti
+          ->getSection(
+              tested_ubiquiti->parseCommand("sh run interface 0/3").value())
+          .value());
+
+  tested_ubiquiti->update(largeUbiquitiConfig(9));
+  expected = {vector<string>{"interface", "0/3"},
+              vector<string>{"interface", "0/9"}};
+  EXPECT_EQ(expected, tested_ubiquiti->getChangedSections());
+  EXPECT_EQ(11, tested_ubiquiti->size());
+}
+
+// Benchmark of parsing a ~10k line running config and of refreshing it after
+// a change of a single section.
+TEST_F(TreeCacheTest, updateLargeConfig) {
+  const unsigned int interfaceCount = 2000;
+  string config = largeUbiquitiConfig(interfaceCount);
+  const unsigned int iterations = 20;
+
+  auto begin = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i) {
+    tested_ubiquiti->clear();
+    tested_ubiquiti->update(config);
+  }
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_EQ(interfaceCount + 2, tested_ubiquiti->size());
+  MLOG(MINFO) << "Parsing a " << std::count(config.begin(), config.end(), '\n')
+              << " line config took on average "
+              << std::chrono::duration_cast<std::chrono::microseconds>(
+                     end - begin)
+                      .count() /
+          iterations
+              << " us";
+
+  begin = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i) {
+    string changed = config;
+    boost::replace_all(
+        changed, "'port 1000'", "'port 1000 rev " + to_string(i) + "'");
+    tested_ubiquiti->update(changed);
+    EXPECT_EQ(1, tested_ubiquiti->getChangedSections().size());
+  }
+  end = std::chrono::steady_clock::now();
+  MLOG(MINFO) << "Refreshing one section took on average "
+              << std::chrono::duration_cast<std::chrono::microseconds>(
+                     end - begin)
+                      .count() /
+          iterations
+              << " us";
+}
+
 } // namespace devmand::channels::cli
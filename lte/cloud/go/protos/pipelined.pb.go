@@ -162,7 +162,7 @@ func (x FlowRequest_FlowState) String() string {
 }
 
 func (FlowRequest_FlowState) EnumDescriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{11, 0}
+	return fileDescriptor_e17e923ef6f5752e, []int{15, 0}
 }
 
 type FlowResponse_Result int32
@@ -190,7 +190,7 @@ func (x FlowResponse_Result) String() string {
 }
 
 func (FlowResponse_Result) EnumDescriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{12, 0}
+	return fileDescriptor_e17e923ef6f5752e, []int{16, 0}
 }
 
 type SubscriberQuotaUpdate_Type int32
@@ -218,7 +218,7 @@ func (x SubscriberQuotaUpdate_Type) String() string {
 }
 
 func (SubscriberQuotaUpdate_Type) EnumDescriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{14, 0}
+	return fileDescriptor_e17e923ef6f5752e, []int{18, 0}
 }
 
 // Deprecated
@@ -773,6 +773,166 @@ func (m *DeactivateFlowsResult) GetResult() DeactivateFlowsResult_Result {
 	return DeactivateFlowsResult_SUCCESS
 }
 
+// Activations for many subscribers, applied in request order
+type ActivateFlowsBatchRequest struct {
+	Requests             []*ActivateFlowsRequest `protobuf:"bytes,1,rep,name=requests,proto3" json:"requests,omitempty"`
+	XXX_NoUnkeyedLiteral struct{}                `json:"-"`
+	XXX_unrecognized     []byte                  `json:"-"`
+	XXX_sizecache        int32                   `json:"-"`
+}
+
+func (m *ActivateFlowsBatchRequest) Reset()         { *m = ActivateFlowsBatchRequest{} }
+func (m *ActivateFlowsBatchRequest) String() string { return proto.CompactTextString(m) }
+func (*ActivateFlowsBatchRequest) ProtoMessage()    {}
+func (*ActivateFlowsBatchRequest) Descriptor() ([]byte, []int) {
+	return fileDescriptor_e17e923ef6f5752e, []int{11}
+}
+
+func (m *ActivateFlowsBatchRequest) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_ActivateFlowsBatchRequest.Unmarshal(m, b)
+}
+func (m *ActivateFlowsBatchRequest) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_ActivateFlowsBatchRequest.Marshal(b, m, deterministic)
+}
+func (m *ActivateFlowsBatchRequest) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_ActivateFlowsBatchRequest.Merge(m, src)
+}
+func (m *ActivateFlowsBatchRequest) XXX_Size() int {
+	return xxx_messageInfo_ActivateFlowsBatchRequest.Size(m)
+}
+func (m *ActivateFlowsBatchRequest) XXX_DiscardUnknown() {
+	xxx_messageInfo_ActivateFlowsBatchRequest.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_ActivateFlowsBatchRequest proto.InternalMessageInfo
+
+func (m *ActivateFlowsBatchRequest) GetRequests() []*ActivateFlowsRequest {
+	if m != nil {
+		return m.Requests
+	}
+	return nil
+}
+
+// One result per request, in request order
+type ActivateFlowsBatchResult struct {
+	Results              []*ActivateFlowsResult `protobuf:"bytes,1,rep,name=results,proto3" json:"results,omitempty"`
+	XXX_NoUnkeyedLiteral struct{}               `json:"-"`
+	XXX_unrecognized     []byte                 `json:"-"`
+	XXX_sizecache        int32                  `json:"-"`
+}
+
+func (m *ActivateFlowsBatchResult) Reset()         { *m = ActivateFlowsBatchResult{} }
+func (m *ActivateFlowsBatchResult) String() string { return proto.CompactTextString(m) }
+func (*ActivateFlowsBatchResult) ProtoMessage()    {}
+func (*ActivateFlowsBatchResult) Descriptor() ([]byte, []int) {
+	return fileDescriptor_e17e923ef6f5752e, []int{12}
+}
+
+func (m *ActivateFlowsBatchResult) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_ActivateFlowsBatchResult.Unmarshal(m, b)
+}
+func (m *ActivateFlowsBatchResult) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_ActivateFlowsBatchResult.Marshal(b, m, deterministic)
+}
+func (m *ActivateFlowsBatchResult) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_ActivateFlowsBatchResult.Merge(m, src)
+}
+func (m *ActivateFlowsBatchResult) XXX_Size() int {
+	return xxx_messageInfo_ActivateFlowsBatchResult.Size(m)
+}
+func (m *ActivateFlowsBatchResult) XXX_DiscardUnknown() {
+	xxx_messageInfo_ActivateFlowsBatchResult.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_ActivateFlowsBatchResult proto.InternalMessageInfo
+
+func (m *ActivateFlowsBatchResult) GetResults() []*ActivateFlowsResult {
+	if m != nil {
+		return m.Results
+	}
+	return nil
+}
+
+// Deactivations for many subscribers, applied in request order
+type DeactivateFlowsBatchRequest struct {
+	Requests             []*DeactivateFlowsRequest `protobuf:"bytes,1,rep,name=requests,proto3" json:"requests,omitempty"`
+	XXX_NoUnkeyedLiteral struct{}                  `json:"-"`
+	XXX_unrecognized     []byte                    `json:"-"`
+	XXX_sizecache        int32                     `json:"-"`
+}
+
+func (m *DeactivateFlowsBatchRequest) Reset()         { *m = DeactivateFlowsBatchRequest{} }
+func (m *DeactivateFlowsBatchRequest) String() string { return proto.CompactTextString(m) }
+func (*DeactivateFlowsBatchRequest) ProtoMessage()    {}
+func (*DeactivateFlowsBatchRequest) Descriptor() ([]byte, []int) {
+	return fileDescriptor_e17e923ef6f5752e, []int{13}
+}
+
+func (m *DeactivateFlowsBatchRequest) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_DeactivateFlowsBatchRequest.Unmarshal(m, b)
+}
+func (m *DeactivateFlowsBatchRequest) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_DeactivateFlowsBatchRequest.Marshal(b, m, deterministic)
+}
+func (m *DeactivateFlowsBatchRequest) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_DeactivateFlowsBatchRequest.Merge(m, src)
+}
+func (m *DeactivateFlowsBatchRequest) XXX_Size() int {
+	return xxx_messageInfo_DeactivateFlowsBatchRequest.Size(m)
+}
+func (m *DeactivateFlowsBatchRequest) XXX_DiscardUnknown() {
+	xxx_messageInfo_DeactivateFlowsBatchRequest.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_DeactivateFlowsBatchRequest proto.InternalMessageInfo
+
+func (m *DeactivateFlowsBatchRequest) GetRequests() []*DeactivateFlowsRequest {
+	if m != nil {
+		return m.Requests
+	}
+	return nil
+}
+
+// One result per request, in request order
+type DeactivateFlowsBatchResult struct {
+	Results              []*DeactivateFlowsResult `protobuf:"bytes,1,rep,name=results,proto3" json:"results,omitempty"`
+	XXX_NoUnkeyedLiteral struct{}                 `json:"-"`
+	XXX_unrecognized     []byte                   `json:"-"`
+	XXX_sizecache        int32                    `json:"-"`
+}
+
+func (m *DeactivateFlowsBatchResult) Reset()         { *m = DeactivateFlowsBatchResult{} }
+func (m *DeactivateFlowsBatchResult) String() string { return proto.CompactTextString(m) }
+func (*DeactivateFlowsBatchResult) ProtoMessage()    {}
+func (*DeactivateFlowsBatchResult) Descriptor() ([]byte, []int) {
+	return fileDescriptor_e17e923ef6f5752e, []int{14}
+}
+
+func (m *DeactivateFlowsBatchResult) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_DeactivateFlowsBatchResult.Unmarshal(m, b)
+}
+func (m *DeactivateFlowsBatchResult) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_DeactivateFlowsBatchResult.Marshal(b, m, deterministic)
+}
+func (m *DeactivateFlowsBatchResult) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_DeactivateFlowsBatchResult.Merge(m, src)
+}
+func (m *DeactivateFlowsBatchResult) XXX_Size() int {
+	return xxx_messageInfo_DeactivateFlowsBatchResult.Size(m)
+}
+func (m *DeactivateFlowsBatchResult) XXX_DiscardUnknown() {
+	xxx_messageInfo_DeactivateFlowsBatchResult.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_DeactivateFlowsBatchResult proto.InternalMessageInfo
+
+func (m *DeactivateFlowsBatchResult) GetResults() []*DeactivateFlowsResult {
+	if m != nil {
+		return m.Results
+	}
+	return nil
+}
+
 type FlowRequest struct {
 	Match                *FlowMatch            `protobuf:"bytes,1,opt,name=match,proto3" json:"match,omitempty"`
 	AppName              string                `protobuf:"bytes,2,opt,name=app_name,json=appName,proto3" json:"app_name,omitempty"`
@@ -790,7 +950,7 @@ func (m *FlowRequest) Reset()         { *m = FlowRequest{} }
 func (m *FlowRequest) String() string { return proto.CompactTextString(m) }
 func (*FlowRequest) ProtoMessage()    {}
 func (*FlowRequest) Descriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{11}
+	return fileDescriptor_e17e923ef6f5752e, []int{15}
 }
 
 func (m *FlowRequest) XXX_Unmarshal(b []byte) error {
@@ -871,7 +1031,7 @@ func (m *FlowResponse) Reset()         { *m = FlowResponse{} }
 func (m *FlowResponse) String() string { return proto.CompactTextString(m) }
 func (*FlowResponse) ProtoMessage()    {}
 func (*FlowResponse) Descriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{12}
+	return fileDescriptor_e17e923ef6f5752e, []int{16}
 }
 
 func (m *FlowResponse) XXX_Unmarshal(b []byte) error {
@@ -919,7 +1079,7 @@ func (m *UEMacFlowRequest) Reset()         { *m = UEMacFlowRequest{} }
 func (m *UEMacFlowRequest) String() string { return proto.CompactTextString(m) }
 func (*UEMacFlowRequest) ProtoMessage()    {}
 func (*UEMacFlowRequest) Descriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{13}
+	return fileDescriptor_e17e923ef6f5752e, []int{17}
 }
 
 func (m *UEMacFlowRequest) XXX_Unmarshal(b []byte) error {
@@ -989,7 +1149,7 @@ func (m *SubscriberQuotaUpdate) Reset()         { *m = SubscriberQuotaUpdate{} }
 func (m *SubscriberQuotaUpdate) String() string { return proto.CompactTextString(m) }
 func (*SubscriberQuotaUpdate) ProtoMessage()    {}
 func (*SubscriberQuotaUpdate) Descriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{14}
+	return fileDescriptor_e17e923ef6f5752e, []int{18}
 }
 
 func (m *SubscriberQuotaUpdate) XXX_Unmarshal(b []byte) error {
@@ -1042,7 +1202,7 @@ func (m *UpdateSubscriberQuotaStateRequest) Reset()         { *m = UpdateSubscri
 func (m *UpdateSubscriberQuotaStateRequest) String() string { return proto.CompactTextString(m) }
 func (*UpdateSubscriberQuotaStateRequest) ProtoMessage()    {}
 func (*UpdateSubscriberQuotaStateRequest) Descriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{15}
+	return fileDescriptor_e17e923ef6f5752e, []int{19}
 }
 
 func (m *UpdateSubscriberQuotaStateRequest) XXX_Unmarshal(b []byte) error {
@@ -1083,7 +1243,7 @@ func (m *TableAssignment) Reset()         { *m = TableAssignment{} }
 func (m *TableAssignment) String() string { return proto.CompactTextString(m) }
 func (*TableAssignment) ProtoMessage()    {}
 func (*TableAssignment) Descriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{16}
+	return fileDescriptor_e17e923ef6f5752e, []int{20}
 }
 
 func (m *TableAssignment) XXX_Unmarshal(b []byte) error {
@@ -1136,7 +1296,7 @@ func (m *AllTableAssignments) Reset()         { *m = AllTableAssignments{} }
 func (m *AllTableAssignments) String() string { return proto.CompactTextString(m) }
 func (*AllTableAssignments) ProtoMessage()    {}
 func (*AllTableAssignments) Descriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{17}
+	return fileDescriptor_e17e923ef6f5752e, []int{21}
 }
 
 func (m *AllTableAssignments) XXX_Unmarshal(b []byte) error {
@@ -1176,7 +1336,7 @@ func (m *SerializedRyuPacket) Reset()         { *m = SerializedRyuPacket{} }
 func (m *SerializedRyuPacket) String() string { return proto.CompactTextString(m) }
 func (*SerializedRyuPacket) ProtoMessage()    {}
 func (*SerializedRyuPacket) Descriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{18}
+	return fileDescriptor_e17e923ef6f5752e, []int{22}
 }
 
 func (m *SerializedRyuPacket) XXX_Unmarshal(b []byte) error {
@@ -1222,7 +1382,7 @@ func (m *PacketDropTableId) Reset()         { *m = PacketDropTableId{} }
 func (m *PacketDropTableId) String() string { return proto.CompactTextString(m) }
 func (*PacketDropTableId) ProtoMessage()    {}
 func (*PacketDropTableId) Descriptor() ([]byte, []int) {
-	return fileDescriptor_e17e923ef6f5752e, []int{19}
+	return fileDescriptor_e17e923ef6f5752e, []int{23}
 }
 
 func (m *PacketDropTableId) XXX_Unmarshal(b []byte) error {
@@ -1269,6 +1429,10 @@ func init() {
 	proto.RegisterType((*RuleModResult)(nil), "magma.lte.RuleModResult")
 	proto.RegisterType((*ActivateFlowsResult)(nil), "magma.lte.ActivateFlowsResult")
 	proto.RegisterType((*DeactivateFlowsResult)(nil), "magma.lte.DeactivateFlowsResult")
+	proto.RegisterType((*ActivateFlowsBatchRequest)(nil), "magma.lte.ActivateFlowsBatchRequest")
+	proto.RegisterType((*ActivateFlowsBatchResult)(nil), "magma.lte.ActivateFlowsBatchResult")
+	proto.RegisterType((*DeactivateFlowsBatchRequest)(nil), "magma.lte.DeactivateFlowsBatchRequest")
+	proto.RegisterType((*DeactivateFlowsBatchResult)(nil), "magma.lte.DeactivateFlowsBatchResult")
 	proto.RegisterType((*FlowRequest)(nil), "magma.lte.FlowRequest")
 	proto.RegisterType((*FlowResponse)(nil), "magma.lte.FlowResponse")
 	proto.RegisterType((*UEMacFlowRequest)(nil), "magma.lte.UEMacFlowRequest")
@@ -1283,97 +1447,102 @@ func init() {
 func init() { proto.RegisterFile("lte/protos/pipelined.proto", fileDescriptor_e17e923ef6f5752e) }
 
 var fileDescriptor_e17e923ef6f5752e = []byte{
-	// 1435 bytes of a gzipped FileDescriptorProto
-	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xb4, 0x58, 0xcb, 0x72, 0xdb, 0x36,
-	0x17, 0x36, 0x25, 0x59, 0xb2, 0x8e, 0x64, 0x9b, 0x86, 0x1d, 0x5f, 0xe4, 0x38, 0x71, 0x38, 0x93,
-	0xf9, 0xfd, 0x77, 0x3a, 0xf2, 0x8c, 0xdb, 0x49, 0x3a, 0xc9, 0x22, 0xc3, 0xea, 0xe2, 0xb0, 0xf5,
-	0x45, 0x81, 0xe4, 0xd4, 0xed, 0xa2, 0x1c, 0x98, 0xc4, 0x38, 0x9c, 0x90, 0x22, 0x43, 0x40, 0x69,
-	0xdc, 0xe9, 0x74, 0xd9, 0x75, 0xd7, 0xdd, 0x76, 0xd5, 0xe9, 0x13, 0xf4, 0x0d, 0xfa, 0x0e, 0x7d,
-	0x86, 0x6e, 0xbb, 0xee, 0x10, 0x80, 0x64, 0x9a, 0x92, 0xed, 0x5c, 0xdc, 0x95, 0x08, 0xe0, 0x9c,
-	0xef, 0x7c, 0x38, 0xf8, 0x70, 0x00, 0x08, 0x6a, 0x3e, 0xa7, 0xdb, 0x51, 0x1c, 0xf2, 0x90, 0x6d,
-	0x47, 0x5e, 0x44, 0x7d, 0xaf, 0x4f, 0xdd, 0xba, 0xe8, 0x40, 0xe5, 0x80, 0x9c, 0x06, 0xa4, 0xee,
-	0x73, 0x5a, 0x5b, 0x0b, 0x63, 0xe7, 0xb3, 0x78, 0x68, 0xe8, 0x84, 0x41, 0x10, 0xf6, 0xa5, 0x55,
-	0x6d, 0x2d, 0x8d, 0x10, 0xfa, 0x9e, 0x73, 0xe6, 0x9e, 0xa8, 0xa1, 0xcd, 0xd4, 0x10, 0xa3, 0x8c,
-	0x79, 0x61, 0xdf, 0x0e, 0x48, 0x9f, 0x9c, 0xd2, 0x58, 0x59, 0x6c, 0xa4, 0x2d, 0x06, 0x27, 0xcc,
-	0x89, 0xbd, 0x13, 0x1a, 0x0f, 0x01, 0x8c, 0x3f, 0x34, 0x58, 0xe8, 0x52, 0x3e, 0x88, 0xda, 0x7e,
-	0xf8, 0x1d, 0xc3, 0xf4, 0xd5, 0x80, 0x32, 0x8e, 0x1e, 0xc3, 0x4c, 0x2c, 0x3f, 0xd9, 0xaa, 0xb6,
-	0x99, 0xdf, 0xaa, 0xec, 0xdc, 0xad, 0x8f, 0xa8, 0xd6, 0x4d, 0x87, 0x7b, 0xaf, 0x09, 0xa7, 0x69,
-	0x17, 0x3c, 0x72, 0x40, 0x4b, 0x30, 0x4d, 0xa3, 0xd0, 0x79, 0xb1, 0x9a, 0xdb, 0xd4, 0xb6, 0x0a,
-	0x58, 0x36, 0xd0, 0x33, 0x98, 0x7d, 0x35, 0x08, 0x39, 0xb1, 0x07, 0x91, 0x4b, 0x38, 0x65, 0xab,
-	0xf9, 0x4d, 0x6d, 0xab, 0xb2, 0xf3, 0x71, 0x0a, 0xf7, 0x48, 0x8c, 0x74, 0x47, 0x24, 0x9f, 0x25,
-	0xf6, 0x5d, 0x4e, 0x38, 0x1d, 0x06, 0xa9, 0x0a, 0x08, 0x69, 0xc7, 0x8c, 0x13, 0x45, 0xfd, 0xa8,
-	0xb5, 0x4f, 0x9c, 0x21, 0xf5, 0x87, 0x63, 0xd4, 0xd7, 0xd3, 0x21, 0x12, 0xd3, 0x84, 0xf7, 0x5b,
-	0xd2, 0x36, 0x4e, 0x01, 0x89, 0x18, 0x1d, 0x91, 0xf7, 0xff, 0x2e, 0x3f, 0xc6, 0x0f, 0x6a, 0x32,
-	0x62, 0xd2, 0xc3, 0x38, 0x63, 0x49, 0xd3, 0x3e, 0x34, 0x69, 0x97, 0x44, 0xff, 0x49, 0x03, 0x3d,
-	0x2d, 0x03, 0x36, 0xf0, 0x39, 0x7a, 0x04, 0xc5, 0x58, 0x7c, 0x89, 0xb0, 0x73, 0x3b, 0x46, 0x2a,
-	0x6c, 0xd6, 0xb8, 0x2e, 0x7f, 0xb0, 0xf2, 0x30, 0x1e, 0x40, 0x51, 0xa1, 0x54, 0xa0, 0xd4, 0x3d,
-	0x6a, 0x34, 0x5a, 0xdd, 0xae, 0x3e, 0x95, 0x34, 0xda, 0xa6, 0xb5, 0x77, 0x84, 0x5b, 0xba, 0x86,
-	0x10, 0xcc, 0x1d, 0x1e, 0xf5, 0x9a, 0x66, 0xaf, 0xd5, 0xb4, 0x5b, 0x9d, 0xc3, 0xc6, 0x53, 0x3d,
-	0x67, 0xf4, 0x61, 0x41, 0xf1, 0x3e, 0x8c, 0xbd, 0x53, 0xaf, 0xdf, 0x3b, 0x8b, 0x28, 0x7a, 0x0c,
-	0x05, 0x7e, 0x16, 0x51, 0x45, 0xe3, 0x7f, 0x29, 0x1a, 0x63, 0xb6, 0xf5, 0xf3, 0x4f, 0x2c, 0x9c,
-	0x8c, 0xdb, 0x00, 0x29, 0xa8, 0x22, 0xe4, 0x76, 0x8f, 0xf5, 0x29, 0xf1, 0xfb, 0xb5, 0xae, 0x19,
-	0xff, 0x68, 0xb0, 0x34, 0x69, 0xbd, 0xd0, 0xff, 0x21, 0xcf, 0x3c, 0x57, 0x25, 0x7c, 0x25, 0x3d,
-	0xf3, 0x51, 0xaa, 0xad, 0x26, 0x4e, 0x6c, 0xd0, 0x0a, 0x94, 0xbc, 0xc8, 0x26, 0xae, 0x1b, 0x8b,
-	0xa4, 0x96, 0x71, 0xd1, 0x8b, 0x4c, 0xd7, 0x8d, 0xd1, 0x1a, 0xcc, 0xc4, 0x03, 0x9f, 0xda, 0x9e,
-	0x9b, 0xc8, 0x3d, 0xbf, 0x55, 0xc6, 0xa5, 0xa4, 0x6d, 0xb9, 0x0c, 0x3d, 0x82, 0x59, 0xf7, 0xac,
-	0x4f, 0x02, 0xcf, 0xb1, 0x93, 0x2e, 0xb6, 0x5a, 0x10, 0x32, 0xba, 0x95, 0x0a, 0xa4, 0x24, 0x37,
-	0xf0, 0x29, 0xae, 0x2a, 0xdb, 0xa4, 0xc1, 0x50, 0x03, 0xe6, 0x94, 0x98, 0xec, 0x50, 0xcc, 0x6c,
-	0x75, 0x5a, 0xb0, 0xbc, 0x7d, 0x55, 0x62, 0xf0, 0x6c, 0x9c, 0xee, 0x32, 0x7e, 0xd5, 0x60, 0xb9,
-	0x49, 0xc9, 0x07, 0x4e, 0x3d, 0x3d, 0xc3, 0xdc, 0xc5, 0x19, 0x8e, 0xb3, 0xcc, 0xbf, 0x3b, 0xcb,
-	0x5f, 0x34, 0x98, 0x4d, 0x26, 0xbd, 0x1f, 0xba, 0x4a, 0x4e, 0x2b, 0x50, 0x52, 0x11, 0x05, 0xc1,
-	0x32, 0x2e, 0xca, 0x80, 0xe8, 0xe1, 0x48, 0xad, 0x39, 0x21, 0x93, 0xf4, 0x8e, 0xbc, 0x00, 0x91,
-	0x95, 0xea, 0xc3, 0xc9, 0x52, 0x5d, 0x84, 0xf9, 0x8e, 0x89, 0x7b, 0x96, 0xb9, 0x67, 0x0f, 0x3b,
-	0xb5, 0xb4, 0x7e, 0x73, 0xc6, 0xef, 0x1a, 0x2c, 0x66, 0xb4, 0x23, 0x60, 0x9e, 0xc2, 0x22, 0xe3,
-	0x84, 0xab, 0xa5, 0xb5, 0x65, 0x98, 0x61, 0xa1, 0x58, 0xbd, 0x8c, 0x16, 0x5e, 0x90, 0x4e, 0x62,
-	0xc1, 0xa5, 0x0b, 0xfa, 0x02, 0x96, 0xd2, 0x2a, 0x19, 0x41, 0xe5, 0xae, 0x81, 0x42, 0x29, 0xbd,
-	0x28, 0x2c, 0xe3, 0x67, 0x0d, 0x6e, 0x8d, 0x2d, 0xb8, 0xe0, 0xfb, 0x24, 0xb3, 0xcf, 0xd3, 0x1b,
-	0x6c, 0xa2, 0xc7, 0x4d, 0x6d, 0xf6, 0xbf, 0x73, 0x50, 0x49, 0x15, 0x63, 0xf4, 0x11, 0x4c, 0x07,
-	0x84, 0x3b, 0x2f, 0x94, 0xf4, 0x96, 0x52, 0x3c, 0x12, 0xb3, 0xfd, 0x64, 0x0c, 0x4b, 0x93, 0x44,
-	0x79, 0x24, 0x8a, 0xec, 0x3e, 0x09, 0xa8, 0xda, 0x75, 0x25, 0x12, 0x45, 0x07, 0x24, 0xa0, 0xc9,
-	0xd0, 0xc9, 0x19, 0xa7, 0xcc, 0x8e, 0xdf, 0x08, 0xcd, 0x15, 0x70, 0x49, 0xb4, 0xf1, 0x1b, 0x74,
-	0x0f, 0xaa, 0x8c, 0xc6, 0xaf, 0x3d, 0x87, 0xda, 0xa2, 0xa2, 0x14, 0x84, 0x67, 0x45, 0xf5, 0x89,
-	0x0a, 0xb1, 0x02, 0x25, 0x16, 0x3b, 0x76, 0x40, 0x1c, 0xb1, 0xad, 0xca, 0xb8, 0xc8, 0x62, 0x67,
-	0x9f, 0x38, 0xc9, 0x80, 0xcb, 0xb8, 0x18, 0x28, 0xca, 0x01, 0x97, 0xf1, 0x64, 0xe0, 0x01, 0x4c,
-	0x27, 0x4b, 0x47, 0x57, 0x4b, 0x22, 0x7d, 0x9b, 0x19, 0xda, 0x6a, 0x76, 0xe2, 0x5b, 0x16, 0x66,
-	0x69, 0x6e, 0x84, 0x50, 0x1e, 0xf5, 0x21, 0x1d, 0xaa, 0xed, 0xbd, 0xc3, 0xaf, 0xec, 0x06, 0x6e,
-	0x25, 0x39, 0xd2, 0xa7, 0xd0, 0x5d, 0x58, 0x17, 0x3d, 0x43, 0x15, 0x36, 0xf6, 0xcc, 0x6e, 0xd7,
-	0x6a, 0x5b, 0x0d, 0xb3, 0x67, 0x1d, 0x1e, 0xe8, 0x1a, 0xda, 0x80, 0x35, 0x61, 0xd0, 0xb6, 0x0e,
-	0xc6, 0x87, 0x73, 0x23, 0xc4, 0xd6, 0x71, 0xc7, 0xc2, 0xad, 0xa6, 0x9e, 0x37, 0x7e, 0x84, 0xaa,
-	0x24, 0xc4, 0xa2, 0xb0, 0xcf, 0x28, 0x7a, 0x90, 0x59, 0xf8, 0x3b, 0x63, 0xcc, 0xa5, 0xe1, 0x4d,
-	0xad, 0xf7, 0x6f, 0x1a, 0xe8, 0xd9, 0x13, 0xf8, 0x1d, 0xab, 0x4d, 0x40, 0x9c, 0x74, 0xa5, 0x2d,
-	0x05, 0xc4, 0x11, 0xa5, 0x76, 0x19, 0x8a, 0x01, 0xf3, 0x98, 0x2b, 0xab, 0x4c, 0x19, 0xab, 0x16,
-	0xba, 0x03, 0x15, 0x12, 0xd9, 0x23, 0x2f, 0xb9, 0xde, 0x65, 0x12, 0xed, 0x2b, 0xbf, 0x15, 0x28,
-	0x11, 0xa5, 0x22, 0xb5, 0xda, 0x44, 0x88, 0xc8, 0xf8, 0x4b, 0x83, 0x5b, 0x99, 0x53, 0x55, 0x1e,
-	0xa1, 0x37, 0x44, 0xb8, 0x0d, 0x15, 0x79, 0xa8, 0x4b, 0x21, 0xe6, 0xc5, 0x02, 0xdc, 0x9f, 0x88,
-	0x96, 0x0a, 0x5e, 0x17, 0x45, 0x12, 0xa4, 0x67, 0xf2, 0x6d, 0x7c, 0x0a, 0x05, 0x21, 0xdb, 0x79,
-	0xa8, 0x3c, 0x37, 0xf7, 0xac, 0xa6, 0xfd, 0xec, 0xe8, 0xb0, 0x67, 0xea, 0x53, 0xa8, 0x0a, 0x33,
-	0x07, 0x87, 0xaa, 0xa5, 0xa1, 0x59, 0x28, 0xf7, 0x5a, 0x78, 0xdf, 0x3a, 0x30, 0x7b, 0x49, 0xe9,
-	0xb2, 0xe1, 0xde, 0xb5, 0x17, 0x07, 0xf4, 0x08, 0x4a, 0xe7, 0xf7, 0x8e, 0xa4, 0xe0, 0x6c, 0x5e,
-	0x47, 0x0f, 0x0f, 0x1d, 0x8c, 0x18, 0xe6, 0x7b, 0xe4, 0xc4, 0xa7, 0x26, 0x63, 0xde, 0x69, 0x3f,
-	0xa0, 0x7d, 0x7e, 0x61, 0xc7, 0x6a, 0x17, 0x77, 0xec, 0x06, 0x40, 0x40, 0xbc, 0xbe, 0xcd, 0x13,
-	0x17, 0x75, 0x33, 0x29, 0x27, 0x3d, 0x02, 0x03, 0xdd, 0x87, 0x39, 0xe6, 0xc4, 0xc9, 0xb6, 0x97,
-	0x16, 0xf2, 0x34, 0x2d, 0xe0, 0x59, 0xd5, 0x2b, 0xac, 0x98, 0xf1, 0x2d, 0x2c, 0x9a, 0xbe, 0x9f,
-	0x09, 0xcb, 0xd0, 0x2e, 0x2c, 0x08, 0x2f, 0x9b, 0x9c, 0x77, 0xaa, 0x09, 0xd5, 0x52, 0x13, 0xca,
-	0xf8, 0x61, 0x9d, 0x67, 0x80, 0x8c, 0xc7, 0xb0, 0xd8, 0xa5, 0xb1, 0x47, 0x7c, 0xef, 0x7b, 0xea,
-	0xe2, 0xb3, 0x41, 0x87, 0x38, 0x2f, 0x29, 0x47, 0x3a, 0xe4, 0xa3, 0x97, 0x72, 0x0b, 0x55, 0x71,
-	0xf2, 0x89, 0x10, 0x14, 0xbc, 0x80, 0x79, 0x6a, 0xc9, 0xc5, 0xb7, 0x51, 0x87, 0x05, 0x69, 0xdf,
-	0x8c, 0xc3, 0x48, 0xc4, 0xb2, 0x84, 0x3e, 0x24, 0x35, 0xa5, 0xa7, 0x69, 0x5c, 0xe2, 0x72, 0x68,
-	0xe7, 0xcf, 0x19, 0x28, 0x77, 0x86, 0xcf, 0x05, 0xd4, 0x51, 0xd7, 0x33, 0x79, 0x27, 0x10, 0xa5,
-	0x18, 0x6d, 0x64, 0xaf, 0x63, 0x17, 0xee, 0xa8, 0xb5, 0xf5, 0x2b, 0x6e, 0x6b, 0xc6, 0x14, 0xc2,
-	0x30, 0x7b, 0xe1, 0xec, 0x42, 0xd7, 0xdd, 0x60, 0x6b, 0x77, 0x2e, 0x37, 0x50, 0x98, 0xc7, 0x30,
-	0x9f, 0x39, 0x2f, 0xd0, 0xbd, 0xab, 0xce, 0x12, 0x89, 0xbb, 0x79, 0xdd, 0x71, 0x63, 0x4c, 0x21,
-	0x13, 0xe6, 0x76, 0x29, 0x97, 0x13, 0x3c, 0x62, 0xe4, 0x94, 0xa2, 0x05, 0xe5, 0x25, 0x9e, 0x4d,
-	0xf5, 0xe7, 0xa1, 0xe7, 0xd6, 0x6a, 0x99, 0xf3, 0x10, 0x53, 0x27, 0x8c, 0x5d, 0x91, 0x6b, 0x63,
-	0x0a, 0x3d, 0x01, 0x68, 0xc4, 0x54, 0x21, 0xa3, 0xe5, 0xc9, 0x45, 0xba, 0xb6, 0x72, 0x49, 0x09,
-	0x94, 0x00, 0x98, 0x06, 0xe1, 0xeb, 0xf7, 0x06, 0x68, 0xc2, 0xbc, 0xdc, 0x26, 0xc3, 0xaa, 0xcf,
-	0xde, 0x07, 0xe5, 0x00, 0xe6, 0xcf, 0x1f, 0x0a, 0x32, 0xc9, 0xb7, 0xb3, 0x4b, 0x9d, 0x7e, 0x44,
-	0x5c, 0x27, 0x04, 0x0a, 0xb5, 0xcb, 0x4b, 0x01, 0x7a, 0xa7, 0xa7, 0xc6, 0xdb, 0xd0, 0x1e, 0xd5,
-	0xff, 0x09, 0xb4, 0xd3, 0x0f, 0xb9, 0xeb, 0x68, 0xb7, 0xa1, 0x6a, 0xba, 0xee, 0x08, 0x0d, 0x5d,
-	0xf5, 0xca, 0xbb, 0x8a, 0x97, 0x95, 0x68, 0xd6, 0xa7, 0x9c, 0xde, 0x08, 0x94, 0x4c, 0x91, 0xd5,
-	0x69, 0x5b, 0xc7, 0x1f, 0x04, 0xf5, 0x25, 0x2c, 0xef, 0x52, 0x3e, 0xa9, 0x9a, 0x4d, 0xd0, 0xfd,
-	0x85, 0x8d, 0x39, 0xee, 0xf2, 0xf9, 0xfa, 0x37, 0x6b, 0xc2, 0x60, 0xdb, 0xe7, 0x74, 0xdb, 0xf1,
-	0xc3, 0x81, 0xbb, 0x7d, 0x1a, 0xaa, 0xff, 0x04, 0x4e, 0x8a, 0xe2, 0xf7, 0x93, 0x7f, 0x03, 0x00,
-	0x00, 0xff, 0xff, 0x0f, 0xc4, 0x52, 0xfb, 0xa7, 0x10, 0x00, 0x00,
+	// 1513 bytes of a gzipped FileDescriptorProto
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x58, 0x5b, 0x6f, 0x1b, 0x45,
+	0x14, 0x66, 0x6d, 0xc7, 0xae, 0x8f, 0xed, 0xc4, 0x99, 0xa4, 0xa9, 0xe3, 0x34, 0x6d, 0xba, 0x50,
+	0x28, 0x08, 0x39, 0x52, 0x40, 0x6d, 0x45, 0x85, 0x2a, 0xd7, 0x97, 0x76, 0x21, 0x89, 0xdd, 0xb5,
+	0x5d, 0x02, 0x42, 0xac, 0xd6, 0xbb, 0x23, 0x77, 0x55, 0xdb, 0xbb, 0xdd, 0x5d, 0x97, 0x06, 0x21,
+	0x1e, 0x79, 0xe6, 0x81, 0x27, 0x5e, 0x79, 0x42, 0xfc, 0x02, 0x7e, 0x0b, 0xbf, 0x81, 0x57, 0x9e,
+	0x99, 0x9b, 0x9d, 0xf1, 0xda, 0x8e, 0x7b, 0x09, 0x4f, 0xde, 0x99, 0x39, 0x97, 0x6f, 0xce, 0x7c,
+	0xe7, 0x9c, 0x19, 0x43, 0xb1, 0x1f, 0xe2, 0x7d, 0xcf, 0x77, 0x43, 0x37, 0xd8, 0xf7, 0x1c, 0x0f,
+	0xf7, 0x9d, 0x21, 0xb6, 0x4b, 0x6c, 0x02, 0xa5, 0x07, 0x66, 0x6f, 0x60, 0x96, 0x88, 0x44, 0x71,
+	0xdb, 0xf5, 0xad, 0xbb, 0xfe, 0x58, 0xd0, 0x72, 0x07, 0x03, 0x77, 0xc8, 0xa5, 0x8a, 0xdb, 0xb2,
+	0x05, 0xb7, 0xef, 0x58, 0xa7, 0x76, 0x57, 0x2c, 0xed, 0x49, 0x4b, 0x01, 0x0e, 0x02, 0xc7, 0x1d,
+	0x1a, 0x03, 0x73, 0x68, 0xf6, 0xb0, 0x2f, 0x24, 0x76, 0x65, 0x89, 0x51, 0x37, 0xb0, 0x7c, 0xa7,
+	0x8b, 0xfd, 0xb1, 0x01, 0xf5, 0x2f, 0x05, 0xd6, 0x5b, 0x38, 0x1c, 0x79, 0xf5, 0xbe, 0xfb, 0x7d,
+	0xa0, 0xe3, 0xe7, 0x23, 0x1c, 0x84, 0xe8, 0x1e, 0x5c, 0xf2, 0xf9, 0x67, 0x50, 0x50, 0xf6, 0xe2,
+	0xb7, 0x32, 0x07, 0xd7, 0x4b, 0x13, 0xa8, 0xa5, 0xb2, 0x15, 0x3a, 0x2f, 0xcc, 0x10, 0xcb, 0x2a,
+	0xfa, 0x44, 0x01, 0x6d, 0xc2, 0x0a, 0xf6, 0x5c, 0xeb, 0x69, 0x21, 0xb6, 0xa7, 0xdc, 0x4a, 0xe8,
+	0x7c, 0x80, 0x1e, 0x43, 0xee, 0xf9, 0xc8, 0x0d, 0x4d, 0x63, 0xe4, 0xd9, 0x44, 0x37, 0x28, 0xc4,
+	0xc9, 0x6a, 0xe6, 0xe0, 0x63, 0xc9, 0x6e, 0x87, 0xad, 0xb4, 0x26, 0x20, 0x1f, 0x53, 0xf9, 0x56,
+	0x48, 0xe6, 0xc6, 0x4e, 0xb2, 0xcc, 0x04, 0x97, 0x0b, 0xd4, 0xae, 0x80, 0xde, 0xa9, 0x1d, 0x99,
+	0xd6, 0x18, 0xfa, 0x9d, 0x19, 0xe8, 0x3b, 0xb2, 0x0b, 0x2a, 0x4a, 0x71, 0xbf, 0x22, 0x6c, 0xb5,
+	0x07, 0x88, 0xf9, 0x68, 0xb2, 0xb8, 0xff, 0x7f, 0xf1, 0x51, 0x7f, 0x14, 0x9b, 0x61, 0x9b, 0x1e,
+	0xfb, 0x99, 0x09, 0x9a, 0xf2, 0xb6, 0x41, 0x5b, 0xe0, 0xfd, 0x67, 0x05, 0xf2, 0x32, 0x0d, 0x82,
+	0x51, 0x3f, 0x44, 0x9f, 0x41, 0xd2, 0x67, 0x5f, 0xcc, 0xed, 0xea, 0x81, 0x2a, 0xb9, 0x8d, 0x0a,
+	0x97, 0xf8, 0x8f, 0x2e, 0x34, 0xd4, 0xdb, 0x90, 0x14, 0x56, 0x32, 0x90, 0x6a, 0x75, 0x2a, 0x95,
+	0x5a, 0xab, 0x95, 0x7f, 0x87, 0x0e, 0xea, 0x65, 0xed, 0xb0, 0xa3, 0xd7, 0xf2, 0x0a, 0x42, 0xb0,
+	0xda, 0xe8, 0xb4, 0xab, 0xe5, 0x76, 0xad, 0x6a, 0xd4, 0x9a, 0x8d, 0xca, 0xa3, 0x7c, 0x4c, 0x1d,
+	0xc2, 0xba, 0xc0, 0xdd, 0xf0, 0x9d, 0x9e, 0x33, 0x6c, 0x9f, 0x7a, 0x98, 0x84, 0x3b, 0x11, 0x92,
+	0x5f, 0x01, 0xe3, 0x03, 0x09, 0xc6, 0x8c, 0x6c, 0xe9, 0xec, 0x53, 0x67, 0x4a, 0xea, 0x55, 0x00,
+	0xc9, 0x54, 0x12, 0x62, 0x0f, 0x4f, 0x08, 0x10, 0xfa, 0xfb, 0x75, 0x5e, 0x51, 0xff, 0x55, 0x60,
+	0x73, 0xde, 0x79, 0xa1, 0x0f, 0x21, 0x1e, 0x38, 0xb6, 0x08, 0xf8, 0x15, 0x79, 0xe7, 0x93, 0x50,
+	0x6b, 0x55, 0x9d, 0xca, 0xa0, 0x2b, 0x90, 0x72, 0x3c, 0xc3, 0xb4, 0x6d, 0x9f, 0x05, 0x35, 0xad,
+	0x27, 0x1d, 0xaf, 0x4c, 0x46, 0x68, 0x9b, 0xd0, 0x64, 0xd4, 0xc7, 0x86, 0x63, 0x53, 0xba, 0xc7,
+	0xc9, 0x4a, 0x8a, 0x8e, 0x35, 0x3b, 0x20, 0xb1, 0xcd, 0xd9, 0xa7, 0x43, 0x73, 0xe0, 0x58, 0x06,
+	0x9d, 0x0a, 0x0a, 0x09, 0x46, 0xa3, 0xcb, 0x92, 0x23, 0x41, 0x39, 0xb2, 0xaa, 0x67, 0x85, 0x2c,
+	0x1d, 0x04, 0xa8, 0x02, 0xab, 0x82, 0x4c, 0x86, 0xcb, 0x76, 0x56, 0x58, 0x61, 0x28, 0xaf, 0x9e,
+	0x17, 0x18, 0x3d, 0xe7, 0xcb, 0x53, 0xea, 0xef, 0x0a, 0x6c, 0x55, 0xb1, 0xf9, 0x96, 0x5b, 0x97,
+	0x77, 0x18, 0x9b, 0xde, 0xe1, 0x2c, 0xca, 0xf8, 0xeb, 0xa3, 0xfc, 0x4d, 0x81, 0x1c, 0xdd, 0xf4,
+	0x91, 0x6b, 0x0b, 0x3a, 0x91, 0x60, 0x0b, 0x8f, 0x0c, 0x20, 0x09, 0x36, 0x77, 0x48, 0x12, 0x7f,
+	0xcc, 0xd6, 0x18, 0xa3, 0x89, 0x9c, 0x91, 0x53, 0x26, 0xa2, 0x54, 0xbd, 0x33, 0x9f, 0xaa, 0x1b,
+	0xb0, 0xd6, 0x2c, 0xeb, 0x6d, 0xad, 0x7c, 0x68, 0x8c, 0x27, 0x15, 0x99, 0xbf, 0x31, 0xf5, 0x4f,
+	0x05, 0x36, 0x22, 0xdc, 0x61, 0x66, 0x1e, 0xc1, 0x46, 0x40, 0x12, 0x50, 0x1c, 0xad, 0xc1, 0xdd,
+	0x8c, 0x0b, 0x45, 0x61, 0x11, 0x2c, 0x7d, 0x9d, 0x2b, 0xb1, 0x03, 0xe7, 0x2a, 0xe8, 0x0b, 0xd8,
+	0x94, 0x59, 0x32, 0x31, 0x15, 0x5b, 0x62, 0x0a, 0x49, 0x7c, 0x11, 0xb6, 0xd4, 0x5f, 0x14, 0xb8,
+	0x3c, 0x73, 0xe0, 0x0c, 0xef, 0xfd, 0x48, 0x9e, 0xcb, 0x09, 0x36, 0x57, 0xe3, 0xa2, 0x92, 0xfd,
+	0x04, 0xb6, 0xa7, 0xe2, 0xf7, 0xc0, 0x0c, 0xad, 0xa7, 0x17, 0x51, 0x63, 0xd5, 0x36, 0x14, 0xe6,
+	0x59, 0x66, 0x18, 0xef, 0x12, 0x06, 0x4d, 0x1d, 0xc9, 0xb5, 0xc5, 0x76, 0xd9, 0x36, 0xc7, 0xe2,
+	0xea, 0xb7, 0xb0, 0x13, 0x89, 0xc7, 0x14, 0xe2, 0xcf, 0x67, 0x10, 0xdf, 0x38, 0x2f, 0x92, 0x51,
+	0xcc, 0x27, 0x50, 0x9c, 0x6f, 0x5d, 0x14, 0xe3, 0x08, 0xea, 0xbd, 0x65, 0xa7, 0x74, 0x86, 0xfb,
+	0x9f, 0x18, 0x64, 0xa4, 0xa6, 0x87, 0x3e, 0x82, 0x95, 0x01, 0x35, 0x2d, 0x52, 0x7c, 0x53, 0xb2,
+	0x44, 0xc5, 0x8e, 0x98, 0x5b, 0x2e, 0x42, 0x33, 0xdc, 0xf4, 0x3c, 0x83, 0xd0, 0x09, 0x8b, 0xea,
+	0x96, 0x22, 0xe3, 0x63, 0x32, 0xa4, 0x4b, 0xdd, 0x53, 0xd2, 0x53, 0x0c, 0xff, 0x25, 0xcb, 0xed,
+	0x84, 0x9e, 0x62, 0x63, 0xfd, 0x25, 0xba, 0x01, 0xd9, 0x00, 0xfb, 0x2f, 0x1c, 0x0b, 0x1b, 0xac,
+	0x72, 0x27, 0x98, 0x66, 0x46, 0xcc, 0xb1, 0x4a, 0x4c, 0x12, 0x39, 0xf0, 0x2d, 0x72, 0x5b, 0xb1,
+	0x58, 0xf9, 0x22, 0x89, 0x4c, 0x86, 0xa4, 0x3b, 0xd3, 0x05, 0x9b, 0x14, 0x0d, 0xba, 0x90, 0xe4,
+	0x0b, 0x64, 0x48, 0x17, 0x6e, 0xc3, 0x0a, 0x4d, 0x11, 0x5c, 0x48, 0x31, 0x9a, 0xee, 0x45, 0x60,
+	0x8b, 0xdd, 0xb1, 0x6f, 0xde, 0x00, 0xb9, 0xb8, 0xea, 0x42, 0x7a, 0x32, 0x87, 0xf2, 0x90, 0xad,
+	0x1f, 0x36, 0xbe, 0x32, 0x2a, 0x7a, 0x8d, 0x72, 0x91, 0xd0, 0xf4, 0x3a, 0xec, 0xb0, 0x99, 0x71,
+	0xb6, 0x57, 0x0e, 0xcb, 0xad, 0x96, 0x56, 0xd7, 0x2a, 0xe5, 0xb6, 0xd6, 0x38, 0x26, 0xd4, 0xdd,
+	0x85, 0x6d, 0x26, 0x50, 0xd7, 0x8e, 0x67, 0x97, 0x63, 0x13, 0x8b, 0xb5, 0x93, 0xa6, 0xa6, 0x13,
+	0x8b, 0x71, 0xf5, 0x27, 0x32, 0xc3, 0x00, 0x05, 0x9e, 0x3b, 0x0c, 0x30, 0x01, 0x3e, 0x9d, 0x60,
+	0xd7, 0x66, 0x90, 0x73, 0xc1, 0x8b, 0xca, 0xab, 0x3f, 0x48, 0x37, 0x8f, 0xde, 0x74, 0x5e, 0xb3,
+	0xaa, 0x93, 0xe8, 0xcb, 0x1d, 0x2d, 0x45, 0xc6, 0xac, 0xa5, 0x6d, 0x41, 0x72, 0x10, 0x38, 0x81,
+	0xcd, 0xab, 0x39, 0x39, 0x1b, 0x3e, 0x42, 0xd7, 0x20, 0x63, 0x7a, 0xc6, 0x44, 0x8b, 0x9f, 0x77,
+	0xda, 0xf4, 0x8e, 0x84, 0x1e, 0x39, 0x54, 0x53, 0xb0, 0x48, 0x9c, 0xb6, 0xc9, 0x48, 0xa4, 0xfe,
+	0x4d, 0xca, 0x52, 0xe4, 0xf6, 0xc2, 0xaf, 0x2a, 0x17, 0x04, 0xb8, 0x0e, 0x19, 0x7e, 0x79, 0xe2,
+	0x44, 0x8c, 0xb3, 0x03, 0xb8, 0x39, 0xd7, 0x9a, 0xe4, 0xbc, 0xc4, 0x9a, 0x11, 0x70, 0x4d, 0xfa,
+	0xad, 0x7e, 0x0a, 0x09, 0x46, 0xdb, 0x35, 0xc8, 0x3c, 0x29, 0x1f, 0x6a, 0x55, 0xe3, 0x71, 0xa7,
+	0xd1, 0x2e, 0x93, 0xd3, 0xc8, 0xc2, 0xa5, 0xe3, 0x86, 0x18, 0x29, 0x28, 0x07, 0xe9, 0x76, 0x4d,
+	0x3f, 0x22, 0x4c, 0x69, 0xd3, 0x16, 0x61, 0xc0, 0x8d, 0xa5, 0x17, 0x34, 0x9a, 0xda, 0x67, 0xf7,
+	0xbb, 0x68, 0x6a, 0xcf, 0x85, 0xa7, 0x8f, 0x15, 0x54, 0x1f, 0xd6, 0xda, 0x66, 0xb7, 0x8f, 0xcb,
+	0xe4, 0xee, 0xdf, 0x1b, 0x0e, 0xf0, 0x30, 0x9c, 0xca, 0x58, 0x65, 0x3a, 0x63, 0x77, 0x01, 0x06,
+	0xa6, 0x33, 0x34, 0x42, 0xaa, 0x22, 0x6e, 0x80, 0x69, 0x3a, 0xc3, 0x6c, 0xa0, 0x9b, 0xb0, 0x4a,
+	0x7c, 0xd1, 0xb4, 0xe7, 0x12, 0xfc, 0xd6, 0x92, 0xd0, 0x73, 0x62, 0x96, 0x49, 0x05, 0xea, 0x77,
+	0xa4, 0xed, 0xf5, 0xfb, 0x11, 0xb7, 0x01, 0x7a, 0x08, 0xeb, 0x4c, 0xcb, 0x30, 0xcf, 0x26, 0xc5,
+	0x86, 0x8a, 0xd2, 0x86, 0x22, 0x7a, 0x7a, 0x3e, 0x8c, 0x18, 0x52, 0xef, 0xc1, 0x46, 0x0b, 0xfb,
+	0x8e, 0xd9, 0x77, 0x7e, 0xc0, 0xb6, 0x7e, 0x3a, 0x6a, 0x9a, 0xd6, 0x33, 0x1c, 0x92, 0x3c, 0x8b,
+	0x7b, 0xcf, 0x78, 0x0a, 0x65, 0x75, 0xfa, 0x49, 0xb8, 0x9f, 0x70, 0x08, 0xff, 0xc4, 0x91, 0xb3,
+	0x6f, 0xb5, 0x04, 0xeb, 0x5c, 0xbe, 0xea, 0xbb, 0x1e, 0xf3, 0xa5, 0x31, 0x7e, 0x70, 0x68, 0x82,
+	0x4f, 0x2b, 0x7a, 0x2a, 0xe4, 0x4b, 0x07, 0xbf, 0x02, 0xa4, 0x9b, 0xe3, 0x67, 0x19, 0x6a, 0x8a,
+	0x6b, 0x30, 0xbf, 0x7b, 0xb1, 0x62, 0x8a, 0x76, 0xa3, 0xd7, 0xde, 0xa9, 0xb7, 0x40, 0x71, 0xe7,
+	0x9c, 0x5b, 0xb1, 0xfa, 0x0e, 0xd2, 0x21, 0x37, 0xd5, 0x53, 0xd0, 0xb2, 0x2e, 0x56, 0x5c, 0xd2,
+	0x8e, 0x88, 0xcd, 0x13, 0x58, 0x8b, 0x54, 0x7c, 0xb4, 0xbc, 0xd3, 0x14, 0x97, 0x36, 0x0c, 0x62,
+	0xd9, 0x04, 0x34, 0xdb, 0x37, 0xd1, 0x7b, 0x8b, 0x10, 0xc9, 0xed, 0xaf, 0xf8, 0xee, 0x12, 0x29,
+	0xe1, 0xa2, 0x07, 0x9b, 0xf3, 0xda, 0x1c, 0x7a, 0x7f, 0x31, 0xbc, 0x29, 0x37, 0x37, 0x97, 0xca,
+	0x09, 0x47, 0x65, 0x58, 0x7d, 0x88, 0x43, 0x7e, 0x58, 0x9d, 0x80, 0x3c, 0x89, 0xd1, 0xba, 0x50,
+	0x65, 0x4f, 0xed, 0xd2, 0x13, 0xd7, 0xb1, 0x8b, 0xc5, 0xc8, 0x1d, 0x4a, 0xc7, 0x96, 0xeb, 0xdb,
+	0x8c, 0x37, 0xc4, 0xc4, 0x7d, 0x80, 0x8a, 0x8f, 0x85, 0x79, 0xb4, 0x35, 0xbf, 0xe1, 0x14, 0xaf,
+	0x2c, 0x28, 0xe7, 0xdc, 0x80, 0x8e, 0x07, 0xee, 0x8b, 0x37, 0x36, 0x50, 0x85, 0x35, 0x9e, 0xf2,
+	0xe3, 0x0e, 0x16, 0xbc, 0x89, 0x95, 0x63, 0x58, 0x3b, 0x7b, 0x5c, 0x72, 0xc2, 0x5c, 0x8d, 0xd2,
+	0x56, 0x7e, 0x78, 0x2e, 0x23, 0x35, 0x86, 0xe2, 0xe2, 0xb2, 0x86, 0x5e, 0xeb, 0x79, 0xfa, 0x2a,
+	0xb0, 0x27, 0xbd, 0x6c, 0x0e, 0x6c, 0xf9, 0xf1, 0xbf, 0x0c, 0x76, 0x1d, 0xb2, 0xa4, 0x27, 0x4c,
+	0xac, 0xa1, 0xf3, 0xfe, 0x19, 0x38, 0x0f, 0x97, 0x46, 0xf3, 0xaf, 0x8f, 0x43, 0x7c, 0x21, 0xa6,
+	0x78, 0x88, 0xb4, 0x66, 0x5d, 0x3b, 0x79, 0x2b, 0x53, 0x5f, 0xc2, 0x16, 0xe1, 0xfb, 0xbc, 0xca,
+	0x3c, 0x87, 0xf7, 0x53, 0x45, 0x66, 0x56, 0xe5, 0xc1, 0xce, 0x37, 0xdb, 0x4c, 0x60, 0x9f, 0xfe,
+	0x7d, 0x64, 0xf5, 0xdd, 0x91, 0xbd, 0xdf, 0x73, 0xc5, 0xff, 0x48, 0xdd, 0x24, 0xfb, 0xfd, 0xe4,
+	0x3f, 0xbd, 0xc3, 0xba, 0x1d, 0xdb, 0x12, 0x00, 0x00,
 }
 
 // Reference imports to suppress errors if they are not otherwise used.
@@ -1394,6 +1563,10 @@ type PipelinedClient interface {
 	ActivateFlows(ctx context.Context, in *ActivateFlowsRequest, opts ...grpc.CallOption) (*ActivateFlowsResult, error)
 	// Deactivate flows for a subscriber
 	DeactivateFlows(ctx context.Context, in *DeactivateFlowsRequest, opts ...grpc.CallOption) (*DeactivateFlowsResult, error)
+	// Activate flows for many subscribers in one call
+	ActivateFlowsBatch(ctx context.Context, in *ActivateFlowsBatchRequest, opts ...grpc.CallOption) (*ActivateFlowsBatchResult, error)
+	// Deactivate flows for many subscribers in one call
+	DeactivateFlowsBatch(ctx context.Context, in *DeactivateFlowsBatchRequest, opts ...grpc.CallOption) (*DeactivateFlowsBatchResult, error)
 	// Get policy usage stats
 	GetPolicyUsage(ctx context.Context, in *protos.Void, opts ...grpc.CallOption) (*RuleRecordTable, error)
 	// Add new dpi flow
@@ -1454,6 +1627,24 @@ func (c *pipelinedClient) DeactivateFlows(ctx context.Context, in *DeactivateFlo
 	return out, nil
 }
 
+func (c *pipelinedClient) ActivateFlowsBatch(ctx context.Context, in *ActivateFlowsBatchRequest, opts ...grpc.CallOption) (*ActivateFlowsBatchResult, error) {
+	out := new(ActivateFlowsBatchResult)
+	err := c.cc.Invoke(ctx, "/magma.lte.Pipelined/ActivateFlowsBatch", in, out, opts...)
+	if err != nil {
+		return nil, err
+	}
+	return out, nil
+}
+
+func (c *pipelinedClient) DeactivateFlowsBatch(ctx context.Context, in *DeactivateFlowsBatchRequest, opts ...grpc.CallOption) (*DeactivateFlowsBatchResult, error) {
+	out := new(DeactivateFlowsBatchResult)
+	err := c.cc.Invoke(ctx, "/magma.lte.Pipelined/DeactivateFlowsBatch", in, out, opts...)
+	if err != nil {
+		return nil, err
+	}
+	return out, nil
+}
+
 func (c *pipelinedClient) GetPolicyUsage(ctx context.Context, in *protos.Void, opts ...grpc.CallOption) (*RuleRecordTable, error) {
 	out := new(RuleRecordTable)
 	err := c.cc.Invoke(ctx, "/magma.lte.Pipelined/GetPolicyUsage", in, out, opts...)
@@ -1561,6 +1752,10 @@ type PipelinedServer interface {
 	ActivateFlows(context.Context, *ActivateFlowsRequest) (*ActivateFlowsResult, error)
 	// Deactivate flows for a subscriber
 	DeactivateFlows(context.Context, *DeactivateFlowsRequest) (*DeactivateFlowsResult, error)
+	// Activate flows for many subscribers in one call
+	ActivateFlowsBatch(context.Context, *ActivateFlowsBatchRequest) (*ActivateFlowsBatchResult, error)
+	// Deactivate flows for many subscribers in one call
+	DeactivateFlowsBatch(context.Context, *DeactivateFlowsBatchRequest) (*DeactivateFlowsBatchResult, error)
 	// Get policy usage stats
 	GetPolicyUsage(context.Context, *protos.Void) (*RuleRecordTable, error)
 	// Add new dpi flow
@@ -1599,6 +1794,12 @@ func (*UnimplementedPipelinedServer) ActivateFlows(ctx context.Context, req *Act
 func (*UnimplementedPipelinedServer) DeactivateFlows(ctx context.Context, req *DeactivateFlowsRequest) (*DeactivateFlowsResult, error) {
 	return nil, status.Errorf(codes.Unimplemented, "method DeactivateFlows not implemented")
 }
+func (*UnimplementedPipelinedServer) ActivateFlowsBatch(ctx context.Context, req *ActivateFlowsBatchRequest) (*ActivateFlowsBatchResult, error) {
+	return nil, status.Errorf(codes.Unimplemented, "method ActivateFlowsBatch not implemented")
+}
+func (*UnimplementedPipelinedServer) DeactivateFlowsBatch(ctx context.Context, req *DeactivateFlowsBatchRequest) (*DeactivateFlowsBatchResult, error) {
+	return nil, status.Errorf(codes.Unimplemented, "method DeactivateFlowsBatch not implemented")
+}
 func (*UnimplementedPipelinedServer) GetPolicyUsage(ctx context.Context, req *protos.Void) (*RuleRecordTable, error) {
 	return nil, status.Errorf(codes.Unimplemented, "method GetPolicyUsage not implemented")
 }
@@ -1691,6 +1892,42 @@ func _Pipelined_DeactivateFlows_Handler(srv interface{}, ctx context.Context, de
 	return interceptor(ctx, in, info, handler)
 }
 
+func _Pipelined_ActivateFlowsBatch_Handler(srv interface{}, ctx context.Context, dec func(interface{}) error, interceptor grpc.UnaryServerInterceptor) (interface{}, error) {
+	in := new(ActivateFlowsBatchRequest)
+	if err := dec(in); err != nil {
+		return nil, err
+	}
+	if interceptor == nil {
+		return srv.(PipelinedServer).ActivateFlowsBatch(ctx, in)
+	}
+	info := &grpc.UnaryServerInfo{
+		Server:     srv,
+		FullMethod: "/magma.lte.Pipelined/ActivateFlowsBatch",
+	}
+	handler := func(ctx context.Context, req interface{}) (interface{}, error) {
+		return srv.(PipelinedServer).ActivateFlowsBatch(ctx, req.(*ActivateFlowsBatchRequest))
+	}
+	return interceptor(ctx, in, info, handler)
+}
+
+func _Pipelined_DeactivateFlowsBatch_Handler(srv interface{}, ctx context.Context, dec func(interface{}) error, interceptor grpc.UnaryServerInterceptor) (interface{}, error) {
+	in := new(DeactivateFlowsBatchRequest)
+	if err := dec(in); err != nil {
+		return nil, err
+	}
+	if interceptor == nil {
+		return srv.(PipelinedServer).DeactivateFlowsBatch(ctx, in)
+	}
+	info := &grpc.UnaryServerInfo{
+		Server:     srv,
+		FullMethod: "/magma.lte.Pipelined/DeactivateFlowsBatch",
+	}
+	handler := func(ctx context.Context, req interface{}) (interface{}, error) {
+		return srv.(PipelinedServer).DeactivateFlowsBatch(ctx, req.(*DeactivateFlowsBatchRequest))
+	}
+	return interceptor(ctx, in, info, handler)
+}
+
 func _Pipelined_GetPolicyUsage_Handler(srv interface{}, ctx context.Context, dec func(interface{}) error, interceptor grpc.UnaryServerInterceptor) (interface{}, error) {
 	in := new(protos.Void)
 	if err := dec(in); err != nil {
@@ -1905,6 +2142,14 @@ var _Pipelined_serviceDesc = grpc.ServiceDesc{
 			MethodName: "DeactivateFlows",
 			Handler:    _Pipelined_DeactivateFlows_Handler,
 		},
+		{
+			MethodName: "ActivateFlowsBatch",
+			Handler:    _Pipelined_ActivateFlowsBatch_Handler,
+		},
+		{
+			MethodName: "DeactivateFlowsBatch",
+			Handler:    _Pipelined_DeactivateFlowsBatch_Handler,
+		},
 		{
 			MethodName: "GetPolicyUsage",
 			Handler:    _Pipelined_GetPolicyUsage_Handler,
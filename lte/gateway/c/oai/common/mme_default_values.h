@@ -35,6 +35,14 @@
  ******************************************************************************/
 #define MME_STATISTIC_TIMER_S (60)
 
+/*******************************************************************************
+ * Overload Control Constants
+ ******************************************************************************/
+/* MME_APP queue occupancy in percent at which S1AP OVERLOAD START is sent */
+#define MME_OVERLOAD_HIGH_WATERMARK_PERCENT (80)
+/* MME_APP queue occupancy in percent at which S1AP OVERLOAD STOP is sent */
+#define MME_OVERLOAD_LOW_WATERMARK_PERCENT (50)
+
 /*******************************************************************************
  * GTPV1 User Plane Constants
  ******************************************************************************/
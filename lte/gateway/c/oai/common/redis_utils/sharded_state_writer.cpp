@@ -0,0 +1,180 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "sharded_state_writer.h"
+
+#include <utility>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <common_defs.h>
+#include <log.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+namespace magma {
+namespace lte {
+
+namespace {
+
+class RedisStore : public ShardedStateWriter::Store {
+ public:
+  int write(const std::string& key, const std::string& value) override
+  {
+    return redis_client_.write(key, value);
+  }
+
+  int clear(const std::string& key) override
+  {
+    return redis_client_.clear_keys({key});
+  }
+
+ private:
+  RedisClient redis_client_;
+};
+
+} // namespace
+
+ShardedStateWriter::ShardedStateWriter(uint32_t num_shards):
+  ShardedStateWriter(num_shards, []() {
+    return std::unique_ptr<Store>(new RedisStore());
+  })
+{
+}
+
+ShardedStateWriter::ShardedStateWriter(
+  uint32_t num_shards,
+  StoreFactory make_store)
+{
+  if (num_shards == 0) {
+    num_shards = 1;
+  }
+  for (uint32_t i = 0; i < num_shards; i++) {
+    shards_.emplace_back(std::make_unique<Shard>());
+  }
+  for (auto& shard : shards_) {
+    Shard* shard_p = shard.get();
+    auto store = make_store();
+    shard->worker =
+      std::thread([this, shard_p, store = std::move(store)]() mutable {
+        run(*shard_p, std::move(store));
+      });
+  }
+}
+
+ShardedStateWriter::~ShardedStateWriter()
+{
+  for (auto& shard : shards_) {
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->stopping = true;
+    }
+    shard->cv.notify_all();
+  }
+  for (auto& shard : shards_) {
+    if (shard->worker.joinable()) {
+      shard->worker.join();
+    }
+  }
+}
+
+ShardedStateWriter::Shard& ShardedStateWriter::get_shard(uint64_t shard_key)
+{
+  return *shards_[shard_key % shards_.size()];
+}
+
+void ShardedStateWriter::write(
+  uint64_t shard_key,
+  const std::string& key,
+  std::string value)
+{
+  enqueue(shard_key, key, PendingWrite{false, std::move(value)});
+}
+
+void ShardedStateWriter::clear(uint64_t shard_key, const std::string& key)
+{
+  enqueue(shard_key, key, PendingWrite{true, ""});
+}
+
+void ShardedStateWriter::enqueue(
+  uint64_t shard_key,
+  const std::string& key,
+  PendingWrite op)
+{
+  auto& shard = get_shard(shard_key);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.pending.find(key);
+    if (it != shard.pending.end()) {
+      // Not written yet, the latest value wins
+      it->second = std::move(op);
+      return;
+    }
+    shard.pending.emplace(key, std::move(op));
+    shard.order.push_back(key);
+  }
+  shard.cv.notify_all();
+}
+
+void ShardedStateWriter::flush()
+{
+  for (auto& shard : shards_) {
+    std::unique_lock<std::mutex> lock(shard->mutex);
+    shard->cv.wait(
+      lock, [&shard]() { return shard->order.empty() && !shard->busy; });
+  }
+}
+
+void ShardedStateWriter::run(Shard& shard, std::unique_ptr<Store> store)
+{
+  std::unique_lock<std::mutex> lock(shard.mutex);
+  while (true) {
+    shard.cv.wait(
+      lock, [&shard]() { return shard.stopping || !shard.order.empty(); });
+    if (shard.order.empty()) {
+      // Stopping with nothing left to write
+      return;
+    }
+    auto key = std::move(shard.order.front());
+    shard.order.pop_front();
+    auto it = shard.pending.find(key);
+    auto op = std::move(it->second);
+    shard.pending.erase(it);
+    shard.busy = true;
+    lock.unlock();
+
+    int rc = op.is_delete ? store->clear(key) : store->write(key, op.value);
+    if (rc != RETURNok) {
+      OAILOG_ERROR(LOG_UTIL, "Failed to write state for %s to db", key.c_str());
+    }
+
+    lock.lock();
+    shard.busy = false;
+    shard.cv.notify_all();
+  }
+}
+
+} // namespace lte
+} // namespace magma
@@ -0,0 +1,124 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "redis_client.h"
+
+namespace magma {
+namespace lte {
+
+/**
+ * ShardedStateWriter moves redis writes of task and UE state off the task
+ * thread. Writes are spread over a fixed number of shards, each owning a
+ * worker thread and its own RedisClient; all writes for the same shard key
+ * (e.g. an IMSI) land on the same shard and are applied in order. Pending
+ * writes to the same redis key are coalesced, so only the latest value of a
+ * UE context is written when the task updates it faster than redis keeps up.
+ *
+ * Only persistence is sharded: MME_APP/NAS still handle every UE on the
+ * MME_APP thread. A write is acknowledged before redis applies it, so a
+ * crash can lose the latest updates of a UE.
+ */
+class ShardedStateWriter {
+ public:
+  /**
+   * Where a shard applies its writes. Each shard makes its own and only uses
+   * it from its worker thread.
+   */
+  class Store {
+   public:
+    virtual ~Store() = default;
+    virtual int write(const std::string& key, const std::string& value) = 0;
+    virtual int clear(const std::string& key) = 0;
+  };
+  using StoreFactory = std::function<std::unique_ptr<Store>()>;
+
+  /**
+   * Applies writes to redis, with one RedisClient per shard
+   */
+  explicit ShardedStateWriter(uint32_t num_shards);
+
+  ShardedStateWriter(uint32_t num_shards, StoreFactory make_store);
+
+  /**
+   * Drains pending writes and joins the workers
+   */
+  ~ShardedStateWriter();
+
+  /**
+   * Queues a write of value to key on the shard of shard_key
+   */
+  void write(uint64_t shard_key, const std::string& key, std::string value);
+
+  /**
+   * Queues the deletion of key on the shard of shard_key, ordered after any
+   * write to key queued before
+   */
+  void clear(uint64_t shard_key, const std::string& key);
+
+  /**
+   * Blocks until all writes queued so far have been applied
+   */
+  void flush();
+
+  uint32_t get_num_shards() const { return shards_.size(); }
+
+  ShardedStateWriter(ShardedStateWriter const&) = delete;
+  ShardedStateWriter& operator=(ShardedStateWriter const&) = delete;
+
+ private:
+  struct PendingWrite {
+    bool is_delete;
+    std::string value;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::condition_variable cv;
+    // Keys in first-queued order, values in pending
+    std::deque<std::string> order;
+    std::unordered_map<std::string, PendingWrite> pending;
+    bool busy = false;
+    bool stopping = false;
+    std::thread worker;
+  };
+
+  Shard& get_shard(uint64_t shard_key);
+  void enqueue(uint64_t shard_key, const std::string& key, PendingWrite op);
+  void run(Shard& shard, std::unique_ptr<Store> store);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace lte
+} // namespace magma
@@ -66,9 +66,12 @@
 #define MME_CONFIG_STRING_MAXUE "MAXUE"
 #define MME_CONFIG_STRING_RELATIVE_CAPACITY "RELATIVE_CAPACITY"
 #define MME_CONFIG_STRING_STATISTIC_TIMER "MME_STATISTIC_TIMER"
+#define MME_CONFIG_STRING_OVERLOAD_HIGH_WATERMARK "OVERLOAD_HIGH_WATERMARK"
+#define MME_CONFIG_STRING_OVERLOAD_LOW_WATERMARK "OVERLOAD_LOW_WATERMARK"
 
 #define MME_CONFIG_STRING_IP_CAPABILITY "IP_CAPABILITY"
 #define MME_CONFIG_STRING_USE_STATELESS "USE_STATELESS"
+#define MME_CONFIG_STRING_STATE_WRITE_WORKERS "STATE_WRITE_WORKERS"
 #define MME_CONFIG_STRING_FULL_NETWORK_NAME "FULL_NETWORK_NAME"
 #define MME_CONFIG_STRING_SHORT_NETWORK_NAME "SHORT_NETWORK_NAME"
 #define MME_CONFIG_STRING_DAYLIGHT_SAVING_TIME "DAYLIGHT_SAVING_TIME"
@@ -91,6 +94,8 @@
 
 #define MME_CONFIG_STRING_INTERTASK_INTERFACE_CONFIG "INTERTASK_INTERFACE"
 #define MME_CONFIG_STRING_INTERTASK_INTERFACE_QUEUE_SIZE "ITTI_QUEUE_SIZE"
+#define MME_CONFIG_STRING_INTERTASK_INTERFACE_TRACE_SAMPLING                   \
+  "ITTI_TRACE_SAMPLING"
 
 #define MME_CONFIG_STRING_S6A_CONFIG "S6A"
 #define MME_CONFIG_STRING_S6A_CONF_FILE_PATH "S6A_CONF"
@@ -216,6 +221,7 @@ typedef struct s6a_config_s {
 
 typedef struct itti_config_s {
   uint32_t queue_size;
+  uint32_t trace_sampling; // trace one IMSI in trace_sampling, 0 disables
   bstring log_file;
 } itti_config_t;
 
@@ -278,6 +284,10 @@ typedef struct mme_config_s {
 
   uint32_t mme_statistic_timer;
 
+  // MME_APP queue occupancy (percent) entering / leaving S1AP overload
+  uint8_t overload_high_watermark;
+  uint8_t overload_low_watermark;
+
   bstring ip_capability;
   bstring non_eps_service_control;
 
@@ -304,6 +314,8 @@ typedef struct mme_config_s {
   lai_t lai;
 
   bool use_stateless;
+  // Threads persisting state to redis, sharded by IMSI; 0 writes inline
+  uint32_t state_write_workers;
 } mme_config_t;
 
 extern mme_config_t mme_config;
@@ -36,7 +36,9 @@ extern "C" {
 #endif
 
 #include <conversions.h>
+#include <functional>
 #include "redis_utils/redis_client.h"
+#include "redis_utils/sharded_state_writer.h"
 
 namespace {
 constexpr char IMSI_PREFIX[] = "IMSI";
@@ -93,6 +95,9 @@ class StateManager {
   virtual int read_state_from_db()
   {
     if (persist_state_enabled) {
+      if (state_writer) {
+        state_writer->flush();
+      }
       ProtoType state_proto = ProtoType();
       if (redis_client->read_proto(table_key, state_proto) != RETURNok) {
         return RETURNerror;
@@ -107,6 +112,9 @@ class StateManager {
     if (!persist_state_enabled) {
       return RETURNok;
     }
+    if (state_writer) {
+      state_writer->flush();
+    }
     auto keys = redis_client->get_keys("IMSI*" + task_name + "*");
     for (const auto& key : keys) {
       ProtoUe ue_proto = ProtoUe();
@@ -141,7 +149,15 @@ class StateManager {
       ProtoType state_proto = ProtoType();
       StateConverter::state_to_proto(state_cache_p, &state_proto);
 
-      if (redis_client->write_proto(table_key, state_proto) != RETURNok) {
+      if (state_writer) {
+        std::string value;
+        if (redis_client->serialize(state_proto, value) != RETURNok) {
+          OAILOG_ERROR(log_task, "Failed to serialize state");
+          return;
+        }
+        state_writer->write(
+          std::hash<std::string>()(table_key), table_key, std::move(value));
+      } else if (redis_client->write_proto(table_key, state_proto) != RETURNok) {
         OAILOG_ERROR(log_task, "Failed to write state to db");
         return;
       }
@@ -162,6 +178,19 @@ class StateManager {
     ProtoUe ue_proto = ProtoUe();
     StateConverter::ue_to_proto(ue_context, &ue_proto);
     std::string key = IMSI_PREFIX + imsi_str + ":" + task_name;
+    if (state_writer) {
+      // Shard on the IMSI so that all writes of a UE stay in order
+      std::string value;
+      if (redis_client->serialize(ue_proto, value) != RETURNok) {
+        OAILOG_ERROR(
+          log_task, "Failed to serialize UE state for IMSI %s",
+          imsi_str.c_str());
+        return;
+      }
+      state_writer->write(
+        std::hash<std::string>()(imsi_str), key, std::move(value));
+      return;
+    }
     if (redis_client->write_proto(key, ue_proto) != RETURNok) {
       OAILOG_ERROR(
           log_task, "Failed to write UE state to db for IMSI %s",
@@ -192,6 +221,10 @@ class StateManager {
     if (persist_state_enabled) {
       std::vector<std::string> keys = {IMSI_PREFIX + imsi_str + ":" +
                                        task_name};
+      if (state_writer) {
+        state_writer->clear(std::hash<std::string>()(imsi_str), keys[0]);
+        return;
+      }
       if (redis_client->clear_keys(keys) != RETURNok) {
         OAILOG_ERROR(log_task, "Failed to remove UE state from db");
         return;
@@ -210,6 +243,17 @@ class StateManager {
     return persist_state_enabled;
   }
 
+  /**
+   * Moves db writes of this task state to num_shards writer threads, sharded
+   * by IMSI for UE state. 0 keeps writes synchronous on the task thread.
+   */
+  void enable_sharded_writes(uint32_t num_shards)
+  {
+    if (persist_state_enabled && num_shards > 0) {
+      state_writer = std::make_unique<ShardedStateWriter>(num_shards);
+    }
+  }
+
  protected:
   StateManager():
     is_initialized(false),
@@ -242,6 +286,8 @@ class StateManager {
   hash_table_ts_t* state_ue_ht;
   // TODO: Revisit one shared connection for all types of state
   std::unique_ptr<RedisClient> redis_client;
+  // Asynchronous writer shards, null when writes are synchronous
+  std::unique_ptr<ShardedStateWriter> state_writer;
   // Flag for check asserting if the state has been initialized.
   bool is_initialized;
   // Flag for check asserting that write should be done after read.
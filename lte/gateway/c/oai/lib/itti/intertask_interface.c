@@ -41,6 +41,7 @@
 #include <malloc.h>
 #include <stdint.h>
 #include <sys/time.h>
+#include <time.h>
 
 #include "assertions.h"
 #include "intertask_interface.h"
@@ -60,6 +61,7 @@
 #include "dynamic_memory_check.h"
 #include "shared_ts_log.h"
 #include "log.h"
+#include "common_types.h"
 
 /* ITTI DEBUG groups */
 #define ITTI_DEBUG_POLL (1 << 0)
@@ -97,6 +99,36 @@ typedef struct message_list_s {
   uint32_t message_priority;       ///< Message priority
 } message_list_t;
 
+/*
+ * Dequeue weights of each priority level: per round, a task handles up to
+ * this many messages of a level before lower levels get their turn, so
+ * control / cleanup traffic overtakes new work without starving it.
+ */
+static const uint32_t itti_queue_level_weights[ITTI_QUEUE_LEVELS] = {8, 4, 1};
+
+/*
+ * Latency histograms of one (origin, destination, message id) triple.
+ * Bucket i counts samples in [2^(i-1), 2^i) microseconds, the last bucket
+ * everything above. Updated lock-free by the receiving tasks, drained by
+ * itti_latency_stats_apply().
+ */
+typedef struct itti_latency_entry_s {
+  uint32_t key; ///< 0 while the slot is free
+  uint64_t wait[ITTI_LATENCY_BUCKETS];
+  uint64_t handler[ITTI_LATENCY_BUCKETS];
+  uint64_t wait_max_us;
+  uint64_t handler_max_us;
+  bool reported; ///< Had samples in the previous interval, reader only
+} itti_latency_entry_t;
+
+#define ITTI_LATENCY_TABLE_SIZE 4096
+
+typedef struct queue_wait_stats_s {
+  uint64_t wait_sum_us;
+  uint64_t wait_max_us;
+  uint64_t messages;
+} queue_wait_stats_t;
+
 typedef struct thread_desc_s {
   /*
    * pthread associated with the thread
@@ -116,11 +148,43 @@ typedef struct thread_desc_s {
 
 typedef struct task_desc_s {
   /*
-   * Queue of messages belonging to the task
+   * Queues of messages belonging to the task, one per priority level
    */
-  struct lfds710_queue_bmm_state message_queue
+  struct lfds710_queue_bmm_state message_queue[ITTI_QUEUE_LEVELS]
     __attribute__((aligned(LFDS710_PAL_ATOMIC_ISOLATION_IN_BYTES)));
-  struct lfds710_queue_bmm_element* qbmme;
+  struct lfds710_queue_bmm_element* qbmme[ITTI_QUEUE_LEVELS];
+
+  /*
+   * Remaining dequeue credits of each level in the current round. Only
+   * touched by the receiving task.
+   */
+  uint32_t level_credits[ITTI_QUEUE_LEVELS];
+
+  /*
+   * Queue-wait statistics per level. Updated with atomics by the receiving
+   * task and swapped to zero by the reader, so neither side takes a lock.
+   */
+  queue_wait_stats_t wait_stats[ITTI_QUEUE_LEVELS];
+
+  /*
+   * Message the task is currently handling, closed on its next
+   * itti_receive_msg() to account the handler time.
+   */
+  itti_latency_entry_t* handling_entry;
+  uint64_t handling_since_us;
+  imsi64_t handling_imsi;
+  message_number_t handling_number;
+
+  /*
+   * Queue occupancy, updated atomically by senders and the receiving task.
+   * peak_depth is the high watermark since it was last read. level_depth
+   * splits queue_depth per priority level, each level holding at most
+   * queue_size messages.
+   */
+  uint32_t queue_depth __attribute__((aligned(8)));
+  uint32_t peak_depth;
+  uint32_t level_depth[ITTI_QUEUE_LEVELS];
+  uint64_t overflows;
 } task_desc_t;
 
 typedef struct itti_desc_s {
@@ -148,6 +212,10 @@ typedef struct itti_desc_s {
   volatile uint32_t ready_tasks;
 
   memory_pools_handle_t memory_pools_handle;
+
+  itti_latency_entry_t* latency_table;
+  /* Trace one IMSI in trace_sampling, 0 disables tracing */
+  uint32_t trace_sampling;
 } itti_desc_t;
 
 static itti_desc_t itti_desc;
@@ -217,6 +285,47 @@ static inline message_number_t itti_increment_message_number(void)
   return __sync_fetch_and_add(&itti_desc.message_number, 1);
 }
 
+static inline itti_queue_level_t itti_get_queue_level(uint32_t priority)
+{
+  if (priority >= MESSAGE_PRIORITY_MED_PLUS) {
+    return ITTI_QUEUE_LEVEL_HIGH;
+  } else if (priority >= MESSAGE_PRIORITY_MED_LEAST) {
+    return ITTI_QUEUE_LEVEL_MED;
+  }
+  return ITTI_QUEUE_LEVEL_LOW;
+}
+
+static inline uint64_t itti_get_monotonic_time_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static inline void itti_update_queue_depth(
+  task_id_t task_id,
+  itti_queue_level_t level,
+  int delta)
+{
+  task_desc_t* task = &itti_desc.tasks[task_id];
+  uint32_t depth;
+  uint32_t peak;
+
+  if (delta < 0) {
+    __sync_fetch_and_sub(&task->level_depth[level], 1);
+    __sync_fetch_and_sub(&task->queue_depth, 1);
+    return;
+  }
+  __sync_fetch_and_add(&task->level_depth[level], 1);
+  depth = __sync_add_and_fetch(&task->queue_depth, 1);
+  peak = task->peak_depth;
+  while (depth > peak) {
+    uint32_t prev = __sync_val_compare_and_swap(&task->peak_depth, peak, depth);
+    if (prev == peak) break;
+    peak = prev;
+  }
+}
+
 static inline uint32_t itti_get_message_priority(MessagesIds message_id)
 {
   AssertFatal(
@@ -307,12 +416,15 @@ int itti_send_broadcast_message(MessageDef* message_p)
         memcpy(new_message_p, message_p, size);
         result = itti_send_msg_to_task(
           destination_task_id, INSTANCE_DEFAULT, new_message_p);
-        AssertFatal(
-          result >= 0,
-          "Failed to send message %d to thread %d (task %d)!\n",
-          message_p->ittiMsgHeader.messageId,
-          thread_id,
-          destination_task_id);
+        if (result < 0) {
+          OAILOG_ERROR(
+            LOG_ITTI,
+            "Failed to send message %d to thread %d (task %d)!\n",
+            message_p->ittiMsgHeader.messageId,
+            thread_id,
+            destination_task_id);
+          ret = result;
+        }
       }
     }
   }
@@ -441,11 +553,34 @@ int itti_send_msg_to_task(
       new->msg = message;
       new->message_number = message_number;
       new->message_priority = priority;
+      message->ittiMsgHeader.enqueueTime = itti_get_monotonic_time_us();
       /*
-       * Enqueue message in destination task queue
+       * Enqueue message in the destination task queue of its priority level
        */
-      lfds710_queue_bmm_enqueue(
-        &itti_desc.tasks[destination_task_id].message_queue, NULL, new);
+      if (!lfds710_queue_bmm_enqueue(
+            &itti_desc.tasks[destination_task_id]
+               .message_queue[itti_get_queue_level(priority)],
+            NULL,
+            new)) {
+        /*
+         * Queue is full: account the overflow and hand the failure back to
+         * the sender instead of silently losing the message.
+         */
+        __sync_fetch_and_add(
+          &itti_desc.tasks[destination_task_id].overflows, 1);
+        OAILOG_ERROR(
+          LOG_ITTI,
+          "Queue of task %s is full (%u), dropping message %s from %s\n",
+          itti_get_task_name(destination_task_id),
+          itti_desc.tasks_info[destination_task_id].queue_size,
+          itti_desc.messages_info[message_id].name,
+          itti_get_task_name(origin_task_id));
+        itti_free(origin_task_id, new);
+        itti_free(origin_task_id, message);
+        return -1;
+      }
+      itti_update_queue_depth(
+        destination_task_id, itti_get_queue_level(priority), 1);
 
       /*
         * Only use event fd for tasks, subtasks will pool the queue
@@ -490,6 +625,166 @@ int itti_send_msg_to_task(
   return 0;
 }
 
+/*
+ * Weighted round robin over the priority levels of a task: take from the
+ * highest level that still has credits in this round, and start a new round
+ * once every non-empty level has used its share.
+ */
+static bool itti_dequeue_weighted(
+  task_desc_t* task,
+  struct message_list_s** message)
+{
+  int round;
+  int level;
+
+  for (round = 0; round < 2; round++) {
+    for (level = 0; level < ITTI_QUEUE_LEVELS; level++) {
+      if (
+        task->level_credits[level] > 0 &&
+        lfds710_queue_bmm_dequeue(
+          &task->message_queue[level], NULL, (void**) message)) {
+        task->level_credits[level]--;
+        return true;
+      }
+    }
+    for (level = 0; level < ITTI_QUEUE_LEVELS; level++) {
+      task->level_credits[level] = itti_queue_level_weights[level];
+    }
+  }
+  return false;
+}
+
+static inline int itti_latency_bucket(uint64_t us)
+{
+  int bucket = 0;
+  while (us > 0 && bucket < ITTI_LATENCY_BUCKETS - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+static inline void itti_atomic_max(uint64_t* target, uint64_t value)
+{
+  uint64_t current = *target;
+  while (value > current) {
+    uint64_t prev = __sync_val_compare_and_swap(target, current, value);
+    if (prev == current) break;
+    current = prev;
+  }
+}
+
+/*
+ * Find or claim the histogram slot of a (origin, destination, message)
+ * triple with lock-free linear probing. Returns NULL once the table is full.
+ */
+static itti_latency_entry_t* itti_get_latency_entry(
+  task_id_t origin_task_id,
+  task_id_t destination_task_id,
+  MessagesIds message_id)
+{
+  uint32_t key = ((uint32_t)(origin_task_id & 0xff) << 24) |
+                 ((uint32_t)(destination_task_id & 0xff) << 16) |
+                 (((uint32_t) message_id + 1) & 0xffff);
+  uint32_t slot = (key * 2654435761u) % ITTI_LATENCY_TABLE_SIZE;
+  int probe;
+
+  if (itti_desc.latency_table == NULL) {
+    return NULL;
+  }
+  for (probe = 0; probe < ITTI_LATENCY_TABLE_SIZE; probe++) {
+    itti_latency_entry_t* entry = &itti_desc.latency_table[slot];
+    uint32_t current = entry->key;
+    if (current == key) {
+      return entry;
+    }
+    if (current == 0) {
+      current = __sync_val_compare_and_swap(&entry->key, 0, key);
+      if (current == 0 || current == key) {
+        return entry;
+      }
+    }
+    slot = (slot + 1) % ITTI_LATENCY_TABLE_SIZE;
+  }
+  return NULL;
+}
+
+static inline bool itti_trace_imsi(imsi64_t imsi64)
+{
+  return itti_desc.trace_sampling > 0 && imsi64 != 0 &&
+         (imsi64 % itti_desc.trace_sampling) == 0;
+}
+
+/*
+ * Close the handler time of the message the task received last: the task
+ * is back in itti_receive_msg() so it is done with it.
+ */
+static void itti_record_handler_time(task_id_t task_id, task_desc_t* task)
+{
+  uint64_t handler_us;
+
+  if (task->handling_entry == NULL) {
+    return;
+  }
+  handler_us = itti_get_monotonic_time_us() - task->handling_since_us;
+  __sync_fetch_and_add(
+    &task->handling_entry->handler[itti_latency_bucket(handler_us)], 1);
+  itti_atomic_max(&task->handling_entry->handler_max_us, handler_us);
+  if (itti_trace_imsi(task->handling_imsi)) {
+    OAILOG_INFO(
+      LOG_ITTI,
+      "ITTI trace IMSI " IMSI_64_FMT " message %lu handled by %s in %lu us\n",
+      task->handling_imsi,
+      task->handling_number,
+      itti_get_task_name(task_id),
+      handler_us);
+  }
+  task->handling_entry = NULL;
+}
+
+static void itti_record_queue_wait(
+  task_id_t task_id,
+  task_desc_t* task,
+  const struct message_list_s* message)
+{
+  MessageHeader* header = &message->msg->ittiMsgHeader;
+  uint64_t now = itti_get_monotonic_time_us();
+  uint64_t wait = now > header->enqueueTime ? now - header->enqueueTime : 0;
+  queue_wait_stats_t* stats =
+    &task->wait_stats[itti_get_queue_level(message->message_priority)];
+  itti_latency_entry_t* entry = itti_get_latency_entry(
+    header->originTaskId, task_id, header->messageId);
+
+  header->dequeueTime = now;
+  if (entry != NULL) {
+    __sync_fetch_and_add(&entry->wait[itti_latency_bucket(wait)], 1);
+    itti_atomic_max(&entry->wait_max_us, wait);
+  }
+  task->handling_entry = entry;
+  task->handling_since_us = now;
+  task->handling_number = message->message_number;
+  task->handling_imsi = 0;
+  if (itti_desc.trace_sampling > 0) {
+    task->handling_imsi = itti_get_associated_imsi(message->msg);
+    if (itti_trace_imsi(task->handling_imsi)) {
+      OAILOG_INFO(
+        LOG_ITTI,
+        "ITTI trace IMSI " IMSI_64_FMT " message %lu %s from %s to %s "
+        "queued %lu us\n",
+        task->handling_imsi,
+        message->message_number,
+        itti_desc.messages_info[header->messageId].name,
+        itti_get_task_name(header->originTaskId),
+        itti_get_task_name(task_id),
+        wait);
+    }
+  }
+
+  __sync_fetch_and_add(&stats->wait_sum_us, wait);
+  __sync_fetch_and_add(&stats->messages, 1);
+  itti_atomic_max(&stats->wait_max_us, wait);
+}
+
 void itti_receive_msg(task_id_t task_id, MessageDef** received_msg)
 {
   thread_id_t thread_id;
@@ -507,6 +802,8 @@ void itti_receive_msg(task_id_t task_id, MessageDef** received_msg)
   thread_id = TASK_GET_THREAD_ID(task_id);
   *received_msg = NULL;
 
+  itti_record_handler_time(task_id, &itti_desc.tasks[task_id]);
+
   n_read = read(
     itti_desc.threads[thread_id].task_event_fd,
     &sem_counter,
@@ -518,9 +815,7 @@ void itti_receive_msg(task_id_t task_id, MessageDef** received_msg)
     n_read,
     sizeof(sem_counter));
 
-  if (
-    lfds710_queue_bmm_dequeue(
-      &itti_desc.tasks[task_id].message_queue, NULL, (void**) &message) == 0) {
+  if (!itti_dequeue_weighted(&itti_desc.tasks[task_id], &message)) {
     OAILOG_WARNING(
       LOG_ITTI,
       "No message in queue for task %d while there are %zu and some "
@@ -531,11 +826,161 @@ void itti_receive_msg(task_id_t task_id, MessageDef** received_msg)
 
   AssertFatal(message != NULL, "Message from message queue is NULL!\n");
 
+  itti_update_queue_depth(
+    task_id, itti_get_queue_level(message->message_priority), -1);
+  itti_record_queue_wait(task_id, &itti_desc.tasks[task_id], message);
   *received_msg = message->msg;
 
   itti_free(ITTI_MSG_ORIGIN_ID(message->msg), message);
 }
 
+uint32_t itti_get_queue_size(task_id_t task_id)
+{
+  AssertFatal(
+    task_id < itti_desc.task_max,
+    "Task id (%d) is out of range (%d)!\n",
+    task_id,
+    itti_desc.task_max);
+  return itti_desc.tasks_info[task_id].queue_size;
+}
+
+uint32_t itti_get_queue_fullest_level_depth(task_id_t task_id)
+{
+  task_desc_t* task;
+  uint32_t fullest = 0;
+  int level;
+
+  AssertFatal(
+    task_id < itti_desc.task_max,
+    "Task id (%d) is out of range (%d)!\n",
+    task_id,
+    itti_desc.task_max);
+  task = &itti_desc.tasks[task_id];
+  for (level = 0; level < ITTI_QUEUE_LEVELS; level++) {
+    uint32_t depth = __sync_fetch_and_add(&task->level_depth[level], 0);
+    if (depth > fullest) {
+      fullest = depth;
+    }
+  }
+  return fullest;
+}
+
+uint32_t itti_get_queue_depth(task_id_t task_id)
+{
+  AssertFatal(
+    task_id < itti_desc.task_max,
+    "Task id (%d) is out of range (%d)!\n",
+    task_id,
+    itti_desc.task_max);
+  return __sync_fetch_and_add(&itti_desc.tasks[task_id].queue_depth, 0);
+}
+
+uint32_t itti_get_queue_peak_depth(task_id_t task_id)
+{
+  task_desc_t* task;
+
+  AssertFatal(
+    task_id < itti_desc.task_max,
+    "Task id (%d) is out of range (%d)!\n",
+    task_id,
+    itti_desc.task_max);
+  task = &itti_desc.tasks[task_id];
+  /*
+   * Reset the watermark to the current depth so that the next read reports
+   * the peak of the following interval only
+   */
+  return __sync_lock_test_and_set(
+    &task->peak_depth, __sync_fetch_and_add(&task->queue_depth, 0));
+}
+
+void itti_get_queue_wait_stats(
+  task_id_t task_id,
+  itti_queue_level_t level,
+  uint64_t* avg_wait_us,
+  uint64_t* max_wait_us)
+{
+  queue_wait_stats_t* stats;
+  uint64_t messages;
+  uint64_t wait_sum_us;
+
+  AssertFatal(
+    task_id < itti_desc.task_max,
+    "Task id (%d) is out of range (%d)!\n",
+    task_id,
+    itti_desc.task_max);
+  AssertFatal(level < ITTI_QUEUE_LEVELS, "Bad queue level %d\n", level);
+  stats = &itti_desc.tasks[task_id].wait_stats[level];
+
+  /*
+   * A message received while the counters are being swapped may land in
+   * the sum of one interval and the count of the next, which only skews
+   * the average slightly.
+   */
+  messages = __sync_lock_test_and_set(&stats->messages, 0);
+  wait_sum_us = __sync_lock_test_and_set(&stats->wait_sum_us, 0);
+  *avg_wait_us = messages ? wait_sum_us / messages : 0;
+  *max_wait_us = __sync_lock_test_and_set(&stats->wait_max_us, 0);
+}
+
+void itti_set_trace_sampling(uint32_t one_in_n_imsi)
+{
+  itti_desc.trace_sampling = one_in_n_imsi;
+}
+
+void itti_latency_stats_apply(itti_latency_stats_cb_t callback, void* arg)
+{
+  itti_latency_stats_t stats;
+  int slot;
+  int bucket;
+
+  if (itti_desc.latency_table == NULL) {
+    return;
+  }
+  for (slot = 0; slot < ITTI_LATENCY_TABLE_SIZE; slot++) {
+    itti_latency_entry_t* entry = &itti_desc.latency_table[slot];
+    uint32_t key = entry->key;
+    bool seen = false;
+
+    if (key == 0) {
+      continue;
+    }
+    memset(&stats, 0, sizeof(stats));
+    stats.origin_task_id = (task_id_t)(key >> 24);
+    stats.destination_task_id = (task_id_t)((key >> 16) & 0xff);
+    stats.message_id = (MessagesIds)((key & 0xffff) - 1);
+    /*
+     * Drain the buckets so that each call reports the interval since the
+     * previous one
+     */
+    for (bucket = 0; bucket < ITTI_LATENCY_BUCKETS; bucket++) {
+      stats.wait[bucket] = __sync_lock_test_and_set(&entry->wait[bucket], 0);
+      stats.handler[bucket] =
+        __sync_lock_test_and_set(&entry->handler[bucket], 0);
+      seen = seen || stats.wait[bucket] || stats.handler[bucket];
+    }
+    stats.wait_max_us = __sync_lock_test_and_set(&entry->wait_max_us, 0);
+    stats.handler_max_us = __sync_lock_test_and_set(&entry->handler_max_us, 0);
+    /*
+     * Report a triple once more after it goes idle so that the values of
+     * its last busy interval are cleared rather than exported forever
+     */
+    if (seen || entry->reported) {
+      callback(&stats, arg);
+    }
+    entry->reported = seen;
+  }
+}
+
+uint64_t itti_get_queue_overflows(task_id_t task_id)
+{
+  AssertFatal(
+    task_id < itti_desc.task_max,
+    "Task id (%d) is out of range (%d)!\n",
+    task_id,
+    itti_desc.task_max);
+  return __sync_fetch_and_add(&itti_desc.tasks[task_id].overflows, 0);
+}
+
 int itti_create_task(
   task_id_t task_id,
   void* (*start_routine)(void*),
@@ -626,6 +1071,7 @@ int itti_init(
 {
   task_id_t task_id;
   thread_id_t thread_id;
+  int level;
 
   itti_desc.message_number = 1;
   ITTI_DEBUG(
@@ -651,6 +1097,8 @@ int itti_init(
     LFDS710_PAL_ATOMIC_ISOLATION_IN_BYTES,
     itti_desc.task_max * sizeof(task_desc_t));
   memset(itti_desc.tasks, 0, itti_desc.task_max * sizeof(task_desc_t));
+  itti_desc.latency_table =
+    calloc(ITTI_LATENCY_TABLE_SIZE, sizeof(itti_latency_entry_t));
   /*
    * Allocates memory for threads info
    */
@@ -679,14 +1127,18 @@ int itti_init(
       " Creating queue of message of size %u\n",
       itti_desc.tasks_info[task_id].queue_size);
 
-    itti_desc.tasks[task_id].qbmme = calloc(
-      itti_desc.tasks_info[task_id].queue_size,
-      sizeof(struct lfds710_queue_bmm_element));
-    lfds710_queue_bmm_init_valid_on_current_logical_core(
-      &itti_desc.tasks[task_id].message_queue,
-      itti_desc.tasks[task_id].qbmme,
-      itti_desc.tasks_info[task_id].queue_size,
-      NULL);
+    for (level = 0; level < ITTI_QUEUE_LEVELS; level++) {
+      itti_desc.tasks[task_id].qbmme[level] = calloc(
+        itti_desc.tasks_info[task_id].queue_size,
+        sizeof(struct lfds710_queue_bmm_element));
+      lfds710_queue_bmm_init_valid_on_current_logical_core(
+        &itti_desc.tasks[task_id].message_queue[level],
+        itti_desc.tasks[task_id].qbmme[level],
+        itti_desc.tasks_info[task_id].queue_size,
+        NULL);
+      itti_desc.tasks[task_id].level_credits[level] =
+        itti_queue_level_weights[level];
+    }
   }
 
   /*
@@ -755,6 +1207,7 @@ void itti_wait_tasks_end(void)
   int end = 0;
   int thread_id;
   task_id_t task_id;
+  int level;
   int ready_tasks;
   int result;
   int retries = 10;
@@ -824,8 +1277,11 @@ void itti_wait_tasks_end(void)
   }
 
   for (task_id = TASK_FIRST; task_id < itti_desc.task_max; task_id++) {
-    free_wrapper((void**) &itti_desc.tasks[task_id].qbmme);
+    for (level = 0; level < ITTI_QUEUE_LEVELS; level++) {
+      free_wrapper((void**) &itti_desc.tasks[task_id].qbmme[level]);
+    }
   }
+  free_wrapper((void**) &itti_desc.latency_table);
 
   free_wrapper((void**) &itti_desc.tasks);
   free_wrapper((void**) &itti_desc.threads);
@@ -73,6 +73,37 @@ typedef enum message_priorities_e {
   MESSAGE_PRIORITY_MIN = 10,
 } message_priorities_t;
 
+/* Task queues are split in levels; a message goes to the level of its
+ * MESSAGE_DEF priority: MED_PLUS and above, MED_LEAST and above, the rest.
+ * Order is only kept within a level, so messages of one UE procedure must
+ * share a level or a later one can be handled before an earlier one. */
+typedef enum itti_queue_level_e {
+  ITTI_QUEUE_LEVEL_HIGH = 0,
+  ITTI_QUEUE_LEVEL_MED,
+  ITTI_QUEUE_LEVEL_LOW,
+  ITTI_QUEUE_LEVELS,
+} itti_queue_level_t;
+
+/* Log2 microsecond buckets of the ITTI latency histograms: bucket 0 is
+ * below 1us, bucket i is [2^(i-1), 2^i) us and the last one is open ended */
+#define ITTI_LATENCY_BUCKETS 22
+
+/* Queue-wait and handler time histograms of one (origin, destination,
+ * message id) triple over an export interval */
+typedef struct itti_latency_stats_s {
+  task_id_t origin_task_id;
+  task_id_t destination_task_id;
+  MessagesIds message_id;
+  uint64_t wait[ITTI_LATENCY_BUCKETS];
+  uint64_t handler[ITTI_LATENCY_BUCKETS];
+  uint64_t wait_max_us;
+  uint64_t handler_max_us;
+} itti_latency_stats_t;
+
+typedef void (*itti_latency_stats_cb_t)(
+  const itti_latency_stats_t *stats,
+  void *arg);
+
 typedef struct message_info_s {
   task_id_t id;
   message_priorities_t priority;
@@ -119,6 +150,66 @@ int itti_send_msg_to_task(
  **/
 void itti_receive_msg(task_id_t task_id, MessageDef **received_msg);
 
+/** \brief Return how many messages each priority level queue of a task
+ * holds. A message is dropped once its own level is full, whatever the
+ * occupancy of the other levels.
+ \param task_id Task ID
+ **/
+uint32_t itti_get_queue_size(task_id_t task_id);
+
+/** \brief Return the number of messages queued in the fullest priority
+ * level of a task, to compare against itti_get_queue_size()
+ \param task_id Task ID
+ **/
+uint32_t itti_get_queue_fullest_level_depth(task_id_t task_id);
+
+/** \brief Return the number of messages currently queued for a task
+ \param task_id Task ID
+ **/
+uint32_t itti_get_queue_depth(task_id_t task_id);
+
+/** \brief Return the highest queue depth seen for a task since the previous
+ * call, and restart the measurement from the current depth.
+ \param task_id Task ID
+ **/
+uint32_t itti_get_queue_peak_depth(task_id_t task_id);
+
+/** \brief Return the average and maximum time messages of a priority level
+ * spent queued for a task since the previous call, and reset them.
+ \param task_id Task ID
+ \param level Priority level
+ \param avg_wait_us Average queue wait in microseconds
+ \param max_wait_us Maximum queue wait in microseconds
+ **/
+void itti_get_queue_wait_stats(
+  task_id_t task_id,
+  itti_queue_level_t level,
+  uint64_t *avg_wait_us,
+  uint64_t *max_wait_us);
+
+/** \brief Call callback with the latency histograms of every (origin,
+ * destination, message id) triple seen since the previous call, and reset
+ * them.
+ \param callback Called once per triple with samples in the interval, and
+ * once with empty histograms for a triple which had samples in the previous
+ * interval only
+ \param arg Opaque argument passed to callback
+ **/
+void itti_latency_stats_apply(itti_latency_stats_cb_t callback, void *arg);
+
+/** \brief Log the queue wait and handler time of every hop of the messages
+ * associated to one IMSI out of one_in_n_imsi, so that the path of a slow
+ * procedure can be followed per IMSI. 0 disables tracing.
+ \param one_in_n_imsi Sampling ratio over IMSIs
+ **/
+void itti_set_trace_sampling(uint32_t one_in_n_imsi);
+
+/** \brief Return the number of messages rejected because the queue of a task
+ * was full.
+ \param task_id Task ID
+ **/
+uint64_t itti_get_queue_overflows(task_id_t task_id);
+
 /** \brief Start thread associated to the task
  * \param task_id task to start
  * \param start_routine entry point for the task
@@ -137,6 +137,8 @@ typedef struct MessageHeader_s {
   task_id_t destinationTaskId; /**< ID of the destination task */
   instance_t instance;         /**< Task instance for virtualization */
   imsi64_t imsi;               /** IMSI associated to sender task */
+  uint64_t enqueueTime; /**< Monotonic time (us) the message was queued */
+  uint64_t dequeueTime; /**< Monotonic time (us) the message was received */
 
   MessageHeaderSize
     ittiMsgSize; /**< Message size (not including header size) */
@@ -0,0 +1,231 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * S1AP encode/decode micro-benchmark.
+ *
+ * Decodes a set of S1AP PDUs in a tight loop and re-encodes the NAS payload
+ * of each uplink message as a DownlinkNASTransport, reporting the average
+ * cost per PDU. The built-in seeds cover the per-UE hot path; extra PDUs can
+ * be passed as files, e.g. the oai_fuzz s1ap corpus:
+ *
+ *   s1ap_codec_bench 100000 ~/fuzz/input/id:000000 ...
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bstrlib.h"
+#include "common_defs.h"
+#include "dynamic_memory_check.h"
+#include "intertask_interface.h"
+#include "log.h"
+#include "mme_config.h"
+#include "shared_ts_log.h"
+#include "s1ap_common.h"
+#include "s1ap_ies_defs.h"
+#include "s1ap_mme_decoder.h"
+#include "s1ap_mme_encoder.h"
+
+#define BENCH_DEFAULT_ITERATIONS 100000
+#define BENCH_MAX_PDU_SIZE 4096
+
+// minus one from all string sizeof's due to trailing null byte
+#define STATIC_BUF_LEN(buf) (sizeof(buf) - 1)
+
+typedef struct bench_seed_s {
+  const char *name;
+  bstring pdu;
+} bench_seed_t;
+
+// InitialUEMessage carrying an Attach Request, same layout as fuzz_s1ap.c
+static const char initial_ue_message[] =
+  "\x00\x0c\x40\x3c\x00\x00\x05\x00\x08\x00\x02\x00\x01\x00\x1a\x00\x14\x13"
+  "\x07\x41\x72\x0b\xf6\x00\xf1\x10\x00\x01\x02\x00\x00\x00\x01\x02\x00\xe0"
+  "\xe0\x00\x43\x00\x06\x00\x00\xf1\x10\x00\x01\x00\x64\x40\x08\x00\x00\xf1"
+  "\x10\x00\x00\x00\xa0\x00\x86\x40\x01\x30";
+
+static const char uplink_nas_transport[] =
+  "\x00\x0d\x40\x3d\x00\x00\x05\x00\x00\x00\x02\x00\x01\x00\x08\x00\x02\x00"
+  "\x01\x00\x1a\x00\x14\x13\x07\x41\x72\x0b\xf6\x00\xf1\x10\x00\x01\x02\x00"
+  "\x00\x00\x01\x02\x00\xe0\xe0\x00\x64\x40\x08\x00\x00\xf1\x10\x00\x00\x00"
+  "\xa0\x00\x43\x40\x06\x00\x00\xf1\x10\x00\x01";
+
+// One E-RAB set up on 192.168.60.141, TEID 1
+static const char initial_context_setup_response[] =
+  "\x20\x09\x00\x22\x00\x00\x03\x00\x00\x40\x02\x00\x01\x00\x08\x40\x02\x00"
+  "\x01\x00\x33\x40\x0f\x00\x00\x32\x40\x0a\x0a\x1f\xc0\xa8\x3c\x8d\x00\x00"
+  "\x00\x01";
+
+static uint64_t bench_now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+static bstring bench_read_file(const char *path)
+{
+  char buf[BENCH_MAX_PDU_SIZE];
+  FILE *fp;
+  size_t n_read;
+
+  fp = fopen(path, "rb");
+  if (fp == NULL) {
+    return NULL;
+  }
+  n_read = fread(buf, 1, sizeof(buf), fp);
+  fclose(fp);
+
+  return blk2bstr(buf, n_read);
+}
+
+/*
+ * Encode a DownlinkNASTransport echoing the NAS PDU of a decoded uplink
+ * message, which exercises the same encoder path as
+ * s1ap_generate_downlink_nas_transport.
+ */
+static int bench_encode_downlink(const S1ap_NAS_PDU_t *nas_pdu)
+{
+  s1ap_message message = {0};
+  S1ap_DownlinkNASTransportIEs_t *downlinkNasTransport;
+  uint8_t *buffer_p = NULL;
+  uint32_t length = 0;
+  int rc;
+
+  message.procedureCode = S1ap_ProcedureCode_id_downlinkNASTransport;
+  message.direction = S1AP_PDU_PR_initiatingMessage;
+  downlinkNasTransport = &message.msg.s1ap_DownlinkNASTransportIEs;
+  downlinkNasTransport->mme_ue_s1ap_id = 1;
+  downlinkNasTransport->eNB_UE_S1AP_ID = 1;
+  OCTET_STRING_fromBuf(
+    &downlinkNasTransport->nas_pdu, (char *) nas_pdu->buf, nas_pdu->size);
+
+  rc = s1ap_mme_encode_pdu(&message, &buffer_p, &length);
+  free(buffer_p);
+  free_s1ap_downlinknastransport(downlinkNasTransport);
+  return rc;
+}
+
+static int bench_run_seed(const bench_seed_t *seed, int iterations)
+{
+  s1ap_message message;
+  MessagesIds message_id;
+  const S1ap_NAS_PDU_t *nas_pdu;
+  uint64_t decode_ns = 0;
+  uint64_t encode_ns = 0;
+  uint64_t start;
+  int encoded = 0;
+  int i;
+
+  for (i = 0; i < iterations; i++) {
+    memset(&message, 0, sizeof(message));
+    message_id = MESSAGES_ID_MAX;
+
+    start = bench_now_ns();
+    if (s1ap_mme_decode_pdu(&message, seed->pdu, &message_id) < 0) {
+      printf("%-40s decode failed, skipping\n", seed->name);
+      return -1;
+    }
+    decode_ns += bench_now_ns() - start;
+
+    nas_pdu = NULL;
+    if (message_id == S1AP_INITIAL_UE_MESSAGE_LOG) {
+      nas_pdu = &message.msg.s1ap_InitialUEMessageIEs.nas_pdu;
+    } else if (message_id == S1AP_UPLINK_NAS_LOG) {
+      nas_pdu = &message.msg.s1ap_UplinkNASTransportIEs.nas_pdu;
+    }
+    if (nas_pdu != NULL) {
+      start = bench_now_ns();
+      if (bench_encode_downlink(nas_pdu) == 0) {
+        encoded++;
+      }
+      encode_ns += bench_now_ns() - start;
+    }
+
+    start = bench_now_ns();
+    s1ap_free_mme_decode_pdu(&message, message_id);
+    decode_ns += bench_now_ns() - start;
+  }
+
+  printf(
+    "%-40s %6d bytes  decode %8.1f ns/pdu  encode %8.1f ns/pdu\n",
+    seed->name,
+    blength(seed->pdu),
+    (double) decode_ns / iterations,
+    encoded ? (double) encode_ns / encoded : 0.0);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  bench_seed_t seeds[3 + argc];
+  int n_seeds = 0;
+  int iterations = BENCH_DEFAULT_ITERATIONS;
+  int i;
+
+  if (argc > 1) {
+    iterations = atoi(argv[1]);
+    if (iterations <= 0) {
+      printf("Usage: %s [iterations] [s1ap corpus files...]\n", argv[0]);
+      return -1;
+    }
+  }
+
+  if (
+    OAILOG_INIT(
+      MME_CONFIG_STRING_MME_CONFIG, OAILOG_LEVEL_ERROR, MAX_LOG_PROTOS) !=
+    RETURNok)
+    return -1;
+  if (shared_log_init(MAX_LOG_PROTOS) != RETURNok) return -1;
+
+  seeds[n_seeds].name = "InitialUEMessage";
+  seeds[n_seeds++].pdu = blk2bstr(
+    initial_ue_message, STATIC_BUF_LEN(initial_ue_message));
+  seeds[n_seeds].name = "UplinkNASTransport";
+  seeds[n_seeds++].pdu = blk2bstr(
+    uplink_nas_transport, STATIC_BUF_LEN(uplink_nas_transport));
+  seeds[n_seeds].name = "InitialContextSetupResponse";
+  seeds[n_seeds++].pdu = blk2bstr(
+    initial_context_setup_response,
+    STATIC_BUF_LEN(initial_context_setup_response));
+
+  for (i = 2; i < argc; i++) {
+    bstring pdu = bench_read_file(argv[i]);
+    if (pdu == NULL) {
+      printf("Could not read %s\n", argv[i]);
+      continue;
+    }
+    seeds[n_seeds].name = argv[i];
+    seeds[n_seeds++].pdu = pdu;
+  }
+
+  for (i = 0; i < n_seeds; i++) {
+    bench_run_seed(&seeds[i], iterations);
+    bdestroy_wrapper(&seeds[i].pdu);
+  }
+
+  return 0;
+}
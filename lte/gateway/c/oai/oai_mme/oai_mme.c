@@ -93,6 +93,7 @@ int main(int argc, char *argv[])
    */
   // Intialize loggers and configured log levels.
   OAILOG_LOG_CONFIGURE(&mme_config.log_config);
+  itti_set_trace_sampling(mme_config.itti_config.trace_sampling);
   CHECK_INIT_RETURN(service303_init(&(mme_config.service303_config)));
 
   // Service started, but not healthy yet
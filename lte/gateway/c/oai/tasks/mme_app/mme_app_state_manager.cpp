@@ -76,6 +76,7 @@ int MmeNasStateManager::initialize_state(const mme_config_t* mme_config_p) {
 
   int rc = read_state_from_db();
   read_ue_state_from_db();
+  enable_sharded_writes(mme_config_p->state_write_workers);
   is_initialized = true;
   return rc;
 }
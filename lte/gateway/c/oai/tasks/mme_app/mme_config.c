@@ -183,6 +183,7 @@ void s6a_config_init(s6a_config_t *s6a_conf)
 void itti_config_init(itti_config_t *itti_conf)
 {
   itti_conf->queue_size = ITTI_QUEUE_MAX_ELEMENTS;
+  itti_conf->trace_sampling = 0;
   itti_conf->log_file = NULL;
 }
 
@@ -254,6 +255,8 @@ void mme_config_init(mme_config_t *config)
   config->unauthenticated_imsi_supported = 0;
   config->relative_capacity = RELATIVE_CAPACITY;
   config->mme_statistic_timer = MME_STATISTIC_TIMER_S;
+  config->overload_high_watermark = MME_OVERLOAD_HIGH_WATERMARK_PERCENT;
+  config->overload_low_watermark = MME_OVERLOAD_LOW_WATERMARK_PERCENT;
 
   log_config_init(&config->log_config);
   eps_network_feature_config_init(&config->eps_network_feature_support);
@@ -521,6 +524,22 @@ int mme_config_parse_file(mme_config_t *config_pP)
       config_pP->mme_statistic_timer = (uint32_t) aint;
     }
 
+    if ((config_setting_lookup_int(
+          setting_mme, MME_CONFIG_STRING_OVERLOAD_HIGH_WATERMARK, &aint))) {
+      config_pP->overload_high_watermark = (uint8_t) aint;
+    }
+
+    if ((config_setting_lookup_int(
+          setting_mme, MME_CONFIG_STRING_OVERLOAD_LOW_WATERMARK, &aint))) {
+      config_pP->overload_low_watermark = (uint8_t) aint;
+    }
+    AssertFatal(
+      config_pP->overload_low_watermark < config_pP->overload_high_watermark &&
+        config_pP->overload_high_watermark <= 100,
+      "Bad overload watermarks (low %u, high %u)\n",
+      config_pP->overload_low_watermark,
+      config_pP->overload_high_watermark);
+
     if ((config_setting_lookup_string(
           setting_mme,
           MME_CONFIG_STRING_IP_CAPABILITY,
@@ -535,6 +554,11 @@ int mme_config_parse_file(mme_config_t *config_pP)
       config_pP->use_stateless = parse_bool(astring);
     }
 
+    if ((config_setting_lookup_int(
+          setting_mme, MME_CONFIG_STRING_STATE_WRITE_WORKERS, &aint))) {
+      config_pP->state_write_workers = (uint32_t) aint;
+    }
+
     if ((config_setting_lookup_string(
           setting_mme,
           EPS_NETWORK_FEATURE_SUPPORT_EMERGENCY_BEARER_SERVICES_IN_S1_MODE,
@@ -582,6 +606,12 @@ int mme_config_parse_file(mme_config_t *config_pP)
             &aint))) {
         config_pP->itti_config.queue_size = (uint32_t) aint;
       }
+      if ((config_setting_lookup_int(
+            setting,
+            MME_CONFIG_STRING_INTERTASK_INTERFACE_TRACE_SAMPLING,
+            &aint))) {
+        config_pP->itti_config.trace_sampling = (uint32_t) aint;
+      }
     }
     // S6A SETTING
     setting =
@@ -1318,16 +1348,25 @@ void mme_config_display(mme_config_t *config_pP)
     config_pP->relative_capacity);
   OAILOG_INFO(
     LOG_CONFIG,
-    "- Statistics timer .....................: %u (seconds)\n\n",
+    "- Statistics timer .....................: %u (seconds)\n",
     config_pP->mme_statistic_timer);
+  OAILOG_INFO(
+    LOG_CONFIG,
+    "- Overload watermarks ..................: high %u%% low %u%%\n\n",
+    config_pP->overload_high_watermark,
+    config_pP->overload_low_watermark);
   OAILOG_INFO(
     LOG_CONFIG,
     "- IP Capability ........................: %s\n\n",
     bdata(config_pP->ip_capability));
   OAILOG_INFO(
     LOG_CONFIG,
-    "- Use Stateless ........................: %s\n\n",
+    "- Use Stateless ........................: %s\n",
     config_pP->use_stateless ? "true" : "false");
+  OAILOG_INFO(
+    LOG_CONFIG,
+    "- State write workers ..................: %u\n\n",
+    config_pP->state_write_workers);
   OAILOG_INFO(LOG_CONFIG, "- CSFB:\n");
   OAILOG_INFO(
     LOG_CONFIG,
@@ -1362,6 +1401,10 @@ void mme_config_display(mme_config_t *config_pP)
     LOG_CONFIG,
     "    queue size .......: %u (bytes)\n",
     config_pP->itti_config.queue_size);
+  OAILOG_INFO(
+    LOG_CONFIG,
+    "    trace sampling ...: 1/%u IMSI\n",
+    config_pP->itti_config.trace_sampling);
   OAILOG_INFO(
     LOG_CONFIG,
     "    log file .........: %s\n",
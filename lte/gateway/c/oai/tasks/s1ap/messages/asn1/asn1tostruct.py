@@ -40,6 +40,14 @@ choicelist = {}
 choiceiesDefs = {}
 outdir = './'
 
+# Messages on the per-UE hot path. Their container and plain IEs are decoded
+# straight into the caller's IE struct instead of through a heap copy.
+directDecodeList = [
+    "S1ap_UplinkNASTransport",
+    "S1ap_InitialUEMessage",
+    "S1ap_InitialContextSetupResponse",
+]
+
 filenames = []
 verbosity = 0
 prefix = ""
@@ -388,7 +396,7 @@ f.write("#endif /* %s_IES_DEFS_H_ */\n\n" % (fileprefix.upper()))
 #Generate Decode functions
 f = open(outdir + fileprefix + '_decoder.c', 'w')
 outputHeaderToFile(f, filename)
-f.write("#include \"%s_common.h\"\n#include \"%s_ies_defs.h\"\n#include \"log.h\"\n\n" % (fileprefix, fileprefix))
+f.write("#include \"%s_common.h\"\n#include \"%s_ies_defs.h\"\n#include \"per_decoder.h\"\n#include \"log.h\"\n\n" % (fileprefix, fileprefix))
 for key in iesDefs:
     if key in ieofielist.values():
         continue
@@ -414,8 +422,12 @@ for key in iesDefs:
     f.write("    ANY_t *any_p) {\n\n")
 
     f.write("    %s_t  %s;\n    %s_t *%s_p = &%s;\n" % (asn1cStruct, asn1cStructfirstlower, asn1cStruct, asn1cStructfirstlower, asn1cStructfirstlower))
+    directDecode = asn1cStruct in directDecodeList
+    nestedIes = [ie for ie in iesDefs[key]["ies"] if ie[2] in (list(ieofielist.keys()) + list(choicelist.keys()))]
     f.write("    int i, decoded = 0;\n")
-    if len(iesDefs[key]["ies"]) != 0:
+    if directDecode:
+        f.write("    asn_dec_rval_t dec_ret;\n")
+    if len(iesDefs[key]["ies"]) != 0 and (not directDecode or len(nestedIes) != 0):
         f.write("    int tempDecoded = 0;\n")
 
     f.write("    assert(any_p != NULL);\n")
@@ -424,7 +436,16 @@ for key in iesDefs:
         f.write("    memset(%s, 0, sizeof(%s_t));\n" % (lowerFirstCamelWord(re.sub('-', '_', key)), prefix + re.sub('-', '_', key)))
 
     f.write("   OAILOG_DEBUG (LOG_%s, \"Decoding message %s (%%s:%%d)\\n\", __FILE__, __LINE__);\n\n" % (fileprefix.upper(), re.sub('-', '_', keyName)))
-    f.write("    ANY_to_type_aper(any_p, &asn_DEF_%s, (void**)&%s_p);\n\n" % (asn1cStruct, asn1cStructfirstlower))
+    if directDecode:
+        f.write("    memset(%s_p, 0, sizeof(%s_t));\n" % (asn1cStructfirstlower, asn1cStruct))
+        f.write("    dec_ret = aper_decode(NULL, &asn_DEF_%s, (void**)&%s_p, any_p->buf, any_p->size, 0, 0);\n" % (asn1cStruct, asn1cStructfirstlower))
+        f.write("    if (dec_ret.code != RC_OK) {\n")
+        f.write("       OAILOG_ERROR (LOG_%s, \"Decoding of message %s failed\\n\");\n" % (fileprefix.upper(), asn1cStruct))
+        f.write("        ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_%s, %s_p);\n" % (asn1cStruct, asn1cStructfirstlower))
+        f.write("        return -1;\n")
+        f.write("    }\n\n")
+    else:
+        f.write("    ANY_to_type_aper(any_p, &asn_DEF_%s, (void**)&%s_p);\n\n" % (asn1cStruct, asn1cStructfirstlower))
     f.write("    for (i = 0; i < %s_p->%slist.count; i++) {\n" % (asn1cStructfirstlower, iesaccess))
     f.write("        %s_IE_t *ie_p;\n" % (fileprefix[0].upper() + fileprefix[1:]))
     f.write("        ie_p = %s_p->%slist.array[i];\n" % (asn1cStructfirstlower, iesaccess))
@@ -443,6 +464,24 @@ for key in iesDefs:
             f.write("            /* Conditional field */\n")
         f.write("            case %s_ProtocolIE_ID_%s:\n" % (fileprefix_first_upper, re.sub('-', '_', ie[0])))
         f.write("            {\n")
+        if directDecode and ie[2] not in (list(ieofielist.keys()) + list(choicelist.keys())):
+            # Decode in place: aper_decode fills the pre-allocated member.
+            f.write("                %s_t *%s_p = &%s->%s;\n" % (ietypeunderscore, lowerFirstCamelWord(ietypesubst), lowerFirstCamelWord(re.sub('-', '_', key)), ienameunderscore))
+            if ie[3] != "mandatory":
+                f.write("                %s->presenceMask |= %s_%s_PRESENT;\n" % (lowerFirstCamelWord(re.sub('-', '_', key)), keyupperunderscore, ieupperunderscore))
+            f.write("                dec_ret = aper_decode(NULL, &asn_DEF_%s, (void**)&%s_p, ie_p->value.buf, ie_p->value.size, 0, 0);\n" % (ietypeunderscore, lowerFirstCamelWord(ietypesubst)))
+            f.write("                if (dec_ret.code != RC_OK) {\n")
+            f.write("                   OAILOG_ERROR (LOG_%s, \"Decoding of IE %s failed\\n\");\n" % (fileprefix.upper(), ienameunderscore))
+            f.write("                    ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_%s, %s_p);\n" % (ietypeunderscore, lowerFirstCamelWord(ietypesubst)))
+            f.write("                    memset(%s_p, 0, sizeof(%s_t));\n" % (lowerFirstCamelWord(ietypesubst), ietypeunderscore))
+            f.write("                    ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_%s, %s_p);\n" % (asn1cStruct, asn1cStructfirstlower))
+            f.write("                    return -1;\n")
+            f.write("                }\n")
+            f.write("                decoded += dec_ret.consumed;\n")
+            f.write("                if (asn1_xer_print)\n")
+            f.write("                    xer_fprint(stdout, &asn_DEF_%s, %s_p);\n" % (ietypeunderscore, lowerFirstCamelWord(ietypesubst)))
+            f.write("            } break;\n")
+            continue
         f.write("                %s_t *%s_p = NULL;\n" % (ietypeunderscore, lowerFirstCamelWord(ietypesubst)))
         if ie[3] != "mandatory":
             f.write("                %s->presenceMask |= %s_%s_PRESENT;\n" % (lowerFirstCamelWord(re.sub('-', '_', key)), keyupperunderscore, ieupperunderscore))
@@ -478,7 +517,10 @@ for key in iesDefs:
     f.write("               OAILOG_ERROR (LOG_%s, \"Unknown protocol IE id (%%d) for message %s\\n\", (int)ie_p->id);\n" % (fileprefix.upper(), re.sub('-', '_', structName.lower())))
     f.write("        }\n")
     f.write("    }\n")
-    f.write("    ASN_STRUCT_FREE(asn_DEF_%s, %s_p);\n" % (asn1cStruct, asn1cStructfirstlower))
+    if directDecode:
+        f.write("    ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_%s, %s_p);\n" % (asn1cStruct, asn1cStructfirstlower))
+    else:
+        f.write("    ASN_STRUCT_FREE(asn_DEF_%s, %s_p);\n" % (asn1cStruct, asn1cStructfirstlower))
     f.write("    return decoded;\n")
     f.write("}\n\n")
 
@@ -137,6 +137,8 @@ void* s1ap_mme_thread(__attribute__((unused)) void* args)
     state = get_s1ap_state(false);
     AssertFatal(state != NULL, "failed to retrieve s1ap state (was null)");
 
+    s1ap_mme_update_overload_state(state);
+
     switch (ITTI_MSG_ID(received_message_p)) {
       case ACTIVATE_MESSAGE: {
         hss_associated = true;
@@ -110,6 +110,21 @@ static inline int s1ap_mme_encode_pathswitchreqack(
   uint8_t **buffer,
   uint32_t *length);
 
+static inline int s1ap_mme_encode_overload_start(
+  s1ap_message *message_p,
+  uint8_t **buffer,
+  uint32_t *length);
+
+static inline int s1ap_mme_encode_overload_stop(
+  s1ap_message *message_p,
+  uint8_t **buffer,
+  uint32_t *length);
+
+static inline int s1ap_mme_encode_error_indication(
+  s1ap_message *message_p,
+  uint8_t **buffer,
+  uint32_t *length);
+
 static inline int s1ap_mme_encode_pathswitchreqfailure(
   s1ap_message *message_p,
   uint8_t **buffer,
@@ -209,6 +224,15 @@ static inline int s1ap_mme_encode_initiating(
       return s1ap_mme_encode_mme_configuration_transfer(
         message_p, buffer, length);
 
+    case S1ap_ProcedureCode_id_OverloadStart:
+      return s1ap_mme_encode_overload_start(message_p, buffer, length);
+
+    case S1ap_ProcedureCode_id_OverloadStop:
+      return s1ap_mme_encode_overload_stop(message_p, buffer, length);
+
+    case S1ap_ProcedureCode_id_ErrorIndication:
+      return s1ap_mme_encode_error_indication(message_p, buffer, length);
+
     default:
       OAILOG_DEBUG(
         LOG_S1AP,
@@ -486,6 +510,75 @@ static inline int s1ap_mme_encode_paging(
     paging_p);
 }
 
+//------------------------------------------------------------------------------
+static inline int s1ap_mme_encode_overload_start(
+  s1ap_message *message_p,
+  uint8_t **buffer,
+  uint32_t *length)
+{
+  S1ap_OverloadStart_t overload_start;
+  S1ap_OverloadStart_t *overload_start_p = &overload_start;
+  memset(overload_start_p, 0, sizeof(S1ap_OverloadStart_t));
+  if (
+    s1ap_encode_s1ap_overloadstarties(
+      overload_start_p, &message_p->msg.s1ap_OverloadStartIEs) < 0) {
+    return -1;
+  }
+  return s1ap_generate_initiating_message(
+    buffer,
+    length,
+    S1ap_ProcedureCode_id_OverloadStart,
+    S1ap_Criticality_ignore,
+    &asn_DEF_S1ap_OverloadStart,
+    overload_start_p);
+}
+
+//------------------------------------------------------------------------------
+static inline int s1ap_mme_encode_overload_stop(
+  s1ap_message *message_p,
+  uint8_t **buffer,
+  uint32_t *length)
+{
+  S1ap_OverloadStop_t overload_stop;
+  S1ap_OverloadStop_t *overload_stop_p = &overload_stop;
+  memset(overload_stop_p, 0, sizeof(S1ap_OverloadStop_t));
+  if (
+    s1ap_encode_s1ap_overloadstopies(
+      overload_stop_p, &message_p->msg.s1ap_OverloadStopIEs) < 0) {
+    return -1;
+  }
+  return s1ap_generate_initiating_message(
+    buffer,
+    length,
+    S1ap_ProcedureCode_id_OverloadStop,
+    S1ap_Criticality_reject,
+    &asn_DEF_S1ap_OverloadStop,
+    overload_stop_p);
+}
+
+//------------------------------------------------------------------------------
+static inline int s1ap_mme_encode_error_indication(
+  s1ap_message *message_p,
+  uint8_t **buffer,
+  uint32_t *length)
+{
+  S1ap_ErrorIndication_t error_indication;
+  S1ap_ErrorIndication_t *error_indication_p = &error_indication;
+  memset(error_indication_p, 0, sizeof(S1ap_ErrorIndication_t));
+  if (
+    s1ap_encode_s1ap_errorindicationies(
+      error_indication_p, &message_p->msg.s1ap_ErrorIndicationIEs) < 0) {
+    return -1;
+  }
+  return s1ap_generate_initiating_message(
+    buffer,
+    length,
+    S1ap_ProcedureCode_id_ErrorIndication,
+    S1ap_Criticality_ignore,
+    &asn_DEF_S1ap_ErrorIndication,
+    error_indication_p);
+}
+
 //------------------------------------------------------------------------------
 static inline int s1ap_mme_encode_e_rab_setup(
   s1ap_message *message_p,
@@ -77,6 +77,8 @@
 #include "S1ap-MME-Code.h"
 #include "S1ap-MME-Group-ID.h"
 #include "S1ap-MME-UE-S1AP-ID.h"
+#include "S1ap-OverloadAction.h"
+#include "S1ap-OverloadResponse.h"
 #include "S1ap-PLMNidentity.h"
 #include "S1ap-ProcedureCode.h"
 #include "S1ap-ResetType.h"
@@ -298,6 +300,181 @@ int s1ap_mme_generate_s1_setup_failure(
   OAILOG_FUNC_RETURN(LOG_S1AP, rc);
 }
 
+//------------------------------------------------------------------------------
+int s1ap_mme_generate_overload_start(
+  const sctp_assoc_id_t assoc_id,
+  const long overload_action)
+{
+  uint8_t *buffer_p = 0;
+  uint32_t length = 0;
+  s1ap_message message = {0};
+  S1ap_OverloadStartIEs_t *overload_start_p = NULL;
+  int rc = RETURNok;
+
+  OAILOG_FUNC_IN(LOG_S1AP);
+  overload_start_p = &message.msg.s1ap_OverloadStartIEs;
+  message.procedureCode = S1ap_ProcedureCode_id_OverloadStart;
+  message.direction = S1AP_PDU_PR_initiatingMessage;
+  overload_start_p->overloadResponse.present =
+    S1ap_OverloadResponse_PR_overloadAction;
+  overload_start_p->overloadResponse.choice.overloadAction = overload_action;
+
+  if (s1ap_mme_encode_pdu(&message, &buffer_p, &length) < 0) {
+    OAILOG_ERROR(LOG_S1AP, "Failed to encode overload start\n");
+    free_s1ap_overloadstart(overload_start_p);
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+
+  bstring b = blk2bstr(buffer_p, length);
+  free(buffer_p);
+  rc = s1ap_mme_itti_send_sctp_request(&b, assoc_id, 0, INVALID_MME_UE_S1AP_ID);
+  free_s1ap_overloadstart(overload_start_p);
+  OAILOG_FUNC_RETURN(LOG_S1AP, rc);
+}
+
+//------------------------------------------------------------------------------
+int s1ap_mme_generate_overload_stop(const sctp_assoc_id_t assoc_id)
+{
+  uint8_t *buffer_p = 0;
+  uint32_t length = 0;
+  s1ap_message message = {0};
+  S1ap_OverloadStopIEs_t *overload_stop_p = NULL;
+  int rc = RETURNok;
+
+  OAILOG_FUNC_IN(LOG_S1AP);
+  overload_stop_p = &message.msg.s1ap_OverloadStopIEs;
+  message.procedureCode = S1ap_ProcedureCode_id_OverloadStop;
+  message.direction = S1AP_PDU_PR_initiatingMessage;
+
+  if (s1ap_mme_encode_pdu(&message, &buffer_p, &length) < 0) {
+    OAILOG_ERROR(LOG_S1AP, "Failed to encode overload stop\n");
+    free_s1ap_overloadstop(overload_stop_p);
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+
+  bstring b = blk2bstr(buffer_p, length);
+  free(buffer_p);
+  rc = s1ap_mme_itti_send_sctp_request(&b, assoc_id, 0, INVALID_MME_UE_S1AP_ID);
+  free_s1ap_overloadstop(overload_stop_p);
+  OAILOG_FUNC_RETURN(LOG_S1AP, rc);
+}
+
+//------------------------------------------------------------------------------
+int s1ap_mme_generate_overload_error_indication(
+  const sctp_assoc_id_t assoc_id,
+  const sctp_stream_id_t stream,
+  const enb_ue_s1ap_id_t enb_ue_s1ap_id)
+{
+  uint8_t *buffer_p = 0;
+  uint32_t length = 0;
+  s1ap_message message = {0};
+  S1ap_ErrorIndicationIEs_t *error_indication_p = NULL;
+  int rc = RETURNok;
+
+  OAILOG_FUNC_IN(LOG_S1AP);
+  error_indication_p = &message.msg.s1ap_ErrorIndicationIEs;
+  message.procedureCode = S1ap_ProcedureCode_id_ErrorIndication;
+  message.direction = S1AP_PDU_PR_initiatingMessage;
+  error_indication_p->presenceMask =
+    S1AP_ERRORINDICATIONIES_ENB_UE_S1AP_ID_PRESENT |
+    S1AP_ERRORINDICATIONIES_CAUSE_PRESENT;
+  error_indication_p->eNB_UE_S1AP_ID = enb_ue_s1ap_id;
+  s1ap_mme_set_cause(
+    &error_indication_p->cause,
+    S1ap_Cause_PR_misc,
+    S1ap_CauseMisc_control_processing_overload);
+
+  if (s1ap_mme_encode_pdu(&message, &buffer_p, &length) < 0) {
+    OAILOG_ERROR(LOG_S1AP, "Failed to encode error indication\n");
+    free_s1ap_errorindication(error_indication_p);
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+
+  bstring b = blk2bstr(buffer_p, length);
+  free(buffer_p);
+  rc = s1ap_mme_itti_send_sctp_request(
+    &b, assoc_id, stream, INVALID_MME_UE_S1AP_ID);
+  free_s1ap_errorindication(error_indication_p);
+  OAILOG_FUNC_RETURN(LOG_S1AP, rc);
+}
+
+/*
+ * Overload state of the MME as advertised to the eNBs. Only the S1AP task
+ * reads or writes it.
+ */
+static bool s1ap_mme_overloaded = false;
+
+//------------------------------------------------------------------------------
+bool s1ap_mme_is_overloaded(void)
+{
+  return s1ap_mme_overloaded;
+}
+
+//------------------------------------------------------------------------------
+static void s1ap_mme_send_overload_msg(s1ap_state_t *state, bool start)
+{
+  hashtable_element_array_t *enb_array = NULL;
+  enb_description_t *enb_ref_p = NULL;
+  int idx;
+
+  enb_array = hashtable_ts_get_elements(&state->enbs);
+  if (enb_array == NULL) {
+    return;
+  }
+  for (idx = 0; idx < enb_array->num_elements; idx++) {
+    enb_ref_p = (enb_description_t *) enb_array->elements[idx];
+    if (enb_ref_p->s1_state != S1AP_READY) {
+      continue;
+    }
+    if (start) {
+      s1ap_mme_generate_overload_start(
+        enb_ref_p->sctp_assoc_id,
+        S1ap_OverloadAction_reject_non_emergency_mo_dt);
+    } else {
+      s1ap_mme_generate_overload_stop(enb_ref_p->sctp_assoc_id);
+    }
+  }
+  free_wrapper((void **) &enb_array->elements);
+  free_wrapper((void **) &enb_array);
+}
+
+//------------------------------------------------------------------------------
+void s1ap_mme_update_overload_state(s1ap_state_t *state)
+{
+  /*
+   * NAS is processed inside MME_APP, so the MME_APP queue is the one that
+   * backs up first when attach / service request load exceeds capacity.
+   * Each priority level drops messages once it alone is full, so the fill
+   * is that of the fullest level against the size of one level.
+   */
+  uint32_t size = itti_get_queue_size(TASK_MME_APP);
+  uint32_t percent = 0;
+
+  if (size == 0) {
+    return;
+  }
+  percent = (itti_get_queue_fullest_level_depth(TASK_MME_APP) * 100) / size;
+
+  if (!s1ap_mme_overloaded && percent >= mme_config.overload_high_watermark) {
+    OAILOG_WARNING(
+      LOG_S1AP,
+      "MME_APP queue at %u%%, sending S1AP OVERLOAD START to eNBs\n",
+      percent);
+    s1ap_mme_overloaded = true;
+    increment_counter("s1ap_overload", 1, 1, "action", "start");
+    s1ap_mme_send_overload_msg(state, true);
+  } else if (
+    s1ap_mme_overloaded && percent <= mme_config.overload_low_watermark) {
+    OAILOG_INFO(
+      LOG_S1AP,
+      "MME_APP queue at %u%%, sending S1AP OVERLOAD STOP to eNBs\n",
+      percent);
+    s1ap_mme_overloaded = false;
+    increment_counter("s1ap_overload", 1, 1, "action", "stop");
+    s1ap_mme_send_overload_msg(state, false);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //************************** Management procedures ***************************//
 ////////////////////////////////////////////////////////////////////////////////
@@ -514,6 +691,11 @@ int s1ap_mme_handle_s1_setup_request(
   if (rc == RETURNok) {
     update_mme_app_stats_connected_enb_add();
     increment_counter("s1_setup", 1, 1, "result", "success");
+    if (s1ap_mme_overloaded) {
+      // The eNB missed the broadcast, bring it in line with the others
+      s1ap_mme_generate_overload_start(
+        assoc_id, S1ap_OverloadAction_reject_non_emergency_mo_dt);
+    }
   }
   OAILOG_FUNC_RETURN(LOG_S1AP, rc);
 }
@@ -132,6 +132,43 @@ int s1ap_mme_generate_s1_setup_failure(
   const long cause_value,
   const long time_to_wait);
 
+/** \brief Send an S1AP OVERLOAD START to one eNB.
+ * \param assoc_id SCTP association ID of the eNB
+ * \param overload_action S1ap_OverloadAction_t value to apply
+ * @returns int
+ **/
+int s1ap_mme_generate_overload_start(
+  const sctp_assoc_id_t assoc_id,
+  const long overload_action);
+
+/** \brief Send an S1AP OVERLOAD STOP to one eNB.
+ * \param assoc_id SCTP association ID of the eNB
+ * @returns int
+ **/
+int s1ap_mme_generate_overload_stop(const sctp_assoc_id_t assoc_id);
+
+/** \brief Tell an eNB that the MME shed its Initial UE message because of
+ * overload, so that it releases the RRC connection instead of waiting for
+ * a reply that never comes.
+ * \param assoc_id SCTP association ID of the eNB
+ * \param stream SCTP stream the Initial UE message came on
+ * \param enb_ue_s1ap_id eNB UE S1AP ID of the shed message
+ * @returns int
+ **/
+int s1ap_mme_generate_overload_error_indication(
+  const sctp_assoc_id_t assoc_id,
+  const sctp_stream_id_t stream,
+  const enb_ue_s1ap_id_t enb_ue_s1ap_id);
+
+/** \brief Compare the MME_APP queue occupancy with the configured watermarks
+ * and broadcast OVERLOAD START / STOP to all ready eNBs on a state change.
+ **/
+void s1ap_mme_update_overload_state(s1ap_state_t *state);
+
+/** \brief Whether OVERLOAD START is currently in effect.
+ **/
+bool s1ap_mme_is_overloaded(void);
+
 int s1ap_mme_handle_erab_setup_response(
   s1ap_state_t *state,
   const sctp_assoc_id_t assoc_id,
@@ -122,6 +122,32 @@ int s1ap_mme_handle_initial_ue_message(
     ecgi_t ecgi = {.plmn = {0}, .cell_identity = {0}};
     csg_id_t csg_id = 0;
 
+    /*
+     * While OVERLOAD START is in effect, reject new non-emergency, mobile
+     * originated connections that raced the eNB receiving it rather than
+     * queueing more work behind an already saturated MME_APP. The Error
+     * Indication lets the eNB release the RRC connection right away.
+     */
+    if (
+      s1ap_mme_is_overloaded() &&
+      initialUEMessage_p->rrC_Establishment_Cause !=
+        S1ap_RRC_Establishment_Cause_emergency &&
+      initialUEMessage_p->rrC_Establishment_Cause !=
+        S1ap_RRC_Establishment_Cause_highPriorityAccess &&
+      initialUEMessage_p->rrC_Establishment_Cause !=
+        S1ap_RRC_Establishment_Cause_mt_Access) {
+      OAILOG_WARNING(
+        LOG_S1AP,
+        "MME overloaded, rejecting Initial UE message for eNB UE S1AP ID "
+        ENB_UE_S1AP_ID_FMT " with RRC establishment cause %ld\n",
+        enb_ue_s1ap_id,
+        initialUEMessage_p->rrC_Establishment_Cause);
+      increment_counter("s1ap_overload_shed_initial_ue", 1, NO_LABELS);
+      s1ap_mme_generate_overload_error_indication(
+        assoc_id, stream, enb_ue_s1ap_id);
+      OAILOG_FUNC_RETURN(LOG_S1AP, RETURNok);
+    }
+
     /*
      * This UE eNB Id has currently no known s1 association.
      * * * * Create new UE context by associating new mme_ue_s1ap_id.
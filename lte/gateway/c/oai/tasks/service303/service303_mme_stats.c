@@ -21,10 +21,24 @@
 #define SERVICE303
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 
 #include "mme_app_state.h"
+#include "intertask_interface.h"
 #include "service303.h"
 
+/* Tasks whose ITTI queue occupancy is exported */
+static const task_id_t service303_monitored_tasks[] = {
+  TASK_MME_APP,
+  TASK_S1AP,
+  TASK_SCTP,
+  TASK_S6A,
+  TASK_S11,
+  TASK_SPGW_APP,
+  TASK_SGS,
+};
+
 static void service303_mme_statistics_read(void)
 {
   size_t label = 0;
@@ -36,8 +50,147 @@ static void service303_mme_statistics_read(void)
   return;
 }
 
+static const char* const service303_queue_level_names[ITTI_QUEUE_LEVELS] = {
+  "high",
+  "med",
+  "low",
+};
+
+static void service303_itti_statistics_read(void)
+{
+  size_t i;
+  itti_queue_level_t level;
+  for (i = 0; i < sizeof(service303_monitored_tasks) / sizeof(task_id_t);
+       i++) {
+    task_id_t task_id = service303_monitored_tasks[i];
+    const char* task_name = itti_get_task_name(task_id);
+    set_gauge(
+      "itti_queue_depth", itti_get_queue_depth(task_id), 1, "task", task_name);
+    set_gauge(
+      "itti_queue_peak_depth",
+      itti_get_queue_peak_depth(task_id),
+      1,
+      "task",
+      task_name);
+    set_gauge(
+      "itti_queue_overflows",
+      itti_get_queue_overflows(task_id),
+      1,
+      "task",
+      task_name);
+    for (level = 0; level < ITTI_QUEUE_LEVELS; level++) {
+      uint64_t avg_wait_us = 0;
+      uint64_t max_wait_us = 0;
+      itti_get_queue_wait_stats(task_id, level, &avg_wait_us, &max_wait_us);
+      set_gauge(
+        "itti_queue_wait_avg_us",
+        avg_wait_us,
+        2,
+        "task",
+        task_name,
+        "priority",
+        service303_queue_level_names[level]);
+      set_gauge(
+        "itti_queue_wait_max_us",
+        max_wait_us,
+        2,
+        "task",
+        task_name,
+        "priority",
+        service303_queue_level_names[level]);
+    }
+  }
+  return;
+}
+
+/*
+ * Value (upper bound, in us) below which a fraction of the histogram samples
+ * fall; buckets are log2 so this is accurate to a factor of two.
+ */
+static uint64_t service303_latency_quantile(
+  const uint64_t* buckets,
+  uint64_t count,
+  double quantile)
+{
+  uint64_t rank = (uint64_t)(quantile * count);
+  uint64_t seen = 0;
+  int bucket;
+  if (count == 0) {
+    return 0;
+  }
+  for (bucket = 0; bucket < ITTI_LATENCY_BUCKETS; bucket++) {
+    seen += buckets[bucket];
+    if (seen > rank) {
+      return bucket == 0 ? 1 : (uint64_t) 1 << bucket;
+    }
+  }
+  return (uint64_t) 1 << (ITTI_LATENCY_BUCKETS - 1);
+}
+
+static void service303_export_latency(
+  const char* name,
+  const uint64_t* buckets,
+  uint64_t max_us,
+  const itti_latency_stats_t* stats)
+{
+  char metric[64];
+  uint64_t count = 0;
+  int bucket;
+  const char* origin = itti_get_task_name(stats->origin_task_id);
+  const char* destination = itti_get_task_name(stats->destination_task_id);
+  const char* message = itti_get_message_name(stats->message_id);
+
+  for (bucket = 0; bucket < ITTI_LATENCY_BUCKETS; bucket++) {
+    count += buckets[bucket];
+  }
+  /*
+   * An idle interval exports zeros so the gauges do not keep showing the
+   * last busy interval
+   */
+  snprintf(metric, sizeof(metric), "%s_count", name);
+  set_gauge(
+    metric, count, 3, "src", origin, "dst", destination, "msg", message);
+  snprintf(metric, sizeof(metric), "%s_p50_us", name);
+  set_gauge(
+    metric,
+    service303_latency_quantile(buckets, count, 0.5),
+    3,
+    "src",
+    origin,
+    "dst",
+    destination,
+    "msg",
+    message);
+  snprintf(metric, sizeof(metric), "%s_p99_us", name);
+  set_gauge(
+    metric,
+    service303_latency_quantile(buckets, count, 0.99),
+    3,
+    "src",
+    origin,
+    "dst",
+    destination,
+    "msg",
+    message);
+  snprintf(metric, sizeof(metric), "%s_max_us", name);
+  set_gauge(
+    metric, max_us, 3, "src", origin, "dst", destination, "msg", message);
+}
+
+static void service303_itti_latency_cb(
+  const itti_latency_stats_t* stats,
+  __attribute__((unused)) void* arg)
+{
+  service303_export_latency(
+    "itti_msg_queue_wait", stats->wait, stats->wait_max_us, stats);
+  service303_export_latency(
+    "itti_msg_handler_time", stats->handler, stats->handler_max_us, stats);
+}
+
 void service303_statistics_read(void)
 {
   service303_mme_statistics_read();
+  service303_itti_statistics_read();
+  itti_latency_stats_apply(service303_itti_latency_cb, NULL);
   return;
 }
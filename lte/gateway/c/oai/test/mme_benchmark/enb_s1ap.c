@@ -0,0 +1,524 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file enb_s1ap.c
+  \brief eNB side S1AP encoding/decoding used by the MME load generator.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "enb_s1ap.h"
+
+#include "assertions.h"
+#include "conversions.h"
+#include "s1ap_common.h"
+#include "s1ap_ies_defs.h"
+#include "S1AP-PDU.h"
+#include "S1ap-CauseRadioNetwork.h"
+#include "S1ap-E-RABSetupItemCtxtSURes.h"
+#include "S1ap-E-RABToBeSetupItemCtxtSUReq.h"
+#include "S1ap-ENB-ID.h"
+#include "S1ap-InitiatingMessage.h"
+#include "S1ap-PLMNidentity.h"
+#include "S1ap-PagingDRX.h"
+#include "S1ap-ProcedureCode.h"
+#include "S1ap-RRC-Establishment-Cause.h"
+#include "S1ap-ResetAll.h"
+#include "S1ap-ResetType.h"
+#include "S1ap-SuccessfulOutcome.h"
+#include "S1ap-SupportedTAs-Item.h"
+#include "S1ap-UE-S1AP-IDs.h"
+#include "S1ap-UEPagingID.h"
+#include "S1ap-UnsuccessfulOutcome.h"
+#include "asn_SEQUENCE_OF.h"
+#include "per_decoder.h"
+
+#define ENB_S1AP_TRANSPORT_ADDRESS 0xc0a83c8d // 192.168.60.141
+
+static bstring enb_s1ap_to_bstring(uint8_t *buffer, ssize_t length)
+{
+  bstring pdu = NULL;
+
+  if (length > 0 && buffer != NULL) {
+    pdu = blk2bstr(buffer, length);
+  }
+  free(buffer);
+  return pdu;
+}
+
+static void enb_s1ap_set_tai(const enb_s1ap_cell_t *cell, S1ap_TAI_t *tai)
+{
+  MCC_MNC_TO_TBCD(cell->mcc, cell->mnc, cell->mnc_len, &tai->pLMNidentity);
+  TAC_TO_ASN1(cell->tac, &tai->tAC);
+}
+
+static void enb_s1ap_set_ecgi(
+  const enb_s1ap_cell_t *cell,
+  S1ap_EUTRAN_CGI_t *ecgi)
+{
+  MCC_MNC_TO_TBCD(cell->mcc, cell->mnc, cell->mnc_len, &ecgi->pLMNidentity);
+  MACRO_ENB_ID_TO_CELL_IDENTITY(cell->enb_id, 0, &ecgi->cell_ID);
+}
+
+//------------------------------------------------------------------------------
+bstring enb_s1ap_s1_setup_request(const enb_s1ap_cell_t *cell)
+{
+  S1ap_S1SetupRequest_t s1_setup_request;
+  S1ap_S1SetupRequestIEs_t ies;
+  S1ap_SupportedTAs_Item_t *ta;
+  S1ap_PLMNidentity_t *plmn;
+  uint8_t *buffer = NULL;
+  uint32_t length = 0;
+  ssize_t encoded;
+
+  memset(&s1_setup_request, 0, sizeof(s1_setup_request));
+  memset(&ies, 0, sizeof(ies));
+
+  MCC_MNC_TO_TBCD(
+    cell->mcc, cell->mnc, cell->mnc_len, &ies.global_ENB_ID.pLMNidentity);
+  ies.global_ENB_ID.eNB_ID.present = S1ap_ENB_ID_PR_macroENB_ID;
+  MACRO_ENB_ID_TO_BIT_STRING(
+    cell->enb_id, &ies.global_ENB_ID.eNB_ID.choice.macroENB_ID);
+
+  ta = calloc(1, sizeof(*ta));
+  TAC_TO_ASN1(cell->tac, &ta->tAC);
+  plmn = calloc(1, sizeof(*plmn));
+  MCC_MNC_TO_TBCD(cell->mcc, cell->mnc, cell->mnc_len, plmn);
+  ASN_SEQUENCE_ADD(&ta->broadcastPLMNs.list, plmn);
+  ASN_SEQUENCE_ADD(&ies.supportedTAs.list, ta);
+
+  ies.defaultPagingDRX = S1ap_PagingDRX_v64;
+
+  if (s1ap_encode_s1ap_s1setuprequesties(&s1_setup_request, &ies) < 0) {
+    free_s1ap_s1setuprequest(&ies);
+    return NULL;
+  }
+  encoded = s1ap_generate_initiating_message(
+    &buffer,
+    &length,
+    S1ap_ProcedureCode_id_S1Setup,
+    S1ap_Criticality_reject,
+    &asn_DEF_S1ap_S1SetupRequest,
+    &s1_setup_request);
+  free_s1ap_s1setuprequest(&ies);
+  return enb_s1ap_to_bstring(buffer, encoded);
+}
+
+//------------------------------------------------------------------------------
+bstring enb_s1ap_initial_ue_message(
+  const enb_s1ap_cell_t *cell,
+  uint32_t enb_ue_s1ap_id,
+  const uint8_t *nas,
+  size_t nas_len,
+  bool has_s_tmsi,
+  uint8_t mme_code,
+  uint32_t m_tmsi)
+{
+  S1ap_InitialUEMessage_t initial_ue_message;
+  S1ap_InitialUEMessageIEs_t ies;
+  uint8_t *buffer = NULL;
+  uint32_t length = 0;
+  ssize_t encoded;
+
+  memset(&initial_ue_message, 0, sizeof(initial_ue_message));
+  memset(&ies, 0, sizeof(ies));
+
+  ies.eNB_UE_S1AP_ID = enb_ue_s1ap_id;
+  OCTET_STRING_fromBuf(&ies.nas_pdu, (const char *) nas, nas_len);
+  enb_s1ap_set_tai(cell, &ies.tai);
+  enb_s1ap_set_ecgi(cell, &ies.eutran_cgi);
+  if (has_s_tmsi) {
+    ies.presenceMask |= S1AP_INITIALUEMESSAGEIES_S_TMSI_PRESENT;
+    MME_CODE_TO_OCTET_STRING(mme_code, &ies.s_tmsi.mMEC);
+    M_TMSI_TO_OCTET_STRING(m_tmsi, &ies.s_tmsi.m_TMSI);
+    ies.rrC_Establishment_Cause = S1ap_RRC_Establishment_Cause_mt_Access;
+  } else {
+    ies.rrC_Establishment_Cause = S1ap_RRC_Establishment_Cause_mo_Signalling;
+  }
+
+  if (s1ap_encode_s1ap_initialuemessageies(&initial_ue_message, &ies) < 0) {
+    free_s1ap_initialuemessage(&ies);
+    return NULL;
+  }
+  encoded = s1ap_generate_initiating_message(
+    &buffer,
+    &length,
+    S1ap_ProcedureCode_id_initialUEMessage,
+    S1ap_Criticality_ignore,
+    &asn_DEF_S1ap_InitialUEMessage,
+    &initial_ue_message);
+  free_s1ap_initialuemessage(&ies);
+  return enb_s1ap_to_bstring(buffer, encoded);
+}
+
+//------------------------------------------------------------------------------
+bstring enb_s1ap_uplink_nas_transport(
+  const enb_s1ap_cell_t *cell,
+  uint32_t mme_ue_s1ap_id,
+  uint32_t enb_ue_s1ap_id,
+  const uint8_t *nas,
+  size_t nas_len)
+{
+  S1ap_UplinkNASTransport_t uplink_nas_transport;
+  S1ap_UplinkNASTransportIEs_t ies;
+  uint8_t *buffer = NULL;
+  uint32_t length = 0;
+  ssize_t encoded;
+
+  memset(&uplink_nas_transport, 0, sizeof(uplink_nas_transport));
+  memset(&ies, 0, sizeof(ies));
+
+  ies.mme_ue_s1ap_id = mme_ue_s1ap_id;
+  ies.eNB_UE_S1AP_ID = enb_ue_s1ap_id;
+  OCTET_STRING_fromBuf(&ies.nas_pdu, (const char *) nas, nas_len);
+  enb_s1ap_set_ecgi(cell, &ies.eutran_cgi);
+  enb_s1ap_set_tai(cell, &ies.tai);
+
+  if (
+    s1ap_encode_s1ap_uplinknastransporties(&uplink_nas_transport, &ies) < 0) {
+    free_s1ap_uplinknastransport(&ies);
+    return NULL;
+  }
+  encoded = s1ap_generate_initiating_message(
+    &buffer,
+    &length,
+    S1ap_ProcedureCode_id_uplinkNASTransport,
+    S1ap_Criticality_ignore,
+    &asn_DEF_S1ap_UplinkNASTransport,
+    &uplink_nas_transport);
+  free_s1ap_uplinknastransport(&ies);
+  return enb_s1ap_to_bstring(buffer, encoded);
+}
+
+//------------------------------------------------------------------------------
+bstring enb_s1ap_initial_context_setup_response(
+  uint32_t mme_ue_s1ap_id,
+  uint32_t enb_ue_s1ap_id,
+  const uint8_t *e_rab_id,
+  int nb_e_rabs,
+  uint32_t enb_teid)
+{
+  S1ap_InitialContextSetupResponse_t initial_context_setup_response;
+  S1ap_InitialContextSetupResponseIEs_t ies;
+  S1ap_E_RABSetupItemCtxtSURes_t *e_rab;
+  uint8_t *buffer = NULL;
+  uint32_t length = 0;
+  ssize_t encoded;
+  int i;
+
+  memset(
+    &initial_context_setup_response,
+    0,
+    sizeof(initial_context_setup_response));
+  memset(&ies, 0, sizeof(ies));
+
+  ies.mme_ue_s1ap_id = mme_ue_s1ap_id;
+  ies.eNB_UE_S1AP_ID = enb_ue_s1ap_id;
+  for (i = 0; i < nb_e_rabs; i++) {
+    e_rab = calloc(1, sizeof(*e_rab));
+    e_rab->e_RAB_ID = e_rab_id[i];
+    INT32_TO_BIT_STRING(
+      ENB_S1AP_TRANSPORT_ADDRESS, &e_rab->transportLayerAddress);
+    GTP_TEID_TO_ASN1(enb_teid + i, &e_rab->gTP_TEID);
+    ASN_SEQUENCE_ADD(
+      &ies.e_RABSetupListCtxtSURes.s1ap_E_RABSetupItemCtxtSURes, e_rab);
+  }
+
+  if (
+    s1ap_encode_s1ap_initialcontextsetupresponseies(
+      &initial_context_setup_response, &ies) < 0) {
+    free_s1ap_initialcontextsetupresponse(&ies);
+    return NULL;
+  }
+  encoded = s1ap_generate_successfull_outcome(
+    &buffer,
+    &length,
+    S1ap_ProcedureCode_id_InitialContextSetup,
+    S1ap_Criticality_reject,
+    &asn_DEF_S1ap_InitialContextSetupResponse,
+    &initial_context_setup_response);
+  free_s1ap_initialcontextsetupresponse(&ies);
+  return enb_s1ap_to_bstring(buffer, encoded);
+}
+
+//------------------------------------------------------------------------------
+bstring enb_s1ap_ue_context_release_request(
+  uint32_t mme_ue_s1ap_id,
+  uint32_t enb_ue_s1ap_id)
+{
+  S1ap_UEContextReleaseRequest_t ue_context_release_request;
+  S1ap_UEContextReleaseRequestIEs_t ies;
+  uint8_t *buffer = NULL;
+  uint32_t length = 0;
+  ssize_t encoded;
+
+  memset(&ue_context_release_request, 0, sizeof(ue_context_release_request));
+  memset(&ies, 0, sizeof(ies));
+
+  ies.mme_ue_s1ap_id = mme_ue_s1ap_id;
+  ies.eNB_UE_S1AP_ID = enb_ue_s1ap_id;
+  ies.cause.present = S1ap_Cause_PR_radioNetwork;
+  ies.cause.choice.radioNetwork = S1ap_CauseRadioNetwork_user_inactivity;
+
+  if (
+    s1ap_encode_s1ap_uecontextreleaserequesties(
+      &ue_context_release_request, &ies) < 0) {
+    free_s1ap_uecontextreleaserequest(&ies);
+    return NULL;
+  }
+  encoded = s1ap_generate_initiating_message(
+    &buffer,
+    &length,
+    S1ap_ProcedureCode_id_UEContextReleaseRequest,
+    S1ap_Criticality_ignore,
+    &asn_DEF_S1ap_UEContextReleaseRequest,
+    &ue_context_release_request);
+  free_s1ap_uecontextreleaserequest(&ies);
+  return enb_s1ap_to_bstring(buffer, encoded);
+}
+
+//------------------------------------------------------------------------------
+bstring enb_s1ap_ue_context_release_complete(
+  uint32_t mme_ue_s1ap_id,
+  uint32_t enb_ue_s1ap_id)
+{
+  S1ap_UEContextReleaseComplete_t ue_context_release_complete;
+  S1ap_UEContextReleaseCompleteIEs_t ies;
+  uint8_t *buffer = NULL;
+  uint32_t length = 0;
+  ssize_t encoded;
+
+  memset(&ue_context_release_complete, 0, sizeof(ue_context_release_complete));
+  memset(&ies, 0, sizeof(ies));
+
+  ies.mme_ue_s1ap_id = mme_ue_s1ap_id;
+  ies.eNB_UE_S1AP_ID = enb_ue_s1ap_id;
+
+  if (
+    s1ap_encode_s1ap_uecontextreleasecompleteies(
+      &ue_context_release_complete, &ies) < 0) {
+    free_s1ap_uecontextreleasecomplete(&ies);
+    return NULL;
+  }
+  encoded = s1ap_generate_successfull_outcome(
+    &buffer,
+    &length,
+    S1ap_ProcedureCode_id_UEContextRelease,
+    S1ap_Criticality_reject,
+    &asn_DEF_S1ap_UEContextReleaseComplete,
+    &ue_context_release_complete);
+  free_s1ap_uecontextreleasecomplete(&ies);
+  return enb_s1ap_to_bstring(buffer, encoded);
+}
+
+//------------------------------------------------------------------------------
+bstring enb_s1ap_reset_all(void)
+{
+  S1ap_Reset_t reset;
+  S1ap_ResetIEs_t ies;
+  uint8_t *buffer = NULL;
+  uint32_t length = 0;
+  ssize_t encoded;
+
+  memset(&reset, 0, sizeof(reset));
+  memset(&ies, 0, sizeof(ies));
+
+  ies.cause.present = S1ap_Cause_PR_radioNetwork;
+  ies.cause.choice.radioNetwork = S1ap_CauseRadioNetwork_unspecified;
+  ies.resetType.present = S1ap_ResetType_PR_s1_Interface;
+  ies.resetType.choice.s1_Interface = S1ap_ResetAll_reset_all;
+
+  if (s1ap_encode_s1ap_reseties(&reset, &ies) < 0) {
+    free_s1ap_reset(&ies);
+    return NULL;
+  }
+  encoded = s1ap_generate_initiating_message(
+    &buffer,
+    &length,
+    S1ap_ProcedureCode_id_Reset,
+    S1ap_Criticality_reject,
+    &asn_DEF_S1ap_Reset,
+    &reset);
+  free_s1ap_reset(&ies);
+  return enb_s1ap_to_bstring(buffer, encoded);
+}
+
+//------------------------------------------------------------------------------
+static int enb_s1ap_decode_initiating(
+  S1ap_InitiatingMessage_t *initiating_p,
+  enb_s1ap_downlink_t *dl)
+{
+  switch (initiating_p->procedureCode) {
+    case S1ap_ProcedureCode_id_downlinkNASTransport: {
+      S1ap_DownlinkNASTransportIEs_t ies;
+
+      memset(&ies, 0, sizeof(ies));
+      if (
+        s1ap_decode_s1ap_downlinknastransporties(&ies, &initiating_p->value) <
+        0) {
+        return -1;
+      }
+      dl->procedure = ENB_S1AP_DOWNLINK_NAS;
+      dl->has_mme_ue_s1ap_id = true;
+      dl->mme_ue_s1ap_id = ies.mme_ue_s1ap_id;
+      dl->has_enb_ue_s1ap_id = true;
+      dl->enb_ue_s1ap_id = ies.eNB_UE_S1AP_ID;
+      dl->nas_pdu = blk2bstr(ies.nas_pdu.buf, ies.nas_pdu.size);
+      free_s1ap_downlinknastransport(&ies);
+    } break;
+
+    case S1ap_ProcedureCode_id_InitialContextSetup: {
+      S1ap_InitialContextSetupRequestIEs_t ies;
+      S1ap_E_RABToBeSetupItemCtxtSUReq_t *e_rab;
+      int i;
+
+      memset(&ies, 0, sizeof(ies));
+      if (
+        s1ap_decode_s1ap_initialcontextsetuprequesties(
+          &ies, &initiating_p->value) < 0) {
+        return -1;
+      }
+      dl->procedure = ENB_S1AP_INITIAL_CONTEXT_SETUP_REQUEST;
+      dl->has_mme_ue_s1ap_id = true;
+      dl->mme_ue_s1ap_id = ies.mme_ue_s1ap_id;
+      dl->has_enb_ue_s1ap_id = true;
+      dl->enb_ue_s1ap_id = ies.eNB_UE_S1AP_ID;
+      for (i = 0;
+           i < ies.e_RABToBeSetupListCtxtSUReq.s1ap_E_RABToBeSetupItemCtxtSUReq
+                 .count &&
+           i < ENB_S1AP_MAX_E_RABS;
+           i++) {
+        e_rab = (S1ap_E_RABToBeSetupItemCtxtSUReq_t *) ies
+                  .e_RABToBeSetupListCtxtSUReq.s1ap_E_RABToBeSetupItemCtxtSUReq
+                  .array[i];
+        dl->e_rab_id[dl->nb_e_rabs++] = e_rab->e_RAB_ID;
+        // Attach Accept is piggybacked on the default bearer
+        if (e_rab->nAS_PDU != NULL && dl->nas_pdu == NULL) {
+          dl->nas_pdu = blk2bstr(e_rab->nAS_PDU->buf, e_rab->nAS_PDU->size);
+        }
+      }
+      free_s1ap_initialcontextsetuprequest(&ies);
+    } break;
+
+    case S1ap_ProcedureCode_id_UEContextRelease: {
+      S1ap_UEContextReleaseCommandIEs_t ies;
+
+      memset(&ies, 0, sizeof(ies));
+      if (
+        s1ap_decode_s1ap_uecontextreleasecommandies(
+          &ies, &initiating_p->value) < 0) {
+        return -1;
+      }
+      dl->procedure = ENB_S1AP_UE_CONTEXT_RELEASE_COMMAND;
+      if (ies.uE_S1AP_IDs.present == S1ap_UE_S1AP_IDs_PR_uE_S1AP_ID_pair) {
+        dl->has_mme_ue_s1ap_id = true;
+        dl->mme_ue_s1ap_id =
+          ies.uE_S1AP_IDs.choice.uE_S1AP_ID_pair.mME_UE_S1AP_ID;
+        dl->has_enb_ue_s1ap_id = true;
+        dl->enb_ue_s1ap_id =
+          ies.uE_S1AP_IDs.choice.uE_S1AP_ID_pair.eNB_UE_S1AP_ID;
+      } else if (
+        ies.uE_S1AP_IDs.present == S1ap_UE_S1AP_IDs_PR_mME_UE_S1AP_ID) {
+        dl->has_mme_ue_s1ap_id = true;
+        dl->mme_ue_s1ap_id = ies.uE_S1AP_IDs.choice.mME_UE_S1AP_ID;
+      }
+      free_s1ap_uecontextreleasecommand(&ies);
+    } break;
+
+    case S1ap_ProcedureCode_id_Paging: {
+      S1ap_PagingIEs_t ies;
+      const OCTET_STRING_t *m_tmsi;
+
+      memset(&ies, 0, sizeof(ies));
+      if (s1ap_decode_s1ap_pagingies(&ies, &initiating_p->value) < 0) {
+        return -1;
+      }
+      dl->procedure = ENB_S1AP_PAGING;
+      if (ies.uePagingID.present == S1ap_UEPagingID_PR_s_TMSI) {
+        m_tmsi = &ies.uePagingID.choice.s_TMSI.m_TMSI;
+        if (m_tmsi->size == 4) {
+          BUFFER_TO_INT32(m_tmsi->buf, dl->paging_m_tmsi);
+        }
+      }
+      free_s1ap_paging(&ies);
+    } break;
+
+    default: break;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+int enb_s1ap_decode_downlink(const_bstring pdu, enb_s1ap_downlink_t *dl)
+{
+  S1AP_PDU_t s1ap_pdu;
+  S1AP_PDU_t *pdu_p = &s1ap_pdu;
+  asn_dec_rval_t dec_ret;
+  int rc = 0;
+
+  memset(dl, 0, sizeof(*dl));
+  memset(pdu_p, 0, sizeof(*pdu_p));
+  dec_ret = aper_decode(
+    NULL, &asn_DEF_S1AP_PDU, (void **) &pdu_p, bdata(pdu), blength(pdu), 0, 0);
+  if (dec_ret.code != RC_OK) {
+    ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_S1AP_PDU, pdu_p);
+    return -1;
+  }
+
+  switch (pdu_p->present) {
+    case S1AP_PDU_PR_initiatingMessage:
+      rc = enb_s1ap_decode_initiating(&pdu_p->choice.initiatingMessage, dl);
+      break;
+
+    case S1AP_PDU_PR_successfulOutcome:
+      switch (pdu_p->choice.successfulOutcome.procedureCode) {
+        case S1ap_ProcedureCode_id_S1Setup:
+          dl->procedure = ENB_S1AP_S1_SETUP_RESPONSE;
+          break;
+        case S1ap_ProcedureCode_id_Reset:
+          dl->procedure = ENB_S1AP_RESET_ACKNOWLEDGE;
+          break;
+        default: break;
+      }
+      break;
+
+    case S1AP_PDU_PR_unsuccessfulOutcome:
+      if (
+        pdu_p->choice.unsuccessfulOutcome.procedureCode ==
+        S1ap_ProcedureCode_id_S1Setup) {
+        dl->procedure = ENB_S1AP_S1_SETUP_FAILURE;
+      }
+      break;
+
+    default: break;
+  }
+
+  ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_S1AP_PDU, pdu_p);
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+void enb_s1ap_downlink_free(enb_s1ap_downlink_t *dl)
+{
+  bdestroy(dl->nas_pdu);
+  dl->nas_pdu = NULL;
+}
@@ -0,0 +1,127 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file enb_s1ap.h
+  \brief eNB side S1AP encoding/decoding used by the MME load generator.
+
+  The MME only ever decodes uplink and encodes downlink S1AP, so the
+  simulated eNBs need the opposite direction. Everything goes through the
+  generated s1ap_encode_* / s1ap_decode_* helpers so that the PDUs on the
+  wire are exactly what asn1c produces for a real eNB.
+*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bstrlib.h"
+
+#define ENB_S1AP_MAX_E_RABS 8
+
+typedef enum {
+  ENB_S1AP_UNKNOWN = 0,
+  ENB_S1AP_S1_SETUP_RESPONSE,
+  ENB_S1AP_S1_SETUP_FAILURE,
+  ENB_S1AP_DOWNLINK_NAS,
+  ENB_S1AP_INITIAL_CONTEXT_SETUP_REQUEST,
+  ENB_S1AP_UE_CONTEXT_RELEASE_COMMAND,
+  ENB_S1AP_PAGING,
+  ENB_S1AP_RESET_ACKNOWLEDGE,
+} enb_s1ap_procedure_t;
+
+/*
+ * Flattened view of a downlink PDU, holding only what the simulated eNB
+ * and UE act upon. nas_pdu is owned by the structure and released with
+ * enb_s1ap_downlink_free().
+ */
+typedef struct enb_s1ap_downlink_s {
+  enb_s1ap_procedure_t procedure;
+  bool has_mme_ue_s1ap_id;
+  uint32_t mme_ue_s1ap_id;
+  bool has_enb_ue_s1ap_id;
+  uint32_t enb_ue_s1ap_id;
+  bstring nas_pdu;
+  uint32_t paging_m_tmsi;
+  int nb_e_rabs;
+  uint8_t e_rab_id[ENB_S1AP_MAX_E_RABS];
+} enb_s1ap_downlink_t;
+
+typedef struct enb_s1ap_cell_s {
+  uint32_t enb_id; // 20 bits macro eNB ID
+  uint16_t tac;
+  uint16_t mcc;
+  uint16_t mnc;
+  uint16_t mnc_len;
+} enb_s1ap_cell_t;
+
+bstring enb_s1ap_s1_setup_request(const enb_s1ap_cell_t *cell);
+
+bstring enb_s1ap_initial_ue_message(
+  const enb_s1ap_cell_t *cell,
+  uint32_t enb_ue_s1ap_id,
+  const uint8_t *nas,
+  size_t nas_len,
+  bool has_s_tmsi,
+  uint8_t mme_code,
+  uint32_t m_tmsi);
+
+bstring enb_s1ap_uplink_nas_transport(
+  const enb_s1ap_cell_t *cell,
+  uint32_t mme_ue_s1ap_id,
+  uint32_t enb_ue_s1ap_id,
+  const uint8_t *nas,
+  size_t nas_len);
+
+bstring enb_s1ap_initial_context_setup_response(
+  uint32_t mme_ue_s1ap_id,
+  uint32_t enb_ue_s1ap_id,
+  const uint8_t *e_rab_id,
+  int nb_e_rabs,
+  uint32_t enb_teid);
+
+bstring enb_s1ap_ue_context_release_request(
+  uint32_t mme_ue_s1ap_id,
+  uint32_t enb_ue_s1ap_id);
+
+bstring enb_s1ap_ue_context_release_complete(
+  uint32_t mme_ue_s1ap_id,
+  uint32_t enb_ue_s1ap_id);
+
+bstring enb_s1ap_reset_all(void);
+
+/*
+ * Decodes a PDU the MME sent to the eNB. Returns 0 on success, -1 when the
+ * PDU could not be decoded; unsupported procedures decode successfully as
+ * ENB_S1AP_UNKNOWN.
+ */
+int enb_s1ap_decode_downlink(const_bstring pdu, enb_s1ap_downlink_t *dl);
+
+void enb_s1ap_downlink_free(enb_s1ap_downlink_t *dl);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,1305 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * Closed-loop MME load generator.
+ *
+ * Runs the real S1AP and MME_APP (with NAS) tasks in process and drives them
+ * through the same ITTI interface the SCTP task uses, with a simulated
+ * population of eNBs and UEs. The S6a and S11 peers are replaced by local
+ * responders, and IP allocation (mobilityd) is answered by the S11 responder
+ * through the PAA of the Create Session Response, so the binary needs no
+ * network, HSS or SPGW and can run in CI:
+ *
+ *   mme_benchmark --scenario all --enbs 4 --ues 1000 --concurrency 64
+ *
+ * Each scenario runs a number of rounds; a round is one or more phases and
+ * every phase runs one procedure for every actor, keeping at most
+ * --concurrency procedures in flight. Latency is measured from the first
+ * uplink message to the event that ends the procedure on the MME side.
+ * The exit status is non-zero when any procedure failed or timed out, or
+ * when a p99 exceeds --max-p99-ms.
+ */
+
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include "bstrlib.h"
+
+#include "3gpp_33.401.h"
+#include "common_defs.h"
+#include "conversions.h"
+#include "intertask_interface.h"
+#include "itti_free_defined_msg.h"
+#include "log.h"
+#include "mme_config.h"
+#include "mme_app_extern.h"
+#include "s1ap_mme.h"
+#include "shared_ts_log.h"
+}
+
+#include "enb_s1ap.h"
+#include "mme_benchmark_itti.h"
+#include "ue_nas.h"
+
+#if EMBEDDED_SGW
+#define TASK_SPGW TASK_SPGW_APP
+#else
+#define TASK_SPGW TASK_S11
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// S1 Setup must use stream 0, UE associated signalling any other stream
+const uint16_t BENCH_SCTP_STREAMS = 2;
+const uint16_t BENCH_UE_STREAM = 1;
+
+const uint16_t BENCH_MCC = 1;
+const uint16_t BENCH_MNC = 1;
+const uint16_t BENCH_MNC_LEN = 2;
+const uint16_t BENCH_TAC = 1;
+const uint8_t BENCH_MME_CODE = 1;
+const uint16_t BENCH_MME_GID = 1;
+const uint8_t BENCH_XRES_LENGTH = 8;
+const char BENCH_APN[] = "magma.ipv4";
+
+enum Procedure {
+  PROC_NONE = 0,
+  PROC_S1_SETUP,
+  PROC_ATTACH,
+  PROC_DETACH,
+  PROC_IDLE,
+  PROC_PAGING,
+  PROC_SERVICE_REQUEST,
+  PROC_TAU,
+  PROC_S1_RESET,
+  PROC_MAX,
+};
+
+const char* const procedure_names[PROC_MAX] = {
+  "none",
+  "s1-setup",
+  "attach",
+  "detach",
+  "idle",
+  "paging",
+  "service-request",
+  "tau",
+  "s1-reset",
+};
+
+struct Actor {
+  Procedure procedure = PROC_NONE;
+  Clock::time_point start;
+  // The procedure latency was already recorded, e.g. TAU Accept received
+  // but the connection not yet released
+  bool recorded = false;
+};
+
+struct Enb : Actor {
+  uint32_t index = 0;
+  sctp_assoc_id_t assoc_id = 0;
+  enb_s1ap_cell_t cell;
+};
+
+enum UeState {
+  UE_DEREGISTERED,
+  UE_CONNECTED,
+  UE_IDLE,
+  // Left in an unknown state by a failed procedure, skipped from then on
+  UE_BROKEN,
+};
+
+struct Ue : Actor {
+  uint32_t index = 0;
+  char imsi[IMSI_BCD_DIGITS_MAX + 1];
+  Enb* enb = nullptr;
+  UeState state = UE_DEREGISTERED;
+  uint32_t enb_ue_s1ap_id = 0;
+  uint32_t mme_ue_s1ap_id = INVALID_MME_UE_S1AP_ID;
+  uint8_t kasme[KASME_LENGTH_OCTETS];
+  uint8_t xres[BENCH_XRES_LENGTH];
+  ue_nas_security_t security;
+  uint8_t guti[UE_NAS_GUTI_LENGTH];
+  uint8_t mme_code = 0;
+  uint32_t m_tmsi = 0;
+  teid_t mme_teid = 0;
+  ebi_t ebi = 0;
+  bool paging_answered = false;
+};
+
+struct Options {
+  std::string scenario = "all";
+  uint32_t enbs = 4;
+  uint32_t ues = 1000;
+  uint32_t concurrency = 64;
+  uint32_t rounds = 3;
+  uint32_t timeout_ms = 5000;
+  double max_p99_ms = 0;
+};
+
+struct ProcedureStats {
+  std::vector<double> latencies_ms;
+  uint64_t failed = 0;
+  double seconds = 0;
+};
+
+/*
+ * Messages the stub tasks received from the MME, handed over to the driver
+ * thread so that all simulated eNB/UE/peer state is owned by one thread.
+ */
+class EventQueue {
+ public:
+  void push(MessageDef* msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(msg);
+    cv_.notify_one();
+  }
+
+  MessageDef* pop(std::chrono::milliseconds timeout)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cv_.wait_for(lock, timeout, [this] { return !queue_.empty(); })) {
+      return nullptr;
+    }
+    MessageDef* msg = queue_.front();
+    queue_.pop_front();
+    return msg;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<MessageDef*> queue_;
+};
+
+EventQueue events;
+
+const task_id_t stub_tasks[] = {TASK_SCTP, TASK_S6A, TASK_SPGW};
+
+void* stub_task_thread(void* args)
+{
+  task_id_t task_id = *static_cast<const task_id_t*>(args);
+
+  itti_mark_task_ready(task_id);
+  while (1) {
+    MessageDef* msg = nullptr;
+
+    itti_receive_msg(task_id, &msg);
+    if (ITTI_MSG_ID(msg) == TERMINATE_MESSAGE) {
+      itti_free(ITTI_MSG_ORIGIN_ID(msg), msg);
+      itti_exit_task();
+    }
+    events.push(msg);
+  }
+  return nullptr;
+}
+
+void free_message(MessageDef* msg)
+{
+  itti_free_msg_content(msg);
+  itti_free(ITTI_MSG_ORIGIN_ID(msg), msg);
+}
+
+double elapsed_ms(Clock::time_point start, Clock::time_point end)
+{
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+class Benchmark {
+ public:
+  explicit Benchmark(const Options& options): options_(options) {}
+
+  int init();
+  int run();
+
+ private:
+  // Scenarios
+  bool run_scenario(const std::string& name, uint32_t first_ue);
+  std::vector<Ue*> make_population(uint32_t first_ue);
+  template<typename T>
+  void run_phase(Procedure procedure, const std::vector<T*>& actors);
+  void drain();
+  bool report(const std::string& name);
+
+  // Procedure bookkeeping
+  void start(Enb* enb, Procedure procedure);
+  void start(Ue* ue, Procedure procedure);
+  void complete(Actor* actor, Procedure procedure);
+  void record(Actor* actor, Procedure procedure);
+  void fail(Enb* enb);
+  void fail(Ue* ue);
+
+  // eNB side
+  void send_to_s1ap(const Enb* enb, uint16_t stream, bstring payload);
+  void send_initial_ue_message(Ue* ue, const uint8_t* nas, size_t nas_len);
+  void send_uplink_nas(Ue* ue, const uint8_t* nas, size_t nas_len);
+  void handle_sctp_data_req(const sctp_data_req_t* data_req);
+  void handle_downlink_nas(Ue* ue, const_bstring nas_pdu);
+  void handle_initial_context_setup(Ue* ue, const enb_s1ap_downlink_t* dl);
+  void handle_ue_context_release(Ue* ue);
+  void handle_paging(const Enb* enb, uint32_t m_tmsi);
+  void handle_reset_acknowledge(Enb* enb);
+
+  // S6a and S11 responders
+  void handle_auth_info_req(const s6a_auth_info_req_t* air);
+  void handle_update_location_req(const s6a_update_location_req_t* ulr);
+  void handle_purge_ue_req(const s6a_purge_ue_req_t* pur);
+  void handle_create_session_req(
+    const itti_s11_create_session_request_t* csr);
+  void handle_modify_bearer_req(const itti_s11_modify_bearer_request_t* mbr);
+  void handle_delete_session_req(
+    const itti_s11_delete_session_request_t* dsr);
+  void handle_release_access_bearers_req(
+    const itti_s11_release_access_bearers_request_t* rab);
+  void send_paging_trigger(Ue* ue);
+
+  void dispatch(MessageDef* msg);
+  Ue* ue_by_imsi(const char* imsi);
+  Ue* ue_by_s1ap_id(const enb_s1ap_downlink_t* dl);
+  Enb* enb_by_assoc_id(sctp_assoc_id_t assoc_id);
+
+  Options options_;
+  std::vector<Enb> enbs_;
+  std::vector<Ue> ues_;
+  std::unordered_map<uint32_t, Ue*> ue_by_mme_id_;
+  std::unordered_map<uint32_t, Ue*> ue_by_m_tmsi_;
+  std::unordered_map<teid_t, Ue*> ue_by_teid_;
+  ProcedureStats stats_[PROC_MAX];
+  uint32_t next_sgw_teid_ = 1;
+};
+
+//------------------------------------------------------------------------------
+int Benchmark::init()
+{
+  uint32_t n_scenarios = options_.scenario == "all" ? 4 : 1;
+
+  mme_config_init(&mme_config);
+  mme_config.max_enbs = options_.enbs;
+  mme_config.max_ues = options_.ues * n_scenarios;
+  mme_config.use_stateless = false;
+  mme_config.non_eps_service_control = bfromcstr("OFF");
+
+  mme_config.nas_config.prefered_integrity_algorithm[0] = EIA2_128_ALG_ID;
+  mme_config.nas_config.prefered_integrity_algorithm[1] = EIA1_128_ALG_ID;
+  mme_config.nas_config.prefered_integrity_algorithm[2] = EIA0_ALG_ID;
+  mme_config.nas_config.prefered_ciphering_algorithm[0] = EEA0_ALG_ID;
+  mme_config.nas_config.prefered_ciphering_algorithm[1] = EEA0_ALG_ID;
+  mme_config.nas_config.prefered_ciphering_algorithm[2] = EEA0_ALG_ID;
+
+  mme_config.served_tai.nb_tai = 1;
+  mme_config.served_tai.plmn_mcc[0] = BENCH_MCC;
+  mme_config.served_tai.plmn_mnc[0] = BENCH_MNC;
+  mme_config.served_tai.plmn_mnc_len[0] = BENCH_MNC_LEN;
+  mme_config.served_tai.tac[0] = BENCH_TAC;
+
+  mme_config.gummei.nb = 1;
+  mme_config.gummei.gummei[0].plmn.mcc_digit1 = 0;
+  mme_config.gummei.gummei[0].plmn.mcc_digit2 = 0;
+  mme_config.gummei.gummei[0].plmn.mcc_digit3 = 1;
+  mme_config.gummei.gummei[0].plmn.mnc_digit1 = 0;
+  mme_config.gummei.gummei[0].plmn.mnc_digit2 = 1;
+  mme_config.gummei.gummei[0].plmn.mnc_digit3 = 0xf;
+  mme_config.gummei.gummei[0].mme_gid = BENCH_MME_GID;
+  mme_config.gummei.gummei[0].mme_code = BENCH_MME_CODE;
+
+  mme_config.log_config.udp_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.gtpv1u_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.gtpv2c_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.sctp_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.s1ap_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.nas_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.mme_app_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.spgw_app_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.s11_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.s6a_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.secu_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.util_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.async_system_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.itti_log_level = OAILOG_LEVEL_ERROR;
+  mme_config.log_config.sgs_log_level = OAILOG_LEVEL_ERROR;
+  OAILOG_LOG_CONFIGURE(&mme_config.log_config);
+
+  for (size_t i = 0; i < sizeof(stub_tasks) / sizeof(stub_tasks[0]); i++) {
+    if (
+      itti_create_task(
+        stub_tasks[i],
+        &stub_task_thread,
+        const_cast<task_id_t*>(&stub_tasks[i])) != RETURNok) {
+      fprintf(
+        stderr, "Could not create %s\n", itti_get_task_name(stub_tasks[i]));
+      return RETURNerror;
+    }
+  }
+  if (mme_app_init(&mme_config) != RETURNok) return RETURNerror;
+  if (s1ap_mme_init(&mme_config) != RETURNok) return RETURNerror;
+
+  enbs_.resize(options_.enbs);
+  for (uint32_t i = 0; i < options_.enbs; i++) {
+    Enb* enb = &enbs_[i];
+
+    enb->index = i;
+    enb->assoc_id = i + 1;
+    enb->cell.enb_id = i + 1;
+    enb->cell.tac = BENCH_TAC;
+    enb->cell.mcc = BENCH_MCC;
+    enb->cell.mnc = BENCH_MNC;
+    enb->cell.mnc_len = BENCH_MNC_LEN;
+  }
+
+  ues_.resize(options_.ues * n_scenarios);
+  for (uint32_t i = 0; i < ues_.size(); i++) {
+    Ue* ue = &ues_[i];
+
+    ue->index = i;
+    snprintf(ue->imsi, sizeof(ue->imsi), "%03u%02u%010u", BENCH_MCC,
+      BENCH_MNC, i);
+    ue->enb = &enbs_[i % enbs_.size()];
+    // eNB UE S1AP ID is 24 bits, unique across eNBs keeps lookups simple
+    ue->enb_ue_s1ap_id = i + 1;
+    for (size_t j = 0; j < sizeof(ue->kasme); j++) {
+      ue->kasme[j] = (uint8_t)(i * 31 + j);
+    }
+    for (size_t j = 0; j < sizeof(ue->xres); j++) {
+      ue->xres[j] = (uint8_t)((i >> (8 * (j % 4))) ^ (0xa5 + j));
+    }
+    memset(&ue->security, 0, sizeof(ue->security));
+  }
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+int Benchmark::run()
+{
+  static const char* const scenarios[] = {
+    "attach-storm", "paging-storm", "tau-churn", "s1-reset"};
+  std::vector<Enb*> enbs;
+  bool ok = true;
+  uint32_t first_ue = 0;
+
+  for (auto& enb : enbs_) {
+    MessageDef* msg = itti_alloc_new_message(TASK_SCTP, SCTP_NEW_ASSOCIATION);
+
+    SCTP_NEW_ASSOCIATION(msg).assoc_id = enb.assoc_id;
+    SCTP_NEW_ASSOCIATION(msg).instreams = BENCH_SCTP_STREAMS;
+    SCTP_NEW_ASSOCIATION(msg).outstreams = BENCH_SCTP_STREAMS;
+    itti_send_msg_to_task(TASK_S1AP, INSTANCE_DEFAULT, msg);
+    enbs.push_back(&enb);
+  }
+  run_phase(PROC_S1_SETUP, enbs);
+  drain();
+  if (!report("s1-setup")) {
+    fprintf(stderr, "S1 Setup failed, not running any scenario\n");
+    return EXIT_FAILURE;
+  }
+
+  for (const char* scenario : scenarios) {
+    if (options_.scenario != "all" && options_.scenario != scenario) {
+      continue;
+    }
+    ok = run_scenario(scenario, first_ue) && ok;
+    first_ue += options_.ues;
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//------------------------------------------------------------------------------
+std::vector<Ue*> Benchmark::make_population(uint32_t first_ue)
+{
+  std::vector<Ue*> population;
+
+  for (uint32_t i = first_ue; i < first_ue + options_.ues; i++) {
+    population.push_back(&ues_[i]);
+  }
+  return population;
+}
+
+bool Benchmark::run_scenario(const std::string& name, uint32_t first_ue)
+{
+  std::vector<Ue*> ues = make_population(first_ue);
+  std::vector<Enb*> enbs;
+
+  for (auto& enb : enbs_) {
+    enbs.push_back(&enb);
+  }
+
+  if (name == "attach-storm") {
+    for (uint32_t round = 0; round < options_.rounds; round++) {
+      run_phase(PROC_ATTACH, ues);
+      run_phase(PROC_DETACH, ues);
+    }
+  } else if (name == "paging-storm") {
+    run_phase(PROC_ATTACH, ues);
+    run_phase(PROC_IDLE, ues);
+    for (uint32_t round = 0; round < options_.rounds; round++) {
+      run_phase(PROC_PAGING, ues);
+      run_phase(PROC_IDLE, ues);
+    }
+  } else if (name == "tau-churn") {
+    run_phase(PROC_ATTACH, ues);
+    run_phase(PROC_IDLE, ues);
+    for (uint32_t round = 0; round < options_.rounds; round++) {
+      run_phase(PROC_TAU, ues);
+    }
+  } else if (name == "s1-reset") {
+    run_phase(PROC_ATTACH, ues);
+    for (uint32_t round = 0; round < options_.rounds; round++) {
+      run_phase(PROC_S1_RESET, enbs);
+      run_phase(PROC_SERVICE_REQUEST, ues);
+    }
+  }
+  return report(name);
+}
+
+/*
+ * Runs one procedure for every actor that is able to, keeping at most
+ * options_.concurrency of them in flight. Actors whose procedure did not end
+ * within options_.timeout_ms count as failed.
+ */
+template<typename T>
+void Benchmark::run_phase(Procedure procedure, const std::vector<T*>& actors)
+{
+  const std::chrono::milliseconds timeout(options_.timeout_ms);
+  std::deque<T*> pending(actors.begin(), actors.end());
+  std::vector<T*> active;
+  Clock::time_point phase_start = Clock::now();
+
+  while (!pending.empty() || !active.empty()) {
+    while (!pending.empty() && active.size() < options_.concurrency) {
+      T* actor = pending.front();
+
+      pending.pop_front();
+      start(actor, procedure);
+      if (actor->procedure != PROC_NONE) active.push_back(actor);
+    }
+
+    MessageDef* msg = events.pop(std::chrono::milliseconds(10));
+    if (msg != nullptr) dispatch(msg);
+
+    Clock::time_point now = Clock::now();
+    for (size_t i = 0; i < active.size();) {
+      T* actor = active[i];
+
+      if (actor->procedure != PROC_NONE && now - actor->start > timeout) {
+        fail(actor);
+      }
+      if (actor->procedure == PROC_NONE) {
+        active[i] = active.back();
+        active.pop_back();
+      } else {
+        i++;
+      }
+    }
+  }
+  stats_[procedure].seconds +=
+    elapsed_ms(phase_start, Clock::now()) / 1000.0;
+
+  // Let the MME finish with the tail of this phase (e.g. the UE Context
+  // Release Complete) before the next phase touches the same UEs.
+  drain();
+}
+
+void Benchmark::drain()
+{
+  int idle_polls = 0;
+
+  while (idle_polls < 2) {
+    MessageDef* msg = events.pop(std::chrono::milliseconds(5));
+    if (msg != nullptr) {
+      dispatch(msg);
+      idle_polls = 0;
+    } else if (
+      itti_get_queue_depth(TASK_S1AP) == 0 &&
+      itti_get_queue_depth(TASK_MME_APP) == 0) {
+      idle_polls++;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+void Benchmark::start(Enb* enb, Procedure procedure)
+{
+  bstring pdu = nullptr;
+
+  switch (procedure) {
+    case PROC_S1_SETUP: pdu = enb_s1ap_s1_setup_request(&enb->cell); break;
+    case PROC_S1_RESET: pdu = enb_s1ap_reset_all(); break;
+    default: return;
+  }
+
+  enb->procedure = procedure;
+  enb->start = Clock::now();
+  enb->recorded = false;
+  if (pdu == nullptr) {
+    fail(enb);
+    return;
+  }
+  // Non UE associated signalling, stream 0
+  send_to_s1ap(enb, 0, pdu);
+}
+
+void Benchmark::start(Ue* ue, Procedure procedure)
+{
+  uint8_t nas[UE_NAS_MAX_PDU_SIZE];
+  size_t nas_len;
+  bstring pdu;
+
+  switch (procedure) {
+    case PROC_ATTACH:
+      if (ue->state != UE_DEREGISTERED) return;
+      break;
+    case PROC_DETACH:
+    case PROC_IDLE:
+      if (ue->state != UE_CONNECTED) return;
+      break;
+    case PROC_PAGING:
+    case PROC_SERVICE_REQUEST:
+    case PROC_TAU:
+      if (ue->state != UE_IDLE) return;
+      break;
+    default: return;
+  }
+
+  ue->procedure = procedure;
+  ue->start = Clock::now();
+  ue->recorded = false;
+
+  switch (procedure) {
+    case PROC_ATTACH:
+      nas_len = ue_nas_attach_request(ue->imsi, nas);
+      send_initial_ue_message(ue, nas, nas_len);
+      break;
+
+    case PROC_DETACH:
+      nas_len = ue_nas_detach_request(&ue->security, ue->guti, nas);
+      send_uplink_nas(ue, nas, nas_len);
+      break;
+
+    case PROC_IDLE:
+      pdu = enb_s1ap_ue_context_release_request(
+        ue->mme_ue_s1ap_id, ue->enb_ue_s1ap_id);
+      if (pdu == nullptr) {
+        fail(ue);
+        return;
+      }
+      send_to_s1ap(ue->enb, BENCH_UE_STREAM, pdu);
+      break;
+
+    case PROC_PAGING:
+      ue->paging_answered = false;
+      send_paging_trigger(ue);
+      break;
+
+    case PROC_SERVICE_REQUEST:
+      nas_len = ue_nas_service_request(&ue->security, nas);
+      send_initial_ue_message(ue, nas, nas_len);
+      break;
+
+    case PROC_TAU:
+      nas_len = ue_nas_periodic_tau_request(&ue->security, ue->guti, nas);
+      send_initial_ue_message(ue, nas, nas_len);
+      break;
+
+    default: break;
+  }
+}
+
+void Benchmark::record(Actor* actor, Procedure procedure)
+{
+  if (actor->recorded) return;
+  actor->recorded = true;
+  stats_[procedure].latencies_ms.push_back(
+    elapsed_ms(actor->start, Clock::now()));
+}
+
+void Benchmark::complete(Actor* actor, Procedure procedure)
+{
+  record(actor, procedure);
+  actor->procedure = PROC_NONE;
+}
+
+void Benchmark::fail(Enb* enb)
+{
+  if (enb->procedure == PROC_NONE) return;
+  stats_[enb->procedure].failed++;
+  enb->procedure = PROC_NONE;
+}
+
+void Benchmark::fail(Ue* ue)
+{
+  if (ue->procedure == PROC_NONE) return;
+  stats_[ue->procedure].failed++;
+  ue->procedure = PROC_NONE;
+  ue->state = UE_BROKEN;
+}
+
+//------------------------------------------------------------------------------
+void Benchmark::send_to_s1ap(const Enb* enb, uint16_t stream, bstring payload)
+{
+  MessageDef* msg = itti_alloc_new_message(TASK_SCTP, SCTP_DATA_IND);
+
+  SCTP_DATA_IND(msg).payload = payload;
+  SCTP_DATA_IND(msg).stream = stream;
+  SCTP_DATA_IND(msg).assoc_id = enb->assoc_id;
+  SCTP_DATA_IND(msg).instreams = BENCH_SCTP_STREAMS;
+  SCTP_DATA_IND(msg).outstreams = BENCH_SCTP_STREAMS;
+  itti_send_msg_to_task(TASK_S1AP, INSTANCE_DEFAULT, msg);
+}
+
+void Benchmark::send_initial_ue_message(
+  Ue* ue,
+  const uint8_t* nas,
+  size_t nas_len)
+{
+  // Idle UEs are identified by the S-TMSI from the RRC connection request
+  bool has_s_tmsi = ue->state == UE_IDLE;
+  bstring pdu = enb_s1ap_initial_ue_message(
+    &ue->enb->cell,
+    ue->enb_ue_s1ap_id,
+    nas,
+    nas_len,
+    has_s_tmsi,
+    ue->mme_code,
+    ue->m_tmsi);
+
+  if (pdu == nullptr) {
+    fail(ue);
+    return;
+  }
+  send_to_s1ap(ue->enb, BENCH_UE_STREAM, pdu);
+}
+
+void Benchmark::send_uplink_nas(Ue* ue, const uint8_t* nas, size_t nas_len)
+{
+  bstring pdu = enb_s1ap_uplink_nas_transport(
+    &ue->enb->cell, ue->mme_ue_s1ap_id, ue->enb_ue_s1ap_id, nas, nas_len);
+
+  if (pdu == nullptr) {
+    fail(ue);
+    return;
+  }
+  send_to_s1ap(ue->enb, BENCH_UE_STREAM, pdu);
+}
+
+void Benchmark::handle_sctp_data_req(const sctp_data_req_t* data_req)
+{
+  enb_s1ap_downlink_t dl;
+  Enb* enb = enb_by_assoc_id(data_req->assoc_id);
+  Ue* ue;
+
+  if (enb == nullptr) return;
+  if (enb_s1ap_decode_downlink(data_req->payload, &dl) != 0) {
+    fprintf(stderr, "Could not decode S1AP PDU for eNB %u\n", enb->index);
+    return;
+  }
+
+  switch (dl.procedure) {
+    case ENB_S1AP_S1_SETUP_RESPONSE:
+      if (enb->procedure == PROC_S1_SETUP) complete(enb, PROC_S1_SETUP);
+      break;
+
+    case ENB_S1AP_S1_SETUP_FAILURE: fail(enb); break;
+
+    case ENB_S1AP_DOWNLINK_NAS:
+      ue = ue_by_s1ap_id(&dl);
+      if (ue != nullptr) {
+        ue->mme_ue_s1ap_id = dl.mme_ue_s1ap_id;
+        ue_by_mme_id_[dl.mme_ue_s1ap_id] = ue;
+        handle_downlink_nas(ue, dl.nas_pdu);
+      }
+      break;
+
+    case ENB_S1AP_INITIAL_CONTEXT_SETUP_REQUEST:
+      ue = ue_by_s1ap_id(&dl);
+      if (ue != nullptr) {
+        ue->mme_ue_s1ap_id = dl.mme_ue_s1ap_id;
+        ue_by_mme_id_[dl.mme_ue_s1ap_id] = ue;
+        handle_initial_context_setup(ue, &dl);
+      }
+      break;
+
+    case ENB_S1AP_UE_CONTEXT_RELEASE_COMMAND:
+      ue = ue_by_s1ap_id(&dl);
+      if (ue != nullptr) handle_ue_context_release(ue);
+      break;
+
+    case ENB_S1AP_PAGING: handle_paging(enb, dl.paging_m_tmsi); break;
+
+    case ENB_S1AP_RESET_ACKNOWLEDGE: handle_reset_acknowledge(enb); break;
+
+    default: break;
+  }
+  enb_s1ap_downlink_free(&dl);
+}
+
+void Benchmark::handle_downlink_nas(Ue* ue, const_bstring nas_pdu)
+{
+  uint8_t nas[UE_NAS_MAX_PDU_SIZE];
+  size_t nas_len;
+  ue_nas_downlink_t dl;
+
+  if (
+    nas_pdu == nullptr ||
+    ue_nas_decode_downlink(
+      (const uint8_t*) bdata(nas_pdu), blength(nas_pdu), &dl) != 0) {
+    fail(ue);
+    return;
+  }
+
+  switch (dl.message_type) {
+    case UE_NAS_AUTHENTICATION_REQUEST:
+      ue->security.ksi = dl.ksi;
+      nas_len =
+        ue_nas_authentication_response(ue->xres, sizeof(ue->xres), nas);
+      send_uplink_nas(ue, nas, nas_len);
+      break;
+
+    case UE_NAS_SECURITY_MODE_COMMAND:
+      ue_nas_derive_keys(&ue->security, ue->kasme, dl.integrity_alg);
+      nas_len = ue_nas_security_mode_complete(&ue->security, nas);
+      send_uplink_nas(ue, nas, nas_len);
+      break;
+
+    case UE_NAS_TAU_ACCEPT:
+      // The MME releases the connection right after, which ends the TAU
+      if (ue->procedure == PROC_TAU) record(ue, PROC_TAU);
+      break;
+
+    case UE_NAS_ATTACH_REJECT:
+    case UE_NAS_AUTHENTICATION_REJECT:
+    case UE_NAS_TAU_REJECT:
+    case UE_NAS_SERVICE_REJECT: fail(ue); break;
+
+    default: break;
+  }
+}
+
+void Benchmark::handle_initial_context_setup(
+  Ue* ue,
+  const enb_s1ap_downlink_t* dl)
+{
+  uint8_t nas[UE_NAS_MAX_PDU_SIZE];
+  size_t nas_len;
+  ue_nas_downlink_t nas_dl;
+  bstring pdu = enb_s1ap_initial_context_setup_response(
+    ue->mme_ue_s1ap_id,
+    ue->enb_ue_s1ap_id,
+    dl->e_rab_id,
+    dl->nb_e_rabs,
+    ue->index + 1);
+
+  if (pdu == nullptr) {
+    fail(ue);
+    return;
+  }
+  send_to_s1ap(ue->enb, BENCH_UE_STREAM, pdu);
+
+  // Attach Accept rides on the E-RAB setup, Service Request has no NAS
+  if (dl->nas_pdu == nullptr) return;
+  if (
+    ue_nas_decode_downlink(
+      (const uint8_t*) bdata(dl->nas_pdu), blength(dl->nas_pdu), &nas_dl) !=
+      0 ||
+    nas_dl.message_type != UE_NAS_ATTACH_ACCEPT || !nas_dl.has_guti) {
+    fail(ue);
+    return;
+  }
+  memcpy(ue->guti, nas_dl.guti, sizeof(ue->guti));
+  ue->mme_code = nas_dl.mme_code;
+  ue->m_tmsi = nas_dl.m_tmsi;
+  ue_by_m_tmsi_[ue->m_tmsi] = ue;
+  if (dl->nb_e_rabs > 0) ue->ebi = dl->e_rab_id[0];
+
+  nas_len = ue_nas_attach_complete(&ue->security, ue->ebi, nas);
+  send_uplink_nas(ue, nas, nas_len);
+}
+
+void Benchmark::handle_ue_context_release(Ue* ue)
+{
+  bstring pdu = enb_s1ap_ue_context_release_complete(
+    ue->mme_ue_s1ap_id, ue->enb_ue_s1ap_id);
+
+  if (pdu != nullptr) send_to_s1ap(ue->enb, BENCH_UE_STREAM, pdu);
+  ue_by_mme_id_.erase(ue->mme_ue_s1ap_id);
+  ue->mme_ue_s1ap_id = INVALID_MME_UE_S1AP_ID;
+
+  switch (ue->procedure) {
+    case PROC_DETACH:
+      ue->state = UE_DEREGISTERED;
+      complete(ue, PROC_DETACH);
+      break;
+
+    case PROC_IDLE:
+    case PROC_TAU:
+      ue->state = UE_IDLE;
+      complete(ue, ue->procedure);
+      break;
+
+    case PROC_NONE:
+      if (ue->state == UE_CONNECTED) ue->state = UE_IDLE;
+      break;
+
+    default: fail(ue); break;
+  }
+}
+
+void Benchmark::handle_paging(const Enb* enb, uint32_t m_tmsi)
+{
+  uint8_t nas[UE_NAS_MAX_PDU_SIZE];
+  size_t nas_len;
+  auto it = ue_by_m_tmsi_.find(m_tmsi);
+
+  if (it == ue_by_m_tmsi_.end()) return;
+  Ue* ue = it->second;
+  // Paging goes to every eNB of the TAI list, only the camped one answers
+  if (
+    ue->procedure != PROC_PAGING || ue->enb != enb || ue->paging_answered) {
+    return;
+  }
+  ue->paging_answered = true;
+  nas_len = ue_nas_service_request(&ue->security, nas);
+  send_initial_ue_message(ue, nas, nas_len);
+}
+
+void Benchmark::handle_reset_acknowledge(Enb* enb)
+{
+  // The MME dropped every UE associated signalling connection of the eNB
+  for (auto& ue : ues_) {
+    if (ue.enb == enb && ue.state == UE_CONNECTED) {
+      ue_by_mme_id_.erase(ue.mme_ue_s1ap_id);
+      ue.mme_ue_s1ap_id = INVALID_MME_UE_S1AP_ID;
+      ue.state = UE_IDLE;
+    }
+  }
+  if (enb->procedure == PROC_S1_RESET) complete(enb, PROC_S1_RESET);
+}
+
+//------------------------------------------------------------------------------
+void Benchmark::handle_auth_info_req(const s6a_auth_info_req_t* air)
+{
+  Ue* ue = ue_by_imsi(air->imsi);
+  MessageDef* msg;
+
+  if (ue == nullptr) return;
+  msg = itti_alloc_new_message(TASK_S6A, S6A_AUTH_INFO_ANS);
+  s6a_auth_info_ans_t* aia = &msg->ittiMsg.s6a_auth_info_ans;
+  memset(aia, 0, sizeof(*aia));
+  memcpy(aia->imsi, air->imsi, air->imsi_length);
+  aia->imsi_length = air->imsi_length;
+  aia->result.present = S6A_RESULT_BASE;
+  aia->result.choice.base = DIAMETER_SUCCESS;
+  aia->auth_info.nb_of_vectors = 1;
+  eutran_vector_t* vector = &aia->auth_info.eutran_vector[0];
+  vector->xres.size = sizeof(ue->xres);
+  memcpy(vector->xres.data, ue->xres, sizeof(ue->xres));
+  memcpy(vector->kasme, ue->kasme, sizeof(ue->kasme));
+  IMSI_STRING_TO_IMSI64(ue->imsi, &msg->ittiMsgHeader.imsi);
+  itti_send_msg_to_task(TASK_MME_APP, INSTANCE_DEFAULT, msg);
+}
+
+void Benchmark::handle_update_location_req(
+  const s6a_update_location_req_t* ulr)
+{
+  MessageDef* msg = itti_alloc_new_message(TASK_S6A, S6A_UPDATE_LOCATION_ANS);
+  s6a_update_location_ans_t* ula = &msg->ittiMsg.s6a_update_location_ans;
+
+  memset(ula, 0, sizeof(*ula));
+  memcpy(ula->imsi, ulr->imsi, ulr->imsi_length);
+  ula->imsi_length = ulr->imsi_length;
+  ula->result.present = S6A_RESULT_BASE;
+  ula->result.choice.base = DIAMETER_SUCCESS;
+
+  subscription_data_t* data = &ula->subscription_data;
+  data->subscriber_status = SS_SERVICE_GRANTED;
+  data->access_restriction = ARD_HO_TO_NON_3GPP_NOT_ALLOWED;
+  data->access_mode = NAM_ONLY_PACKET;
+  data->rau_tau_timer = 10;
+  data->subscribed_ambr.br_ul = 200000000;
+  data->subscribed_ambr.br_dl = 100000000;
+  data->apn_config_profile.context_identifier = 1;
+  data->apn_config_profile.all_apn_conf_ind = ALL_APN_CONFIGURATIONS_INCLUDED;
+  data->apn_config_profile.nb_apns = 1;
+
+  apn_configuration_t* apn = &data->apn_config_profile.apn_configuration[0];
+  apn->context_identifier = 1;
+  apn->pdn_type = IPv4;
+  apn->service_selection_length = sizeof(BENCH_APN) - 1;
+  memcpy(apn->service_selection, BENCH_APN, sizeof(BENCH_APN) - 1);
+  apn->subscribed_qos.qci = 9;
+  apn->subscribed_qos.allocation_retention_priority.priority_level = 15;
+  apn->subscribed_qos.allocation_retention_priority.pre_emp_vulnerability =
+    (pre_emption_vulnerability_t) PRE_EMPTION_VULNERABILITY_ENABLED;
+  apn->subscribed_qos.allocation_retention_priority.pre_emp_capability =
+    (pre_emption_capability_t) PRE_EMPTION_CAPABILITY_DISABLED;
+  apn->ambr.br_ul = 200000000;
+  apn->ambr.br_dl = 100000000;
+
+  IMSI_STRING_TO_IMSI64(ula->imsi, &msg->ittiMsgHeader.imsi);
+  itti_send_msg_to_task(TASK_MME_APP, INSTANCE_DEFAULT, msg);
+}
+
+void Benchmark::handle_purge_ue_req(const s6a_purge_ue_req_t* pur)
+{
+  MessageDef* msg = itti_alloc_new_message(TASK_S6A, S6A_PURGE_UE_ANS);
+  s6a_purge_ue_ans_t* pua = &msg->ittiMsg.s6a_purge_ue_ans;
+
+  memset(pua, 0, sizeof(*pua));
+  memcpy(pua->imsi, pur->imsi, pur->imsi_length);
+  pua->imsi_length = pur->imsi_length;
+  pua->result.present = S6A_RESULT_BASE;
+  pua->result.choice.base = DIAMETER_SUCCESS;
+  IMSI_STRING_TO_IMSI64(pua->imsi, &msg->ittiMsgHeader.imsi);
+  itti_send_msg_to_task(TASK_MME_APP, INSTANCE_DEFAULT, msg);
+}
+
+void Benchmark::handle_create_session_req(
+  const itti_s11_create_session_request_t* csr)
+{
+  Ue* ue = ue_by_imsi((const char*) csr->imsi.digit);
+  MessageDef* msg;
+
+  if (ue == nullptr) return;
+  ue->mme_teid = csr->sender_fteid_for_cp.teid;
+  ue_by_teid_[ue->mme_teid] = ue;
+
+  msg = itti_alloc_new_message(TASK_SPGW, S11_CREATE_SESSION_RESPONSE);
+  itti_s11_create_session_response_t* csr_rsp =
+    &S11_CREATE_SESSION_RESPONSE(msg);
+  memset(csr_rsp, 0, sizeof(*csr_rsp));
+  csr_rsp->teid = ue->mme_teid;
+  csr_rsp->cause.cause_value = REQUEST_ACCEPTED;
+  csr_rsp->s11_sgw_fteid.ipv4 = 1;
+  csr_rsp->s11_sgw_fteid.interface_type = S11_SGW_GTP_C;
+  csr_rsp->s11_sgw_fteid.teid = next_sgw_teid_++;
+  csr_rsp->s11_sgw_fteid.ipv4_address.s_addr = htonl(0xc0a83c8e);
+  // Stands in for mobilityd: 10.128.0.0/9, one address per UE
+  csr_rsp->paa.pdn_type = IPv4;
+  csr_rsp->paa.ipv4_address.s_addr = htonl(0x0a800001 + ue->index);
+  csr_rsp->ambr.br_ul = 200000000;
+  csr_rsp->ambr.br_dl = 100000000;
+
+  bearer_context_created_t* bearer =
+    &csr_rsp->bearer_contexts_created.bearer_contexts[0];
+  csr_rsp->bearer_contexts_created.num_bearer_context = 1;
+  bearer->eps_bearer_id =
+    csr->bearer_contexts_to_be_created.bearer_contexts[0].eps_bearer_id;
+  bearer->cause.cause_value = REQUEST_ACCEPTED;
+  bearer->s1u_sgw_fteid.ipv4 = 1;
+  bearer->s1u_sgw_fteid.interface_type = S1_U_SGW_GTP_U;
+  bearer->s1u_sgw_fteid.teid = next_sgw_teid_++;
+  bearer->s1u_sgw_fteid.ipv4_address.s_addr = htonl(0xc0a83c8e);
+  csr_rsp->trxn = csr->trxn;
+
+  IMSI_STRING_TO_IMSI64(ue->imsi, &msg->ittiMsgHeader.imsi);
+  itti_send_msg_to_task(TASK_MME_APP, INSTANCE_DEFAULT, msg);
+}
+
+void Benchmark::handle_modify_bearer_req(
+  const itti_s11_modify_bearer_request_t* mbr)
+{
+  MessageDef* msg =
+    itti_alloc_new_message(TASK_SPGW, S11_MODIFY_BEARER_RESPONSE);
+  itti_s11_modify_bearer_response_t* mbr_rsp =
+    &S11_MODIFY_BEARER_RESPONSE(msg);
+
+  memset(mbr_rsp, 0, sizeof(*mbr_rsp));
+  mbr_rsp->teid = mbr->local_teid;
+  mbr_rsp->cause.cause_value = REQUEST_ACCEPTED;
+  mbr_rsp->trxn = mbr->trxn;
+  itti_send_msg_to_task(TASK_MME_APP, INSTANCE_DEFAULT, msg);
+
+  // The S1-U tunnel is being switched to the eNB: the UE is connected
+  auto it = ue_by_teid_.find(mbr->local_teid);
+  if (it == ue_by_teid_.end()) return;
+  Ue* ue = it->second;
+  switch (ue->procedure) {
+    case PROC_ATTACH:
+    case PROC_PAGING:
+    case PROC_SERVICE_REQUEST:
+      ue->state = UE_CONNECTED;
+      complete(ue, ue->procedure);
+      break;
+    default: break;
+  }
+}
+
+void Benchmark::handle_delete_session_req(
+  const itti_s11_delete_session_request_t* dsr)
+{
+  MessageDef* msg =
+    itti_alloc_new_message(TASK_SPGW, S11_DELETE_SESSION_RESPONSE);
+  itti_s11_delete_session_response_t* dsr_rsp =
+    &S11_DELETE_SESSION_RESPONSE(msg);
+
+  memset(dsr_rsp, 0, sizeof(*dsr_rsp));
+  dsr_rsp->teid = dsr->local_teid;
+  dsr_rsp->cause.cause_value = REQUEST_ACCEPTED;
+  dsr_rsp->lbi = dsr->lbi;
+  dsr_rsp->trxn = dsr->trxn;
+  itti_send_msg_to_task(TASK_MME_APP, INSTANCE_DEFAULT, msg);
+}
+
+void Benchmark::handle_release_access_bearers_req(
+  const itti_s11_release_access_bearers_request_t* rab)
+{
+  MessageDef* msg =
+    itti_alloc_new_message(TASK_SPGW, S11_RELEASE_ACCESS_BEARERS_RESPONSE);
+  itti_s11_release_access_bearers_response_t* rab_rsp =
+    &S11_RELEASE_ACCESS_BEARERS_RESPONSE(msg);
+
+  memset(rab_rsp, 0, sizeof(*rab_rsp));
+  rab_rsp->teid = rab->local_teid;
+  rab_rsp->cause.cause_value = REQUEST_ACCEPTED;
+  rab_rsp->trxn = rab->trxn;
+  itti_send_msg_to_task(TASK_MME_APP, INSTANCE_DEFAULT, msg);
+}
+
+// Downlink data for an idle UE, as the SPGW would signal it
+void Benchmark::send_paging_trigger(Ue* ue)
+{
+  MessageDef* msg = itti_alloc_new_message(TASK_SPGW, S11_PAGING_REQUEST);
+
+  memset(&S11_PAGING_REQUEST(msg), 0, sizeof(itti_s11_paging_request_t));
+  S11_PAGING_REQUEST(msg).imsi = strdup(ue->imsi);
+  IMSI_STRING_TO_IMSI64(ue->imsi, &msg->ittiMsgHeader.imsi);
+  itti_send_msg_to_task(TASK_MME_APP, INSTANCE_DEFAULT, msg);
+}
+
+//------------------------------------------------------------------------------
+void Benchmark::dispatch(MessageDef* msg)
+{
+  switch (ITTI_MSG_ID(msg)) {
+    case SCTP_DATA_REQ: handle_sctp_data_req(&SCTP_DATA_REQ(msg)); break;
+    case S6A_AUTH_INFO_REQ:
+      handle_auth_info_req(&msg->ittiMsg.s6a_auth_info_req);
+      break;
+    case S6A_UPDATE_LOCATION_REQ:
+      handle_update_location_req(&msg->ittiMsg.s6a_update_location_req);
+      break;
+    case S6A_PURGE_UE_REQ:
+      handle_purge_ue_req(&msg->ittiMsg.s6a_purge_ue_req);
+      break;
+    case S11_CREATE_SESSION_REQUEST:
+      handle_create_session_req(&S11_CREATE_SESSION_REQUEST(msg));
+      break;
+    case S11_MODIFY_BEARER_REQUEST:
+      handle_modify_bearer_req(&S11_MODIFY_BEARER_REQUEST(msg));
+      break;
+    case S11_DELETE_SESSION_REQUEST:
+      handle_delete_session_req(&S11_DELETE_SESSION_REQUEST(msg));
+      break;
+    case S11_RELEASE_ACCESS_BEARERS_REQUEST:
+      handle_release_access_bearers_req(
+        &S11_RELEASE_ACCESS_BEARERS_REQUEST(msg));
+      break;
+    default: break;
+  }
+  free_message(msg);
+}
+
+Ue* Benchmark::ue_by_imsi(const char* imsi)
+{
+  uint32_t index;
+
+  // IMSIs are generated as MCC MNC followed by the UE index
+  if (strnlen(imsi, IMSI_BCD_DIGITS_MAX + 1) != IMSI_BCD_DIGITS_MAX) {
+    return nullptr;
+  }
+  index = strtoul(imsi + 5, nullptr, 10);
+  if (index >= ues_.size()) return nullptr;
+  return &ues_[index];
+}
+
+Ue* Benchmark::ue_by_s1ap_id(const enb_s1ap_downlink_t* dl)
+{
+  if (
+    dl->has_enb_ue_s1ap_id && dl->enb_ue_s1ap_id >= 1 &&
+    dl->enb_ue_s1ap_id <= ues_.size()) {
+    return &ues_[dl->enb_ue_s1ap_id - 1];
+  }
+  if (dl->has_mme_ue_s1ap_id) {
+    auto it = ue_by_mme_id_.find(dl->mme_ue_s1ap_id);
+    if (it != ue_by_mme_id_.end()) return it->second;
+  }
+  return nullptr;
+}
+
+Enb* Benchmark::enb_by_assoc_id(sctp_assoc_id_t assoc_id)
+{
+  if (assoc_id < 1 || assoc_id > (sctp_assoc_id_t) enbs_.size()) {
+    return nullptr;
+  }
+  return &enbs_[assoc_id - 1];
+}
+
+//------------------------------------------------------------------------------
+double percentile(const std::vector<double>& sorted, double q)
+{
+  if (sorted.empty()) return 0;
+  size_t rank = (size_t) std::ceil(q * sorted.size());
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+bool Benchmark::report(const std::string& name)
+{
+  bool ok = true;
+
+  printf("\n%s\n", name.c_str());
+  printf(
+    "  %-16s %8s %7s %10s %9s %9s %9s\n",
+    "procedure",
+    "count",
+    "failed",
+    "proc/s",
+    "p50 ms",
+    "p99 ms",
+    "p999 ms");
+  for (int i = PROC_NONE + 1; i < PROC_MAX; i++) {
+    ProcedureStats* stats = &stats_[i];
+    std::vector<double>& latencies = stats->latencies_ms;
+
+    if (latencies.empty() && stats->failed == 0) continue;
+    std::sort(latencies.begin(), latencies.end());
+    double p99 = percentile(latencies, 0.99);
+    printf(
+      "  %-16s %8zu %7lu %10.1f %9.3f %9.3f %9.3f\n",
+      procedure_names[i],
+      latencies.size(),
+      (unsigned long) stats->failed,
+      stats->seconds > 0 ? latencies.size() / stats->seconds : 0.0,
+      percentile(latencies, 0.5),
+      p99,
+      percentile(latencies, 0.999));
+
+    if (stats->failed > 0) ok = false;
+    if (options_.max_p99_ms > 0 && p99 > options_.max_p99_ms) {
+      printf(
+        "  %s p99 %.3f ms is over the %.3f ms limit\n",
+        procedure_names[i],
+        p99,
+        options_.max_p99_ms);
+      ok = false;
+    }
+    *stats = ProcedureStats();
+  }
+  fflush(stdout);
+  return ok;
+}
+
+void usage(const char* exe)
+{
+  printf(
+    "Usage: %s [options]\n"
+    "  --scenario NAME     attach-storm, paging-storm, tau-churn, s1-reset "
+    "or all (default all)\n"
+    "  --enbs N            number of simulated eNBs (default 4)\n"
+    "  --ues N             UEs per scenario (default 1000)\n"
+    "  --concurrency N     procedures in flight (default 64)\n"
+    "  --rounds N          rounds per scenario (default 3)\n"
+    "  --timeout-ms N      per procedure timeout (default 5000)\n"
+    "  --max-p99-ms X      fail when a p99 latency is over X ms\n",
+    exe);
+}
+
+bool parse_options(int argc, char** argv, Options* options)
+{
+  static const struct option long_options[] = {
+    {"scenario", required_argument, nullptr, 's'},
+    {"enbs", required_argument, nullptr, 'e'},
+    {"ues", required_argument, nullptr, 'u'},
+    {"concurrency", required_argument, nullptr, 'c'},
+    {"rounds", required_argument, nullptr, 'r'},
+    {"timeout-ms", required_argument, nullptr, 't'},
+    {"max-p99-ms", required_argument, nullptr, 'p'},
+    {"help", no_argument, nullptr, 'h'},
+    {nullptr, 0, nullptr, 0},
+  };
+  int c;
+
+  while ((c = getopt_long(argc, argv, "h", long_options, nullptr)) != -1) {
+    switch (c) {
+      case 's': options->scenario = optarg; break;
+      case 'e': options->enbs = strtoul(optarg, nullptr, 10); break;
+      case 'u': options->ues = strtoul(optarg, nullptr, 10); break;
+      case 'c': options->concurrency = strtoul(optarg, nullptr, 10); break;
+      case 'r': options->rounds = strtoul(optarg, nullptr, 10); break;
+      case 't': options->timeout_ms = strtoul(optarg, nullptr, 10); break;
+      case 'p': options->max_p99_ms = strtod(optarg, nullptr); break;
+      default: return false;
+    }
+  }
+  if (
+    options->scenario != "all" && options->scenario != "attach-storm" &&
+    options->scenario != "paging-storm" && options->scenario != "tau-churn" &&
+    options->scenario != "s1-reset") {
+    return false;
+  }
+  // eNB IDs are 20 bits, eNB UE S1AP IDs 24 bits
+  return options->enbs > 0 && options->enbs < (1 << 20) && options->ues > 0 &&
+         options->ues * 4 < (1 << 24) && options->concurrency > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  int rc;
+
+  if (!parse_options(argc, argv, &options)) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (
+    OAILOG_INIT(
+      MME_CONFIG_STRING_MME_CONFIG, OAILOG_LEVEL_ERROR, MAX_LOG_PROTOS) !=
+    RETURNok)
+    return EXIT_FAILURE;
+  if (shared_log_init(MAX_LOG_PROTOS) != RETURNok) return EXIT_FAILURE;
+  if (mme_benchmark_itti_init() != RETURNok) return EXIT_FAILURE;
+
+  Benchmark benchmark(options);
+  if (benchmark.init() != RETURNok) return EXIT_FAILURE;
+  rc = benchmark.run();
+
+  // The MME tasks are still running, skip the static destructors
+  fflush(stdout);
+  _exit(rc);
+}
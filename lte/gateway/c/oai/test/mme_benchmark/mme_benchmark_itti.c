@@ -0,0 +1,45 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+
+/*! \file mme_benchmark_itti.c
+  \brief ITTI initialisation for the MME load generator.
+*/
+
+#include <stddef.h>
+
+#include "mme_benchmark_itti.h"
+
+#include "intertask_interface.h"
+#include "intertask_interface_init.h"
+
+//------------------------------------------------------------------------------
+int mme_benchmark_itti_init(void)
+{
+  return itti_init(
+    TASK_MAX,
+    THREAD_MAX,
+    MESSAGES_ID_MAX,
+    tasks_info,
+    messages_info,
+    NULL,
+    NULL);
+}
@@ -0,0 +1,328 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file ue_nas.c
+  \brief Minimal UE side EMM encoder/decoder used by the MME load generator.
+*/
+
+#include <string.h>
+
+#include "ue_nas.h"
+
+#include "3gpp_33.401.h"
+#include "secu_defs.h"
+#include "security_types.h"
+
+#define UE_NAS_EPS_MM_PD 0x07
+
+// Security header types, 3GPP TS 24.301 section 9.3.1
+#define UE_NAS_SECURITY_HEADER_INTEGRITY 0x1
+#define UE_NAS_SECURITY_HEADER_INTEGRITY_CIPHERED 0x2
+#define UE_NAS_SECURITY_HEADER_INTEGRITY_CIPHERED_NEW 0x4
+#define UE_NAS_SECURITY_HEADER_SERVICE_REQUEST 0xc
+
+// Security header + MAC + sequence number
+#define UE_NAS_PROTECTED_HEADER_LENGTH 6
+
+#define UE_NAS_GUTI_IEI 0x50
+
+static void ue_nas_mac(
+  const ue_nas_security_t *security,
+  const uint8_t *msg,
+  size_t len,
+  uint8_t mac[4])
+{
+  nas_stream_cipher_t stream_cipher;
+
+  stream_cipher.key = (uint8_t *) security->knas_int;
+  stream_cipher.key_length = sizeof(security->knas_int);
+  stream_cipher.count = security->ul_count;
+  stream_cipher.bearer = 0x00;
+  stream_cipher.direction = SECU_DIRECTION_UPLINK;
+  stream_cipher.message = (uint8_t *) msg;
+  stream_cipher.blength = len << 3;
+
+  switch (security->integrity_alg) {
+    case EIA1_128_ALG_ID: nas_stream_encrypt_eia1(&stream_cipher, mac); break;
+    case EIA2_128_ALG_ID: nas_stream_encrypt_eia2(&stream_cipher, mac); break;
+    default: memset(mac, 0, 4); break;
+  }
+}
+
+/*
+ * Wraps a plain EMM message in a security protected header. Ciphering is
+ * always EEA0, so the payload goes out as is.
+ */
+static size_t ue_nas_protect(
+  ue_nas_security_t *security,
+  uint8_t security_header_type,
+  const uint8_t *plain,
+  size_t plain_len,
+  uint8_t *buf)
+{
+  uint8_t mac[4];
+
+  buf[0] = (security_header_type << 4) | UE_NAS_EPS_MM_PD;
+  buf[5] = security->ul_count & 0xff;
+  memcpy(&buf[UE_NAS_PROTECTED_HEADER_LENGTH], plain, plain_len);
+
+  // The MAC covers the sequence number and the NAS message
+  ue_nas_mac(security, &buf[5], plain_len + 1, mac);
+  memcpy(&buf[1], mac, sizeof(mac));
+  security->ul_count++;
+
+  return plain_len + UE_NAS_PROTECTED_HEADER_LENGTH;
+}
+
+static void ue_nas_decode_attach_accept(
+  const uint8_t *msg,
+  size_t len,
+  ue_nas_downlink_t *dl)
+{
+  size_t i;
+  uint8_t iei;
+
+  // Message type, EPS attach result, T3412, TAI list (LV)
+  if (len < 5) return;
+  i = 5 + msg[4];
+  // ESM message container (LV-E)
+  if (i + 2 > len) return;
+  i += 2 + ((msg[i] << 8) | msg[i + 1]);
+
+  while (i < len) {
+    iei = msg[i];
+    if (iei == UE_NAS_GUTI_IEI) {
+      if (i + 2 + UE_NAS_GUTI_LENGTH > len || msg[i + 1] != UE_NAS_GUTI_LENGTH)
+        return;
+      memcpy(dl->guti, &msg[i + 2], UE_NAS_GUTI_LENGTH);
+      dl->mme_code = dl->guti[6];
+      dl->m_tmsi = (dl->guti[7] << 24) | (dl->guti[8] << 16) |
+                   (dl->guti[9] << 8) | dl->guti[10];
+      dl->has_guti = true;
+      return;
+    }
+    if (iei & 0x80) {
+      // Type 1 IE, IEI and value share one octet
+      i += 1;
+    } else if (iei == 0x13) {
+      // Location area identification
+      i += 6;
+    } else if (iei == 0x17 || iei == 0x53 || iei == 0x59) {
+      // T3402, EMM cause, T3423
+      i += 2;
+    } else {
+      if (i + 1 >= len) return;
+      i += 2 + msg[i + 1];
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+int ue_nas_decode_downlink(
+  const uint8_t *nas,
+  size_t len,
+  ue_nas_downlink_t *dl)
+{
+  const uint8_t *msg = nas;
+
+  memset(dl, 0, sizeof(*dl));
+  if (len < 2 || (nas[0] & 0x0f) != UE_NAS_EPS_MM_PD) return -1;
+
+  if (nas[0] >> 4) {
+    if (len < UE_NAS_PROTECTED_HEADER_LENGTH + 2) return -1;
+    msg += UE_NAS_PROTECTED_HEADER_LENGTH;
+    len -= UE_NAS_PROTECTED_HEADER_LENGTH;
+    if ((msg[0] & 0x0f) != UE_NAS_EPS_MM_PD) return -1;
+  }
+
+  dl->message_type = msg[1];
+  switch (dl->message_type) {
+    case UE_NAS_AUTHENTICATION_REQUEST:
+      if (len < 3) return -1;
+      dl->ksi = msg[2] & 0x07;
+      break;
+
+    case UE_NAS_SECURITY_MODE_COMMAND:
+      if (len < 3) return -1;
+      dl->integrity_alg = msg[2] & 0x07;
+      break;
+
+    case UE_NAS_ATTACH_ACCEPT:
+      ue_nas_decode_attach_accept(&msg[1], len - 1, dl);
+      break;
+
+    default: break;
+  }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+void ue_nas_derive_keys(
+  ue_nas_security_t *security,
+  const uint8_t *kasme,
+  uint8_t integrity_alg)
+{
+  security->integrity_alg = integrity_alg;
+  security->ul_count = 0;
+  derive_key_nas(NAS_INT_ALG, integrity_alg, kasme, security->knas_int);
+}
+
+//------------------------------------------------------------------------------
+size_t ue_nas_attach_request(const char *imsi, uint8_t *buf)
+{
+  size_t n_digits = strlen(imsi);
+  size_t n = 0;
+  size_t len_index;
+  size_t i;
+
+  buf[n++] = UE_NAS_EPS_MM_PD;
+  buf[n++] = UE_NAS_ATTACH_REQUEST;
+  // No key available (7), EPS attach (1)
+  buf[n++] = 0x71;
+
+  // EPS mobile identity: IMSI, TS 24.008 section 10.5.1.4
+  len_index = n++;
+  buf[n++] = ((imsi[0] - '0') << 4) | ((n_digits & 1) ? 0x08 : 0x00) | 0x01;
+  for (i = 1; i < n_digits; i += 2) {
+    buf[n++] = (imsi[i] - '0') |
+               ((i + 1 < n_digits) ? (imsi[i + 1] - '0') << 4 : 0xf0);
+  }
+  buf[len_index] = n - len_index - 1;
+
+  // UE network capability: EEA0, 128-EIA1, 128-EIA2
+  buf[n++] = 0x02;
+  buf[n++] = 0x80;
+  buf[n++] = 0x60;
+
+  // ESM message container: PDN connectivity request, IPv4, initial request
+  buf[n++] = 0x00;
+  buf[n++] = 0x04;
+  buf[n++] = 0x02;
+  buf[n++] = 0x01;
+  buf[n++] = 0xd0;
+  buf[n++] = 0x11;
+
+  return n;
+}
+
+//------------------------------------------------------------------------------
+size_t ue_nas_authentication_response(
+  const uint8_t *res,
+  size_t res_len,
+  uint8_t *buf)
+{
+  buf[0] = UE_NAS_EPS_MM_PD;
+  buf[1] = UE_NAS_AUTHENTICATION_RESPONSE;
+  buf[2] = res_len;
+  memcpy(&buf[3], res, res_len);
+  return res_len + 3;
+}
+
+//------------------------------------------------------------------------------
+size_t ue_nas_security_mode_complete(
+  ue_nas_security_t *security,
+  uint8_t *buf)
+{
+  const uint8_t plain[] = {UE_NAS_EPS_MM_PD, UE_NAS_SECURITY_MODE_COMPLETE};
+
+  return ue_nas_protect(
+    security,
+    UE_NAS_SECURITY_HEADER_INTEGRITY_CIPHERED_NEW,
+    plain,
+    sizeof(plain),
+    buf);
+}
+
+//------------------------------------------------------------------------------
+size_t ue_nas_attach_complete(
+  ue_nas_security_t *security,
+  uint8_t ebi,
+  uint8_t *buf)
+{
+  // ESM: Activate default EPS bearer context accept
+  const uint8_t plain[] = {
+    UE_NAS_EPS_MM_PD, UE_NAS_ATTACH_COMPLETE, 0x00, 0x03, (ebi << 4) | 0x02,
+    0x00,             0xc2};
+
+  return ue_nas_protect(
+    security,
+    UE_NAS_SECURITY_HEADER_INTEGRITY_CIPHERED,
+    plain,
+    sizeof(plain),
+    buf);
+}
+
+//------------------------------------------------------------------------------
+size_t ue_nas_service_request(ue_nas_security_t *security, uint8_t *buf)
+{
+  uint8_t mac[4];
+
+  buf[0] = (UE_NAS_SECURITY_HEADER_SERVICE_REQUEST << 4) | UE_NAS_EPS_MM_PD;
+  buf[1] = ((security->ksi & 0x07) << 5) | (security->ul_count & 0x1f);
+  // Short MAC: two least significant octets of the MAC over the first two
+  ue_nas_mac(security, buf, 2, mac);
+  buf[2] = mac[2];
+  buf[3] = mac[3];
+  security->ul_count++;
+  return 4;
+}
+
+//------------------------------------------------------------------------------
+size_t ue_nas_periodic_tau_request(
+  ue_nas_security_t *security,
+  const uint8_t *guti,
+  uint8_t *buf)
+{
+  uint8_t plain[4 + UE_NAS_GUTI_LENGTH];
+
+  plain[0] = UE_NAS_EPS_MM_PD;
+  plain[1] = UE_NAS_TAU_REQUEST;
+  // Native KSI, periodic updating without active flag
+  plain[2] = ((security->ksi & 0x07) << 4) | 0x03;
+  plain[3] = UE_NAS_GUTI_LENGTH;
+  memcpy(&plain[4], guti, UE_NAS_GUTI_LENGTH);
+
+  return ue_nas_protect(
+    security, UE_NAS_SECURITY_HEADER_INTEGRITY, plain, sizeof(plain), buf);
+}
+
+//------------------------------------------------------------------------------
+size_t ue_nas_detach_request(
+  ue_nas_security_t *security,
+  const uint8_t *guti,
+  uint8_t *buf)
+{
+  uint8_t plain[4 + UE_NAS_GUTI_LENGTH];
+
+  plain[0] = UE_NAS_EPS_MM_PD;
+  plain[1] = UE_NAS_DETACH_REQUEST;
+  // Native KSI, switch off, EPS detach
+  plain[2] = ((security->ksi & 0x07) << 4) | 0x09;
+  plain[3] = UE_NAS_GUTI_LENGTH;
+  memcpy(&plain[4], guti, UE_NAS_GUTI_LENGTH);
+
+  return ue_nas_protect(
+    security,
+    UE_NAS_SECURITY_HEADER_INTEGRITY_CIPHERED,
+    plain,
+    sizeof(plain),
+    buf);
+}
@@ -0,0 +1,125 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file ue_nas.h
+  \brief Minimal UE side EMM encoder/decoder used by the MME load generator.
+
+  Only the messages needed to walk a UE through attach, idle, paging,
+  periodic TAU and detach are supported. Messages are hand encoded so that
+  the load generator does not share (and hide bugs in) the MME NAS codec.
+  Ciphering is always EEA0; integrity uses whichever of EIA1/EIA2 the MME
+  selects in Security Mode Command.
+*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define UE_NAS_MAX_PDU_SIZE 128
+#define UE_NAS_GUTI_LENGTH 11
+
+// EMM message types, 3GPP TS 24.301 table 9.8.1
+#define UE_NAS_ATTACH_REQUEST 0x41
+#define UE_NAS_ATTACH_ACCEPT 0x42
+#define UE_NAS_ATTACH_COMPLETE 0x43
+#define UE_NAS_ATTACH_REJECT 0x44
+#define UE_NAS_DETACH_REQUEST 0x45
+#define UE_NAS_DETACH_ACCEPT 0x46
+#define UE_NAS_TAU_REQUEST 0x48
+#define UE_NAS_TAU_ACCEPT 0x49
+#define UE_NAS_TAU_REJECT 0x4b
+#define UE_NAS_SERVICE_REJECT 0x4e
+#define UE_NAS_AUTHENTICATION_REQUEST 0x52
+#define UE_NAS_AUTHENTICATION_RESPONSE 0x53
+#define UE_NAS_AUTHENTICATION_REJECT 0x54
+#define UE_NAS_SECURITY_MODE_COMMAND 0x5d
+#define UE_NAS_SECURITY_MODE_COMPLETE 0x5e
+#define UE_NAS_SECURITY_MODE_REJECT 0x5f
+
+typedef struct ue_nas_security_s {
+  uint8_t ksi;
+  uint8_t integrity_alg;
+  uint8_t knas_int[16];
+  uint32_t ul_count;
+} ue_nas_security_t;
+
+typedef struct ue_nas_downlink_s {
+  uint8_t message_type;
+  uint8_t ksi;           // Authentication Request
+  uint8_t integrity_alg; // Security Mode Command
+  bool has_guti;         // Attach Accept
+  uint8_t guti[UE_NAS_GUTI_LENGTH];
+  uint8_t mme_code;
+  uint32_t m_tmsi;
+} ue_nas_downlink_t;
+
+int ue_nas_decode_downlink(
+  const uint8_t *nas,
+  size_t len,
+  ue_nas_downlink_t *dl);
+
+void ue_nas_derive_keys(
+  ue_nas_security_t *security,
+  const uint8_t *kasme,
+  uint8_t integrity_alg);
+
+/*
+ * Encoders below write into buf, which must hold UE_NAS_MAX_PDU_SIZE bytes,
+ * and return the encoded length. Protected messages consume one uplink
+ * NAS COUNT.
+ */
+size_t ue_nas_attach_request(const char *imsi, uint8_t *buf);
+
+size_t ue_nas_authentication_response(
+  const uint8_t *res,
+  size_t res_len,
+  uint8_t *buf);
+
+size_t ue_nas_security_mode_complete(
+  ue_nas_security_t *security,
+  uint8_t *buf);
+
+size_t ue_nas_attach_complete(
+  ue_nas_security_t *security,
+  uint8_t ebi,
+  uint8_t *buf);
+
+size_t ue_nas_service_request(ue_nas_security_t *security, uint8_t *buf);
+
+size_t ue_nas_periodic_tau_request(
+  ue_nas_security_t *security,
+  const uint8_t *guti,
+  uint8_t *buf);
+
+size_t ue_nas_detach_request(
+  ue_nas_security_t *security,
+  const uint8_t *guti,
+  uint8_t *buf);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,238 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sharded_state_writer.h"
+
+using ::testing::Test;
+using magma::lte::ShardedStateWriter;
+
+namespace {
+
+/*
+ * What the shards of one writer applied, in the order they applied it. A
+ * write of "block" holds its shard until release() is called, so that the
+ * writes queued meanwhile stay pending.
+ */
+class Recorder {
+ public:
+  void apply(const std::string& key, const std::string* value)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (value != nullptr) {
+      log_.push_back("write " + *value + " " + key);
+      state_[key] = *value;
+    } else {
+      log_.push_back("clear " + key);
+      state_.erase(key);
+    }
+    if (key == "block") {
+      blocked_ = true;
+      cv_.notify_all();
+      cv_.wait(lock, [this]() { return released_; });
+    }
+  }
+
+  void wait_blocked()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return blocked_; });
+  }
+
+  void release()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    released_ = true;
+    cv_.notify_all();
+  }
+
+  std::vector<std::string> get_log()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_;
+  }
+
+  std::map<std::string, std::string> get_state()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<std::string> log_;
+  std::map<std::string, std::string> state_;
+  bool blocked_ = false;
+  bool released_ = false;
+};
+
+class RecorderStore : public ShardedStateWriter::Store {
+ public:
+  explicit RecorderStore(std::shared_ptr<Recorder> recorder):
+    recorder_(recorder)
+  {
+  }
+
+  int write(const std::string& key, const std::string& value) override
+  {
+    // As slow as a redis round trip, so that writes pile up behind it
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    recorder_->apply(key, &value);
+    return 0;
+  }
+
+  int clear(const std::string& key) override
+  {
+    recorder_->apply(key, nullptr);
+    return 0;
+  }
+
+ private:
+  std::shared_ptr<Recorder> recorder_;
+};
+
+class ShardedStateWriterTest : public Test {
+ protected:
+  std::unique_ptr<ShardedStateWriter> make_writer(uint32_t num_shards)
+  {
+    auto recorder = recorder_;
+    return std::make_unique<ShardedStateWriter>(num_shards, [recorder]() {
+      return std::unique_ptr<ShardedStateWriter::Store>(
+        new RecorderStore(recorder));
+    });
+  }
+
+  std::vector<std::string> get_log_of(const std::string& prefix)
+  {
+    std::vector<std::string> filtered;
+    for (const auto& entry : recorder_->get_log()) {
+      if (entry.find(" " + prefix) != std::string::npos) {
+        filtered.push_back(entry);
+      }
+    }
+    return filtered;
+  }
+
+  std::shared_ptr<Recorder> recorder_ = std::make_shared<Recorder>();
+};
+
+TEST_F(ShardedStateWriterTest, TestKeepsOrderOfAShardKey)
+{
+  auto writer = make_writer(4);
+  std::vector<std::string> expected;
+
+  for (int i = 0; i < 50; i++) {
+    auto key = "ue1_" + std::to_string(i);
+    writer->write(1, key, "v");
+    writer->write(2, "ue2_" + std::to_string(i), "v");
+    expected.push_back("write v " + key);
+  }
+  writer->flush();
+
+  EXPECT_EQ(expected, get_log_of("ue1_"));
+  EXPECT_EQ(50, get_log_of("ue2_").size());
+}
+
+TEST_F(ShardedStateWriterTest, TestCoalescesPendingWrites)
+{
+  auto writer = make_writer(1);
+
+  writer->write(1, "block", "x");
+  recorder_->wait_blocked();
+  writer->write(1, "ue", "1");
+  writer->write(1, "ue", "2");
+  writer->write(1, "ue", "3");
+  recorder_->release();
+  writer->flush();
+
+  std::vector<std::string> expected = {"write x block", "write 3 ue"};
+  EXPECT_EQ(expected, recorder_->get_log());
+  EXPECT_EQ("3", recorder_->get_state()["ue"]);
+}
+
+TEST_F(ShardedStateWriterTest, TestClearsAfterWrite)
+{
+  auto writer = make_writer(1);
+
+  // Applied one after the other
+  writer->write(1, "ue1", "1");
+  writer->flush();
+  writer->clear(1, "ue1");
+  writer->flush();
+
+  // Coalesced while pending, the clear wins
+  writer->write(1, "block", "x");
+  recorder_->wait_blocked();
+  writer->write(1, "ue2", "1");
+  writer->clear(1, "ue2");
+  recorder_->release();
+  writer->flush();
+
+  std::vector<std::string> expected = {
+    "write 1 ue1", "clear ue1", "write x block", "clear ue2"};
+  EXPECT_EQ(expected, recorder_->get_log());
+  EXPECT_EQ(0, recorder_->get_state().count("ue1"));
+  EXPECT_EQ(0, recorder_->get_state().count("ue2"));
+}
+
+TEST_F(ShardedStateWriterTest, TestWritesAfterClear)
+{
+  auto writer = make_writer(1);
+
+  writer->write(1, "ue", "1");
+  writer->clear(1, "ue");
+  writer->write(1, "ue", "2");
+  writer->flush();
+
+  EXPECT_EQ("2", recorder_->get_state()["ue"]);
+}
+
+TEST_F(ShardedStateWriterTest, TestFlushesOnShutdown)
+{
+  auto writer = make_writer(4);
+
+  for (int i = 0; i < 200; i++) {
+    writer->write(i, "ue" + std::to_string(i), std::to_string(i));
+  }
+  writer.reset();
+
+  auto state = recorder_->get_state();
+  EXPECT_EQ(200, state.size());
+  EXPECT_EQ("199", state["ue199"]);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -57,6 +57,30 @@ TEST_F(Test, TestMetricsRegistry)
   EXPECT_EQ(registry.SizeMetrics(), 4);
 }
 
+// Tests the MetricsRegistry removes metrics and recreates them on demand
+TEST_F(Test, TestMetricsRegistryRemove)
+{
+  auto prometheus_registry = std::make_shared<Registry>();
+  auto registry = MetricsRegistry<prometheus::Counter, CounterBuilder (&)()>(
+    prometheus_registry, BuildCounter);
+  registry.Get("test", {{"key", "value1"}});
+  registry.Get("test", {{"key", "value2"}});
+  EXPECT_EQ(registry.SizeMetrics(), 2);
+
+  registry.Remove("test", {{"key", "value1"}});
+  EXPECT_EQ(registry.SizeFamilies(), 1);
+  EXPECT_EQ(registry.SizeMetrics(), 1);
+
+  // Removing an unknown timeseries does nothing
+  registry.Remove("test", {{"key", "value1"}});
+  registry.Remove("unknown", {});
+  EXPECT_EQ(registry.SizeMetrics(), 1);
+
+  // A removed timeseries is constructed again when it is next used
+  registry.Get("test", {{"key", "value1"}}).Increment();
+  EXPECT_EQ(registry.SizeMetrics(), 2);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
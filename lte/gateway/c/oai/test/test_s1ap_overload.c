@@ -0,0 +1,150 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the Apache License, Version 2.0  (the "License"); you may not use this file
+ * except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "bstrlib.h"
+#include "dynamic_memory_check.h"
+#include "hashtable.h"
+#include "intertask_interface.h"
+#include "intertask_interface_init.h"
+#include "mme_config.h"
+#include "s1ap_types.h"
+#include "s1ap_mme_handlers.h"
+
+#define TEST_ASSOC_ID 1
+
+static s1ap_state_t state;
+
+/*
+ * ITTI with MME_APP and SCTP marked ready but not running, so messages sent
+ * to them stay queued, and one S1 associated eNB to receive OVERLOAD START.
+ */
+static void setup(void)
+{
+  enb_description_t *enb = calloc(1, sizeof(enb_description_t));
+
+  ck_assert(
+    itti_init(
+      TASK_MAX,
+      THREAD_MAX,
+      MESSAGES_ID_MAX,
+      tasks_info,
+      messages_info,
+      NULL,
+      NULL) == 0);
+  itti_mark_task_ready(TASK_MME_APP);
+  itti_mark_task_ready(TASK_SCTP);
+
+  mme_config.overload_high_watermark = 80;
+  mme_config.overload_low_watermark = 50;
+
+  hashtable_ts_init(&state.enbs, 2, NULL, free_wrapper, bfromcstr("enbs"));
+  enb->enb_id = 1;
+  enb->sctp_assoc_id = TEST_ASSOC_ID;
+  enb->s1_state = S1AP_READY;
+  ck_assert(
+    hashtable_ts_insert(&state.enbs, (hash_key_t) enb->enb_id, enb) ==
+    HASH_TABLE_OK);
+}
+
+static void fill_mme_app_queue(MessagesIds message_id, uint32_t messages)
+{
+  uint32_t i;
+
+  for (i = 0; i < messages; i++) {
+    MessageDef *message = itti_alloc_new_message(TASK_S1AP, message_id);
+    ck_assert(
+      itti_send_msg_to_task(TASK_MME_APP, INSTANCE_DEFAULT, message) == 0);
+  }
+}
+
+START_TEST(overload_start_on_med_level_test)
+{
+  uint32_t size = itti_get_queue_size(TASK_MME_APP);
+  MessageDef *sent = NULL;
+
+  /*
+   * Only the MED level fills up: the HIGH and LOW levels stay empty, so the
+   * occupancy of the task as a whole is well under the high watermark.
+   */
+  fill_mme_app_queue(S1AP_INITIAL_UE_MESSAGE, size * 85 / 100);
+  ck_assert(
+    itti_get_queue_fullest_level_depth(TASK_MME_APP) == size * 85 / 100);
+  ck_assert(itti_get_queue_depth(TASK_SCTP) == 0);
+
+  s1ap_mme_update_overload_state(&state);
+
+  ck_assert(s1ap_mme_is_overloaded() == true);
+  ck_assert(itti_get_queue_depth(TASK_SCTP) == 1);
+  itti_receive_msg(TASK_SCTP, &sent);
+  ck_assert(ITTI_MSG_ID(sent) == SCTP_DATA_REQ);
+  ck_assert(SCTP_DATA_REQ(sent).assoc_id == TEST_ASSOC_ID);
+  ck_assert(blength(SCTP_DATA_REQ(sent).payload) > 0);
+}
+END_TEST
+
+START_TEST(no_overload_below_watermark_test)
+{
+  uint32_t size = itti_get_queue_size(TASK_MME_APP);
+
+  fill_mme_app_queue(S1AP_INITIAL_UE_MESSAGE, size * 70 / 100);
+
+  s1ap_mme_update_overload_state(&state);
+
+  ck_assert(s1ap_mme_is_overloaded() == false);
+  ck_assert(itti_get_queue_depth(TASK_SCTP) == 0);
+}
+END_TEST
+
+Suite *s1ap_overload_suite(void)
+{
+  Suite *s;
+  TCase *tc_core;
+
+  s = suite_create("S1AP overload tests");
+
+  /* Each test forks, so every one starts from a fresh ITTI */
+  tc_core = tcase_create("S1AP overload test");
+  tcase_add_checked_fixture(tc_core, setup, NULL);
+  tcase_add_test(tc_core, overload_start_on_med_level_test);
+  tcase_add_test(tc_core, no_overload_below_watermark_test);
+
+  suite_add_tcase(s, tc_core);
+
+  return s;
+}
+
+int main(void)
+{
+  int number_failed;
+  Suite *s;
+  SRunner *sr;
+
+  s = s1ap_overload_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -7,6 +7,8 @@
  * of patent rights can be found in the PATENTS file in the same directory.
  */
 
+#include <chrono>
+#include <cstdarg>
 #include <string>
 #include <time.h>
 #include <utility>
@@ -19,6 +21,7 @@
 
 #include "DiameterCodes.h"
 #include "LocalEnforcer.h"
+#include "MetricsSingleton.h"
 #include "ServiceRegistrySingleton.h"
 #include "magma_logging.h"
 
@@ -33,11 +36,42 @@ std::chrono::milliseconds time_difference_from_now(
   std::chrono::seconds sec(delta);
   return std::chrono::duration_cast<std::chrono::milliseconds>(sec);
 }
+
+const char* RESTART_SYNC_IN_PROGRESS = "session_restart_sync_in_progress";
+const char* RESTART_SYNC_SUBSCRIBERS = "session_restart_synced_subscribers";
+const char* RESTART_SYNC_DURATION = "session_restart_sync_duration_seconds";
+
+void set_restart_sync_gauge(
+    const char* name, double value, size_t n_labels, ...) {
+  va_list ap;
+  va_start(ap, n_labels);
+  magma::service303::MetricsSingleton::Instance().SetGauge(
+      name, value, n_labels, ap);
+  va_end(ap);
+}
+
+// A subscriber is passing traffic if one of its sessions is active and has
+// rules installed in pipelined
+bool has_active_data_path(
+    std::vector<std::unique_ptr<magma::SessionState>>& sessions) {
+  for (auto& session : sessions) {
+    if (session->get_state() != magma::SESSION_ACTIVE) {
+      continue;
+    }
+    std::vector<std::string> dynamic_rule_ids;
+    session->get_dynamic_rules().get_rule_ids(dynamic_rule_ids);
+    if (!session->get_static_rules().empty() || !dynamic_rule_ids.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
 }  // namespace
 
 namespace magma {
 
 uint32_t LocalEnforcer::REDIRECT_FLOW_PRIORITY = 2000;
+uint32_t LocalEnforcer::SESSION_SYNC_CHUNK_SIZE = 500;
 
 using google::protobuf::RepeatedPtrField;
 using google::protobuf::util::TimeUtil;
@@ -184,9 +218,66 @@ bool LocalEnforcer::setup(
 }
 
 void LocalEnforcer::sync_sessions_on_restart(std::time_t current_time) {
+  auto start = std::chrono::steady_clock::now();
   std::unordered_set<std::string> imsis_to_terminate;
+  SessionRead deferred_imsis;
+  uint64_t synced = 0;
+  bool success    = true;
+  set_restart_sync_gauge(RESTART_SYNC_IN_PROGRESS, 1, size_t(0));
+
+  // Subscribers passing traffic are synced while the store is still being
+  // scanned, the rest are re-read and synced afterwards
+  success &= session_store_.read_all_sessions_chunked(
+      SESSION_SYNC_CHUNK_SIZE, [&](SessionMap& chunk) {
+        SessionMap active;
+        for (auto& it : chunk) {
+          if (has_active_data_path(it.second)) {
+            active[it.first] = std::move(it.second);
+          } else {
+            deferred_imsis.insert(it.first);
+          }
+        }
+        success &= sync_session_chunk(active, current_time, imsis_to_terminate);
+        synced += active.size();
+        set_restart_sync_gauge(RESTART_SYNC_SUBSCRIBERS, synced, size_t(0));
+      });
+
+  SessionRead chunk_imsis;
+  for (auto it = deferred_imsis.begin(); it != deferred_imsis.end();) {
+    chunk_imsis.insert(*it++);
+    if (chunk_imsis.size() < SESSION_SYNC_CHUNK_SIZE &&
+        it != deferred_imsis.end()) {
+      continue;
+    }
+    auto chunk = session_store_.read_sessions(chunk_imsis);
+    success &= sync_session_chunk(chunk, current_time, imsis_to_terminate);
+    synced += chunk_imsis.size();
+    set_restart_sync_gauge(RESTART_SYNC_SUBSCRIBERS, synced, size_t(0));
+    chunk_imsis.clear();
+  }
 
-  auto session_map    = session_store_.read_all_sessions();
+  if (!imsis_to_terminate.empty()) {
+    schedule_termination(imsis_to_terminate);
+    MLOG(MDEBUG) << "Scheduling termination for one or more IMSIs";
+  }
+  std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+  set_restart_sync_gauge(RESTART_SYNC_IN_PROGRESS, 0, size_t(0));
+  set_restart_sync_gauge(RESTART_SYNC_DURATION, duration.count(), size_t(0));
+  if (success) {
+    MLOG(MINFO) << "Successfully synced " << synced << " subscribers after "
+                << "restart in " << duration.count() << " seconds";
+  } else {
+    MLOG(MERROR) << "Failed to sync sessions after restart";
+  }
+}
+
+bool LocalEnforcer::sync_session_chunk(
+    SessionMap& session_map, std::time_t current_time,
+    std::unordered_set<std::string>& imsis_to_terminate) {
+  if (session_map.empty()) {
+    return true;
+  }
   auto session_update = SessionStore::get_default_session_update(session_map);
   // Update the sessions so that their rules match the current timestamp
   for (auto& it : session_map) {
@@ -238,16 +329,7 @@ void LocalEnforcer::sync_sessions_on_restart(std::time_t current_time) {
       }
     }
   }
-  if (!imsis_to_terminate.empty()) {
-    schedule_termination(imsis_to_terminate);
-    MLOG(MDEBUG) << "Scheduling termination for one or more IMSIs";
-  }
-  bool success = session_store_.update_sessions(session_update);
-  if (success) {
-    MLOG(MDEBUG) << "Successfully synced sessions after restart";
-  } else {
-    MLOG(MERROR) << "Failed to sync sessions after restart";
-  }
+  return session_store_.update_sessions(session_update);
 }
 
 void LocalEnforcer::aggregate_records(
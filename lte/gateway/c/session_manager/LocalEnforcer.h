@@ -74,6 +74,9 @@ class LocalEnforcer {
    * Updates rules to be activated/deactivated based on the current time.
    * Also schedules future rule activation and deactivation callbacks to run
    * on the event loop.
+   * Sessions are streamed from the SessionStore in chunks of
+   * SESSION_SYNC_CHUNK_SIZE subscribers. Subscribers with an active data path
+   * are synced as their chunk arrives, all others once the stream is done.
    */
   void sync_sessions_on_restart(std::time_t current_time);
 
@@ -224,6 +227,7 @@ class LocalEnforcer {
       std::function<void(SessionTerminateRequest)> on_termination_callback);
 
   static uint32_t REDIRECT_FLOW_PRIORITY;
+  static uint32_t SESSION_SYNC_CHUNK_SIZE;
 
  private:
   struct RulesToProcess {
@@ -248,6 +252,15 @@ class LocalEnforcer {
   std::chrono::seconds retry_timeout_;
 
  private:
+  /**
+   * Sync one chunk of sessions read on restart and write the result back to
+   * the SessionStore
+   * @return true if the SessionStore update succeeded
+   */
+  bool sync_session_chunk(
+      SessionMap& session_map, std::time_t current_time,
+      std::unordered_set<std::string>& imsis_to_terminate);
+
   /**
    * notify_new_report_for_sessions notifies all sessions that a new usage
    * report is going to be
@@ -47,6 +47,27 @@ SessionMap MemoryStoreClient::read_all_sessions() {
   return session_map;
 }
 
+bool MemoryStoreClient::read_all_sessions_chunked(
+    uint32_t chunk_size, std::function<void(SessionMap&)> on_chunk) {
+  auto session_map = SessionMap{};
+  for (auto& it : session_map_) {
+    auto sessions = std::vector<std::unique_ptr<SessionState>>{};
+    for (auto& stored_session : it.second) {
+      auto session = SessionState::unmarshal(stored_session, *rule_store_);
+      sessions.push_back(std::move(session));
+    }
+    session_map[it.first] = std::move(sessions);
+    if (session_map.size() >= chunk_size) {
+      on_chunk(session_map);
+      session_map.clear();
+    }
+  }
+  if (!session_map.empty()) {
+    on_chunk(session_map);
+  }
+  return true;
+}
+
 bool MemoryStoreClient::write_sessions(SessionMap session_map) {
   for (auto& it : session_map) {
     auto sessions = std::vector<StoredSessionState>{};
@@ -32,6 +32,9 @@ class MemoryStoreClient final : public StoreClient {
 
   SessionMap read_all_sessions();
 
+  bool read_all_sessions_chunked(
+      uint32_t chunk_size, std::function<void(SessionMap&)> on_chunk);
+
   bool write_sessions(SessionMap session_map);
 
  private:
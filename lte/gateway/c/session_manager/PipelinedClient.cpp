@@ -153,17 +153,68 @@ magma::UpdateSubscriberQuotaStateRequest create_subscriber_quota_state_req(
 
 namespace magma {
 
+AsyncPipelinedClient::AsyncPipelinedClient(
+  std::shared_ptr<grpc::Channel> channel,
+  uint32_t max_batch_size,
+  std::chrono::milliseconds batch_flush_interval):
+  stub_(Pipelined::NewStub(channel)),
+  max_batch_size_(max_batch_size),
+  batch_flush_interval_(batch_flush_interval),
+  batch_rpc_supported_(true),
+  batch_loop_running_(true)
+{
+}
+
 AsyncPipelinedClient::AsyncPipelinedClient(
   std::shared_ptr<grpc::Channel> channel):
-  stub_(Pipelined::NewStub(channel))
+  AsyncPipelinedClient(channel, 0, std::chrono::milliseconds(0))
+{
+}
+
+AsyncPipelinedClient::AsyncPipelinedClient(
+  uint32_t max_batch_size,
+  std::chrono::milliseconds batch_flush_interval):
+  AsyncPipelinedClient(
+    ServiceRegistrySingleton::Instance()->GetGrpcChannel(
+      "pipelined",
+      ServiceRegistrySingleton::LOCAL),
+    max_batch_size,
+    batch_flush_interval)
 {
 }
 
 AsyncPipelinedClient::AsyncPipelinedClient():
-  AsyncPipelinedClient(ServiceRegistrySingleton::Instance()->GetGrpcChannel(
-    "pipelined",
-    ServiceRegistrySingleton::LOCAL))
+  AsyncPipelinedClient(0, std::chrono::milliseconds(0))
+{
+}
+
+void AsyncPipelinedClient::batch_flush_loop()
 {
+  if (max_batch_size_ <= 1) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(batch_mutex_);
+  while (batch_loop_running_) {
+    batch_cv_.wait_for(lock, batch_flush_interval_);
+    flush_pending_activations();
+    flush_pending_deactivations();
+  }
+}
+
+void AsyncPipelinedClient::stop_batch_flush_loop()
+{
+  {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    batch_loop_running_ = false;
+  }
+  batch_cv_.notify_all();
+}
+
+void AsyncPipelinedClient::flush_batches()
+{
+  std::lock_guard<std::mutex> lock(batch_mutex_);
+  flush_pending_activations();
+  flush_pending_deactivations();
 }
 
 bool AsyncPipelinedClient::setup_cwf(
@@ -202,7 +253,7 @@ bool AsyncPipelinedClient::deactivate_all_flows(const std::string& imsi)
   DeactivateFlowsRequest req;
   req.mutable_sid()->set_id(imsi);
   MLOG(MDEBUG) << "Deactivating all flows for subscriber " << imsi;
-  deactivate_flows_rpc(req, [imsi](Status status, DeactivateFlowsResult resp) {
+  queue_deactivation(req, [imsi](Status status, DeactivateFlowsResult resp) {
     if (!status.ok()) {
       MLOG(MERROR) << "Could not deactivate flows for subscriber " << imsi
                    << ": " << status.error_message();
@@ -222,7 +273,7 @@ bool AsyncPipelinedClient::deactivate_flows_for_rules(
   MLOG(MDEBUG) << "Deactivating " << rule_ids.size() << " static rules and "
                << dynamic_rules.size() << " dynamic rules for subscriber "
                << imsi;
-  deactivate_flows_rpc(req, [imsi](Status status, DeactivateFlowsResult resp) {
+  queue_deactivation(req, [imsi](Status status, DeactivateFlowsResult resp) {
     if (!status.ok()) {
       MLOG(MERROR) << "Could not deactivate flows for subscriber " << imsi
                    << ": " << status.error_message();
@@ -245,7 +296,7 @@ bool AsyncPipelinedClient::activate_flows_for_rules(
   auto static_req = create_activate_req(
     imsi, ip_addr, static_rules, std::vector<PolicyRule>(),
     RequestOriginType::GX);
-  activate_flows_rpc(static_req,
+  queue_activation(static_req,
     [imsi](Status status, ActivateFlowsResult resp) {
       if (!status.ok()) {
         MLOG(MERROR) << "Could not activate flows through pipelined for UE "
@@ -255,7 +306,7 @@ bool AsyncPipelinedClient::activate_flows_for_rules(
   auto dynamic_req = create_activate_req(
     imsi, ip_addr, std::vector<std::string>(), dynamic_rules,
     RequestOriginType::GX);
-  activate_flows_rpc(dynamic_req,
+  queue_activation(dynamic_req,
     [imsi](Status status, ActivateFlowsResult resp) {
       if (!status.ok()) {
         MLOG(MERROR) << "Could not activate flows through pipelined for UE "
@@ -355,7 +406,7 @@ bool AsyncPipelinedClient::add_gy_final_action_flow(
   auto static_req = create_activate_req(
     imsi, ip_addr, static_rules, std::vector<PolicyRule>(),
     RequestOriginType::GY);
-  activate_flows_rpc(static_req,
+  queue_activation(static_req,
     [imsi](Status status, ActivateFlowsResult resp) {
       if (!status.ok()) {
         MLOG(MERROR) << "Could not activate flows through pipelined for UE "
@@ -365,7 +416,7 @@ bool AsyncPipelinedClient::add_gy_final_action_flow(
   auto dynamic_req = create_activate_req(
     imsi, ip_addr,std::vector<std::string>(), dynamic_rules,
     RequestOriginType::GY);
-  activate_flows_rpc(dynamic_req,
+  queue_activation(dynamic_req,
     [imsi](Status status, ActivateFlowsResult resp) {
       if (!status.ok()) {
         MLOG(MERROR) << "Could not activate flows through pipelined for UE "
@@ -374,6 +425,208 @@ bool AsyncPipelinedClient::add_gy_final_action_flow(
   });
   return true;
 }
+void AsyncPipelinedClient::queue_activation(
+  const ActivateFlowsRequest& request,
+  ActivateCallback callback)
+{
+  if (max_batch_size_ <= 1) {
+    activate_flows_rpc(request, std::move(callback));
+    return;
+  }
+  std::lock_guard<std::mutex> lock(batch_mutex_);
+  // Keep activations and deactivations of a subscriber in the order they
+  // were requested
+  flush_pending_deactivations(request.sid().id());
+  pending_activations_.requests.push_back(request);
+  pending_activations_.callbacks.push_back(std::move(callback));
+  if (pending_activations_.requests.size() >= max_batch_size_) {
+    flush_pending_activations();
+  }
+}
+
+void AsyncPipelinedClient::queue_deactivation(
+  const DeactivateFlowsRequest& request,
+  DeactivateCallback callback)
+{
+  if (max_batch_size_ <= 1) {
+    deactivate_flows_rpc(request, std::move(callback));
+    return;
+  }
+  std::lock_guard<std::mutex> lock(batch_mutex_);
+  // Keep activations and deactivations of a subscriber in the order they
+  // were requested
+  flush_pending_activations(request.sid().id());
+  pending_deactivations_.requests.push_back(request);
+  pending_deactivations_.callbacks.push_back(std::move(callback));
+  if (pending_deactivations_.requests.size() >= max_batch_size_) {
+    flush_pending_deactivations();
+  }
+}
+
+void AsyncPipelinedClient::flush_pending_activations()
+{
+  if (pending_activations_.requests.empty()) {
+    return;
+  }
+  send_activations(
+    std::move(pending_activations_.requests),
+    std::move(pending_activations_.callbacks));
+  pending_activations_.requests.clear();
+  pending_activations_.callbacks.clear();
+}
+
+void AsyncPipelinedClient::flush_pending_deactivations()
+{
+  if (pending_deactivations_.requests.empty()) {
+    return;
+  }
+  send_deactivations(
+    std::move(pending_deactivations_.requests),
+    std::move(pending_deactivations_.callbacks));
+  pending_deactivations_.requests.clear();
+  pending_deactivations_.callbacks.clear();
+}
+
+void AsyncPipelinedClient::flush_pending_activations(const std::string& imsi)
+{
+  auto pending = take_pending(pending_activations_, imsi);
+  if (!pending.requests.empty()) {
+    send_activations(
+      std::move(pending.requests), std::move(pending.callbacks));
+  }
+}
+
+void AsyncPipelinedClient::flush_pending_deactivations(
+  const std::string& imsi)
+{
+  auto pending = take_pending(pending_deactivations_, imsi);
+  if (!pending.requests.empty()) {
+    send_deactivations(
+      std::move(pending.requests), std::move(pending.callbacks));
+  }
+}
+
+template<typename RequestType, typename CallbackType>
+AsyncPipelinedClient::PendingBatch<RequestType, CallbackType>
+AsyncPipelinedClient::take_pending(
+  PendingBatch<RequestType, CallbackType>& batch,
+  const std::string& imsi)
+{
+  PendingBatch<RequestType, CallbackType> taken;
+  size_t kept = 0;
+  for (size_t i = 0; i < batch.requests.size(); i++) {
+    if (batch.requests[i].sid().id() == imsi) {
+      taken.requests.push_back(std::move(batch.requests[i]));
+      taken.callbacks.push_back(std::move(batch.callbacks[i]));
+    } else {
+      if (kept != i) {
+        batch.requests[kept] = std::move(batch.requests[i]);
+        batch.callbacks[kept] = std::move(batch.callbacks[i]);
+      }
+      kept++;
+    }
+  }
+  batch.requests.resize(kept);
+  batch.callbacks.resize(kept);
+  return taken;
+}
+
+void AsyncPipelinedClient::send_activations(
+  std::vector<ActivateFlowsRequest> requests,
+  std::vector<ActivateCallback> callbacks)
+{
+  if (requests.size() == 1 || !batch_rpc_supported_) {
+    for (size_t i = 0; i < requests.size(); i++) {
+      activate_flows_rpc(requests[i], std::move(callbacks[i]));
+    }
+    return;
+  }
+  auto batch = std::make_shared<ActivateFlowsBatchRequest>();
+  for (auto& req : requests) {
+    batch->mutable_requests()->Add()->Swap(&req);
+  }
+  MLOG(MDEBUG) << "Sending " << batch->requests_size()
+               << " flow activations in one batch";
+  activate_flows_batch_rpc(*batch,
+    [this, batch, callbacks](Status status, ActivateFlowsBatchResult resp) {
+      if (status.error_code() == grpc::StatusCode::UNIMPLEMENTED) {
+        MLOG(MWARNING) << "Pipelined does not support batched activations, "
+                       << "sending one request per subscriber";
+        batch_rpc_supported_ = false;
+        for (int i = 0; i < batch->requests_size(); i++) {
+          activate_flows_rpc(batch->requests(i), callbacks[i]);
+        }
+        return;
+      }
+      for (size_t i = 0; i < callbacks.size(); i++) {
+        if (status.ok() && (int) i < resp.results_size()) {
+          callbacks[i](status, resp.results(i));
+        } else {
+          callbacks[i](status, ActivateFlowsResult());
+        }
+      }
+  });
+}
+
+void AsyncPipelinedClient::send_deactivations(
+  std::vector<DeactivateFlowsRequest> requests,
+  std::vector<DeactivateCallback> callbacks)
+{
+  if (requests.size() == 1 || !batch_rpc_supported_) {
+    for (size_t i = 0; i < requests.size(); i++) {
+      deactivate_flows_rpc(requests[i], std::move(callbacks[i]));
+    }
+    return;
+  }
+  auto batch = std::make_shared<DeactivateFlowsBatchRequest>();
+  for (auto& req : requests) {
+    batch->mutable_requests()->Add()->Swap(&req);
+  }
+  MLOG(MDEBUG) << "Sending " << batch->requests_size()
+               << " flow deactivations in one batch";
+  deactivate_flows_batch_rpc(*batch,
+    [this, batch, callbacks](Status status, DeactivateFlowsBatchResult resp) {
+      if (status.error_code() == grpc::StatusCode::UNIMPLEMENTED) {
+        MLOG(MWARNING) << "Pipelined does not support batched deactivations, "
+                       << "sending one request per subscriber";
+        batch_rpc_supported_ = false;
+        for (int i = 0; i < batch->requests_size(); i++) {
+          deactivate_flows_rpc(batch->requests(i), callbacks[i]);
+        }
+        return;
+      }
+      for (size_t i = 0; i < callbacks.size(); i++) {
+        if (status.ok() && (int) i < resp.results_size()) {
+          callbacks[i](status, resp.results(i));
+        } else {
+          callbacks[i](status, DeactivateFlowsResult());
+        }
+      }
+  });
+}
+
+void AsyncPipelinedClient::activate_flows_batch_rpc(
+  const ActivateFlowsBatchRequest& request,
+  std::function<void(Status, ActivateFlowsBatchResult)> callback)
+{
+  auto local_resp = new AsyncLocalResponse<ActivateFlowsBatchResult>(
+    std::move(callback), RESPONSE_TIMEOUT);
+  local_resp->set_response_reader(std::move(
+    stub_->AsyncActivateFlowsBatch(
+      local_resp->get_context(), request, &queue_)));
+}
+
+void AsyncPipelinedClient::deactivate_flows_batch_rpc(
+  const DeactivateFlowsBatchRequest& request,
+  std::function<void(Status, DeactivateFlowsBatchResult)> callback)
+{
+  auto local_resp = new AsyncLocalResponse<DeactivateFlowsBatchResult>(
+    std::move(callback), RESPONSE_TIMEOUT);
+  local_resp->set_response_reader(std::move(
+    stub_->AsyncDeactivateFlowsBatch(
+      local_resp->get_context(), request, &queue_)));
+}
+
 void AsyncPipelinedClient::deactivate_flows_rpc(
   const DeactivateFlowsRequest& request,
   std::function<void(Status, DeactivateFlowsResult)> callback)
@@ -8,6 +8,9 @@
  */
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <unordered_map>
 
@@ -139,6 +142,40 @@ class AsyncPipelinedClient : public GRPCReceiver, public PipelinedClient {
 
   AsyncPipelinedClient(std::shared_ptr<grpc::Channel> pipelined_channel);
 
+  /**
+   * Coalesce flow activations and deactivations for many subscribers into
+   * batched RPCs. A batch is sent once it holds max_batch_size requests or
+   * when batch_flush_loop next wakes up, whichever comes first.
+   * @param max_batch_size - requests per batch, 0 or 1 disables batching
+   * @param batch_flush_interval - longest time a request is held back
+   */
+  AsyncPipelinedClient(
+    uint32_t max_batch_size,
+    std::chrono::milliseconds batch_flush_interval);
+
+  AsyncPipelinedClient(
+    std::shared_ptr<grpc::Channel> pipelined_channel,
+    uint32_t max_batch_size,
+    std::chrono::milliseconds batch_flush_interval);
+
+  /**
+   * Send queued activations and deactivations every batch flush interval,
+   * blocks until stop_batch_flush_loop is called. Only needed when batching
+   * is enabled.
+   */
+  void batch_flush_loop();
+
+  /**
+   * Stop the batch flush loop, anything still queued is sent before the loop
+   * returns
+   */
+  void stop_batch_flush_loop();
+
+  /**
+   * Send all queued activations and deactivations now
+   */
+  void flush_batches();
+
   /**
    * Activates all rules for provided SessionInfos
    * @param infos - list of SessionInfos to setup flows for
@@ -236,9 +273,47 @@ class AsyncPipelinedClient : public GRPCReceiver, public PipelinedClient {
       Status status,
       FlowResponse resp);
 
+ protected:
+  using ActivateCallback = std::function<void(Status, ActivateFlowsResult)>;
+  using DeactivateCallback =
+    std::function<void(Status, DeactivateFlowsResult)>;
+
+  /**
+   * Send a request now, or queue it for the next batch when batching is
+   * enabled. The callback gets this request's own result out of the batch.
+   */
+  void queue_activation(
+    const ActivateFlowsRequest& request,
+    ActivateCallback callback);
+
+  void queue_deactivation(
+    const DeactivateFlowsRequest& request,
+    DeactivateCallback callback);
+
  private:
+  /**
+   * Requests waiting to be sent together, callbacks[i] belongs to requests[i]
+   */
+  template<typename RequestType, typename CallbackType>
+  struct PendingBatch {
+    std::vector<RequestType> requests;
+    std::vector<CallbackType> callbacks;
+  };
+
   static const uint32_t RESPONSE_TIMEOUT = 6; // seconds
   std::unique_ptr<Pipelined::Stub> stub_;
+  const uint32_t max_batch_size_;
+  const std::chrono::milliseconds batch_flush_interval_;
+  // Cleared once pipelined answers a batch RPC with UNIMPLEMENTED
+  std::atomic<bool> batch_rpc_supported_;
+  // Guards the pending batches and the flush loop state. Batches are sent
+  // while holding it so requests leave in the order they were queued.
+  std::mutex batch_mutex_;
+  std::condition_variable batch_cv_;
+  bool batch_loop_running_;
+  PendingBatch<ActivateFlowsRequest, ActivateCallback> pending_activations_;
+  PendingBatch<DeactivateFlowsRequest, DeactivateCallback>
+    pending_deactivations_;
 
  private:
   void setup_policy_rpc(
@@ -257,6 +332,38 @@ class AsyncPipelinedClient : public GRPCReceiver, public PipelinedClient {
     const ActivateFlowsRequest& request,
     std::function<void(Status, ActivateFlowsResult)> callback);
 
+  // The send_* and flush_* helpers expect batch_mutex_ to be held
+  void flush_pending_activations();
+
+  void flush_pending_deactivations();
+
+  // Sends only the pending requests of one subscriber, so a request queued
+  // for it on the other queue is not overtaken by them
+  void flush_pending_activations(const std::string& imsi);
+
+  void flush_pending_deactivations(const std::string& imsi);
+
+  template<typename RequestType, typename CallbackType>
+  static PendingBatch<RequestType, CallbackType> take_pending(
+    PendingBatch<RequestType, CallbackType>& batch,
+    const std::string& imsi);
+
+  void send_activations(
+    std::vector<ActivateFlowsRequest> requests,
+    std::vector<ActivateCallback> callbacks);
+
+  void send_deactivations(
+    std::vector<DeactivateFlowsRequest> requests,
+    std::vector<DeactivateCallback> callbacks);
+
+  void activate_flows_batch_rpc(
+    const ActivateFlowsBatchRequest& request,
+    std::function<void(Status, ActivateFlowsBatchResult)> callback);
+
+  void deactivate_flows_batch_rpc(
+    const DeactivateFlowsBatchRequest& request,
+    std::function<void(Status, DeactivateFlowsBatchResult)> callback);
+
   void add_ue_mac_flow_rpc(
     const UEMacFlowRequest& request,
     std::function<void(Status, FlowResponse)> callback);
@@ -7,6 +7,8 @@
  * of patent rights can be found in the PATENTS file in the same directory.
  */
 
+#include <future>
+
 #include "SessionState.h"
 #include "RedisStoreClient.h"
 #include "magma_logging.h"
@@ -14,10 +16,15 @@
 namespace magma {
 namespace lte {
 
+const uint32_t RedisStoreClient::read_all_chunk_size_ = 500;
+
 RedisStoreClient::RedisStoreClient(
     std::shared_ptr<cpp_redis::client> client, const std::string& redis_table,
-    std::shared_ptr<StaticRuleStore> rule_store)
-    : client_(client), redis_table_(redis_table), rule_store_(rule_store) {}
+    std::shared_ptr<StaticRuleStore> rule_store, uint32_t deserialize_workers)
+    : client_(client),
+      redis_table_(redis_table),
+      rule_store_(rule_store),
+      deserialize_workers_(std::max(deserialize_workers, 1u)) {}
 
 bool RedisStoreClient::try_redis_connect() {
   ServiceConfigLoader loader;
@@ -79,39 +86,56 @@ SessionMap RedisStoreClient::read_sessions(
 }
 
 SessionMap RedisStoreClient::read_all_sessions() {
+  SessionMap session_map;
+  auto success = read_all_sessions_chunked(
+      read_all_chunk_size_, [&session_map](SessionMap& chunk) {
+        for (auto& it : chunk) {
+          session_map[it.first] = std::move(it.second);
+        }
+      });
+  if (!success) {
+    MLOG(MERROR) << "unable to read all sessions from redis";
+  }
+  return session_map;
+}
+
+bool RedisStoreClient::read_all_sessions_chunked(
+    uint32_t chunk_size, std::function<void(SessionMap&)> on_chunk) {
   if (!client_->is_connected()) {
     auto connected = try_redis_connect();
     if (!connected) {
       throw RedisReadFailed();
     }
   }
-  SessionMap session_map;
-  auto hgetall_future = client_->hgetall(redis_table_);
-  client_->sync_commit();
-
-  auto reply = hgetall_future.get();
-  if (reply.is_error()) {
-    MLOG(MERROR) << "unable to read all sessions from redis";
-    return session_map;
-  }
-  auto array = reply.as_array();
-  for (int i = 0; i < array.size(); i += 2) {
-    auto key_reply = array[i];
-    if (!key_reply.is_string()) {
-      MLOG(MERROR) << "Non string key found in sessions from redis";
-      continue;
+  // HSCAN walks the table in small steps instead of blocking Redis on one
+  // HGETALL. The next chunk is requested before the current one is
+  // deserialized, so the round trip overlaps with the parsing. A key can be
+  // returned by more than one HSCAN step, so track what was already handed
+  // out.
+  std::unordered_set<std::string> seen_keys;
+  auto scan_future = client_->hscan(redis_table_, 0, chunk_size);
+  client_->commit();
+  while (true) {
+    auto reply = scan_future.get();
+    if (reply.is_error() || !reply.is_array() ||
+        reply.as_array().size() != 2 || !reply.as_array()[1].is_array()) {
+      MLOG(MERROR) << "RedisStoreClient: Unable to scan sessions";
+      return false;
     }
-    auto key         = key_reply.as_string();
-    auto value_reply = array[i + 1];
-    if (!value_reply.is_string()) {
-      MLOG(MERROR) << "RedisStoreClient: Unable to get value for key " << key;
-      session_map[key] = std::vector<std::unique_ptr<SessionState>>{};
-    } else {
-      session_map[key] =
-          std::move(deserialize_session_vec(value_reply.as_string()));
+    const auto& scan = reply.as_array();
+    auto cursor      = std::stoull(scan[0].as_string());
+    if (cursor != 0) {
+      scan_future = client_->hscan(redis_table_, cursor, chunk_size);
+      client_->commit();
+    }
+    auto session_map = deserialize_scan_chunk(scan[1].as_array(), seen_keys);
+    if (!session_map.empty()) {
+      on_chunk(session_map);
+    }
+    if (cursor == 0) {
+      return true;
     }
   }
-  return session_map;
 }
 
 bool RedisStoreClient::write_sessions(SessionMap session_map) {
@@ -179,5 +203,59 @@ RedisStoreClient::deserialize_session_vec(std::string serialized) {
   return session_vec;
 }
 
+SessionMap RedisStoreClient::deserialize_scan_chunk(
+    const std::vector<cpp_redis::reply>& fields,
+    std::unordered_set<std::string>& seen_keys) {
+  std::vector<std::string> keys;
+  std::vector<const std::string*> values;
+  for (size_t i = 0; i + 1 < fields.size(); i += 2) {
+    if (!fields[i].is_string()) {
+      MLOG(MERROR) << "Non string key found in sessions from redis";
+      continue;
+    }
+    auto key = fields[i].as_string();
+    if (!seen_keys.insert(key).second) {
+      continue;
+    }
+    keys.push_back(key);
+    if (fields[i + 1].is_string()) {
+      values.push_back(&fields[i + 1].as_string());
+    } else {
+      MLOG(MERROR) << "RedisStoreClient: Unable to get value for key " << key;
+      values.push_back(nullptr);
+    }
+  }
+
+  // Each worker takes every n-th entry so that no locking is needed
+  std::vector<std::vector<std::unique_ptr<SessionState>>> sessions(keys.size());
+  auto deserialize_every_nth = [this, &values, &sessions](
+                                   size_t first, size_t step) {
+    for (size_t i = first; i < values.size(); i += step) {
+      if (values[i] != nullptr) {
+        sessions[i] = deserialize_session_vec(*values[i]);
+      }
+    }
+  };
+  auto workers = std::min<size_t>(deserialize_workers_, keys.size());
+  if (workers <= 1) {
+    deserialize_every_nth(0, 1);
+  } else {
+    std::vector<std::future<void>> futures;
+    for (size_t w = 0; w < workers; w++) {
+      futures.push_back(
+          std::async(std::launch::async, deserialize_every_nth, w, workers));
+    }
+    for (auto&& fut : futures) {
+      fut.get();
+    }
+  }
+
+  SessionMap session_map;
+  for (size_t i = 0; i < keys.size(); i++) {
+    session_map[keys[i]] = std::move(sessions[i]);
+  }
+  return session_map;
+}
+
 }  // namespace lte
 }  // namespace magma
@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <unordered_set>
+
 #include <cpp_redis/cpp_redis>
 #include <folly/Format.h>
 #include <folly/dynamic.h>
@@ -36,9 +38,14 @@ class RedisWriteFailed : public std::exception {
  */
 class RedisStoreClient final : public StoreClient {
  public:
+  /**
+   * @param deserialize_workers Number of threads used to deserialize each
+   *        chunk read by read_all_sessions_chunked
+   */
   RedisStoreClient(
       std::shared_ptr<cpp_redis::client> client, const std::string& redis_table,
-      std::shared_ptr<StaticRuleStore> rule_store);
+      std::shared_ptr<StaticRuleStore> rule_store,
+      uint32_t deserialize_workers = 1);
 
   RedisStoreClient(RedisStoreClient const&) = delete;
   RedisStoreClient(RedisStoreClient&&)      = default;
@@ -50,12 +57,17 @@ class RedisStoreClient final : public StoreClient {
 
   SessionMap read_all_sessions();
 
+  bool read_all_sessions_chunked(
+      uint32_t chunk_size, std::function<void(SessionMap&)> on_chunk);
+
   bool write_sessions(SessionMap session_map);
 
  private:
   std::shared_ptr<cpp_redis::client> client_;
   std::string redis_table_;
   std::shared_ptr<StaticRuleStore> rule_store_;
+  uint32_t deserialize_workers_;
+  static const uint32_t read_all_chunk_size_;
 
  private:
   std::string serialize_session_vec(
@@ -63,6 +75,14 @@ class RedisStoreClient final : public StoreClient {
 
   std::vector<std::unique_ptr<SessionState>> deserialize_session_vec(
       std::string serialized);
+
+  /**
+   * Deserialize the field/value pairs of one HSCAN reply, skipping fields in
+   * seen_keys and adding the rest to it
+   */
+  SessionMap deserialize_scan_chunk(
+      const std::vector<cpp_redis::reply>& fields,
+      std::unordered_set<std::string>& seen_keys);
 };
 
 }  // namespace lte
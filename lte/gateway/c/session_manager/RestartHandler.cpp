@@ -90,8 +90,10 @@ void RestartHandler::cleanup_previous_sessions() {
 }
 
 void RestartHandler::setup_aaa_sessions() {
-  auto session_map = session_store_.read_all_sessions();
-  aaa_client_->add_sessions(session_map);
+  session_store_.read_all_sessions_chunked(
+      LocalEnforcer::SESSION_SYNC_CHUNK_SIZE, [this](SessionMap& chunk) {
+        aaa_client_->add_sessions(chunk);
+      });
 }
 
 void RestartHandler::terminate_previous_session(
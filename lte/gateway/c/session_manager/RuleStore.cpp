@@ -50,7 +50,7 @@ void PoliciesByKeyMap<KeyType, hash, equal>::remove(
 template<typename KeyType, typename hash, typename equal>
 bool PoliciesByKeyMap<KeyType, hash, equal>::get_rule_ids_for_key(
   const KeyType& key,
-  std::vector<std::string>& rules_out)
+  std::vector<std::string>& rules_out) const
 {
   auto iter = rules_by_key_.find(key);
   if (iter == rules_by_key_.end()) {
@@ -66,7 +66,7 @@ bool PoliciesByKeyMap<KeyType, hash, equal>::get_rule_ids_for_key(
 template<typename KeyType, typename hash, typename equal>
 bool PoliciesByKeyMap<KeyType, hash, equal>::get_rule_definitions_for_key(
   const KeyType& key,
-  std::vector<PolicyRule>& rules_out)
+  std::vector<PolicyRule>& rules_out) const
 {
   auto iter = rules_by_key_.find(key);
   if (iter == rules_by_key_.end()) {
@@ -80,7 +80,7 @@ bool PoliciesByKeyMap<KeyType, hash, equal>::get_rule_definitions_for_key(
 }
 
 template<typename KeyType, typename hash, typename equal>
-uint32_t PoliciesByKeyMap<KeyType, hash, equal>::policy_count()
+uint32_t PoliciesByKeyMap<KeyType, hash, equal>::policy_count() const
 {
   uint32_t count = 0;
   for (auto const& kv : rules_by_key_) {
@@ -101,44 +101,79 @@ static bool should_track_monitoring_key(PolicyRule::TrackingType tracking_type)
          tracking_type == PolicyRule::OCS_AND_PCRF;
 }
 
+void PolicyRuleBiMap::Snapshot::insert(std::shared_ptr<PolicyRule> rule_p)
+{
+  // replacing a rule must not leave the old definition behind in key maps
+  remove(rule_p->id());
+  rules_by_rule_id[rule_p->id()] = rule_p;
+  if (should_track_charging_key(rule_p->tracking_type())) {
+    rules_by_charging_key.insert(CreditKey(rule_p.get()), rule_p);
+  }
+  if (should_track_monitoring_key(rule_p->tracking_type())) {
+    rules_by_monitoring_key.insert(rule_p->monitoring_key(), rule_p);
+  }
+}
+
+void PolicyRuleBiMap::Snapshot::remove(const std::string& rule_id)
+{
+  auto it = rules_by_rule_id.find(rule_id);
+  if (it == rules_by_rule_id.end()) {
+    return;
+  }
+  auto rule_p = it->second;
+  rules_by_rule_id.erase(it);
+  if (should_track_charging_key(rule_p->tracking_type())) {
+    rules_by_charging_key.remove(CreditKey(rule_p.get()), rule_p);
+  }
+  if (should_track_monitoring_key(rule_p->tracking_type())) {
+    rules_by_monitoring_key.remove(rule_p->monitoring_key(), rule_p);
+  }
+}
+
+PolicyRuleBiMap::PolicyRuleBiMap():
+  snapshot_(std::make_shared<const Snapshot>())
+{
+}
+
 void PolicyRuleBiMap::sync_rules(const std::vector<PolicyRule>& rules)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  rules_by_rule_id_.clear();
-  rules_by_charging_key_ =
-    PoliciesByKeyMap<CreditKey, decltype(&ccHash), decltype(&ccEqual)>(
-      &ccHash, &ccEqual);
-  rules_by_monitoring_key_ = PoliciesByKeyMap<std::string>();
+  auto snapshot = std::make_shared<Snapshot>();
   for (const auto& rule : rules) {
-    auto rule_p = std::make_shared<PolicyRule>(rule);
-    rules_by_rule_id_[rule.id()] = rule_p;
-    if (should_track_charging_key(rule.tracking_type())) {
-      rules_by_charging_key_.insert(CreditKey(rule), rule_p);
-    }
-    if (should_track_monitoring_key(rule.tracking_type())) {
-      rules_by_monitoring_key_.insert(rule.monitoring_key(), rule_p);
-    }
+    snapshot->insert(std::make_shared<PolicyRule>(rule));
   }
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  snapshot_.store(std::move(snapshot));
 }
 
-void PolicyRuleBiMap::insert_rule(const PolicyRule& rule)
+void PolicyRuleBiMap::apply_changes(
+  const std::vector<PolicyRule>& updated_rules,
+  const std::vector<std::string>& removed_rule_ids)
 {
-  auto rule_p = std::make_shared<PolicyRule>(rule);
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  rules_by_rule_id_[rule.id()] = rule_p;
-  if (should_track_charging_key(rule.tracking_type())) {
-    rules_by_charging_key_.insert(CreditKey(rule), rule_p);
+  if (updated_rules.empty() && removed_rule_ids.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  // Rules are shared between snapshots, only the maps are copied
+  auto snapshot = std::make_shared<Snapshot>(*snapshot_.load());
+  for (const auto& rule_id : removed_rule_ids) {
+    snapshot->remove(rule_id);
   }
-  if (should_track_monitoring_key(rule.tracking_type())) {
-    rules_by_monitoring_key_.insert(rule.monitoring_key(), rule_p);
+  for (const auto& rule : updated_rules) {
+    snapshot->insert(std::make_shared<PolicyRule>(rule));
   }
+  snapshot_.store(std::move(snapshot));
+}
+
+void PolicyRuleBiMap::insert_rule(const PolicyRule& rule)
+{
+  apply_changes({rule}, {});
 }
 
 bool PolicyRuleBiMap::get_rule(const std::string& rule_id, PolicyRule* rule)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto it = rules_by_rule_id_.find(rule_id);
-  if (it == rules_by_rule_id_.end()) {
+  auto snapshot = snapshot_.load();
+  auto it = snapshot->rules_by_rule_id.find(rule_id);
+  if (it == snapshot->rules_by_rule_id.end()) {
     return false;
   }
   rule->CopyFrom(*it->second);
@@ -149,26 +184,20 @@ bool PolicyRuleBiMap::remove_rule(
   const std::string& rule_id,
   PolicyRule* rule_out)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto it = rules_by_rule_id_.find(rule_id);
-  if (it == rules_by_rule_id_.end()) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  auto current = snapshot_.load();
+  auto it = current->rules_by_rule_id.find(rule_id);
+  if (it == current->rules_by_rule_id.end()) {
     return false;
   }
-
-  auto rule_ptr = it->second;
   if (rule_out) {
-    rule_out->CopyFrom(*rule_ptr);
+    rule_out->CopyFrom(*it->second);
   }
 
   // Remove the rule from all mappings
-  rules_by_rule_id_.erase(it);
-  if (should_track_charging_key(rule_ptr->tracking_type())) {
-    rules_by_charging_key_.remove(CreditKey(rule_ptr.get()), rule_ptr);
-  }
-  if (should_track_monitoring_key(rule_ptr->tracking_type())) {
-    rules_by_monitoring_key_.remove(rule_ptr->monitoring_key(), rule_ptr);
-  }
-
+  auto snapshot = std::make_shared<Snapshot>(*current);
+  snapshot->remove(rule_id);
+  snapshot_.store(std::move(snapshot));
   return true;
 }
 
@@ -176,9 +205,9 @@ bool PolicyRuleBiMap::get_charging_key_for_rule_id(
   const std::string& rule_id,
   CreditKey* charging_key)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto it = rules_by_rule_id_.find(rule_id);
-  if (it == rules_by_rule_id_.end()) {
+  auto snapshot = snapshot_.load();
+  auto it = snapshot->rules_by_rule_id.find(rule_id);
+  if (it == snapshot->rules_by_rule_id.end()) {
     return false;
   }
   if (should_track_charging_key(it->second->tracking_type())) {
@@ -192,9 +221,9 @@ bool PolicyRuleBiMap::get_monitoring_key_for_rule_id(
   const std::string& rule_id,
   std::string* monitoring_key)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  auto it = rules_by_rule_id_.find(rule_id);
-  if (it == rules_by_rule_id_.end()) {
+  auto snapshot = snapshot_.load();
+  auto it = snapshot->rules_by_rule_id.find(rule_id);
+  if (it == snapshot->rules_by_rule_id.end()) {
     return false;
   }
   if (should_track_monitoring_key(it->second->tracking_type())) {
@@ -208,53 +237,45 @@ bool PolicyRuleBiMap::get_rule_ids_for_charging_key(
   const CreditKey& charging_key,
   std::vector<std::string>& rules_out)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  bool success =
-    rules_by_charging_key_.get_rule_ids_for_key(charging_key, rules_out);
-  return success;
+  return snapshot_.load()->rules_by_charging_key.get_rule_ids_for_key(
+    charging_key, rules_out);
 }
 
 bool PolicyRuleBiMap::get_rule_definitions_for_charging_key(
   const CreditKey& charging_key,
   std::vector<PolicyRule>& rules_out)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  bool success = rules_by_charging_key_.get_rule_definitions_for_key(
+  return snapshot_.load()->rules_by_charging_key.get_rule_definitions_for_key(
     charging_key, rules_out);
-  return success;
 }
 
 bool PolicyRuleBiMap::get_rule_ids_for_monitoring_key(
   const std::string& monitoring_key,
   std::vector<std::string>& rules_out)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  bool success =
-    rules_by_monitoring_key_.get_rule_ids_for_key(monitoring_key, rules_out);
-  return success;
+  return snapshot_.load()->rules_by_monitoring_key.get_rule_ids_for_key(
+    monitoring_key, rules_out);
 }
 
 bool PolicyRuleBiMap::get_rule_definitions_for_monitoring_key(
   const std::string& monitoring_key,
   std::vector<PolicyRule>& rules_out)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  bool success = rules_by_monitoring_key_.get_rule_definitions_for_key(
-    monitoring_key, rules_out);
-  return success;
+  return snapshot_.load()
+    ->rules_by_monitoring_key.get_rule_definitions_for_key(
+      monitoring_key, rules_out);
 }
 
 uint32_t PolicyRuleBiMap::monitored_rules_count()
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  return rules_by_monitoring_key_.policy_count();
+  return snapshot_.load()->rules_by_monitoring_key.policy_count();
 }
 
 bool PolicyRuleBiMap::get_rule_ids(
   std::vector<std::string>& rules_ids_out)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  for(auto kv : rules_by_rule_id_) {
+  auto snapshot = snapshot_.load();
+  for (const auto& kv : snapshot->rules_by_rule_id) {
     rules_ids_out.push_back(kv.first);
   }
   return true;
@@ -263,8 +284,8 @@ bool PolicyRuleBiMap::get_rule_ids(
 bool PolicyRuleBiMap::get_rules(
   std::vector<PolicyRule>& rules_out)
 {
-  std::lock_guard<std::mutex> lock(map_mutex_);
-  for(auto kv : rules_by_rule_id_) {
+  auto snapshot = snapshot_.load();
+  for (const auto& kv : snapshot->rules_by_rule_id) {
     rules_out.push_back(*kv.second);
   }
   return true;
@@ -8,9 +8,12 @@
  */
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
+#include <folly/concurrency/AtomicSharedPtr.h>
+
 #include <lte/protos/policydb.pb.h>
 #include <lte/protos/pipelined.grpc.pb.h>
 
@@ -36,15 +39,15 @@ class PoliciesByKeyMap {
 
   void remove(const KeyType& key, std::shared_ptr<PolicyRule> rule_p);
 
-  uint32_t policy_count();
+  uint32_t policy_count() const;
 
   bool get_rule_ids_for_key(
     const KeyType& key,
-    std::vector<std::string>& rules_out);
+    std::vector<std::string>& rules_out) const;
 
   bool get_rule_definitions_for_key(
     const KeyType& key,
-    std::vector<PolicyRule>& rules_out);
+    std::vector<PolicyRule>& rules_out) const;
 
  private:
   std::unordered_map<KeyType,
@@ -54,15 +57,26 @@ class PoliciesByKeyMap {
 /**
  * RuleChargingKeyMapper is a class for querying a bi-directional map of
  * rule_id <-> charging_key
+ *
+ * Readers never lock: every lookup works on an immutable snapshot of the
+ * maps, writers build a new snapshot and publish it atomically.
  */
 class PolicyRuleBiMap {
  public:
-  PolicyRuleBiMap() : rules_by_charging_key_(&ccHash, &ccEqual) {}
+  PolicyRuleBiMap();
   /**
    * Clear the maps and add in the given rules
    */
   virtual void sync_rules(const std::vector<PolicyRule>& rules);
 
+  /**
+   * Insert or replace updated_rules and remove rules with ids in
+   * removed_rule_ids, publishing all of the changes at once
+   */
+  virtual void apply_changes(
+    const std::vector<PolicyRule>& updated_rules,
+    const std::vector<std::string>& removed_rule_ids);
+
   virtual void insert_rule(const PolicyRule& rule);
 
   virtual bool get_rule(const std::string& rule_id, PolicyRule* rule);
@@ -116,16 +130,25 @@ class PolicyRuleBiMap {
   virtual bool get_rules(std::vector<PolicyRule>& rules_out);
 
  protected:
-  // guards all three maps below
-  std::mutex map_mutex_;
-  // rule_id -> PolicyRule
-  std::unordered_map<std::string, std::shared_ptr<PolicyRule>>
-    rules_by_rule_id_;
-  // charging key -> [PolicyRule]
-  PoliciesByKeyMap<CreditKey, decltype(&ccHash), decltype(&ccEqual)>
-    rules_by_charging_key_;
-  // monitoring key -> [PolicyRule]
-  PoliciesByKeyMap<std::string> rules_by_monitoring_key_;
+  struct Snapshot {
+    Snapshot() : rules_by_charging_key(&ccHash, &ccEqual) {}
+
+    void insert(std::shared_ptr<PolicyRule> rule_p);
+    void remove(const std::string& rule_id);
+
+    // rule_id -> PolicyRule
+    std::unordered_map<std::string, std::shared_ptr<PolicyRule>>
+      rules_by_rule_id;
+    // charging key -> [PolicyRule]
+    PoliciesByKeyMap<CreditKey, decltype(&ccHash), decltype(&ccEqual)>
+      rules_by_charging_key;
+    // monitoring key -> [PolicyRule]
+    PoliciesByKeyMap<std::string> rules_by_monitoring_key;
+  };
+
+  // serializes writers, which copy the current snapshot and publish a new one
+  std::mutex write_mutex_;
+  folly::atomic_shared_ptr<const Snapshot> snapshot_;
 };
 
 /**
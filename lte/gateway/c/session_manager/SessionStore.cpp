@@ -35,6 +35,11 @@ SessionMap SessionStore::read_all_sessions() {
   return store_client_->read_all_sessions();
 }
 
+bool SessionStore::read_all_sessions_chunked(
+    uint32_t chunk_size, std::function<void(SessionMap&)> on_chunk) {
+  return store_client_->read_all_sessions_chunked(chunk_size, on_chunk);
+}
+
 SessionMap SessionStore::read_sessions_for_reporting(const SessionRead& req) {
   auto session_map   = store_client_->read_sessions(req);
   auto session_map_2 = store_client_->read_sessions(req);
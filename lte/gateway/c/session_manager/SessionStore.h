@@ -72,6 +72,16 @@ class SessionStore {
    */
   SessionMap read_all_sessions();
 
+  /**
+   * Read the last written values for all existing sessions through the
+   * storage interface, one chunk of subscribers at a time.
+   * @param chunk_size number of subscribers per chunk
+   * @param on_chunk called with each chunk in the calling thread
+   * @return true if all sessions could be read
+   */
+  bool read_all_sessions_chunked(
+      uint32_t chunk_size, std::function<void(SessionMap&)> on_chunk);
+
   /**
    * Read the last written values for the requested sessions through the
    * storage interface. This also modifies the request_numbers stored before
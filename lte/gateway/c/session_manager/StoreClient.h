@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include <lte/protos/session_manager.grpc.pb.h>
@@ -45,6 +46,19 @@ class StoreClient {
    */
   virtual SessionMap read_all_sessions() = 0;
 
+  /**
+   * Directly read all subscriber sessions from storage, a chunk of
+   * subscribers at a time, so that the whole table is never held in memory.
+   * A subscriber is passed to on_chunk at most once.
+   *
+   * @param chunk_size Number of subscribers to read per chunk. Storage may
+   *        return slightly more or fewer.
+   * @param on_chunk Called with each chunk, in the calling thread
+   * @return True if every chunk was read successfully
+   */
+  virtual bool read_all_sessions_chunked(
+      uint32_t chunk_size, std::function<void(SessionMap&)> on_chunk) = 0;
+
   /**
    * Directly write the subscriber sessions into storage, overwriting previous
    * values.
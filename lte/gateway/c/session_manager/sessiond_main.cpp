@@ -33,6 +33,8 @@
 #define DEFAULT_USAGE_REPORTING_THRESHOLD 0.8
 #define DEFAULT_QUOTA_EXHAUSTION_TERMINATION_MS 30000 // 30sec
 #define DEFAULT_EXTRA_QUOTA_MARGIN 1024
+#define DEFAULT_PIPELINED_FLUSH_INTERVAL_MS 10
+#define DEFAULT_SESSION_SYNC_WORKERS 2
 
 #ifdef DEBUG
 extern "C" void __gcov_flush(void);
@@ -114,19 +116,39 @@ int main(int argc, char *argv[])
   auto rule_store = std::make_shared<magma::StaticRuleStore>();
   magma::PolicyLoader policy_loader;
   std::thread policy_loader_thread([&]() {
-    policy_loader.start_loop(
+    policy_loader.start_incremental_loop(
       [&](std::vector<magma::PolicyRule> rules) {
         rule_store->sync_rules(rules);
       },
+      [&](
+        std::vector<magma::PolicyRule> rules,
+        std::vector<std::string> removed_rule_ids) {
+        rule_store->apply_changes(rules, removed_rule_ids);
+      },
       config["rule_update_inteval_sec"].as<uint32_t>());
     policy_loader.stop();
   });
 
-  auto pipelined_client = std::make_shared<magma::AsyncPipelinedClient>();
+  uint32_t pipelined_batch_size = 0;
+  if (config["pipelined_max_batch_size"].IsDefined()) {
+    pipelined_batch_size = config["pipelined_max_batch_size"].as<uint32_t>();
+  }
+  uint32_t pipelined_flush_interval_ms = DEFAULT_PIPELINED_FLUSH_INTERVAL_MS;
+  if (config["pipelined_batch_flush_interval_ms"].IsDefined()) {
+    pipelined_flush_interval_ms =
+      config["pipelined_batch_flush_interval_ms"].as<uint32_t>();
+  }
+  auto pipelined_client = std::make_shared<magma::AsyncPipelinedClient>(
+    pipelined_batch_size,
+    std::chrono::milliseconds(pipelined_flush_interval_ms));
   std::thread rule_manager_thread([&]() {
     MLOG(MINFO) << "Started pipelined response thread";
     pipelined_client->rpc_response_loop();
   });
+  std::thread pipelined_batch_thread([&]() {
+    MLOG(MINFO) << "Started pipelined batch flush thread";
+    pipelined_client->batch_flush_loop();
+  });
 
   auto directoryd_client = std::make_shared<magma::AsyncDirectorydClient>();
   std::thread directoryd_thread([&]() {
@@ -193,6 +215,10 @@ int main(int argc, char *argv[])
   magma::SessionCredit::EXTRA_QUOTA_MARGIN = margin;
   magma::SessionCredit::TERMINATE_SERVICE_WHEN_QUOTA_EXHAUSTED =
    config["terminate_service_when_quota_exhausted"].as<bool>();
+  if (config["session_sync_chunk_size"].IsDefined()) {
+    magma::LocalEnforcer::SESSION_SYNC_CHUNK_SIZE =
+      config["session_sync_chunk_size"].as<uint32_t>();
+  }
 
   auto controller_channel = get_controller_channel(config,
     mconfig.relay_enabled());
@@ -217,10 +243,15 @@ int main(int argc, char *argv[])
   bool is_stateless = config["support_stateless"].IsDefined()
       && config["support_stateless"].as<bool>();
   if (is_stateless) {
+    uint32_t sync_workers = DEFAULT_SESSION_SYNC_WORKERS;
+    if (config["session_sync_workers"].IsDefined()) {
+      sync_workers = config["session_sync_workers"].as<uint32_t>();
+    }
     auto store_client = std::make_shared<magma::lte::RedisStoreClient>(
         std::make_shared<cpp_redis::client>(),
         config["sessions_table"].as<std::string>(),
-        rule_store);
+        rule_store,
+        sync_workers);
     bool connected;
     do {
       MLOG(MINFO) << "Attempting to connect to Redis";
@@ -285,11 +316,13 @@ int main(int argc, char *argv[])
   monitor->sync_sessions_on_restart(time(NULL));
   monitor->start();
   server.Stop();
+  pipelined_client->stop_batch_flush_loop();
 
   reporter_thread.join();
   local_thread.join();
   proxy_thread.join();
   rule_manager_thread.join();
+  pipelined_batch_thread.join();
   directoryd_thread.join();
   restart_handler_thread.join();
   policy_loader_thread.join();
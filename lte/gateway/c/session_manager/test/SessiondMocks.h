@@ -41,6 +41,10 @@ public:
     ON_CALL(*this, AddRule(_, _, _)).WillByDefault(Return(Status::OK));
     ON_CALL(*this, ActivateFlows(_, _, _)).WillByDefault(Return(Status::OK));
     ON_CALL(*this, DeactivateFlows(_, _, _)).WillByDefault(Return(Status::OK));
+    ON_CALL(*this, ActivateFlowsBatch(_, _, _))
+      .WillByDefault(Return(Status::OK));
+    ON_CALL(*this, DeactivateFlowsBatch(_, _, _))
+      .WillByDefault(Return(Status::OK));
   }
 
   MOCK_METHOD3(AddRule,
@@ -51,6 +55,13 @@ public:
   MOCK_METHOD3(DeactivateFlows,
                Status(grpc::ServerContext *, const DeactivateFlowsRequest *,
                       DeactivateFlowsResult *));
+  MOCK_METHOD3(ActivateFlowsBatch,
+               Status(grpc::ServerContext *, const ActivateFlowsBatchRequest *,
+                      ActivateFlowsBatchResult *));
+  MOCK_METHOD3(DeactivateFlowsBatch,
+               Status(grpc::ServerContext *,
+                      const DeactivateFlowsBatchRequest *,
+                      DeactivateFlowsBatchResult *));
 };
 
 class MockPipelinedClient : public PipelinedClient {
@@ -676,6 +676,66 @@ TEST_F(LocalEnforcerTest, test_sync_sessions_on_restart) {
   EXPECT_FALSE(session->is_dynamic_rule_installed("dynamic_rule4"));
 }
 
+// Subscribers passing traffic are synced while the store is scanned, the
+// others are re-read and synced afterwards. Both must end up synced.
+TEST_F(LocalEnforcerTest, test_sync_sessions_on_restart_deferred) {
+  const std::vector<std::string> imsis = {"IMSI1", "IMSI2", "IMSI3"};
+  const std::string session_id = "1234";
+  insert_static_rule(1, "", "rule1");
+  insert_static_rule(1, "", "rule2");
+
+  for (const auto& imsi : imsis) {
+    CreateSessionResponse response;
+    create_credit_update_response(imsi, 1, 1024, true,
+                                  response.mutable_credits()->Add());
+    local_enforcer->init_session_credit(session_map, imsi, session_id,
+                                        test_cfg, response);
+    bool success =
+        session_store->create_sessions(imsi, std::move(session_map[imsi]));
+    EXPECT_TRUE(success);
+  }
+
+  auto session_map_2 = session_store->read_sessions(
+      SessionRead(imsis.begin(), imsis.end()));
+  auto session_update =
+      session_store->get_default_session_update(session_map_2);
+  RuleLifetime installed = {
+      .activation_time = std::time_t(0),
+      .deactivation_time = std::time_t(0),
+  };
+  RuleLifetime scheduled = {
+      .activation_time = std::time_t(5),
+      .deactivation_time = std::time_t(0),
+  };
+  // Only IMSI1 has a rule installed, so only it is passing traffic
+  auto& uc1 = session_update["IMSI1"][session_id];
+  session_map_2["IMSI1"].front()->activate_static_rule(
+      "rule1", installed, uc1);
+  for (const auto& imsi : imsis) {
+    auto& uc = session_update[imsi][session_id];
+    session_map_2[imsi].front()->schedule_static_rule("rule2", scheduled, uc);
+  }
+  EXPECT_TRUE(session_store->update_sessions(session_update));
+
+  // Sync one subscriber at a time so every chunk boundary is crossed
+  auto chunk_size = LocalEnforcer::SESSION_SYNC_CHUNK_SIZE;
+  LocalEnforcer::SESSION_SYNC_CHUNK_SIZE = 1;
+  local_enforcer->sync_sessions_on_restart(std::time_t(10));
+  LocalEnforcer::SESSION_SYNC_CHUNK_SIZE = chunk_size;
+
+  session_map_2 = session_store->read_sessions(
+      SessionRead(imsis.begin(), imsis.end()));
+  for (const auto& imsi : imsis) {
+    EXPECT_EQ(session_map_2[imsi].size(), 1);
+    EXPECT_TRUE(
+        session_map_2[imsi].front()->is_static_rule_installed("rule2"));
+  }
+  EXPECT_TRUE(
+      session_map_2["IMSI1"].front()->is_static_rule_installed("rule1"));
+  EXPECT_FALSE(
+      session_map_2["IMSI2"].front()->is_static_rule_installed("rule1"));
+}
+
 // Make sure sessions that are scheduled to be terminated before sync are
 // correctly scheduled to be terminated again.
 TEST_F(LocalEnforcerTest, test_termination_scheduling_on_sync_sessions) {
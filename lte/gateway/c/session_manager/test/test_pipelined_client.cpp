@@ -0,0 +1,288 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <grpc++/grpc++.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "MagmaService.h"
+#include "PipelinedClient.h"
+#include "ServiceRegistrySingleton.h"
+#include "SessiondMocks.h"
+
+using grpc::Status;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::Test;
+
+namespace magma {
+
+/**
+ * Exposes the request queues so tests can see each callback's result
+ */
+class TestPipelinedClient : public AsyncPipelinedClient {
+ public:
+  TestPipelinedClient(
+    std::shared_ptr<grpc::Channel> channel,
+    uint32_t max_batch_size):
+    AsyncPipelinedClient(
+      channel, max_batch_size, std::chrono::milliseconds(10))
+  {
+  }
+
+  using AsyncPipelinedClient::queue_activation;
+  using AsyncPipelinedClient::queue_deactivation;
+};
+
+static ActivateFlowsRequest make_activate_req(
+  const std::string& imsi,
+  const std::string& rule_id)
+{
+  ActivateFlowsRequest req;
+  req.mutable_sid()->set_id(imsi);
+  req.add_rule_ids(rule_id);
+  return req;
+}
+
+static DeactivateFlowsRequest make_deactivate_req(const std::string& imsi)
+{
+  DeactivateFlowsRequest req;
+  req.mutable_sid()->set_id(imsi);
+  return req;
+}
+
+// Answers each request of a batch with a result naming its first rule
+static Status answer_activations(
+  grpc::ServerContext* context,
+  const ActivateFlowsBatchRequest* request,
+  ActivateFlowsBatchResult* response)
+{
+  for (const auto& req : request->requests()) {
+    auto result = response->add_results()->add_static_rule_results();
+    result->set_rule_id(req.rule_ids(0));
+    result->set_result(RuleModResult::SUCCESS);
+  }
+  return Status::OK;
+}
+
+class PipelinedClientTest : public ::testing::Test {
+ protected:
+  virtual void SetUp()
+  {
+    channel = ServiceRegistrySingleton::Instance()->GetGrpcChannel(
+      "test_service", ServiceRegistrySingleton::LOCAL);
+    pipelined_mock = std::make_shared<MockPipelined>();
+    test_service =
+      std::make_shared<service303::MagmaService>("test_service", "1.0");
+    test_service->AddServiceToServer(pipelined_mock.get());
+    std::thread([&]() {
+      test_service->Start();
+      test_service->WaitForShutdown();
+    }).detach();
+  }
+
+  virtual void TearDown()
+  {
+    if (client != nullptr) {
+      client->stop();
+    }
+    test_service->Stop();
+  }
+
+  void start_client(uint32_t max_batch_size)
+  {
+    client = std::make_shared<TestPipelinedClient>(channel, max_batch_size);
+    std::thread([&]() { client->rpc_response_loop(); }).detach();
+  }
+
+  // Queues an activation and returns the rule id its callback saw
+  std::future<std::string> activate(
+    const std::string& imsi,
+    const std::string& rule_id)
+  {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    client->queue_activation(
+      make_activate_req(imsi, rule_id),
+      [promise](Status status, ActivateFlowsResult resp) {
+        if (!status.ok()) {
+          promise->set_value("error: " + status.error_message());
+        } else if (resp.static_rule_results_size() == 0) {
+          promise->set_value("");
+        } else {
+          promise->set_value(resp.static_rule_results(0).rule_id());
+        }
+      });
+    return promise->get_future();
+  }
+
+  std::future<Status> deactivate(const std::string& imsi)
+  {
+    auto promise = std::make_shared<std::promise<Status>>();
+    client->queue_deactivation(
+      make_deactivate_req(imsi),
+      [promise](Status status, DeactivateFlowsResult resp) {
+        promise->set_value(status);
+      });
+    return promise->get_future();
+  }
+
+  template<typename T>
+  static T wait(std::future<T>& future)
+  {
+    EXPECT_EQ(
+      std::future_status::ready,
+      future.wait_for(std::chrono::seconds(5)));
+    return future.get();
+  }
+
+ protected:
+  std::shared_ptr<grpc::Channel> channel;
+  std::shared_ptr<MockPipelined> pipelined_mock;
+  std::shared_ptr<service303::MagmaService> test_service;
+  std::shared_ptr<TestPipelinedClient> client;
+};
+
+/**
+ * Activations for different subscribers are sent in one batch RPC and each
+ * callback gets the result of its own request
+ */
+TEST_F(PipelinedClientTest, test_coalesce_activations)
+{
+  start_client(100);
+  EXPECT_CALL(*pipelined_mock, ActivateFlows(_, _, _)).Times(0);
+  EXPECT_CALL(*pipelined_mock, ActivateFlowsBatch(_, _, _))
+    .Times(1)
+    .WillOnce(Invoke(answer_activations));
+
+  auto f1 = activate("IMSI1", "rule1");
+  auto f2 = activate("IMSI2", "rule2");
+  auto f3 = activate("IMSI3", "rule3");
+  client->flush_batches();
+
+  EXPECT_EQ("rule1", wait(f1));
+  EXPECT_EQ("rule2", wait(f2));
+  EXPECT_EQ("rule3", wait(f3));
+}
+
+/**
+ * A batch is sent as soon as it is full
+ */
+TEST_F(PipelinedClientTest, test_flush_full_batch)
+{
+  start_client(2);
+  EXPECT_CALL(*pipelined_mock, ActivateFlowsBatch(_, _, _))
+    .Times(1)
+    .WillOnce(Invoke(answer_activations));
+
+  auto f1 = activate("IMSI1", "rule1");
+  auto f2 = activate("IMSI2", "rule2");
+
+  EXPECT_EQ("rule1", wait(f1));
+  EXPECT_EQ("rule2", wait(f2));
+}
+
+/**
+ * A failed batch fails the callback of every request in it
+ */
+TEST_F(PipelinedClientTest, test_batch_error_fans_out)
+{
+  start_client(100);
+  EXPECT_CALL(*pipelined_mock, DeactivateFlows(_, _, _)).Times(0);
+  EXPECT_CALL(*pipelined_mock, DeactivateFlowsBatch(_, _, _))
+    .Times(1)
+    .WillOnce(Return(Status(grpc::StatusCode::INTERNAL, "boom")));
+
+  auto f1 = deactivate("IMSI1");
+  auto f2 = deactivate("IMSI2");
+  client->flush_batches();
+
+  EXPECT_EQ(grpc::StatusCode::INTERNAL, wait(f1).error_code());
+  EXPECT_EQ(grpc::StatusCode::INTERNAL, wait(f2).error_code());
+}
+
+/**
+ * Queueing a deactivation only sends the pending activations of the same
+ * subscriber, the others stay batched
+ */
+TEST_F(PipelinedClientTest, test_order_per_subscriber)
+{
+  start_client(100);
+  std::mutex mutex;
+  std::vector<std::string> activated;
+  EXPECT_CALL(*pipelined_mock, ActivateFlows(_, _, _))
+    .Times(2)
+    .WillRepeatedly(Invoke(
+      [&](
+        grpc::ServerContext*,
+        const ActivateFlowsRequest* request,
+        ActivateFlowsResult*) {
+        std::lock_guard<std::mutex> lock(mutex);
+        activated.push_back(request->sid().id());
+        return Status::OK;
+      }));
+
+  auto f1 = activate("IMSI1", "rule1");
+  auto f2 = activate("IMSI2", "rule2");
+  auto f3 = deactivate("IMSI1");
+
+  // IMSI1 is activated on its own before its deactivation is queued
+  EXPECT_EQ("", wait(f1));
+  EXPECT_EQ(
+    std::future_status::timeout, f2.wait_for(std::chrono::milliseconds(100)));
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(std::vector<std::string>{"IMSI1"}, activated);
+  }
+
+  client->flush_batches();
+  EXPECT_EQ("", wait(f2));
+  EXPECT_TRUE(wait(f3).ok());
+}
+
+/**
+ * When pipelined does not know the batch RPC the batch is resent one request
+ * at a time and later requests skip the batch RPC
+ */
+TEST_F(PipelinedClientTest, test_batch_unimplemented_fallback)
+{
+  start_client(100);
+  EXPECT_CALL(*pipelined_mock, ActivateFlowsBatch(_, _, _))
+    .Times(1)
+    .WillOnce(Return(Status(grpc::StatusCode::UNIMPLEMENTED, "")));
+  EXPECT_CALL(*pipelined_mock, ActivateFlows(_, _, _))
+    .Times(4)
+    .WillRepeatedly(Return(Status::OK));
+
+  auto f1 = activate("IMSI1", "rule1");
+  auto f2 = activate("IMSI2", "rule2");
+  client->flush_batches();
+  EXPECT_EQ("", wait(f1));
+  EXPECT_EQ("", wait(f2));
+
+  auto f3 = activate("IMSI3", "rule3");
+  auto f4 = activate("IMSI4", "rule4");
+  client->flush_batches();
+  EXPECT_EQ("", wait(f3));
+  EXPECT_EQ("", wait(f4));
+}
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+} // namespace magma
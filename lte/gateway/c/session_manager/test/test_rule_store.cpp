@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree. An additional grant
+ * of patent rights can be found in the PATENTS file in the same directory.
+ */
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include "RuleStore.h"
+#include "magma_logging.h"
+
+using ::testing::Test;
+
+namespace magma {
+
+class RuleStoreTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() { rule_store = std::make_shared<StaticRuleStore>(); }
+
+  PolicyRule build_rule(
+    uint32_t rating_group,
+    const std::string& m_key,
+    const std::string& rule_id)
+  {
+    PolicyRule rule;
+    rule.set_id(rule_id);
+    rule.set_rating_group(rating_group);
+    rule.set_monitoring_key(m_key);
+    rule.set_tracking_type(PolicyRule::OCS_AND_PCRF);
+    return rule;
+  }
+
+ protected:
+  std::shared_ptr<StaticRuleStore> rule_store;
+};
+
+TEST_F(RuleStoreTest, test_apply_changes)
+{
+  rule_store->sync_rules({build_rule(1, "m1", "rule1"),
+                          build_rule(2, "m2", "rule2"),
+                          build_rule(3, "m1", "rule3")});
+  EXPECT_EQ(3, rule_store->monitored_rules_count());
+
+  // rule1 moves to another monitoring key, rule3 is removed
+  rule_store->apply_changes({build_rule(1, "m2", "rule1")}, {"rule3"});
+
+  std::vector<std::string> rule_ids;
+  EXPECT_TRUE(rule_store->get_rule_ids_for_monitoring_key("m2", rule_ids));
+  EXPECT_EQ(2, rule_ids.size());
+  rule_ids.clear();
+  rule_store->get_rule_ids_for_monitoring_key("m1", rule_ids);
+  EXPECT_EQ(0, rule_ids.size());
+  EXPECT_EQ(2, rule_store->monitored_rules_count());
+
+  PolicyRule rule_out;
+  EXPECT_FALSE(rule_store->get_rule("rule3", &rule_out));
+  EXPECT_TRUE(rule_store->get_rule("rule1", &rule_out));
+  EXPECT_EQ("m2", rule_out.monitoring_key());
+
+  // removing an unknown rule is not an error
+  rule_store->apply_changes({}, {"unknown"});
+  EXPECT_EQ(2, rule_store->monitored_rules_count());
+}
+
+TEST_F(RuleStoreTest, test_read_during_sync)
+{
+  std::vector<PolicyRule> rules;
+  for (int i = 0; i < 100; i++) {
+    rules.push_back(build_rule(1, "m1", "rule" + std::to_string(i)));
+  }
+  rule_store->sync_rules(rules);
+
+  // readers see either the old or the new set of rules, never a partial one
+  std::atomic<bool> done(false);
+  std::thread writer([&]() {
+    for (int i = 0; i < 100; i++) {
+      rule_store->sync_rules(rules);
+    }
+    done = true;
+  });
+  while (!done) {
+    std::vector<std::string> rule_ids;
+    rule_store->get_rule_ids_for_monitoring_key("m1", rule_ids);
+    EXPECT_EQ(100, rule_ids.size());
+  }
+  writer.join();
+}
+
+int main(int argc, char** argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  FLAGS_logtostderr = 1;
+  FLAGS_v = 10;
+  return RUN_ALL_TESTS();
+}
+
+} // namespace magma
@@ -121,6 +121,21 @@ TEST_F(StoreClientTest, test_read_and_write) {
   EXPECT_EQ(all_sessions[imsi].front()->get_session_id(), sid);
   EXPECT_EQ(all_sessions[imsi3].size(), 1);
   EXPECT_EQ(all_sessions[imsi3].front()->get_session_id(), sid3);
+
+  // Get all sessions, two subscribers at a time
+  std::vector<size_t> chunk_sizes;
+  std::set<std::string> chunked_imsis;
+  auto success = store_client->read_all_sessions_chunked(
+      2, [&](SessionMap& chunk) {
+        chunk_sizes.push_back(chunk.size());
+        for (auto& it : chunk) {
+          EXPECT_EQ(it.second.size(), 1);
+          chunked_imsis.insert(it.first);
+        }
+      });
+  EXPECT_TRUE(success);
+  EXPECT_EQ(chunk_sizes, std::vector<size_t>({2, 1}));
+  EXPECT_EQ(chunked_imsis, std::set<std::string>({imsi, imsi2, imsi3}));
 }
 
 TEST_F(StoreClientTest, test_lambdas) {
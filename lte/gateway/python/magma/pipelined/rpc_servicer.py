@@ -17,13 +17,17 @@ from lte.protos.pipelined_pb2 import (
     SetupFlowsResult,
     RequestOriginType,
     ActivateFlowsResult,
+    ActivateFlowsBatchResult,
     DeactivateFlowsResult,
+    DeactivateFlowsBatchResult,
     FlowResponse,
     RuleModResult,
     SetupUEMacRequest,
     SetupPolicyRequest,
     SetupQuotaRequest,
     ActivateFlowsRequest,
+    ActivateFlowsBatchRequest,
+    DeactivateFlowsBatchRequest,
     AllTableAssignments,
     TableAssignment)
 from lte.protos.policydb_pb2 import PolicyRule
@@ -185,6 +189,36 @@ class PipelinedRpcServicer(pipelined_pb2_grpc.PipelinedServicer):
 
         fut.set_result(res)
 
+    def ActivateFlowsBatch(self, request, context):
+        """
+        Activate flows for many subscribers, results are in request order
+        """
+        if not self._service_manager.is_app_enabled(
+                EnforcementController.APP_NAME):
+            context.set_code(grpc.StatusCode.UNAVAILABLE)
+            context.set_details('Service not enabled!')
+            return None
+
+        fut = Future()  # type: Future[ActivateFlowsBatchResult]
+        self._loop.call_soon_threadsafe(self._activate_flows_batch,
+                                        request, fut)
+        return fut.result()
+
+    def _activate_flows_batch(self, request: ActivateFlowsBatchRequest,
+                              fut: 'Future[ActivateFlowsBatchResult]'
+                              ) -> ActivateFlowsBatchResult:
+        logging.debug('Activating flows for %d requests',
+                      len(request.requests))
+        results = []
+        for req in request.requests:
+            req_fut = Future()  # type: Future[ActivateFlowsResult]
+            if req.request_origin.type == RequestOriginType.GX:
+                self._activate_flows_gx(req, req_fut)
+            else:
+                self._activate_flows_gy(req, req_fut)
+            results.append(req_fut.result())
+        fut.set_result(ActivateFlowsBatchResult(results=results))
+
     def _activate_rules_in_enforcement_stats(self, imsi: str, ip_addr: str,
                                              static_rule_ids: List[str],
                                              dynamic_rules: List[PolicyRule]
@@ -236,6 +270,30 @@ class PipelinedRpcServicer(pipelined_pb2_grpc.PipelinedServicer):
                                             request)
         return DeactivateFlowsResult()
 
+    def DeactivateFlowsBatch(self, request, context):
+        """
+        Deactivate flows for many subscribers
+        """
+        if not self._service_manager.is_app_enabled(
+                EnforcementController.APP_NAME):
+            context.set_code(grpc.StatusCode.UNAVAILABLE)
+            context.set_details('Service not enabled!')
+            return None
+
+        self._loop.call_soon_threadsafe(self._deactivate_flows_batch,
+                                        request)
+        return DeactivateFlowsBatchResult(
+            results=[DeactivateFlowsResult() for _ in request.requests])
+
+    def _deactivate_flows_batch(self, request: DeactivateFlowsBatchRequest):
+        logging.debug('Deactivating flows for %d requests',
+                      len(request.requests))
+        for req in request.requests:
+            if req.request_origin.type == RequestOriginType.GX:
+                self._deactivate_flows_gx(req)
+            else:
+                self._deactivate_flows_gy(req)
+
     def _deactivate_flows_gx(self, request):
         logging.debug('Deactivating GX flows for %s', request.sid.id)
         if request.rule_ids:
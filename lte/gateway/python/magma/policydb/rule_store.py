@@ -23,6 +23,16 @@ class PolicyRuleDict(RedisHashDict):
     """
     _DICT_HASH = "policydb:rules"
     _NOTIFY_CHANNEL = "policydb:rules:stream_update"
+    # Sorted set of changed rule ids scored by _CHANGE_COUNTER, read by the
+    # sessiond PolicyLoader to fetch only rules that changed. The loader
+    # removes the entries it has applied.
+    _CHANGE_LOG = "policydb:rules:changes"
+    _CHANGE_COUNTER = "policydb:rules:change_counter"
+    _LOG_CHANGE_SCRIPT = """
+        local change = redis.call('INCR', KEYS[2])
+        redis.call('ZADD', KEYS[1], change, ARGV[1])
+        return change
+    """
 
     def __init__(self):
         client = get_default_client()
@@ -32,6 +42,23 @@ class PolicyRuleDict(RedisHashDict):
             get_proto_serializer(),
             get_proto_deserializer(PolicyRule))
 
+    def __setitem__(self, key, value):
+        super().__setitem__(key, value)
+        self._log_change(key)
+
+    def __delitem__(self, key):
+        super().__delitem__(key)
+        self._log_change(key)
+
+    def _log_change(self, key):
+        """
+        Record the change after the rule itself is written, so that readers
+        of the change log always find the new value. The counter and the log
+        are updated atomically to keep changes ordered between writers.
+        """
+        self.redis.eval(self._LOG_CHANGE_SCRIPT, 2, self._CHANGE_LOG,
+                        self._CHANGE_COUNTER, key)
+
     def send_update_notification(self):
         """
         Use Redis pub/sub channels to send notifications. Subscribers can listen
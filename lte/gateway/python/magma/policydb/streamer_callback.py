@@ -49,7 +49,9 @@ class PolicyDBStreamerCallback(StreamerClient.Callback):
             pass
 
     def _store_policy_rule(self, policy):
-        self._policy_dict[policy.id] = policy
+        # Resyncs carry every rule, only log the ones that actually changed
+        if self._policy_dict.get(policy.id) != policy:
+            self._policy_dict[policy.id] = policy
 
     def _remove_old_policies(self, id_set):
         """
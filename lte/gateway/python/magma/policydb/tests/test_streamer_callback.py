@@ -8,10 +8,13 @@ of patent rights can be found in the PATENTS file in the same directory.
 """
 
 import unittest
-from lte.protos.policydb_pb2 import AssignedPolicies, ChargingRuleNameSet
+import unittest.mock
+from lte.protos.policydb_pb2 import AssignedPolicies, ChargingRuleNameSet, \
+    PolicyRule
 from lte.protos.session_manager_pb2 import PolicyReAuthRequest, \
     PolicyReAuthAnswer, ReAuthResult
-from magma.policydb.streamer_callback import RuleMappingsStreamerCallback
+from magma.policydb.streamer_callback import PolicyDBStreamerCallback, \
+    RuleMappingsStreamerCallback
 from magma.policydb.reauth_handler import ReAuthHandler
 from orc8r.protos.streamer_pb2 import DataUpdate
 
@@ -60,6 +63,66 @@ class MockSessionProxyResponderStub3:
         )
 
 
+class MockPolicyRuleDict(dict):
+    """
+    This Mock PolicyRuleDict records the ids its change log would be given,
+    every set and delete is logged like PolicyRuleDict does
+    """
+    def __init__(self):
+        super().__init__()
+        self.changes = []
+
+    def __setitem__(self, key, value):
+        super().__setitem__(key, value)
+        self.changes.append(key)
+
+    def __delitem__(self, key):
+        super().__delitem__(key)
+        self.changes.append(key)
+
+    def send_update_notification(self):
+        pass
+
+
+class PolicyDBStreamerCallbackTest(unittest.TestCase):
+    @unittest.mock.patch('magma.policydb.streamer_callback.PolicyRuleDict',
+                         MockPolicyRuleDict)
+    def test_ResyncLogsOnlyChanges(self):
+        """
+        Test that a resync only writes, and so logs, new, changed and deleted
+        rules. Unchanged rules are left alone.
+        """
+        callback = PolicyDBStreamerCallback()
+        policy_dict = callback._policy_dict
+        policy_dict['unchanged'] = PolicyRule(id='unchanged', priority=1)
+        policy_dict['changed'] = PolicyRule(id='changed', priority=1)
+        policy_dict['deleted'] = PolicyRule(id='deleted', priority=1)
+        policy_dict.changes.clear()
+
+        updates = [
+            DataUpdate(
+                key=rule.id,
+                value=rule.SerializeToString(),
+            ) for rule in [
+                PolicyRule(id='unchanged', priority=1),
+                PolicyRule(id='changed', priority=2),
+                PolicyRule(id='new', priority=1),
+            ]
+        ]
+        callback.process_update("stream", updates, True)
+
+        self.assertEqual(sorted(policy_dict.changes),
+                         ['changed', 'deleted', 'new'])
+        self.assertEqual(sorted(policy_dict.keys()),
+                         ['changed', 'new', 'unchanged'])
+        self.assertEqual(policy_dict['changed'].priority, 2)
+
+        # The same resync again changes nothing
+        policy_dict.changes.clear()
+        callback.process_update("stream", updates, True)
+        self.assertEqual(policy_dict.changes, [])
+
+
 class RuleMappingsStreamerCallbackTest(unittest.TestCase):
     def test_SuccessfulUpdate(self):
         """
@@ -137,6 +137,41 @@ public:
     return SUCCESS;
   }
 
+  /**
+   * getmany returns the values stored at the given keys with a single HMGET.
+   * Keys not present in the hash are returned in missing_keys_out.
+   */
+  ObjectMapResult getmany(
+    const std::vector<std::string>& keys,
+    std::vector<ObjectType>& values_out,
+    std::vector<std::string>& missing_keys_out) {
+    if (keys.empty()) {
+      return SUCCESS;
+    }
+    auto hmget_future = client_->hmget(hash_, keys);
+    client_->sync_commit();
+    auto reply = hmget_future.get();
+    if (reply.is_error() || !reply.is_array()) {
+      MLOG(MERROR) << "unable to perform hmget command";
+      return CLIENT_ERROR;
+    }
+    auto array = reply.as_array();
+    for (size_t i = 0; i < array.size() && i < keys.size(); i++) {
+      if (array[i].is_null()) {
+        missing_keys_out.push_back(keys[i]);
+        continue;
+      }
+      ObjectType obj;
+      if (!array[i].is_string() ||
+          !deserializer_(array[i].as_string(), obj)) {
+        MLOG(MERROR) << "Unable to deserialize value for key " << keys[i];
+        return DESERIALIZE_FAIL;
+      }
+      values_out.push_back(obj);
+    }
+    return SUCCESS;
+  }
+
 private:
   /*
    * Return the version of the value for key *key*. Returns 0 if
@@ -12,8 +12,15 @@
 #include "ServiceConfigLoader.h"
 #include "magma_logging.h"
 
+#include <algorithm>
+#include <string>
+
 namespace magma {
 
+static const std::string POLICY_RULES_HASH = "policydb:rules";
+// Change log kept by policydb writers, see magma/policydb/rule_store.py
+static const std::string POLICY_RULES_CHANGES = "policydb:rules:changes";
+
 bool try_redis_connect(cpp_redis::client& client)
 {
   ServiceConfigLoader loader;
@@ -63,6 +70,122 @@ bool do_loop(
   return true;
 }
 
+/**
+ * Reads the change log, a sorted set of rule ids scored by a counter the
+ * writers increment on every change. Ids changed after last_change are
+ * returned, last_change is moved to the latest change seen.
+ */
+static bool get_changed_rule_ids(
+  cpp_redis::client& client,
+  uint64_t& last_change,
+  std::vector<std::string>& rule_ids_out)
+{
+  auto changes_future = client.zrangebyscore(
+    POLICY_RULES_CHANGES,
+    "(" + std::to_string(last_change),
+    "+inf",
+    true);
+  client.sync_commit();
+  auto reply = changes_future.get();
+  if (reply.is_error() || !reply.is_array()) {
+    MLOG(MERROR) << "Failed to read rule change log";
+    return false;
+  }
+  auto array = reply.as_array();
+  for (size_t i = 0; i + 1 < array.size(); i += 2) {
+    rule_ids_out.push_back(array[i].as_string());
+    last_change = std::max(
+      last_change, (uint64_t) std::stod(array[i + 1].as_string()));
+  }
+  return true;
+}
+
+/**
+ * Returns the score of the latest change in the change log, 0 if it is empty
+ */
+static bool get_latest_change(cpp_redis::client& client, uint64_t& change_out)
+{
+  auto latest_future = client.zrevrange(POLICY_RULES_CHANGES, 0, 0, true);
+  client.sync_commit();
+  auto reply = latest_future.get();
+  if (reply.is_error() || !reply.is_array()) {
+    MLOG(MERROR) << "Failed to read rule change log";
+    return false;
+  }
+  auto array = reply.as_array();
+  change_out = array.size() < 2 ?
+    0 : (uint64_t) std::stod(array[1].as_string());
+  return true;
+}
+
+/**
+ * Drops the change log entries up to last_change, they have been applied.
+ * A rule changed since then is scored above last_change, so it is kept.
+ */
+static void trim_change_log(cpp_redis::client& client, uint64_t last_change)
+{
+  auto trim_future = client.zremrangebyscore(
+    POLICY_RULES_CHANGES, "-inf", std::to_string(last_change));
+  client.sync_commit();
+  auto reply = trim_future.get();
+  if (reply.is_error()) {
+    // Left for a later loop to trim
+    MLOG(MERROR) << "Failed to trim rule change log";
+  }
+}
+
+bool do_incremental_loop(
+  cpp_redis::client& client,
+  RedisMap<PolicyRule>& policy_map,
+  bool full_sync_due,
+  uint64_t& last_change,
+  const std::function<void(std::vector<PolicyRule>)>& full_sync,
+  const std::function<
+    void(std::vector<PolicyRule>, std::vector<std::string>)>& apply_changes)
+{
+  if (!client.is_connected()) {
+    if (!try_redis_connect(client)) {
+      return false;
+    }
+    MLOG(MINFO) << "Connected to redis server";
+  }
+  if (full_sync_due) {
+    // Changes logged after this point are applied again on the next loop
+    uint64_t latest_change;
+    if (!get_latest_change(client, latest_change)) {
+      return false;
+    }
+    if (!do_loop(client, policy_map, full_sync)) {
+      return false;
+    }
+    last_change = latest_change;
+    trim_change_log(client, last_change);
+    return true;
+  }
+
+  std::vector<std::string> changed_ids;
+  uint64_t change = last_change;
+  if (!get_changed_rule_ids(client, change, changed_ids)) {
+    return false;
+  }
+  if (changed_ids.empty()) {
+    return true;
+  }
+  std::vector<PolicyRule> rules;
+  std::vector<std::string> removed_ids;
+  auto result = policy_map.getmany(changed_ids, rules, removed_ids);
+  if (result != SUCCESS) {
+    MLOG(MERROR) << "Failed to get changed rules because map error " << result;
+    return false;
+  }
+  MLOG(MDEBUG) << rules.size() << " rules changed, " << removed_ids.size()
+               << " rules removed";
+  apply_changes(rules, removed_ids);
+  last_change = change;
+  trim_change_log(client, last_change);
+  return true;
+}
+
 void PolicyLoader::start_loop(
   std::function<void(std::vector<PolicyRule>)> processor,
   uint32_t loop_interval_seconds)
@@ -70,13 +193,44 @@ void PolicyLoader::start_loop(
   is_running_ = true;
   auto client = std::make_shared<cpp_redis::client>();
   auto policy_map = RedisMap<PolicyRule>(
-    client, "policydb:rules", get_proto_serializer(), get_proto_deserializer());
+    client, POLICY_RULES_HASH, get_proto_serializer(), get_proto_deserializer());
   while (is_running_) {
     do_loop(*client, policy_map, processor);
     std::this_thread::sleep_for(std::chrono::seconds(loop_interval_seconds));
   }
 }
 
+void PolicyLoader::start_incremental_loop(
+  std::function<void(std::vector<PolicyRule>)> full_sync,
+  std::function<void(std::vector<PolicyRule>, std::vector<std::string>)>
+    apply_changes,
+  uint32_t loop_interval_seconds,
+  uint32_t full_sync_loops)
+{
+  is_running_ = true;
+  auto client = std::make_shared<cpp_redis::client>();
+  auto policy_map = RedisMap<PolicyRule>(
+    client, POLICY_RULES_HASH, get_proto_serializer(), get_proto_deserializer());
+  uint64_t last_change = 0;
+  uint32_t loops_since_full_sync = 0;
+  bool full_sync_due = true;
+  while (is_running_) {
+    if (do_incremental_loop(
+          *client,
+          policy_map,
+          full_sync_due,
+          last_change,
+          full_sync,
+          apply_changes)) {
+      loops_since_full_sync = full_sync_due ? 0 : loops_since_full_sync + 1;
+      full_sync_due = loops_since_full_sync >= full_sync_loops;
+    } else {
+      full_sync_due = true;
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(loop_interval_seconds));
+  }
+}
+
 void PolicyLoader::stop()
 {
   is_running_ = false;
@@ -28,6 +28,22 @@ public:
     std::function<void(std::vector<PolicyRule>)> processor,
     uint32_t loop_interval_seconds);
 
+  /**
+   * start_incremental_loop loads all policies on the first loop and then only
+   * the ones changed since the previous loop, using the change log policydb
+   * writers keep next to the rules. full_sync receives every rule, like the
+   * processor of start_loop, apply_changes receives changed rules and ids of
+   * removed ones. A full sync is repeated every full_sync_loops loops and
+   * after any error, so writers not keeping the change log are picked up too.
+   * Change log entries are removed once they have been applied.
+   */
+  void start_incremental_loop(
+    std::function<void(std::vector<PolicyRule>)> full_sync,
+    std::function<void(std::vector<PolicyRule>, std::vector<std::string>)>
+      apply_changes,
+    uint32_t loop_interval_seconds,
+    uint32_t full_sync_loops = 60);
+
   /**
    * Stop the config loop on the next loop
    */
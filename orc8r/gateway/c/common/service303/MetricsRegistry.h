@@ -49,6 +49,16 @@ class MetricsRegistry {
            const std::map<std::string, std::string>& labels,
            Args&&... args);
 
+    /**
+     * Remove the metric instance matching this name and label set, if there
+     * is one, so it is no longer exported. References to it are invalidated.
+     *
+     * @param name: the metric name
+     * @param labels: list of tuples denoting label key value pairs
+     */
+    void Remove(const std::string& name,
+                const std::map<std::string, std::string>& labels);
+
     const std::size_t SizeFamilies() {
       return families_.size();
     }
@@ -114,6 +124,20 @@ T& MetricsRegistry<T, MetricFamilyFactory>::Get(
   return *metric;
 }
 
+template <typename T, typename MetricFamilyFactory>
+void MetricsRegistry<T, MetricFamilyFactory>::Remove(
+  const std::string& name,
+  const std::map<std::string, std::string>& labels) {
+  auto metric_it = metrics_.find(hash_name_and_labels(name, labels));
+  if (metric_it == metrics_.end()) {
+    return;
+  }
+  // A metric is only ever created along with its family
+  auto family = families_.at(std::hash<std::string>{}(name));
+  family->Remove(metric_it->second);
+  metrics_.erase(metric_it);
+}
+
 template <typename T, typename MetricFamilyFactory>
 std::size_t MetricsRegistry<T, MetricFamilyFactory>::hash_name_and_labels(
     const std::string& name,
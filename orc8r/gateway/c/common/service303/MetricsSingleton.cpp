@@ -79,6 +79,16 @@ void MetricsSingleton::SetGauge(const char* name,
   gauges_.Get(name, labels).Set(value);
 }
 
+Gauge& MetricsSingleton::GetGauge(const char* name,
+  const std::map<std::string, std::string>& labels) {
+  return gauges_.Get(name, labels);
+}
+
+void MetricsSingleton::RemoveGauge(const char* name,
+  const std::map<std::string, std::string>& labels) {
+  gauges_.Remove(name, labels);
+}
+
 void MetricsSingleton::ObserveHistogram(const char* name,
   double observation,
   size_t label_count,
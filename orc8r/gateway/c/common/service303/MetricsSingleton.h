@@ -60,6 +60,19 @@ class MetricsSingleton {
       double observation,
       size_t label_count,
       va_list& args);
+    /*
+     * Returns the gauge for this name and label set so that callers setting
+     * it often can hold on to it instead of looking it up on every update.
+     * The gauge lives as long as the singleton.
+     */
+    Gauge& GetGauge(const char* name,
+      const std::map<std::string, std::string>& labels);
+    /*
+     * Removes the gauge for this name and label set so that it is no longer
+     * exported, e.g. once the source it describes is gone.
+     */
+    void RemoveGauge(const char* name,
+      const std::map<std::string, std::string>& labels);
   private:
     MetricsSingleton(); // Prevent construction
     MetricsSingleton(const MetricsSingleton&); // Prevent construction by copying